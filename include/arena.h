@@ -0,0 +1,139 @@
+/**
+ * @brief It defines the arena interface, a region allocator whose memory is
+ * given back all at once
+ *
+ * The entities created by the modules (spaces, objects, links, sets, the
+ * player and the dice) take their memory from the arena given to their
+ * create function, and their destroy functions do not free it.
+ *
+ * @file arena.h
+ * @author Eva Moresova
+ * @version 1.0
+ * @date 20-05-2021
+ * @copyright GNU Public License
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "types.h"
+
+#include <stddef.h>
+
+typedef struct _Arena Arena;
+
+/**
+ * @brief position in an arena, everything allocated after it can be given
+ * back with arena_rewind
+ */
+typedef struct {
+    void *chunk;
+    size_t used;
+} ArenaMark;
+
+/**
+ * @brief Arena create
+ *
+ * @author Eva Moresova
+ * @date 20-05-2021
+ *
+ * @param chunk_size size of the first block asked to malloc, every new block
+ * doubles it. Bigger allocations get a block of their own
+ * @return pointer to Arena or NULL if error
+ */
+Arena* arena_create(size_t chunk_size);
+
+/**
+ * @brief Arena destroy, frees all the blocks and sets it to NULL
+ *
+ * @author Eva Moresova
+ * @date 20-05-2021
+ *
+ * @param a double pointer to Arena
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS arena_destroy(Arena** a);
+
+/**
+ * @brief takes size bytes aligned for any type, the memory is not initialized
+ *
+ * @author Eva Moresova
+ * @date 20-05-2021
+ *
+ * @param a pointer to Arena
+ * @param size number of bytes
+ * @return pointer to the memory or NULL if error
+ */
+void* arena_alloc(Arena* a, size_t size);
+
+/**
+ * @brief copies a string into the arena
+ *
+ * @author Eva Moresova
+ * @date 20-05-2021
+ *
+ * @param a pointer to Arena
+ * @param s string to copy
+ * @return pointer to the copy or NULL if error
+ */
+char* arena_strdup(Arena* a, const char* s);
+
+/**
+ * @brief current position of the arena
+ *
+ * @author Eva Moresova
+ * @date 20-05-2021
+ *
+ * @param a pointer to Arena
+ * @return mark to use with arena_rewind
+ */
+ArenaMark arena_mark(Arena* a);
+
+/**
+ * @brief gives back everything allocated after the mark, the blocks are
+ * kept for the next allocations
+ *
+ * @author Eva Moresova
+ * @date 20-05-2021
+ *
+ * @param a pointer to Arena
+ * @param mark mark taken from the same arena
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS arena_rewind(Arena* a, ArenaMark mark);
+
+/**
+ * @brief gives back everything allocated in the arena
+ *
+ * @author Eva Moresova
+ * @date 20-05-2021
+ *
+ * @param a pointer to Arena
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS arena_reset(Arena* a);
+
+/**
+ * @brief for testing if some memory belongs to the arena
+ *
+ * @author Eva Moresova
+ * @date 20-05-2021
+ *
+ * @param a pointer to Arena
+ * @param p pointer to test
+ * @return TRUE if p is inside one of the blocks of the arena, FALSE otherwise
+ */
+BOOL arena_owns(Arena* a, const void* p);
+
+/**
+ * @brief number of bytes in use
+ *
+ * @author Eva Moresova
+ * @date 20-05-2021
+ *
+ * @param a pointer to Arena
+ * @return number of bytes
+ */
+size_t arena_get_used(Arena* a);
+
+#endif
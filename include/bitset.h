@@ -0,0 +1,162 @@
+/**
+ * @brief It defines the bitset interface, a set of small non negative ids
+ * stored as one bit per id
+ *
+ * @file bitset.h
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 17-05-2021
+ * @copyright GNU Public License
+ */
+
+#ifndef BITSET_H
+#define BITSET_H
+
+#include "types.h"
+
+typedef struct _Bitset Bitset;
+
+/**
+ * @brief creates an empty bitset
+ *
+ * @author Jiri Zak
+ * @date 17-05-2021
+ *
+ * @param n_bits expected biggest id + 1, the bitset grows when needed
+ * @return pointer to Bitset or NULL if error
+ */
+Bitset* bitset_create(int n_bits);
+
+/**
+ * @brief Bitset destroy and set it to NULL
+ *
+ * @author Jiri Zak
+ * @date 17-05-2021
+ *
+ * @param b double pointer to Bitset
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS bitset_destroy(Bitset** b);
+
+/**
+ * @brief adds the id to the bitset
+ *
+ * @author Jiri Zak
+ * @date 17-05-2021
+ *
+ * @param b pointer to Bitset
+ * @param id non negative id
+ * @return STATUS ERROR = 0 if the id is negative or too large to have a
+ * word, OK = 1
+ */
+STATUS bitset_add(Bitset* b, Id id);
+
+/**
+ * @brief adds all the ids of an array to the bitset
+ *
+ * @author Jiri Zak
+ * @date 17-05-2021
+ *
+ * @param b pointer to Bitset
+ * @param ids array of non negative ids
+ * @param n number of ids in the array
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS bitset_add_ids(Bitset* b, const Id* ids, int n);
+
+/**
+ * @brief removes the id from the bitset
+ *
+ * @author Jiri Zak
+ * @date 17-05-2021
+ *
+ * @param b pointer to Bitset
+ * @param id id to remove
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS bitset_remove(Bitset* b, Id id);
+
+/**
+ * @brief for testing if the id is in the bitset
+ *
+ * @author Jiri Zak
+ * @date 17-05-2021
+ *
+ * @param b pointer to Bitset
+ * @param id id to test
+ * @return TRUE if the id is in the bitset, FALSE otherwise
+ */
+BOOL bitset_contains(Bitset* b, Id id);
+
+/**
+ * @brief removes all the ids, the memory is kept
+ *
+ * @author Jiri Zak
+ * @date 17-05-2021
+ *
+ * @param b pointer to Bitset
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS bitset_clear(Bitset* b);
+
+/**
+ * @brief union, dst gets all the ids of src
+ *
+ * @author Jiri Zak
+ * @date 17-05-2021
+ *
+ * @param dst pointer to Bitset that is modified
+ * @param src pointer to Bitset
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS bitset_union(Bitset* dst, Bitset* src);
+
+/**
+ * @brief intersection, dst keeps only the ids that are also in src
+ *
+ * @author Jiri Zak
+ * @date 17-05-2021
+ *
+ * @param dst pointer to Bitset that is modified
+ * @param src pointer to Bitset
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS bitset_intersection(Bitset* dst, Bitset* src);
+
+/**
+ * @brief difference, the ids of src are removed from dst
+ *
+ * @author Jiri Zak
+ * @date 17-05-2021
+ *
+ * @param dst pointer to Bitset that is modified
+ * @param src pointer to Bitset
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS bitset_difference(Bitset* dst, Bitset* src);
+
+/**
+ * @brief number of ids in the bitset
+ *
+ * @author Jiri Zak
+ * @date 17-05-2021
+ *
+ * @param b pointer to Bitset
+ * @return number of ids or -1 if error
+ */
+int bitset_count(Bitset* b);
+
+/**
+ * @brief for testing if two bitsets have any id in common, without
+ * modifying them
+ *
+ * @author Jiri Zak
+ * @date 17-05-2021
+ *
+ * @param a pointer to Bitset
+ * @param b pointer to Bitset
+ * @return TRUE if the intersection is not empty, FALSE otherwise
+ */
+BOOL bitset_intersects(Bitset* a, Bitset* b);
+
+#endif
@@ -11,8 +11,17 @@
 #ifndef COMMAND_H
 #define COMMAND_H
 
+#include <stdio.h>
+
+#include "types.h"
+#include "vocabulary.h"
+
 #define N_CMDT 2
 #define N_CMD 13
+/* words after the verb a command keeps, the rest of the line is left out */
+#define CMD_MAX_ARGS 4
+/* longest line a command is read from */
+#define CMD_LINE 256
 
 typedef enum enum_CmdType {
     CMDS,
@@ -41,16 +50,81 @@ typedef enum enum_rules {
     DIERULE,
     DROPRULE,
     ONRULE,
-    OFFRULE
+    OFFRULE,
+    TOGGLERULE,
+    TELEPORTRULE
 } T_Rules;
 
+/* a command line split in words. The words point into the line, which is
+ * cut with '\0' after each of them, so they last as long as the line */
+typedef struct {
+    T_Command verb;                 // NO_CMD for a line without words
+    const char *args[CMD_MAX_ARGS]; // words after the verb
+    int argc;
+} ParsedCommand;
+
+/**
+ * @brief the words every game knows: the commands, in short and long
+ * form, and the directions
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @return the vocabulary, compiled, or NULL if there is no memory
+ */
+Vocabulary *command_get_vocabulary();
+
+/**
+ * @brief adds the words every game knows to a vocabulary
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param v pointer to Vocabulary
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS command_add_words(Vocabulary *v);
+
+/**
+ * @brief splits a line in words and interprets the first one as a command
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param line the line, changed in place
+ * @param v vocabulary the verb is looked up in, NULL for command_get_vocabulary
+ * @param cmd set to the command and its words
+ * @return STATUS ERROR = 0 if line or cmd is NULL, OK = 1
+ */
+STATUS command_parse(char *line, Vocabulary *v, ParsedCommand *cmd);
+
 /**
- * @brief scan user input and interpret it to command
+ * @brief reads the next line with words of a file and parses it. A line
+ * longer than the buffer is cut
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param in file to read from
+ * @param v vocabulary the verb is looked up in, NULL for command_get_vocabulary
+ * @param line buffer the words of cmd point into
+ * @param size size of the buffer
+ * @param cmd set to the command and its words
+ * @return STATUS ERROR = 0 at the end of the file, OK = 1
+ */
+STATUS command_read(FILE *in, Vocabulary *v, char *line, int size, ParsedCommand *cmd);
+
+/**
+ * @brief scan user input and interpret it to command, one line at a time
  *
  * @author Eva Moresova
  * @date 15-02-2021
- * @return Command type
+ *
+ * @param v vocabulary the verb is looked up in, NULL for command_get_vocabulary
+ * @param line buffer of CMD_LINE chars the words of cmd point into
+ * @param cmd set to the command and its words
+ * @return Command type, NO_CMD at the end of the input
  */
-T_Command get_user_input();
+T_Command get_user_input(Vocabulary *v, char *line, ParsedCommand *cmd);
 
 #endif
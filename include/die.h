@@ -12,6 +12,8 @@
 #define DIE_H
 
 #include "types.h"
+#include "rng.h"
+#include "arena.h"
 
 #include <stdio.h>
 
@@ -23,11 +25,14 @@ typedef struct dice Dice;
  * @author Jiri Zak
  * @date 1-03-2021
  * 
+ * @param a arena the dice is taken from, NULL to malloc it
  * @param minimum minimum of the range
  * @param maximum maximum of the range
+ * @param r generator it is rolled with, not owned. With NULL the dice
+ * creates one of its own, seeded from the clock, and destroys it with itself
  * @return pointer to Dice or NULL if error
  */
-Dice* dice_create(int, int);
+Dice* dice_create(Arena*, int, int, Rng*);
 
 /**
  * @brief Dice destroy and set it to NULL
@@ -41,7 +46,8 @@ Dice* dice_create(int, int);
 STATUS dice_destroy(Dice **);
 
 /**
- * @brief Generate random number from dice range and save it to the structure
+ * @brief Generate random number from dice range and save it to the structure.
+ * It is drawn from the generator of the dice
  *
  * @author Jiri Zak
  * @date 1-03-2021
@@ -76,4 +82,39 @@ STATUS dice_save(FILE*, Dice*);
 
 STATUS dice_set_last_roll(Dice*, int);
 
+/**
+ * @brief smallest value the dice can roll
+ *
+ * @author Jiri Zak
+ * @date 25-05-2021
+ *
+ * @param d pointer to Dice
+ * @return int or -1 if ERROR
+ */
+int dice_get_minimum(Dice* d);
+
+/**
+ * @brief biggest value the dice can roll
+ *
+ * @author Jiri Zak
+ * @date 25-05-2021
+ *
+ * @param d pointer to Dice
+ * @return int or -1 if ERROR
+ */
+int dice_get_maximum(Dice* d);
+
+/**
+ * @brief sets the generator the dice is rolled with, usually the one of
+ * its game. A generator the dice created for itself is destroyed
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param d pointer to Dice
+ * @param r pointer to Rng, not owned by the dice
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS dice_set_rng(Dice* d, Rng* r);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+/**
+ * @brief It defines the dirty list, the spaces, links and objects of a game
+ * that changed since it was last saved. An entity is pushed by its id, and
+ * a link also by its spaces, when it stops being clean, so the list stays
+ * right after the entity is destroyed and built again. The same entity can
+ * be in it more than once, it never holds many more entries than there are
+ * entities
+ *
+ * @file dirty_list.h
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#ifndef DIRTY_LIST_H
+#define DIRTY_LIST_H
+
+#include "types.h"
+
+typedef struct _DirtyList DirtyList;
+
+/* kinds of the entities of the list */
+typedef enum {
+    DIRTY_SPACE = 1,
+    DIRTY_LINK,
+    DIRTY_OBJECT
+} DirtyKind;
+
+/* an entity that changed */
+typedef struct {
+    DirtyKind kind;
+    Id id;
+    Id first;       // spaces of a link, NO_ID for a space or an object
+    Id second;
+} DirtyEntry;
+
+/**
+ * @brief creates an empty dirty list
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @return pointer to created list or NULL in case of error
+ */
+DirtyList* dirty_list_create();
+
+/**
+ * @brief destructor for dirty list
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param l double pointer to list, set to NULL
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS dirty_list_destroy(DirtyList** l);
+
+/**
+ * @brief adds an entity that changed
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param l pointer to list
+ * @param kind kind of the entity
+ * @param id id of the entity
+ * @param first first space of a link, NO_ID for the others
+ * @param second second space of a link, NO_ID for the others
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS dirty_list_push(DirtyList* l, DirtyKind kind, Id id, Id first, Id second);
+
+/**
+ * @brief the entries of the list, valid until it is changed
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param l pointer to list
+ * @param n set to the number of entries
+ * @return the entries or NULL in case of error
+ */
+const DirtyEntry* dirty_list_view(DirtyList* l, int* n);
+
+/**
+ * @brief removes every entry, once what they changed is saved
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param l pointer to list
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS dirty_list_clear(DirtyList* l);
+
+#endif
@@ -14,13 +14,44 @@
 
 #include <stdio.h>
 
+#include "arena.h"
 #include "command.h"
 #include "die.h"
+#include "dirty_list.h"
+#include "intern.h"
 #include "object.h"
 #include "player.h"
+#include "rng.h"
+#include "rule_table.h"
 #include "space.h"
+#include "timer_wheel.h"
 
 typedef struct _Game Game;
+/* world streamed from an image, implemented in world_image.c */
+typedef struct _WorldStream WorldStream;
+/* journal of saved states, implemented in game_state.c */
+typedef struct _GameJournal GameJournal;
+/* world in order of id as the saved states see it, implemented in game_state.c */
+typedef struct _StateView StateView;
+
+/* what a world event does to its target when it is due */
+typedef enum enum_Event {
+    EVENT_OFF,      // turns an object off
+    EVENT_ON,       // turns an object on
+    EVENT_CLOSE,    // closes a link
+    EVENT_OPEN,     // opens a link
+    EVENT_TOGGLE    // switches the light of a space
+} T_Event;
+
+/* an event of the world, due some turns after the world is loaded or after
+ * a command acts on its target */
+typedef struct {
+    T_Event effect;
+    Id target;          // object, link or space, as the effect needs
+    long delay;         // turns until it is due
+    long period;        // turns between two times it happens, 0 to happen once
+    T_Command trigger;  // NO_CMD to start with the world, TURNON, TURNOFF or OPEN
+} WorldEvent;
 
 /**
  * @brief Game create
@@ -54,10 +85,10 @@ STATUS game_create_from_file(Game* game, char* filename);
  * @brief invokes callback function of the specified command
  * 
  * @param game pointer to game 
- * @param cmd new command to execute
+ * @param cmd new command to execute, with the words after it
  * @return STATUS ERROR = 0, OK = 1
  */
-STATUS game_update(Game* game, T_Command cmd);
+STATUS game_update(Game* game, const ParsedCommand* cmd);
 
 /**
  * @brief frees all the game resources
@@ -129,6 +160,52 @@ Object* game_get_object(Game* game, Id id);
  */
 Object* game_get_object_at_position(Game* game, int id);
 
+/**
+ * @brief space getter at position, in loading order
+ *
+ * @author Jiri Zak
+ * @date 25-05-2021
+ *
+ * @param game pointer to game
+ * @param position position in game
+ * @return space at the position or NULL
+ */
+Space* game_get_space_at_position(Game* game, int position);
+
+/**
+ * @brief get number of spaces
+ *
+ * @author Jiri Zak
+ * @date 25-05-2021
+ *
+ * @param game pointer to game
+ * @return number or if ERROR -1
+ */
+int game_get_number_space(Game* game);
+
+/**
+ * @brief link getter at position, in creation order
+ *
+ * @author Jiri Zak
+ * @date 25-05-2021
+ *
+ * @param game pointer to game
+ * @param position position in game
+ * @return link at the position or NULL
+ */
+Link* game_get_link_at_position(Game* game, int position);
+
+/**
+ * @brief get number of links
+ *
+ * @author Jiri Zak
+ * @date 25-05-2021
+ *
+ * @param game pointer to game
+ * @return number or if ERROR -1
+ */
+int game_get_number_link(Game* game);
+
 /**
  * @brief player getter
  *
@@ -151,6 +228,18 @@ Player* game_get_player(Game* game);
  */
 Dice* game_get_dice(Game* game);
 
+/**
+ * @brief getter for the generator the dice and the random rules are drawn
+ * from. Seeding it again makes the game play the same as before
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @return the generator or NULL
+ */
+Rng* game_get_rng(Game* game);
+
 /**
  * @brief open log file for output
  *
@@ -173,6 +262,44 @@ void game_open_log_file(Game *game, char *filename);
  */
 FILE* game_get_log_file(Game* game);
 
+/**
+ * @brief makes room for at least the specified number of spaces and objects,
+ * so loading a world of known size does not grow the storage step by step
+ *
+ * @author Eva Moresova
+ * @date 14-05-2021
+ * 
+ * @param game pointer to game
+ * @param n_spaces number of spaces to make room for
+ * @param n_objects number of objects to make room for
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_reserve(Game* game, int n_spaces, int n_objects);
+
+/**
+ * @brief getter for the arena of the game, the loaders give it to the
+ * create functions of the entities of the world
+ *
+ * @author Eva Moresova
+ * @date 20-05-2021
+ * 
+ * @param game pointer to game
+ * @return pointer to Arena or NULL
+ */
+Arena* game_get_arena(Game* game);
+
+/**
+ * @brief getter for the pool the texts of the world are interned in, the
+ * loaders give it to the create functions of the entities of the world
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @return pointer to InternPool or NULL
+ */
+InternPool* game_get_strings(Game* game);
+
 /**
  * @brief add space to game
  *
@@ -197,6 +324,325 @@ STATUS game_add_space(Game* game, Space* space);
  */
 STATUS game_add_object(Game* game, Object* obj);
 
+/**
+ * @brief add link to game, the game destroys it. The same link is set as
+ * exit of the two spaces it connects
+ *
+ * @author Jiri Zak
+ * @date 22-05-2021
+ * 
+ * @param game pointer to game
+ * @param link pointer to link
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_add_link(Game* game, Link* link);
+
+/**
+ * @brief adds a random rule to the world of the game. The rules are
+ * drawn from once game_compile_rules is called
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @param rule the rule, copied
+ * @return STATUS ERROR = 0 if the rule is not valid, OK = 1
+ */
+STATUS game_add_rule(Game* game, const Rule* rule);
+
+/**
+ * @brief compiles the random rules of the game, the ones of a world
+ * without rules if none was added
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_compile_rules(Game* game);
+
+/**
+ * @brief getter for the random rules of the world
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @return the rules or NULL if none was added
+ */
+RuleTable* game_get_rule_table(Game* game);
+
+/**
+ * @brief adds an event to the world of the game. The ones that start with
+ * the world are scheduled by game_start_events
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @param event the event, copied
+ * @return STATUS ERROR = 0 if the event is not valid, OK = 1
+ */
+STATUS game_add_event(Game* game, const WorldEvent* event);
+
+/**
+ * @brief schedules the events that start with the world
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_start_events(Game* game);
+
+/**
+ * @brief goes on to the next turn of the timers of the game, the events due
+ * in it happen
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @return the number of events that happened, -1 if error
+ */
+int game_tick(Game* game);
+
+/**
+ * @brief getter for the timers of the game
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @return the timers or NULL if the world has no events
+ */
+TimerWheel* game_get_timers(Game* game);
+
+/**
+ * @brief getter for the number of events of the world
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @return the number, -1 if error
+ */
+int game_get_number_event(Game* game);
+
+/**
+ * @brief getter for an event of the world
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @param position position of the event, in the order they were added
+ * @return the event or NULL if there is none there
+ */
+const WorldEvent* game_get_event_at_position(Game* game, int position);
+
+/**
+ * @brief event effect and trigger from their names in a data file
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param effect off, on, close, open or toggle, ignoring case
+ * @param trigger start, turnon, turnoff or open, ignoring case. NULL is start
+ * @param event its effect and trigger are set
+ * @return STATUS ERROR = 0 if a name is not known, OK = 1
+ */
+STATUS game_event_from_names(const char* effect, const char* trigger, WorldEvent* event);
+
+/**
+ * @brief adds a word of the world that means what a known one means. The
+ * first one gives the game a vocabulary of its own
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @param word the new word
+ * @param of a command or a direction, or a synonym added before
+ * @return STATUS ERROR = 0 if of is not known, OK = 1
+ */
+STATUS game_add_synonym(Game* game, const char* word, const char* of);
+
+/**
+ * @brief builds the perfect hash of the vocabulary of the game once the
+ * synonyms of the world are added
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_compile_vocabulary(Game* game);
+
+/**
+ * @brief getter for the words the commands are read with
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @return the vocabulary of the game, or the one every game knows if the
+ * world has no synonyms
+ */
+Vocabulary* game_get_vocabulary(Game* game);
+
+/**
+ * @brief indexes a link by its id and by its name, ignoring case, once it
+ * has one. The first link indexed with a name is the one
+ * game_get_link_by_name tries first
+ *
+ * @author Jiri Zak
+ * @date 23-05-2021
+ *
+ * @param game pointer to game
+ * @param link pointer to link with a name
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_index_link(Game* game, Link* link);
+
+/**
+ * @brief removes a space from the game without destroying it
+ *
+ * @author Jiri Zak
+ * @date 26-05-2021
+ *
+ * @param game pointer to game
+ * @param space pointer to space in the game
+ * @return STATUS ERROR = 0 if it is not in the game, OK = 1
+ */
+STATUS game_remove_space(Game* game, Space* space);
+
+/**
+ * @brief removes an object from the game without destroying it
+ *
+ * @author Jiri Zak
+ * @date 26-05-2021
+ *
+ * @param game pointer to game
+ * @param obj pointer to object in the game
+ * @return STATUS ERROR = 0 if it is not in the game, OK = 1
+ */
+STATUS game_remove_object(Game* game, Object* obj);
+
+/**
+ * @brief removes a link from the game without destroying it
+ *
+ * @author Jiri Zak
+ * @date 26-05-2021
+ *
+ * @param game pointer to game
+ * @param link pointer to link in the game
+ * @return STATUS ERROR = 0 if it is not in the game, OK = 1
+ */
+STATUS game_remove_link(Game* game, Link* link);
+
+/**
+ * @brief sets the stream the world of the game is read from. The game
+ * closes it when it is cleared or destroyed
+ *
+ * @author Jiri Zak
+ * @date 26-05-2021
+ *
+ * @param game pointer to game
+ * @param ws stream, NULL to forget the current one without closing it
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_set_stream(Game* game, WorldStream* ws);
+
+/**
+ * @brief getter for the stream of the world
+ *
+ * @author Jiri Zak
+ * @date 26-05-2021
+ *
+ * @param game pointer to game
+ * @return the stream or NULL if the whole world is in memory
+ */
+WorldStream* game_get_stream(Game* game);
+
+/**
+ * @brief sets the journal the game is saved to. The game closes it when it
+ * is cleared or destroyed
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param game pointer to game
+ * @param j journal, NULL to forget the current one without closing it
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_set_journal(Game* game, GameJournal* j);
+
+/**
+ * @brief getter for the journal of the game
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param game pointer to game
+ * @return the journal or NULL if there is none
+ */
+GameJournal* game_get_journal(Game* game);
+
+/**
+ * @brief sets the view of the world the saved states are made with. The
+ * game destroys it when its spaces, links or objects change, or when it is
+ * cleared or destroyed
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param game pointer to game
+ * @param v view, NULL to forget the current one without destroying it
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_set_state_view(Game* game, StateView* v);
+
+/**
+ * @brief getter for the view of the world of the saved states
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param game pointer to game
+ * @return the view or NULL if there is none yet
+ */
+StateView* game_get_state_view(Game* game);
+
+/**
+ * @brief getter for the list of the spaces, links and objects that stopped
+ * being clean since the game was last saved, by their ids. They are added
+ * to it with the game, so what was changed before is not in it
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @return pointer to DirtyList or NULL
+ */
+DirtyList* game_get_dirty_list(Game* game);
+
+/**
+ * @brief marks every space, link and object of the game and the player as
+ * clean, once their state is saved or as it was loaded, and empties the
+ * dirty list
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param game pointer to game
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_mark_saved(Game* game);
+
 /**
  * @brief set player
  *
@@ -234,6 +680,17 @@ T_Command game_get_prev_command(Game* game);
  */
 T_Rules game_get_last_rule(Game *game);
 
+/**
+ * @brief Returns the space the last rule sends the player to
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @return the space of a teleport, NO_ID for the other rules
+ */
+Id game_get_last_rule_target(Game *game);
+
 
 STATUS game_set_prev_command(Game* game, T_Command cmd);
 
@@ -244,7 +701,49 @@ STATUS game_set_prev_command(Game* game, T_Command cmd);
  * @param filename file to load the spaces from
  * @return STATUS ERROR = 0, OK = 1
  */
-STATUS game_management_load(char* filename, Game* game);
+STATUS game_management_load(const char* filename, Game* game);
+
+/**
+ * @brief sets the number of threads that split a data file into lines
+ * while loading it. The lines are still loaded into the game one by one
+ * and in order, so the game is the same with any number
+ *
+ * @author Eva Moresova
+ * @date 26-05-2021
+ *
+ * @param n_threads number of threads, 0 to use a thread per processor when
+ * the file is big enough, which is the default
+ * @return STATUS ERROR = 0 if the number is negative, OK = 1
+ */
+STATUS game_management_set_threads(int n_threads);
+
+/**
+ * @brief chooses how compiled worlds (.gwc) are loaded from now on. A
+ * streamed world keeps its file mapped and builds each region the first
+ * time one of its spaces or objects is needed. Text data files are always
+ * loaded whole
+ *
+ * @author Jiri Zak
+ * @date 26-05-2021
+ *
+ * @param max_regions -1 to load whole worlds, which is the default, 0 to
+ * stream them keeping every region built, more to evict the least
+ * recently used regions that were not changed when there are more
+ * @return STATUS ERROR = 0 if it is less than -1, OK = 1
+ */
+STATUS game_management_set_stream(int max_regions);
+
+/**
+ * @brief number of links lines of the last data file loaded that were left
+ * out, because their spaces have no exit between them or their id was
+ * already used. Each one is reported on stderr
+ *
+ * @author Eva Moresova
+ * @date 27-05-2021
+ *
+ * @return lines left out
+ */
+int game_management_get_link_errors();
 
 /**
  * @brief get number of objects
@@ -279,7 +778,7 @@ Link *game_get_link_by_name(Game *game, const char *name);
 STATUS game_set_dice(Game* game, Dice* dice);
 STATUS game_save(FILE*, Game*);
 
-STATUS game_management_save(char* filename, Game* game);
+STATUS game_management_save(const char* filename, Game* game);
 
 BOOL game_player_has_light(Game* game);
 
@@ -0,0 +1,145 @@
+/**
+ * @brief It defines the saved game format (.gsv)
+ *
+ * A saved game only has what changes while playing: where the objects are
+ * and if they are turned on, which links are opened, which spaces are
+ * illuminated, the inventory and location of the player and the last roll
+ * of the dice. It is restored on the world it was saved from, which is
+ * identified by a hash of its spaces, links and objects, and it ends the
+ * header with a checksum of the whole save.
+ *
+ * A journal is a save that the changes are appended to: each delta only has
+ * the spaces, links, objects and player marked dirty since the one before,
+ * so saving every few turns costs as much as what was done in them. When
+ * the deltas outgrow the save the journal is written again as one save.
+ * game_state_load reads a journal like any other save.
+ *
+ * @file game_state.h
+ * @author Jiri Zak
+ * @version 2.0
+ * @date 27-05-2021
+ * @copyright GNU Public License
+ */
+
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include "game.h"
+
+#include <stdint.h>
+
+/**
+ * @brief writes the state of a game. Of a streamed world, the regions that
+ * are not in memory are written as the image has them, none is built
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param filename name of the file
+ * @param game pointer to game
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_state_save(const char* filename, Game* game);
+
+/**
+ * @brief tells a saved game from a data file or a world image
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param filename name of the file
+ * @return TRUE if it starts like a saved game
+ */
+BOOL game_state_check(const char* filename);
+
+/**
+ * @brief restores a saved game on the world of a game, with the deltas of
+ * a journal up to the first one that is not whole. Nothing changes if the
+ * save is not valid. Of a streamed world, only the regions the save has
+ * other than the image are built
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param filename name of the file
+ * @param game pointer to game with the world the state was saved from
+ * @return STATUS ERROR = 0 if the file is damaged, of another version or
+ * of another world, OK = 1
+ */
+STATUS game_state_load(const char* filename, Game* game);
+
+/**
+ * @brief frees the view of a world the saves are made with, which the game
+ * keeps from the first save or load until its world changes
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param v double pointer to the view, set to NULL
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_state_view_destroy(StateView** v);
+
+/**
+ * @brief identity of the world of a game, the same whatever order its
+ * spaces, links and objects were loaded in
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param game pointer to game
+ * @return hash of the ids, exits and names, 0 if error
+ */
+uint64_t game_state_world_hash(Game* game);
+
+/**
+ * @brief starts a journal with a save of a game and marks the game clean.
+ * A streamed world is not built, what changes is found by its id
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param filename name of the file, replaced if it exists
+ * @param game pointer to game, its spaces, links and objects must stay
+ * the same while the journal is open
+ * @return the journal or NULL if error
+ */
+GameJournal* game_state_journal_open(const char* filename, Game* game);
+
+/**
+ * @brief appends what changed in a game since the last delta, the entities
+ * of its dirty list and the player, and marks the game clean. Nothing is
+ * written if nothing changed
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param j journal
+ * @param game pointer to game the journal was opened with
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_state_journal_append(GameJournal* j, Game* game);
+
+/**
+ * @brief getter for the file of a journal
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param j journal
+ * @return the name of the file or NULL if error
+ */
+const char* game_state_journal_get_filename(GameJournal* j);
+
+/**
+ * @brief frees a journal, what is in its file stays
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param j double pointer to the journal, set to NULL
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_state_journal_close(GameJournal** j);
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * @brief It defines the id table interface, a hash index from Id to pointer
+ *
+ * @file id_table.h
+ * @author Eva Moresova
+ * @version 1.0
+ * @date 12-05-2021
+ * @copyright GNU Public License
+ */
+
+#ifndef ID_TABLE_H
+#define ID_TABLE_H
+
+#include "types.h"
+#include "arena.h"
+
+typedef struct _IdTable IdTable;
+
+/**
+ * @brief creates an empty id table
+ *
+ * @author Eva Moresova
+ * @date 12-05-2021
+ *
+ * @param a arena the table is taken from, NULL to malloc it
+ * @param capacity expected number of entries, the table grows when needed
+ * @return pointer to created table or NULL in case of error
+ */
+IdTable* id_table_create(Arena* a, int capacity);
+
+/**
+ * @brief destructor for id table, the stored values are not freed
+ *
+ * @author Eva Moresova
+ * @date 12-05-2021
+ *
+ * @param t double pointer to table
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS id_table_destroy(IdTable** t);
+
+/**
+ * @brief stores value under the id, an existing entry with the same id
+ * is replaced
+ *
+ * @author Eva Moresova
+ * @date 12-05-2021
+ *
+ * @param t pointer to table
+ * @param id key of the entry
+ * @param value pointer stored for the id
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS id_table_put(IdTable* t, Id id, void* value);
+
+/**
+ * @brief getter for the value stored under the id
+ *
+ * @author Eva Moresova
+ * @date 12-05-2021
+ *
+ * @param t pointer to table
+ * @param id key of the entry
+ * @return stored pointer or NULL if the id is not in the table
+ */
+void* id_table_get(IdTable* t, Id id);
+
+/**
+ * @brief removes the entry with the specified id
+ *
+ * @author Eva Moresova
+ * @date 12-05-2021
+ *
+ * @param t pointer to table
+ * @param id key of the entry
+ * @return STATUS OK if the entry was removed, ERROR otherwise
+ */
+STATUS id_table_remove(IdTable* t, Id id);
+
+/**
+ * @brief removes all the entries, the memory of the table is kept
+ *
+ * @author Eva Moresova
+ * @date 12-05-2021
+ *
+ * @param t pointer to table
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS id_table_clear(IdTable* t);
+
+/**
+ * @brief getter for the number of entries
+ *
+ * @author Eva Moresova
+ * @date 12-05-2021
+ *
+ * @param t pointer to table
+ * @return number of entries, -1 in case of error
+ */
+int id_table_get_size(IdTable* t);
+
+#endif
@@ -0,0 +1,156 @@
+/**
+ * @brief It defines the string interning interface
+ *
+ * Every different text is stored once per pool, each game has one for its
+ * world. Interning a text gives a handle, a pointer to the stored copy, so
+ * two handles of the same pool are equal only if their texts are equal and
+ * they can be compared with ==. The handles stay valid until the pool is
+ * cleared or destroyed.
+ *
+ * @file intern.h
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 21-05-2021
+ * @copyright GNU Public License
+ */
+
+#ifndef INTERN_H
+#define INTERN_H
+
+#include "types.h"
+
+#include <stddef.h>
+
+typedef struct _InternPool InternPool;
+
+/**
+ * @brief creates an empty pool of texts
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @return pointer to InternPool or NULL if error
+ */
+InternPool* intern_create();
+
+/**
+ * @brief InternPool destroy, with every text stored in it, and set it to NULL
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param p double pointer to InternPool
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS intern_destroy(InternPool** p);
+
+/**
+ * @brief forgets every text of a pool at once, its handles become invalid
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param p pointer to InternPool
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS intern_clear(InternPool* p);
+
+/**
+ * @brief gives the handle of a text, storing it the first time
+ *
+ * @author Jiri Zak
+ * @date 21-05-2021
+ *
+ * @param p pointer to InternPool
+ * @param s text
+ * @return handle of the text or NULL if error
+ */
+const char* intern_string(InternPool* p, const char* s);
+
+/**
+ * @brief gives the handle of the first len characters of s, which does not
+ * need to end with '\0', so a text can be interned from the middle of a line
+ *
+ * @author Jiri Zak
+ * @date 24-05-2021
+ *
+ * @param p pointer to InternPool
+ * @param s start of the text
+ * @param len number of characters
+ * @return handle of the text or NULL if error
+ */
+const char* intern_string_n(InternPool* p, const char* s, size_t len);
+
+/**
+ * @brief looks for the handle of a text without storing it
+ *
+ * @author Jiri Zak
+ * @date 21-05-2021
+ *
+ * @param p pointer to InternPool
+ * @param s text
+ * @return handle of the text or NULL if it was never interned
+ */
+const char* intern_find(InternPool* p, const char* s);
+
+/**
+ * @brief looks for the handle of the lower case version of a text, the one
+ * given by intern_fold for any text equal to s ignoring case
+ *
+ * @author Jiri Zak
+ * @date 21-05-2021
+ *
+ * @param p pointer to InternPool
+ * @param s text
+ * @return handle of the lower case text or NULL if no text equal to s
+ * ignoring case was interned
+ */
+const char* intern_find_folded(InternPool* p, const char* s);
+
+/**
+ * @brief handle of the lower case version of an interned text, two handles
+ * are equal ignoring case if their folded handles are equal
+ *
+ * @author Jiri Zak
+ * @date 21-05-2021
+ *
+ * @param h handle given by intern_string
+ * @return handle of the lower case text or NULL if h is NULL
+ */
+const char* intern_fold(const char* h);
+
+/**
+ * @brief length of an interned text, without calling strlen
+ *
+ * @author Jiri Zak
+ * @date 21-05-2021
+ *
+ * @param h handle given by intern_string
+ * @return length of the text, 0 if h is NULL
+ */
+size_t intern_length(const char* h);
+
+/**
+ * @brief key of a handle for the id tables, so objects can be indexed by
+ * their interned names
+ *
+ * @author Jiri Zak
+ * @date 23-05-2021
+ *
+ * @param h handle given by intern_string
+ * @return the handle as an Id, NO_ID if h is NULL
+ */
+Id intern_key(const char* h);
+
+/**
+ * @brief number of different texts stored
+ *
+ * @author Jiri Zak
+ * @date 21-05-2021
+ *
+ * @param p pointer to InternPool
+ * @return number of texts, -1 if error
+ */
+int intern_get_count(InternPool* p);
+
+#endif
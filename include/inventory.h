@@ -24,10 +24,11 @@ typedef struct _Inventory Inventory;
  * @author Eva Moresova
  * @date 22-03-2021 
  * 
+ * @param a arena the inventory is taken from, NULL to malloc it
  * @param cap capacity of backpack
  * @return pointer to created inventory or NULL in case of error
  */
-Inventory *inventory_create(int cap);
+Inventory *inventory_create(Arena *a, int cap);
 
 /**
  * @brief destructor for inventory
@@ -109,6 +110,16 @@ int inventory_get_capacity(Inventory *i);
  */
 Id* inventory_get_elements(Inventory *i);
 
+/**
+ * @brief Borrowed view of the ids inside the inventory, nothing is allocated.
+ * The view is valid until the inventory is modified
+ * @author Ivan del Horno
+ * @param i Pointer to the inventory
+ * @param count Returns the number of ids in the view
+ * @return Pointer to the first id or NULL if the inventory is empty or NULL
+ */
+const Id* inventory_view(Inventory *i, int *count);
+
 /**
  * @brief Checks if a given ID is inside the inventory
  * @author Ivan del Horno
@@ -132,4 +143,28 @@ int inventory_print(Inventory *inv, FILE *f);
 
 STATUS inventory_save(FILE*, Inventory*);
 
+/**
+ * @brief tells if ids were added to or deleted from an inventory since it
+ * was last marked clean
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param i pointer to the inventory
+ * @return TRUE if it changed, FALSE otherwise or if error
+ */
+BOOL inventory_get_dirty(Inventory *i);
+
+/**
+ * @brief marks an inventory as changed or as clean
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param i pointer to the inventory
+ * @param dirty FALSE once its contents have been saved
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS inventory_set_dirty(Inventory *i, BOOL dirty);
+
 #endif
\ No newline at end of file
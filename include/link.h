@@ -12,6 +12,9 @@
 #define LINK_H
 
 #include "types.h"
+#include "arena.h"
+#include "dirty_list.h"
+#include "intern.h"
 
 #include <stdio.h>
 
@@ -23,10 +26,11 @@ typedef struct _Link Link;
  * @author Jiri Zak
  * @date 1-03-2021
  * 
- * @param id unique id of the link
+ * @param a arena the link is taken from, NULL to malloc it
+ * @param strings pool its name is interned in
  * @return pointer to Link or NULL if error
  */
-Link* link_create();
+Link* link_create(Arena* a, InternPool* strings);
 
 /**
  * @brief Link id setter
@@ -130,6 +134,19 @@ STATUS link_set_second_space(Link* l, Id id);
  */
 Id link_get_second_space(Link* l);
 
+/**
+ * @brief the space at the other end of the link, the same link is shared
+ * by the two spaces it connects
+ *
+ * @author Jiri Zak
+ * @date 22-05-2021
+ * 
+ * @param l pointer to Link
+ * @param from id of the space the link is used from
+ * @return id of the other space or NO_ID if the link does not touch from
+ */
+Id link_get_destination(Link* l, Id from);
+
 /**
  * @brief Link opened setter 
  *
@@ -153,6 +170,43 @@ STATUS link_set_opened(Link* l, BOOL opened);
  */
 BOOL link_get_opened(Link* l);
 
+/**
+ * @brief Link dirty setter
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ * 
+ * @param l pointer to Link
+ * @param dirty FALSE once its state has been saved
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS link_set_dirty(Link* l, BOOL dirty);
+
+/**
+ * @brief Link dirty getter, TRUE when it was opened or closed since it was
+ * last marked clean
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ * 
+ * @param l pointer to Link
+ * @return TRUE or FALSE if ERROR 
+ */
+BOOL link_get_dirty(Link* l);
+
+/**
+ * @brief Link dirty list setter, the list it is pushed on by its id and
+ * its spaces when it stops being clean
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ * 
+ * @param l pointer to Link
+ * @param changes dirty list, NULL for none
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS link_set_dirty_list(Link* l, DirtyList* changes);
+
 /**
  * @brief Link print
  *
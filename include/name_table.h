@@ -0,0 +1,103 @@
+/**
+ * @brief It defines the name table interface, a hash index from a name to
+ * pointer
+ *
+ * @file name_table.h
+ * @author Eva Moresova
+ * @version 1.0
+ * @date 13-05-2021
+ * @copyright GNU Public License
+ */
+
+#ifndef NAME_TABLE_H
+#define NAME_TABLE_H
+
+#include "types.h"
+
+typedef struct _NameTable NameTable;
+
+/**
+ * @brief creates an empty name table. The names are not copied, they
+ * must stay valid while they are in the table
+ *
+ * @author Eva Moresova
+ * @date 13-05-2021
+ *
+ * @param capacity expected number of entries, the table grows when needed
+ * @param fold_case TRUE if names differing only in case are the same key
+ * @return pointer to created table or NULL in case of error
+ */
+NameTable* name_table_create(int capacity, BOOL fold_case);
+
+/**
+ * @brief destructor for name table, names and values are not freed
+ *
+ * @author Eva Moresova
+ * @date 13-05-2021
+ *
+ * @param t double pointer to table
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS name_table_destroy(NameTable** t);
+
+/**
+ * @brief stores value under the name, an existing entry with the same name
+ * is replaced
+ *
+ * @author Eva Moresova
+ * @date 13-05-2021
+ *
+ * @param t pointer to table
+ * @param name key of the entry
+ * @param value pointer stored for the name
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS name_table_put(NameTable* t, const char* name, void* value);
+
+/**
+ * @brief getter for the value stored under the name
+ *
+ * @author Eva Moresova
+ * @date 13-05-2021
+ *
+ * @param t pointer to table
+ * @param name key of the entry
+ * @return stored pointer or NULL if the name is not in the table
+ */
+void* name_table_get(NameTable* t, const char* name);
+
+/**
+ * @brief removes the entry with the specified name
+ *
+ * @author Eva Moresova
+ * @date 13-05-2021
+ *
+ * @param t pointer to table
+ * @param name key of the entry
+ * @return STATUS OK if the entry was removed, ERROR otherwise
+ */
+STATUS name_table_remove(NameTable* t, const char* name);
+
+/**
+ * @brief removes all the entries, the memory of the table is kept
+ *
+ * @author Eva Moresova
+ * @date 13-05-2021
+ *
+ * @param t pointer to table
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS name_table_clear(NameTable* t);
+
+/**
+ * @brief getter for the number of entries
+ *
+ * @author Eva Moresova
+ * @date 13-05-2021
+ *
+ * @param t pointer to table
+ * @return number of entries, -1 in case of error
+ */
+int name_table_get_size(NameTable* t);
+
+#endif
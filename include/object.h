@@ -12,6 +12,9 @@
 #define OBJECT_H
 
 #include "types.h"
+#include "arena.h"
+#include "dirty_list.h"
+#include "intern.h"
 
 #include <stdio.h>
 
@@ -25,10 +28,12 @@ typedef struct _Obj Object;
  * @author Jiri Zak
  * @date 12-02-2021
  * 
+ * @param a arena the object is taken from, NULL to malloc it
+ * @param strings pool its texts are interned in
  * @param id id of object
  * @return pointer to Obejct
  */
-Object *object_create(Id);
+Object *object_create(Arena *, InternPool *, Id);
 
 /**
  * @brief Object destroy and set it to NULL
@@ -269,6 +274,46 @@ STATUS object_set_turnedOn(Object*, BOOL);
  */
 BOOL object_get_turnedOn(Object* object);
 
+/**
+ * @brief Object dirty setter
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ * 
+ * @param object pointer to Object
+ * @param dirty FALSE once its state has been saved
+ * 
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS object_set_dirty(Object* object, BOOL dirty);
+
+/**
+ * @brief Object dirty getter, TRUE when its location or turnedOn changed
+ * since it was last marked clean
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ * 
+ * @param object pointer to Object
+ * 
+ * @return object dirty otherwise FALSE
+ */
+BOOL object_get_dirty(Object* object);
+
+/**
+ * @brief Object dirty list setter, the list it is pushed on by its id
+ * when it stops being clean
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ * 
+ * @param object pointer to Object
+ * @param changes dirty list, NULL for none
+ * 
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS object_set_dirty_list(Object* object, DirtyList* changes);
+
 STATUS object_save(FILE*, Object*);
 
 #endif
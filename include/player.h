@@ -23,11 +23,12 @@ typedef struct _Player Player;
  * @author Jiri Zak
  * @date 22-03-2021
  * 
+ * @param a arena the player is taken from, NULL to malloc it
  * @param id id of player
  * @param cap capacity of players backpack (inventory)
  * @return pointer to Player
  */
-Player *player_create(Id, int);
+Player *player_create(Arena *, Id, int);
 
 /**
  * @brief Player destroy
@@ -187,4 +188,28 @@ STATUS player_save(FILE*, Player*);
 
 BOOL player_has_object(Player* p, Id object);
 
+/**
+ * @brief Tells if the location or the inventory of the player changed since
+ * it was last marked clean
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ * 
+ * @param p pointer to Player
+ * @return TRUE if it changed, FALSE otherwise or if error
+ */
+BOOL player_get_dirty(Player *p);
+
+/**
+ * @brief Marks the player and its inventory as changed or as clean
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ * 
+ * @param p pointer to Player
+ * @param dirty FALSE once its state has been saved
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS player_set_dirty(Player *p, BOOL dirty);
+
 #endif
\ No newline at end of file
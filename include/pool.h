@@ -0,0 +1,79 @@
+/**
+ * @brief It defines the pool interface, an allocator of fixed size
+ * elements taken from big blocks
+ *
+ * @file pool.h
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 19-05-2021
+ * @copyright GNU Public License
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include "types.h"
+
+#include <stddef.h>
+
+typedef struct _Pool Pool;
+
+/**
+ * @brief Pool create
+ *
+ * @author Jiri Zak
+ * @date 19-05-2021
+ *
+ * @param elem_size size of every element given by the pool
+ * @param block_elems number of elements allocated together in one block
+ * @return pointer to Pool or NULL if error
+ */
+Pool* pool_create(size_t elem_size, int block_elems);
+
+/**
+ * @brief Pool destroy, frees all the blocks at once and sets it to NULL.
+ * Elements still in use become invalid
+ *
+ * @author Jiri Zak
+ * @date 19-05-2021
+ *
+ * @param p double pointer to Pool
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS pool_destroy(Pool** p);
+
+/**
+ * @brief takes an element from the pool, the memory is not initialized
+ *
+ * @author Jiri Zak
+ * @date 19-05-2021
+ *
+ * @param p pointer to Pool
+ * @return pointer to the element or NULL if error
+ */
+void* pool_alloc(Pool* p);
+
+/**
+ * @brief gives an element back to the pool so it can be reused
+ *
+ * @author Jiri Zak
+ * @date 19-05-2021
+ *
+ * @param p pointer to Pool
+ * @param elem element taken from the same pool
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS pool_free(Pool* p, void* elem);
+
+/**
+ * @brief number of elements in use
+ *
+ * @author Jiri Zak
+ * @date 19-05-2021
+ *
+ * @param p pointer to Pool
+ * @return number of elements or -1 if error
+ */
+int pool_get_used(Pool* p);
+
+#endif
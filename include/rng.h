@@ -0,0 +1,93 @@
+/**
+ * @brief It defines the random number generator of a game
+ *
+ * Each game has its own generator, so games do not share hidden state and
+ * a game started with the same seed plays the same. It is xoshiro256**,
+ * seeded through splitmix64, and draws in a range without the bias of
+ * taking the remainder.
+ *
+ * @file rng.h
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#ifndef RNG_H
+#define RNG_H
+
+#include "types.h"
+
+#include <stdint.h>
+
+typedef struct _Rng Rng;
+
+/**
+ * @brief creates a generator
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param seed any number, the same seed gives the same numbers
+ * @return pointer to Rng or NULL if error
+ */
+Rng* rng_create(uint64_t seed);
+
+/**
+ * @brief Rng destroy and set it to NULL
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param r double pointer to Rng
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS rng_destroy(Rng** r);
+
+/**
+ * @brief starts a generator again from a seed
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param r pointer to Rng
+ * @param seed any number
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS rng_seed(Rng* r, uint64_t seed);
+
+/**
+ * @brief seed a generator was last started from
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param r pointer to Rng
+ * @return the seed, 0 if error
+ */
+uint64_t rng_get_seed(Rng* r);
+
+/**
+ * @brief next number of a generator
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param r pointer to Rng
+ * @return 64 random bits, 0 if error
+ */
+uint64_t rng_next(Rng* r);
+
+/**
+ * @brief number in [0, n), every one as likely as the others
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param r pointer to Rng
+ * @param n size of the range
+ * @return the number, 0 if error or n is 0
+ */
+uint32_t rng_bounded(Rng* r, uint32_t n);
+
+#endif
@@ -0,0 +1,156 @@
+/**
+ * @brief It defines the table of random rules of a world
+ *
+ * The rules come from the #r lines of the world: an effect, a weight and,
+ * for a teleport, the space the player is sent to. The rules of a line
+ * with a range of space ids only apply in those spaces, and there they
+ * replace the rules of the whole world: the narrowest range that holds the
+ * player is the one drawn from. Each range is compiled into an alias
+ * table, so a rule is drawn in constant time whatever the number of rules.
+ *
+ * @file rule_table.h
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#ifndef RULE_TABLE_H
+#define RULE_TABLE_H
+
+#include "types.h"
+#include "command.h"
+#include "rng.h"
+
+#include <stdio.h>
+
+typedef struct _RuleTable RuleTable;
+
+/* a rule as defined in the world */
+typedef struct {
+    T_Rules effect;     // NO_RULE for a turn where nothing happens
+    int weight;         // chances against the other rules of its range
+    Id target;          // space of a teleport, NO_ID otherwise
+    Id first;           // first space it applies in, NO_ID for the whole world
+    Id last;            // last space it applies in, NO_ID for the whole world
+} Rule;
+
+/**
+ * @brief creates an empty rule table
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @return pointer to RuleTable or NULL if error
+ */
+RuleTable* rule_table_create();
+
+/**
+ * @brief RuleTable destroy and set it to NULL
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param t double pointer to RuleTable
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS rule_table_destroy(RuleTable** t);
+
+/**
+ * @brief adds a rule. It is not drawn until the table is compiled again
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param t pointer to RuleTable
+ * @param r the rule
+ * @return STATUS ERROR = 0 if the weight is negative, a teleport has no
+ * target or only one end of the range is given, OK = 1
+ */
+STATUS rule_table_add(RuleTable* t, const Rule* r);
+
+/**
+ * @brief adds the rules of a world without #r lines: out of 101 turns,
+ * 5 take, 1 die, 5 drop, 5 light and 5 turn off the light of the space
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param t pointer to RuleTable
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS rule_table_add_default(RuleTable* t);
+
+/**
+ * @brief builds the alias table of every range
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param t pointer to RuleTable
+ * @return STATUS ERROR = 0 if there is no memory, OK = 1
+ */
+STATUS rule_table_compile(RuleTable* t);
+
+/**
+ * @brief draws the rule of a turn
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param t pointer to a compiled RuleTable
+ * @param rng generator it is drawn with
+ * @param location space of the player
+ * @param target set to the target of the rule drawn, can be NULL
+ * @return the effect, NO_RULE if nothing happens or error
+ */
+T_Rules rule_table_sample(RuleTable* t, Rng* rng, Id location, Id* target);
+
+/**
+ * @brief number of rules of a table
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param t pointer to RuleTable
+ * @return rules, -1 if error
+ */
+int rule_table_count(RuleTable* t);
+
+/**
+ * @brief rule of a table, in the order they were added
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param t pointer to RuleTable
+ * @param i position of the rule
+ * @return the rule or NULL if error
+ */
+const Rule* rule_table_get(RuleTable* t, int i);
+
+/**
+ * @brief effect of the name used in the data files
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param name take, die, drop, on, off, toggle, teleport or none, in any case
+ * @param effect set to the effect
+ * @return STATUS ERROR = 0 if there is no such effect, OK = 1
+ */
+STATUS rule_effect_from_name(const char* name, T_Rules* effect);
+
+/**
+ * @brief writes the rules of a table as #r lines
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param fp file
+ * @param t pointer to RuleTable
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS rule_table_save(FILE* fp, RuleTable* t);
+
+#endif
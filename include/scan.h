@@ -0,0 +1,81 @@
+/**
+ * @brief It defines the delimiter scanner used to read the data files
+ *
+ * The scanner finds every '|' and '\n' of a block of text at once, with
+ * SSE2 or AVX2 when the processor has them and byte by byte otherwise.
+ * The loader builds the table of fields of each line from the positions.
+ *
+ * @file scan.h
+ * @author Eva Moresova
+ * @version 1.0
+ * @date 24-05-2021
+ * @copyright GNU Public License
+ */
+
+#ifndef SCAN_H
+#define SCAN_H
+
+#include "types.h"
+
+#include <stddef.h>
+
+/**
+ * @brief instruction sets the scanner can use
+ */
+typedef enum {
+    SCAN_SCALAR,
+    SCAN_SSE2,
+    SCAN_AVX2
+} SCAN_ISA;
+
+/**
+ * @brief positions of every '|' and '\n' in a block, in order
+ *
+ * @author Eva Moresova
+ * @date 24-05-2021
+ *
+ * @param p start of the block, it does not need to end with '\0'
+ * @param len number of bytes of the block, at most UINT_MAX
+ * @param out array where the positions, counted from p, are written
+ * @param max size of out, the scan stops before it gets full
+ * @param scanned set to the number of bytes looked at, len unless out
+ * got full. Can be NULL
+ * @return number of positions written
+ */
+size_t scan_delimiters(const char* p, size_t len, unsigned int* out, size_t max, size_t* scanned);
+
+/**
+ * @brief reads a number like atol does, but from a field that does not end
+ * with '\0'
+ *
+ * @author Eva Moresova
+ * @date 24-05-2021
+ *
+ * @param s start of the field
+ * @param len number of characters of the field
+ * @return the number, 0 if the field does not start with one
+ */
+long scan_long(const char* s, size_t len);
+
+/**
+ * @brief chooses the instruction set, by default the best one the processor has
+ *
+ * @author Eva Moresova
+ * @date 24-05-2021
+ *
+ * @param isa instruction set
+ * @return STATUS ERROR = 0 if the processor does not have it, OK = 1
+ */
+STATUS scan_set_isa(SCAN_ISA isa);
+
+/**
+ * @brief getter for the instruction set in use
+ *
+ * @author Eva Moresova
+ * @date 24-05-2021
+ *
+ * @return the instruction set
+ */
+SCAN_ISA scan_get_isa();
+
+#endif
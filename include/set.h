@@ -12,6 +12,7 @@
 #define SET_H
 
 #include "types.h"
+#include "arena.h"
 
 #include <stdio.h>
 
@@ -34,9 +35,10 @@ int set_get_size(Set* s);
  * @author Eva Moresova
  * @date 01-03-2021 
  * 
+ * @param a arena the set and its arrays are taken from, NULL to malloc them
  * @return pointer to created set or NULL in case of error
  */
-Set* set_create(); 
+Set* set_create(Arena* a); 
 
 /**
  * @brief destructor for set
@@ -110,4 +112,29 @@ int set_print(Set* s, FILE* fp);
  */
 Id* set_get_elements(Set* s);
 
+/**
+ * @brief borrowed view of the elements inside the set, nothing is
+ * allocated. The view is valid until the set is modified
+ *
+ * @author Eva Moresova
+ * @date 16-05-2021 
+ * 
+ * @param s pointer to set
+ * @param count returns the number of elements in the view, 0 in case of error
+ * @return pointer to the first element or NULL if there are none
+ */
+const Id* set_iter(Set* s, int* count);
+
+/**
+ * @brief for testing if element with specified id is in the set
+ *
+ * @author Eva Moresova
+ * @date 01-03-2021 
+ * 
+ * @param s pointer to set
+ * @param id Id of element
+ * @return TRUE if element exists in the set, FALSE otherwise
+ */
+BOOL set_element_exists(Set* s, Id id);
+
 #endif
\ No newline at end of file
@@ -11,6 +11,7 @@
 #ifndef SPACE_H
 #define SPACE_H
 
+#include "dirty_list.h"
 #include "link.h"
 #include "object.h"
 #include "types.h"
@@ -20,13 +21,80 @@ typedef struct _Space Space;
 #define MAX_SPACES 100
 #define FIRST_SPACE 1
 
-Space* space_create(Id id);
+/**
+ * Directions of the exits of a space, used as index of its exits
+ */
+typedef enum
+{
+    NORTH,
+    SOUTH,
+    EAST,
+    WEST,
+    UP,
+    DOWN
+} T_Direction;
+
+#define N_DIRECTIONS 6
+
+Space* space_create(Arena* a, InternPool* strings, Id id);
 STATUS space_destroy(Space** space);
 Id space_get_id(Space* space);
 STATUS space_set_name(Space* space, char* name);
 STATUS space_set_description(Space *space, char *description);
 STATUS space_set_detailed_description(Space *space, char *detailed_description);
 const char* space_get_name(Space* space);
+
+/**
+ * @brief sets the exit of a space in a direction. The link is shared with
+ * the space at the other end and it is not destroyed with the space
+ *
+ * @author Jiri Zak
+ * @date 22-05-2021
+ *
+ * @param space pointer to space
+ * @param dir direction of the exit
+ * @param l pointer to Link
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS space_set_exit(Space* space, T_Direction dir, Link* l);
+
+/**
+ * @brief getter for the exit of a space in a direction
+ *
+ * @author Jiri Zak
+ * @date 22-05-2021
+ *
+ * @param space pointer to space
+ * @param dir direction of the exit
+ * @return pointer to Link or NULL if there is no exit
+ */
+Link* space_get_exit(Space* space, T_Direction dir);
+
+/**
+ * @brief looks for an exit of a space that leads to another space
+ *
+ * @author Jiri Zak
+ * @date 22-05-2021
+ *
+ * @param space pointer to space
+ * @param to id of the space the exit leads to
+ * @return pointer to Link or NULL if there is none
+ */
+Link* space_get_exit_to(Space* space, Id to);
+
+/**
+ * @brief indexes a link by its name, ignoring case, so space_get_link_by_name
+ * finds it without looking at the exits. Exits with a name are indexed when
+ * they are set, a link must be added again if it is named later
+ *
+ * @author Jiri Zak
+ * @date 23-05-2021
+ *
+ * @param space pointer to Space
+ * @param l pointer to Link with a name, the space does not destroy it
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS space_add_link(Space* space, Link* l);
 STATUS space_set_north(Space* space, Link* l);
 Link* space_get_north(Space* space);
 STATUS space_set_south(Space* space, Link* l);
@@ -42,11 +110,49 @@ STATUS space_set_down(Space *space, Link *l);
 Link *space_get_down(Space *space);
 STATUS space_add_object(Space* space, Id id);
 STATUS space_remove_object(Space* space, Id id);
-char* space_get_gdesc(Space* space, int line);
+const char* space_get_gdesc(Space* space, int line);
 Id* space_get_objects(Space* s);
+const Id* space_objects_view(Space* s, int* count);
 int space_objects_count(Space* s);
 STATUS space_set_illumination(Space *space, BOOL illumination);
 BOOL space_get_illumination(Space *space);
+
+/**
+ * @brief tells if the illumination or the objects of a space changed since
+ * it was last marked clean
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param space pointer to space
+ * @return TRUE if it changed, FALSE otherwise or if error
+ */
+BOOL space_get_dirty(Space *space);
+
+/**
+ * @brief marks a space as changed or as clean
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param space pointer to space
+ * @param dirty FALSE once its state has been saved
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS space_set_dirty(Space *space, BOOL dirty);
+
+/**
+ * @brief sets the list a space is pushed on by its id when it stops being
+ * clean. It is not pushed for having been changed before
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param space pointer to space
+ * @param changes dirty list, NULL for none
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS space_set_dirty_list(Space *space, DirtyList *changes);
 STATUS space_print(Space* space);
 const char *space_get_description(Space *space);
 const char *space_get_detailed_description(Space *space);
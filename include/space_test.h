@@ -78,5 +78,17 @@ void test2_space_get_west();
 void test1_space_get_object();
 void test2_space_get_object();
 void test3_space_get_object();
+void test3_space_get_name();
+void test1_space_get_description();
+void test2_space_get_description();
+void test1_space_get_exit();
+void test1_space_get_exit_to();
+void test2_space_get_exit_to();
+void test1_space_add_link();
+void test2_space_add_link();
+void test1_space_get_link_by_name();
+void test1_space_get_dirty();
+void test2_space_get_dirty();
+void test3_space_create();
 
 #endif
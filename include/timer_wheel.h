@@ -0,0 +1,146 @@
+/**
+ * @brief It defines the timers of a game, counted in turns
+ *
+ * A timer calls a function some turns after it is scheduled, once or every
+ * some turns after that. The timers are kept in a hierarchical wheel: four
+ * levels of 64 slots, the first one a slot per turn, each of the others a
+ * slot per 64 slots of the one below. A timer is put in the slot of the
+ * turn it is due in, at the lowest level that reaches that far, and moved
+ * down a level when the level below comes round to it. Scheduling and
+ * cancelling take the same time however many timers there are, and a turn
+ * where no timer is due only looks at one empty slot.
+ *
+ * @file timer_wheel.h
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "types.h"
+
+#include <stdint.h>
+
+/* a timer that was never scheduled, or is not any longer */
+#define NO_TIMER 0
+
+/* the furthest a timer can be scheduled, in turns. Longer delays are cut to it */
+#define TIMER_MAX_DELAY ((1L << 24) - 1)
+
+typedef struct _TimerWheel TimerWheel;
+
+/**
+ * @brief handle of a scheduled timer. A handle is not reused once its timer
+ * has fired or been cancelled
+ */
+typedef uint64_t TimerId;
+
+/**
+ * @brief function a timer calls when it is due
+ *
+ * @param context pointer given when the timer was scheduled
+ * @param target id of what the timer acts on
+ * @param event number given when the timer was scheduled
+ */
+typedef void (*timer_fn)(void* context, Id target, int event);
+
+/**
+ * @brief creates a wheel with no timers, at turn 0
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @return pointer to TimerWheel or NULL if error
+ */
+TimerWheel* timer_wheel_create();
+
+/**
+ * @brief TimerWheel destroy and set it to NULL. The timers left are not called
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param w double pointer to TimerWheel
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS timer_wheel_destroy(TimerWheel** w);
+
+/**
+ * @brief schedules a timer
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param w pointer to TimerWheel
+ * @param delay turns until it is due, at least 1
+ * @param period turns between two calls after the first one, 0 to call it once
+ * @param fn function to call
+ * @param context passed to fn
+ * @param target passed to fn
+ * @param event passed to fn
+ * @return the handle of the timer, NO_TIMER if error
+ */
+TimerId timer_wheel_schedule(TimerWheel* w, long delay, long period, timer_fn fn, void* context, Id target, int event);
+
+/**
+ * @brief cancels a timer, it is not called again
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param w pointer to TimerWheel
+ * @param id handle of the timer
+ * @return STATUS ERROR = 0 if it is not scheduled, OK = 1
+ */
+STATUS timer_wheel_cancel(TimerWheel* w, TimerId id);
+
+/**
+ * @brief tells if a timer is still to be called
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param w pointer to TimerWheel
+ * @param id handle of the timer
+ * @return TRUE if it is scheduled
+ */
+BOOL timer_wheel_pending(TimerWheel* w, TimerId id);
+
+/**
+ * @brief goes on to the next turn and calls the timers due in it. A function
+ * called may schedule and cancel timers
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param w pointer to TimerWheel
+ * @return the number of timers called, -1 if error
+ */
+int timer_wheel_advance(TimerWheel* w);
+
+/**
+ * @brief getter for the turns the wheel has gone through
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param w pointer to TimerWheel
+ * @return the turn, -1 if error
+ */
+long timer_wheel_get_turn(TimerWheel* w);
+
+/**
+ * @brief getter for the number of timers scheduled
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param w pointer to TimerWheel
+ * @return the number, -1 if error
+ */
+int timer_wheel_count(TimerWheel* w);
+
+#endif
@@ -0,0 +1,149 @@
+/**
+ * @brief It defines the vocabulary of the commands
+ *
+ * A vocabulary tells what the words typed mean: the command a verb names
+ * and the direction a word of a move names. A word may mean both, "e" is
+ * exit and east. Words are the same whatever their case. A synonym added
+ * for a word means what that word means, worlds add their own ones.
+ *
+ * Once compiled, the words are in a minimal perfect hash: each word has a
+ * slot of its own, found with two hashes of it, so looking a word up takes
+ * the same time however many words there are.
+ *
+ * @file vocabulary.h
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#ifndef VOCABULARY_H
+#define VOCABULARY_H
+
+#include "types.h"
+
+#include <stdio.h>
+
+/* a word does not have a meaning of that kind */
+#define NO_MEANING -1
+
+/* kinds of meaning of a word */
+typedef enum {
+    WORD_VERB,          // a T_Command
+    WORD_DIRECTION,     // a T_Direction
+    N_WORD_KINDS
+} T_WordKind;
+
+typedef struct _Vocabulary Vocabulary;
+
+/**
+ * @brief creates a vocabulary with no words
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @return pointer to Vocabulary or NULL if error
+ */
+Vocabulary* vocabulary_create();
+
+/**
+ * @brief Vocabulary destroy and set it to NULL
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param v double pointer to Vocabulary
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS vocabulary_destroy(Vocabulary** v);
+
+/**
+ * @brief gives a word a meaning, the one of that kind it had is replaced
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param v pointer to Vocabulary
+ * @param word the word, copied
+ * @param kind kind of the meaning
+ * @param meaning the meaning, at least 0
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS vocabulary_add(Vocabulary* v, const char* word, T_WordKind kind, int meaning);
+
+/**
+ * @brief adds a word that means what another one means. It is saved by
+ * vocabulary_save
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param v pointer to Vocabulary
+ * @param word the new word, copied
+ * @param of a word of the vocabulary
+ * @return STATUS ERROR = 0 if of is not in the vocabulary, OK = 1
+ */
+STATUS vocabulary_add_synonym(Vocabulary* v, const char* word, const char* of);
+
+/**
+ * @brief builds the perfect hash of the words. Words added later are found
+ * too, more slowly, until it is compiled again
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param v pointer to Vocabulary
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS vocabulary_compile(Vocabulary* v);
+
+/**
+ * @brief meaning of a word
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param v pointer to Vocabulary
+ * @param word the word, in any case
+ * @param kind kind of the meaning
+ * @return the meaning, NO_MEANING if the word has none of that kind
+ */
+int vocabulary_find(Vocabulary* v, const char* word, T_WordKind kind);
+
+/**
+ * @brief getter for the number of words
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param v pointer to Vocabulary
+ * @return the number, -1 if error
+ */
+int vocabulary_count(Vocabulary* v);
+
+/**
+ * @brief getter for a synonym and the word it was added for
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param v pointer to Vocabulary
+ * @param i position of the synonym, in the order they were added
+ * @param of set to the word it means the same as
+ * @return the synonym or NULL if there is none there
+ */
+const char* vocabulary_get_synonym(Vocabulary* v, int i, const char** of);
+
+/**
+ * @brief writes the synonyms, one #v: line each
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param fp file
+ * @param v pointer to Vocabulary
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS vocabulary_save(FILE* fp, Vocabulary* v);
+
+#endif
@@ -0,0 +1,254 @@
+/**
+ * @brief It defines the compiled world format (.gwc)
+ *
+ * A world image holds fixed size tables of spaces, links, objects, random
+ * rules and events, the player, the dice and every text once in a string
+ * table. The records point to each other by position and to the texts by
+ * index, never by address, so the file is read in place right after
+ * mapping it. The exits of a space are positions in the link table,
+ * nothing is looked up by id.
+ *
+ * The spaces are also grouped in regions of consecutive spaces, each one
+ * with the objects located in them, and indexed by id. A world can be
+ * streamed from its image: only the region of the player is built when it
+ * is opened, the others when game_get_space or game_get_object first asks
+ * for one of their spaces or objects, and the regions that are as in the
+ * image can be evicted to keep a limit.
+ *
+ * @file world_image.h
+ * @author Jiri Zak
+ * @version 4.0
+ * @date 26-05-2021
+ * @copyright GNU Public License
+ */
+
+#ifndef WORLD_IMAGE_H
+#define WORLD_IMAGE_H
+
+#include "game.h"
+
+#include <stddef.h>
+
+/* a space, link or object of a streamed world as its image has it */
+typedef struct {
+    Id id;
+    Id first;                   // first space of a link, location of an object
+    Id second;                  // second space of a link
+    BOOL on;                    // illuminated space, opened link, turned on object
+    const char* name;           // name of an object, in the image
+    Id exits[N_DIRECTIONS];     // space each exit of a space leads to, NO_ID if it has none
+} StreamRecord;
+
+/**
+ * @brief writes the world of a game as an image
+ *
+ * @author Jiri Zak
+ * @date 25-05-2021
+ *
+ * @param filename name of the file
+ * @param game pointer to game
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS world_image_save(const char* filename, Game* game);
+
+/**
+ * @brief tells an image from a text data file
+ *
+ * @author Jiri Zak
+ * @date 25-05-2021
+ *
+ * @param data start of the file
+ * @param size size of the file
+ * @return TRUE if it starts like an image this version can read
+ */
+BOOL world_image_check(const char* data, size_t size);
+
+/**
+ * @brief adds the world of an image to a game
+ *
+ * @author Jiri Zak
+ * @date 25-05-2021
+ *
+ * @param data start of the image, usually a mapped file, aligned to 8 bytes
+ * @param size size of the image
+ * @param game pointer to game
+ * @return STATUS ERROR = 0 if the image is not valid, OK = 1
+ */
+STATUS world_image_load(const char* data, size_t size, Game* game);
+
+/**
+ * @brief sets the number of spaces of a region of the images written
+ * from now on
+ *
+ * @author Jiri Zak
+ * @date 26-05-2021
+ *
+ * @param n spaces, 64 by default
+ * @return STATUS ERROR = 0 if it is not positive, OK = 1
+ */
+STATUS world_image_set_region_spaces(int n);
+
+/**
+ * @brief streams the world of an image into a game, which keeps the stream
+ * until it is cleared or destroyed. The player, the dice, the objects that
+ * are in no space and the region of the player are built at once
+ *
+ * @author Jiri Zak
+ * @date 26-05-2021
+ *
+ * @param data start of the image, aligned to 8 bytes. It must stay valid
+ * until release is called
+ * @param size size of the image
+ * @param game pointer to game without a stream
+ * @param max_regions regions kept in memory, 0 for no limit. Regions that
+ * were changed are never evicted, so there can be more
+ * @param release called with data and size when the stream is closed, can
+ * be NULL
+ * @return STATUS ERROR = 0 if the image is not valid, then data is not
+ * released, OK = 1
+ */
+STATUS world_stream_open(const char* data, size_t size, Game* game, int max_regions, void (*release)(const char* data, size_t size));
+
+/**
+ * @brief frees a stream and releases its image. The entities it built
+ * belong to the game
+ *
+ * @author Jiri Zak
+ * @date 26-05-2021
+ *
+ * @param ws double pointer to the stream, set to NULL
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS world_stream_close(WorldStream** ws);
+
+/**
+ * @brief space of a streamed world, its region is built if it is not in
+ * memory. Used by game_get_space
+ *
+ * @author Jiri Zak
+ * @date 26-05-2021
+ *
+ * @param ws stream
+ * @param game pointer to game
+ * @param id id of the space
+ * @return the space or NULL if the world has no such space
+ */
+Space* world_stream_get_space(WorldStream* ws, Game* game, Id id);
+
+/**
+ * @brief object of a streamed world, its region is built if it is not in
+ * memory. Used by game_get_object
+ *
+ * @author Jiri Zak
+ * @date 26-05-2021
+ *
+ * @param ws stream
+ * @param game pointer to game
+ * @param id id of the object
+ * @return the object or NULL if the world has no such object
+ */
+Object* world_stream_get_object(WorldStream* ws, Game* game, Id id);
+
+/**
+ * @brief builds every region that is not in memory and stops evicting, to
+ * save the whole world
+ *
+ * @author Jiri Zak
+ * @date 26-05-2021
+ *
+ * @param ws stream
+ * @param game pointer to game
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS world_stream_load_all(WorldStream* ws, Game* game);
+
+/**
+ * @brief numbers of records of the image of a stream
+ * @author Jiri Zak
+ * @date 26-05-2021
+ * @param ws stream
+ * @param n_spaces set to the spaces
+ * @param n_links set to the links
+ * @param n_objects set to the objects
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS world_stream_get_size(WorldStream* ws, int* n_spaces, int* n_links, int* n_objects);
+
+/**
+ * @brief a space as the image has it, nothing is built
+ * @author Jiri Zak
+ * @date 26-05-2021
+ * @param ws stream
+ * @param position position of the space in the image
+ * @param r set to the record
+ * @return STATUS ERROR = 0 if there is no such space, OK = 1
+ */
+STATUS world_stream_get_space_record(WorldStream* ws, int position, StreamRecord* r);
+
+/**
+ * @brief a link as the image has it, nothing is built
+ * @author Jiri Zak
+ * @date 26-05-2021
+ * @param ws stream
+ * @param position position of the link in the image
+ * @param r set to the record
+ * @return STATUS ERROR = 0 if there is no such link, OK = 1
+ */
+STATUS world_stream_get_link_record(WorldStream* ws, int position, StreamRecord* r);
+
+/**
+ * @brief an object as the image has it, nothing is built
+ * @author Jiri Zak
+ * @date 26-05-2021
+ * @param ws stream
+ * @param position position of the object in the image
+ * @param r set to the record
+ * @return STATUS ERROR = 0 if there is no such object, OK = 1
+ */
+STATUS world_stream_get_object_record(WorldStream* ws, int position, StreamRecord* r);
+
+/**
+ * @brief space built from a record of the image, its region is not built
+ * if it is not in memory
+ * @author Jiri Zak
+ * @date 26-05-2021
+ * @param ws stream
+ * @param position position of the space in the image
+ * @return the space or NULL if it is not in memory
+ */
+Space* world_stream_get_space_at(WorldStream* ws, int position);
+
+/**
+ * @brief link built from a record of the image, nothing is built if it is
+ * not in memory
+ * @author Jiri Zak
+ * @date 26-05-2021
+ * @param ws stream
+ * @param position position of the link in the image
+ * @return the link or NULL if it is not in memory
+ */
+Link* world_stream_get_link_at(WorldStream* ws, int position);
+
+/**
+ * @brief object built from a record of the image, its region is not built
+ * if it is not in memory
+ * @author Jiri Zak
+ * @date 26-05-2021
+ * @param ws stream
+ * @param position position of the object in the image
+ * @return the object or NULL if it is not in memory
+ */
+Object* world_stream_get_object_at(WorldStream* ws, int position);
+
+/**
+ * @brief number of regions in memory
+ *
+ * @author Jiri Zak
+ * @date 26-05-2021
+ *
+ * @param ws stream
+ * @return regions, -1 if ws is NULL
+ */
+int world_stream_get_resident(WorldStream* ws);
+
+#endif
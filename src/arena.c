@@ -0,0 +1,188 @@
+/**
+ * @brief It implements the arena interface. Memory is taken from a list of
+ * blocks by moving a pointer forward, rewinding just moves it back
+ *
+ * @file arena.c
+ * @author Eva Moresova
+ * @version 1.0
+ * @date 20-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* every new chunk doubles the size of the previous one up to this size, so
+   a big world is kept in a few chunks */
+#define ARENA_MAX_CHUNK ((size_t)1 << 26)
+
+typedef struct _Chunk {
+    struct _Chunk *next;
+    size_t size;  // bytes of data after the header
+    size_t used;
+} Chunk;
+
+struct _Arena {
+    Chunk *first;
+    Chunk *current;  // chunk allocations are taken from, the later ones are free
+    size_t chunk_size;  // size of the next chunk
+};
+
+/**
+ * @brief rounds size up to a multiple of the alignment of max_align_t
+ *
+ * @param size size in bytes
+ * @return aligned size
+ */
+static size_t arena_align(size_t size);
+
+/**
+ * @brief first byte of data of a chunk
+ *
+ * @param c pointer to Chunk
+ * @return pointer to the data
+ */
+static char *arena_chunk_data(Chunk *c);
+
+static size_t arena_align(size_t size) {
+    size_t a = _Alignof(max_align_t);
+    return (size + a - 1) / a * a;
+}
+
+static char *arena_chunk_data(Chunk *c) {
+    return (char *)c + arena_align(sizeof(Chunk));
+}
+
+Arena *arena_create(size_t chunk_size) {
+    if (chunk_size == 0)
+        return NULL;
+
+    Arena *a = malloc(sizeof(struct _Arena));
+    if (a == NULL)
+        return NULL;
+
+    a->first = NULL;
+    a->current = NULL;
+    a->chunk_size = arena_align(chunk_size);
+    return a;
+}
+
+STATUS arena_destroy(Arena **a) {
+    if (a == NULL || *a == NULL)
+        return ERROR;
+
+    Chunk *c = (*a)->first;
+    while (c != NULL) {
+        Chunk *next = c->next;
+        free(c);
+        c = next;
+    }
+    free(*a);
+    *a = NULL;
+    return OK;
+}
+
+void *arena_alloc(Arena *a, size_t size) {
+    if (a == NULL)
+        return NULL;
+
+    size = arena_align(size > 0 ? size : 1);
+    if (a->current != NULL && a->current->size - a->current->used >= size) {
+        void *p = arena_chunk_data(a->current) + a->current->used;
+        a->current->used += size;
+        return p;
+    }
+
+    /* chunks kept by a rewind are reused when big enough */
+    Chunk *prev = a->current;
+    Chunk *c = (prev != NULL) ? prev->next : a->first;
+    while (c != NULL && c->size < size) {
+        c->used = 0;
+        prev = c;
+        c = c->next;
+    }
+
+    if (c == NULL) {
+        size_t n = (size > a->chunk_size) ? size : a->chunk_size;
+        c = malloc(arena_align(sizeof(Chunk)) + n);
+        if (c == NULL)
+            return NULL;
+        c->size = n;
+        c->next = NULL;
+        if (prev != NULL)
+            prev->next = c;
+        else
+            a->first = c;
+        if (a->chunk_size < ARENA_MAX_CHUNK)
+            a->chunk_size *= 2;
+    }
+
+    c->used = size;
+    a->current = c;
+    return arena_chunk_data(c);
+}
+
+char *arena_strdup(Arena *a, const char *s) {
+    if (s == NULL)
+        return NULL;
+
+    size_t len = strlen(s) + 1;
+    char *copy = arena_alloc(a, len);
+    if (copy != NULL)
+        memcpy(copy, s, len);
+    return copy;
+}
+
+ArenaMark arena_mark(Arena *a) {
+    ArenaMark m = {NULL, 0};
+    if (a != NULL && a->current != NULL) {
+        m.chunk = a->current;
+        m.used = a->current->used;
+    }
+    return m;
+}
+
+STATUS arena_rewind(Arena *a, ArenaMark mark) {
+    if (a == NULL)
+        return ERROR;
+
+    if (mark.chunk == NULL) {
+        a->current = NULL;
+    } else {
+        a->current = mark.chunk;
+        a->current->used = mark.used;
+    }
+    return OK;
+}
+
+STATUS arena_reset(Arena *a) {
+    ArenaMark m = {NULL, 0};
+    return arena_rewind(a, m);
+}
+
+BOOL arena_owns(Arena *a, const void *p) {
+    if (a == NULL || p == NULL)
+        return FALSE;
+
+    for (Chunk *c = a->first; c != NULL; c = c->next) {
+        const char *data = arena_chunk_data(c);
+        if ((const char *)p >= data && (const char *)p < data + c->size)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+size_t arena_get_used(Arena *a) {
+    if (a == NULL)
+        return 0;
+
+    size_t used = 0;
+    for (Chunk *c = a->first; c != NULL; c = c->next) {
+        used += c->used;
+        if (c == a->current)
+            return used;
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+/**
+ * @brief It tests the arena module
+ *
+ * @file arena_test.c
+ * @author Eva Moresova
+ * @version 1.0
+ * @date 20-05-2021
+ * @copyright GNU Public License
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/arena.h"
+#include "../include/test.h"
+#include "../include/types.h"
+
+void test_arena_create() {
+    Arena* a = arena_create(64);
+    PRINT_TEST_RESULT(a != NULL && arena_get_used(a) == 0);
+    arena_destroy(&a);
+}
+
+void test_arena_destroy_null() {
+    Arena* a = NULL;
+    PRINT_TEST_RESULT(arena_destroy(&a) == ERROR);
+}
+
+void test_arena_alloc_distinct() {
+    Arena* a = arena_create(64);
+    int* p[100];
+    for (int i = 0; i < 100; i++) {
+        p[i] = arena_alloc(a, sizeof(int));
+        *p[i] = i;
+    }
+    BOOL ok = TRUE;
+    for (int i = 0; i < 100; i++) {
+        if (*p[i] != i || arena_owns(a, p[i]) == FALSE)
+            ok = FALSE;
+    }
+    PRINT_TEST_RESULT(ok == TRUE);
+    arena_destroy(&a);
+}
+
+void test_arena_alloc_big() {
+    Arena* a = arena_create(64);
+    char* p = arena_alloc(a, 1000);
+    memset(p, 'x', 1000);
+    PRINT_TEST_RESULT(p != NULL && arena_owns(a, p + 999) == TRUE);
+    arena_destroy(&a);
+}
+
+void test_arena_strdup() {
+    Arena* a = arena_create(64);
+    char* s = arena_strdup(a, "Hall");
+    PRINT_TEST_RESULT(s != NULL && strcmp(s, "Hall") == 0);
+    arena_destroy(&a);
+}
+
+void test_arena_reset() {
+    Arena* a = arena_create(64);
+    void* first = arena_alloc(a, 16);
+    for (int i = 0; i < 50; i++)
+        arena_alloc(a, 16);
+    arena_reset(a);
+    PRINT_TEST_RESULT(arena_get_used(a) == 0 && arena_alloc(a, 16) == first);
+    arena_destroy(&a);
+}
+
+void test_arena_rewind() {
+    Arena* a = arena_create(64);
+    arena_alloc(a, 16);
+    ArenaMark m = arena_mark(a);
+    void* after = arena_alloc(a, 16);
+    for (int i = 0; i < 50; i++)
+        arena_alloc(a, 16);
+    arena_rewind(a, m);
+    PRINT_TEST_RESULT(arena_alloc(a, 16) == after);
+    arena_destroy(&a);
+}
+
+void test_arena_owns_other() {
+    Arena* a = arena_create(64);
+    int x = 0;
+    arena_alloc(a, 16);
+    PRINT_TEST_RESULT(arena_owns(a, &x) == FALSE);
+    arena_destroy(&a);
+}
+
+void test_all() {
+    test_arena_create();
+    test_arena_destroy_null();
+    test_arena_alloc_distinct();
+    test_arena_alloc_big();
+    test_arena_strdup();
+    test_arena_reset();
+    test_arena_rewind();
+    test_arena_owns_other();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for ARENA unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("Arena test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_arena_create();
+                break;
+            case 2:
+                test_arena_destroy_null();
+                break;
+            case 3:
+                test_arena_alloc_distinct();
+                break;
+            case 4:
+                test_arena_alloc_big();
+                break;
+            case 5:
+                test_arena_strdup();
+                break;
+            case 6:
+                test_arena_reset();
+                break;
+            case 7:
+                test_arena_rewind();
+                break;
+            case 8:
+                test_arena_owns_other();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
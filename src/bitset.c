@@ -0,0 +1,228 @@
+/**
+ * @brief It implements the bitset interface. The set operations work on
+ * 128 bit blocks with SSE2 when available and on 64 bit words otherwise
+ *
+ * @file bitset.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 17-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/bitset.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define WORD_BITS 64
+/* words are allocated in pairs so the SSE2 loops never need a tail */
+#define WORD_STEP 2
+/* words a bitset may have, doubling the ones it has never overflows */
+#define MAX_WORDS (INT_MAX / 2)
+
+struct _Bitset {
+    uint64_t *words;
+    int n_words;
+};
+
+/**
+ * @brief makes room for at least n_words words, new words are zero
+ *
+ * @param b pointer to Bitset
+ * @param n_words number of words needed
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS bitset_grow(Bitset *b, int n_words);
+
+/**
+ * @brief number of ones in a word
+ *
+ * @param w word
+ * @return number of bits set
+ */
+static int bitset_popcount(uint64_t w);
+
+static STATUS bitset_grow(Bitset *b, int n_words) {
+    if (n_words <= b->n_words)
+        return OK;
+
+    int n = (b->n_words > 0) ? b->n_words : WORD_STEP;
+    while (n < n_words)
+        n *= 2;
+
+    uint64_t *words = realloc(b->words, sizeof(uint64_t) * n);
+    if (words == NULL)
+        return ERROR;
+    memset(words + b->n_words, 0, sizeof(uint64_t) * (n - b->n_words));
+    b->words = words;
+    b->n_words = n;
+    return OK;
+}
+
+static int bitset_popcount(uint64_t w) {
+#ifdef __GNUC__
+    return __builtin_popcountll(w);
+#else
+    w = w - ((w >> 1) & 0x5555555555555555ull);
+    w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+    w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (int)((w * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+Bitset *bitset_create(int n_bits) {
+    Bitset *b = malloc(sizeof(struct _Bitset));
+    if (b == NULL)
+        return NULL;
+
+    b->words = NULL;
+    b->n_words = 0;
+    int n_words = (n_bits + WORD_BITS - 1) / WORD_BITS;
+    if (bitset_grow(b, n_words > 0 ? n_words : 1) == ERROR) {
+        free(b);
+        return NULL;
+    }
+    return b;
+}
+
+STATUS bitset_destroy(Bitset **b) {
+    if (b == NULL || *b == NULL)
+        return ERROR;
+
+    free((*b)->words);
+    free(*b);
+    *b = NULL;
+    return OK;
+}
+
+STATUS bitset_add(Bitset *b, Id id) {
+    if (b == NULL || id < 0 || id / WORD_BITS >= MAX_WORDS)
+        return ERROR;
+
+    long word = id / WORD_BITS;
+    if (bitset_grow(b, (int)word + 1) == ERROR)
+        return ERROR;
+    b->words[word] |= (uint64_t)1 << (id % WORD_BITS);
+    return OK;
+}
+
+STATUS bitset_add_ids(Bitset *b, const Id *ids, int n) {
+    if (b == NULL || (ids == NULL && n > 0))
+        return ERROR;
+
+    for (int i = 0; i < n; i++) {
+        if (bitset_add(b, ids[i]) == ERROR)
+            return ERROR;
+    }
+    return OK;
+}
+
+STATUS bitset_remove(Bitset *b, Id id) {
+    if (b == NULL || id < 0)
+        return ERROR;
+
+    if (id / WORD_BITS < b->n_words)
+        b->words[id / WORD_BITS] &= ~((uint64_t)1 << (id % WORD_BITS));
+    return OK;
+}
+
+BOOL bitset_contains(Bitset *b, Id id) {
+    if (b == NULL || id < 0 || id / WORD_BITS >= b->n_words)
+        return FALSE;
+
+    return (b->words[id / WORD_BITS] >> (id % WORD_BITS)) & 1 ? TRUE : FALSE;
+}
+
+STATUS bitset_clear(Bitset *b) {
+    if (b == NULL)
+        return ERROR;
+
+    memset(b->words, 0, sizeof(uint64_t) * b->n_words);
+    return OK;
+}
+
+STATUS bitset_union(Bitset *dst, Bitset *src) {
+    if (dst == NULL || src == NULL)
+        return ERROR;
+
+    if (bitset_grow(dst, src->n_words) == ERROR)
+        return ERROR;
+
+    int i = 0;
+#ifdef __SSE2__
+    for (; i < src->n_words; i += WORD_STEP) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(dst->words + i));
+        __m128i c = _mm_loadu_si128((const __m128i *)(src->words + i));
+        _mm_storeu_si128((__m128i *)(dst->words + i), _mm_or_si128(a, c));
+    }
+#endif
+    for (; i < src->n_words; i++)
+        dst->words[i] |= src->words[i];
+    return OK;
+}
+
+STATUS bitset_intersection(Bitset *dst, Bitset *src) {
+    if (dst == NULL || src == NULL)
+        return ERROR;
+
+    int n = (dst->n_words < src->n_words) ? dst->n_words : src->n_words;
+    int i = 0;
+#ifdef __SSE2__
+    for (; i < n; i += WORD_STEP) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(dst->words + i));
+        __m128i c = _mm_loadu_si128((const __m128i *)(src->words + i));
+        _mm_storeu_si128((__m128i *)(dst->words + i), _mm_and_si128(a, c));
+    }
+#endif
+    for (; i < n; i++)
+        dst->words[i] &= src->words[i];
+    /* ids beyond the end of src can not be in the intersection */
+    memset(dst->words + n, 0, sizeof(uint64_t) * (dst->n_words - n));
+    return OK;
+}
+
+STATUS bitset_difference(Bitset *dst, Bitset *src) {
+    if (dst == NULL || src == NULL)
+        return ERROR;
+
+    int n = (dst->n_words < src->n_words) ? dst->n_words : src->n_words;
+    int i = 0;
+#ifdef __SSE2__
+    for (; i < n; i += WORD_STEP) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(dst->words + i));
+        __m128i c = _mm_loadu_si128((const __m128i *)(src->words + i));
+        _mm_storeu_si128((__m128i *)(dst->words + i), _mm_andnot_si128(c, a));
+    }
+#endif
+    for (; i < n; i++)
+        dst->words[i] &= ~src->words[i];
+    return OK;
+}
+
+int bitset_count(Bitset *b) {
+    if (b == NULL)
+        return -1;
+
+    int c = 0;
+    for (int i = 0; i < b->n_words; i++)
+        c += bitset_popcount(b->words[i]);
+    return c;
+}
+
+BOOL bitset_intersects(Bitset *a, Bitset *b) {
+    if (a == NULL || b == NULL)
+        return FALSE;
+
+    int n = (a->n_words < b->n_words) ? a->n_words : b->n_words;
+    for (int i = 0; i < n; i++) {
+        if (a->words[i] & b->words[i])
+            return TRUE;
+    }
+    return FALSE;
+}
@@ -0,0 +1,177 @@
+/**
+ * @brief It tests the bitset module
+ *
+ * @file bitset_test.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 17-05-2021
+ * @copyright GNU Public License
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/bitset.h"
+#include "../include/test.h"
+#include "../include/types.h"
+
+void test_bitset_create() {
+    Bitset* b = bitset_create(10);
+    PRINT_TEST_RESULT(b != NULL && bitset_count(b) == 0);
+    bitset_destroy(&b);
+}
+
+void test_bitset_destroy_null() {
+    Bitset* b = NULL;
+    PRINT_TEST_RESULT(bitset_destroy(&b) == ERROR);
+}
+
+void test_bitset_add_contains() {
+    Bitset* b = bitset_create(10);
+    bitset_add(b, 3);
+    bitset_add(b, 500);
+    PRINT_TEST_RESULT(bitset_contains(b, 3) == TRUE && bitset_contains(b, 500) == TRUE && bitset_contains(b, 4) == FALSE);
+    bitset_destroy(&b);
+}
+
+void test_bitset_add_negative() {
+    Bitset* b = bitset_create(10);
+    // Ids with no word in an int are rejected, not truncated
+    PRINT_TEST_RESULT(bitset_add(b, NO_ID) == ERROR && bitset_add(b, 1L << 40) == ERROR && bitset_contains(b, 1L << 40) == FALSE);
+    bitset_destroy(&b);
+}
+
+void test_bitset_remove() {
+    Bitset* b = bitset_create(10);
+    bitset_add(b, 3);
+    bitset_remove(b, 3);
+    PRINT_TEST_RESULT(bitset_contains(b, 3) == FALSE);
+    bitset_destroy(&b);
+}
+
+void test_bitset_union() {
+    Bitset* a = bitset_create(10);
+    Bitset* b = bitset_create(1000);
+    bitset_add(a, 1);
+    bitset_add(b, 1);
+    bitset_add(b, 999);
+    bitset_union(a, b);
+    PRINT_TEST_RESULT(bitset_count(a) == 2 && bitset_contains(a, 999) == TRUE);
+    bitset_destroy(&a);
+    bitset_destroy(&b);
+}
+
+void test_bitset_intersection() {
+    Bitset* a = bitset_create(1000);
+    Bitset* b = bitset_create(10);
+    bitset_add(a, 1);
+    bitset_add(a, 2);
+    bitset_add(a, 999);
+    bitset_add(b, 2);
+    bitset_intersection(a, b);
+    PRINT_TEST_RESULT(bitset_count(a) == 1 && bitset_contains(a, 2) == TRUE);
+    bitset_destroy(&a);
+    bitset_destroy(&b);
+}
+
+void test_bitset_difference() {
+    Bitset* a = bitset_create(200);
+    Bitset* b = bitset_create(200);
+    for (int i = 0; i < 200; i++)
+        bitset_add(a, i);
+    for (int i = 0; i < 200; i += 2)
+        bitset_add(b, i);
+    bitset_difference(a, b);
+    PRINT_TEST_RESULT(bitset_count(a) == 100 && bitset_contains(a, 1) == TRUE && bitset_contains(a, 2) == FALSE);
+    bitset_destroy(&a);
+    bitset_destroy(&b);
+}
+
+void test_bitset_intersects() {
+    Bitset* a = bitset_create(100);
+    Bitset* b = bitset_create(100);
+    bitset_add(a, 70);
+    bitset_add(b, 71);
+    BOOL before = bitset_intersects(a, b);
+    bitset_add(b, 70);
+    PRINT_TEST_RESULT(before == FALSE && bitset_intersects(a, b) == TRUE);
+    bitset_destroy(&a);
+    bitset_destroy(&b);
+}
+
+void test_bitset_clear() {
+    Bitset* b = bitset_create(100);
+    bitset_add(b, 64);
+    bitset_clear(b);
+    PRINT_TEST_RESULT(bitset_count(b) == 0);
+    bitset_destroy(&b);
+}
+
+void test_all() {
+    test_bitset_create();
+    test_bitset_destroy_null();
+    test_bitset_add_contains();
+    test_bitset_add_negative();
+    test_bitset_remove();
+    test_bitset_union();
+    test_bitset_intersection();
+    test_bitset_difference();
+    test_bitset_intersects();
+    test_bitset_clear();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for BITSET unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("Bitset test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_bitset_create();
+                break;
+            case 2:
+                test_bitset_destroy_null();
+                break;
+            case 3:
+                test_bitset_add_contains();
+                break;
+            case 4:
+                test_bitset_add_negative();
+                break;
+            case 5:
+                test_bitset_remove();
+                break;
+            case 6:
+                test_bitset_union();
+                break;
+            case 7:
+                test_bitset_intersection();
+                break;
+            case 8:
+                test_bitset_difference();
+                break;
+            case 9:
+                test_bitset_intersects();
+                break;
+            case 10:
+                test_bitset_clear();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
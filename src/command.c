@@ -9,12 +9,13 @@
  */
 
 #include "../include/command.h"
+#include "../include/space.h"
 
+#include <ctype.h>
 #include <stdio.h>
+#include <string.h>
 #include <strings.h>
 
-#define CMD_LENGHT 30
-
 // array for comapring user input and commands
 char *cmd_to_str[N_CMD][N_CMDT] =
     {{"", "No command"},
@@ -31,20 +32,101 @@ char *cmd_to_str[N_CMD][N_CMDT] =
 	 {"", "Save"},
 	 {"", "Load"}};
 
-T_Command get_user_input() {
-    T_Command cmd = NO_CMD;
-    char input[CMD_LENGHT] = "";
-    int i = UNKNOWN - NO_CMD + 1;
-    if (scanf("%s", input) > 0) {
-        cmd = UNKNOWN;
-        while (cmd == UNKNOWN && i < N_CMD) {
-            if (!strcasecmp(input, cmd_to_str[i][CMDS]) 
-            || !strcasecmp(input, cmd_to_str[i][CMDL])) {
-                cmd = i + NO_CMD;
-            } else {
-                i++;
-            }
+// words of the directions, short and long, in the order of T_Direction
+static const char *direction_to_str[N_DIRECTIONS][N_CMDT] =
+    {{"n", "north"},
+     {"s", "south"},
+     {"e", "east"},
+     {"w", "west"},
+     {"u", "up"},
+     {"d", "down"}};
+
+/* words every game knows, built the first time they are looked up */
+static Vocabulary *known_words = NULL;
+
+STATUS command_add_words(Vocabulary *v) {
+    if (v == NULL)
+        return ERROR;
+
+    for (int i = UNKNOWN - NO_CMD + 1; i < N_CMD; i++) {
+        for (int t = 0; t < N_CMDT; t++) {
+            if (cmd_to_str[i][t][0] != '\0' && vocabulary_add(v, cmd_to_str[i][t], WORD_VERB, i + NO_CMD) == ERROR)
+                return ERROR;
+        }
+    }
+    for (int d = 0; d < N_DIRECTIONS; d++) {
+        for (int t = 0; t < N_CMDT; t++) {
+            if (vocabulary_add(v, direction_to_str[d][t], WORD_DIRECTION, d) == ERROR)
+                return ERROR;
         }
     }
-    return cmd;
+    return OK;
+}
+
+Vocabulary *command_get_vocabulary() {
+    if (known_words == NULL) {
+        known_words = vocabulary_create();
+        if (command_add_words(known_words) == ERROR || vocabulary_compile(known_words) == ERROR)
+            vocabulary_destroy(&known_words);
+    }
+    return known_words;
+}
+
+STATUS command_parse(char *line, Vocabulary *v, ParsedCommand *cmd) {
+    char *word = NULL;
+
+    if (line == NULL || cmd == NULL)
+        return ERROR;
+    if (v == NULL)
+        v = command_get_vocabulary();
+
+    cmd->verb = NO_CMD;
+    cmd->argc = 0;
+    // The words are cut where they are, nothing is copied
+    while (*line != '\0') {
+        while (isspace((unsigned char)*line))
+            line++;
+        if (*line == '\0')
+            break;
+        word = line;
+        while (*line != '\0' && !isspace((unsigned char)*line))
+            line++;
+        if (*line != '\0')
+            *line++ = '\0';
+
+        if (cmd->verb == NO_CMD) {
+            int verb = vocabulary_find(v, word, WORD_VERB);
+            cmd->verb = (verb != NO_MEANING) ? (T_Command)verb : UNKNOWN;
+        }
+        else if (cmd->argc < CMD_MAX_ARGS)
+            cmd->args[cmd->argc++] = word;
+    }
+    return OK;
+}
+
+STATUS command_read(FILE *in, Vocabulary *v, char *line, int size, ParsedCommand *cmd) {
+    if (in == NULL || line == NULL || size < 2 || cmd == NULL)
+        return ERROR;
+
+    // Lines without words are not commands, like the spaces scanf skipped
+    while (fgets(line, size, in) != NULL) {
+        size_t len = strlen(line);
+        if (len > 0 && line[len - 1] != '\n' && !feof(in)) {
+            int c;
+            while ((c = fgetc(in)) != EOF && c != '\n')
+                ;
+        }
+        command_parse(line, v, cmd);
+        if (cmd->verb != NO_CMD)
+            return OK;
+    }
+    cmd->verb = NO_CMD;
+    cmd->argc = 0;
+    return ERROR;
+}
+
+T_Command get_user_input(Vocabulary *v, char *line, ParsedCommand *cmd) {
+    if (command_read(stdin, v, line, CMD_LINE, cmd) == ERROR)
+        return NO_CMD;
+    return cmd->verb;
 }
\ No newline at end of file
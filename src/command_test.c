@@ -0,0 +1,201 @@
+/**
+ * @brief It tests the command interpreter module
+ *
+ * @file command_test.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/command.h"
+#include "../include/space.h"
+#include "../include/test.h"
+#include "../include/types.h"
+
+#define TEST_FILE "/tmp/command_test.txt"
+
+void test_command_parse_verb() {
+    char line[] = "take torch\n";
+    ParsedCommand cmd;
+
+    PRINT_TEST_RESULT(command_parse(line, NULL, &cmd) == OK && cmd.verb == TAKE && cmd.argc == 1 && strcmp(cmd.args[0], "torch") == 0);
+}
+
+void test_command_parse_short() {
+    char line[] = "  M   north";
+    ParsedCommand cmd;
+
+    PRINT_TEST_RESULT(command_parse(line, NULL, &cmd) == OK && cmd.verb == MOVE && cmd.argc == 1 && strcmp(cmd.args[0], "north") == 0);
+}
+
+void test_command_parse_args() {
+    char line[] = "open trapdoor with\tladder\r\n";
+    ParsedCommand cmd;
+
+    command_parse(line, NULL, &cmd);
+    // The words are in the line, not copies of it
+    PRINT_TEST_RESULT(cmd.verb == OPEN && cmd.argc == 3 && cmd.args[0] == line + 5 && strcmp(cmd.args[1], "with") == 0 &&
+                      strcmp(cmd.args[2], "ladder") == 0);
+}
+
+void test_command_parse_unknown() {
+    char line[] = "fly away";
+    ParsedCommand cmd;
+
+    PRINT_TEST_RESULT(command_parse(line, NULL, &cmd) == OK && cmd.verb == UNKNOWN && cmd.argc == 1);
+}
+
+void test_command_parse_empty() {
+    char line[] = " \t\n";
+    ParsedCommand cmd;
+
+    PRINT_TEST_RESULT(command_parse(line, NULL, &cmd) == OK && cmd.verb == NO_CMD && cmd.argc == 0);
+}
+
+void test_command_parse_many() {
+    char line[] = "take a b c d e f";
+    ParsedCommand cmd;
+
+    command_parse(line, NULL, &cmd);
+    PRINT_TEST_RESULT(cmd.argc == CMD_MAX_ARGS && strcmp(cmd.args[CMD_MAX_ARGS - 1], "d") == 0);
+}
+
+void test_command_read() {
+    char line[CMD_LINE];
+    ParsedCommand cmd;
+    FILE* fp = fopen(TEST_FILE, "w");
+    BOOL read = FALSE;
+
+    if (fp != NULL) {
+        fputs("\n   \ndrop key\ne", fp);
+        fclose(fp);
+    }
+    fp = fopen(TEST_FILE, "r");
+    if (fp != NULL) {
+        // Lines without words are skipped, the last one needs no '\n'
+        read = command_read(fp, NULL, line, CMD_LINE, &cmd) == OK && cmd.verb == DROP && strcmp(cmd.args[0], "key") == 0 &&
+               command_read(fp, NULL, line, CMD_LINE, &cmd) == OK && cmd.verb == EXIT &&
+               command_read(fp, NULL, line, CMD_LINE, &cmd) == ERROR && cmd.verb == NO_CMD;
+        fclose(fp);
+    }
+    PRINT_TEST_RESULT(read == TRUE);
+    remove(TEST_FILE);
+}
+
+void test_command_read_long() {
+    char line[8];
+    ParsedCommand cmd;
+    FILE* fp = fopen(TEST_FILE, "w");
+    BOOL read = FALSE;
+
+    if (fp != NULL) {
+        fputs("take torchtorchtorch\nroll\n", fp);
+        fclose(fp);
+    }
+    fp = fopen(TEST_FILE, "r");
+    if (fp != NULL) {
+        // What does not fit is left out, not read as the next command
+        read = command_read(fp, NULL, line, sizeof(line), &cmd) == OK && cmd.verb == TAKE &&
+               command_read(fp, NULL, line, sizeof(line), &cmd) == OK && cmd.verb == ROLL;
+        fclose(fp);
+    }
+    PRINT_TEST_RESULT(read == TRUE);
+    remove(TEST_FILE);
+}
+
+void test_command_parse_vocabulary() {
+    char line[] = "GRAB torch";
+    ParsedCommand cmd;
+    Vocabulary* v = vocabulary_create();
+
+    command_add_words(v);
+    vocabulary_add_synonym(v, "grab", "take");
+    vocabulary_compile(v);
+    // The words every game knows are still there, and do not have the synonym
+    PRINT_TEST_RESULT(command_parse(line, v, &cmd) == OK && cmd.verb == TAKE &&
+                      vocabulary_find(v, "north", WORD_DIRECTION) == NORTH &&
+                      vocabulary_find(command_get_vocabulary(), "grab", WORD_VERB) == NO_MEANING);
+    vocabulary_destroy(&v);
+}
+
+void test_command_null() {
+    char line[] = "take";
+    ParsedCommand cmd;
+
+    PRINT_TEST_RESULT(command_parse(NULL, NULL, &cmd) == ERROR && command_parse(line, NULL, NULL) == ERROR &&
+                      command_read(NULL, NULL, line, 5, &cmd) == ERROR);
+}
+
+void test_all() {
+    test_command_parse_verb();
+    test_command_parse_short();
+    test_command_parse_args();
+    test_command_parse_unknown();
+    test_command_parse_empty();
+    test_command_parse_many();
+    test_command_read();
+    test_command_read_long();
+    test_command_parse_vocabulary();
+    test_command_null();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for COMMAND unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("Command test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_command_parse_verb();
+                break;
+            case 2:
+                test_command_parse_short();
+                break;
+            case 3:
+                test_command_parse_args();
+                break;
+            case 4:
+                test_command_parse_unknown();
+                break;
+            case 5:
+                test_command_parse_empty();
+                break;
+            case 6:
+                test_command_parse_many();
+                break;
+            case 7:
+                test_command_read();
+                break;
+            case 8:
+                test_command_read_long();
+                break;
+            case 9:
+                test_command_parse_vocabulary();
+                break;
+            case 10:
+                test_command_null();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
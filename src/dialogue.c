@@ -162,6 +162,14 @@ char *dialogue_rule_print(T_Rules rule, Game *game)
         return "    What happened with the light?";
         break;
 
+    case TOGGLERULE:
+        return "    What happened with the light?";
+        break;
+
+    case TELEPORTRULE:
+        return "    Where are you?";
+        break;
+
     default:
         return "";
         break;
@@ -14,10 +14,15 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "../include/arena.h"
+
 struct dice {
     int minimum;
     int maximum;
     int last_roll;
+    Rng *rng;      // generator the dice is rolled with
+    BOOL own_rng;  // the generator was created with the dice, and goes with it
+    Arena *arena;  // arena the dice was taken from, NULL if it was malloc'd
 };
 
 BOOL dice_exist(Dice *d) {
@@ -28,17 +33,26 @@ BOOL dice_not_exist(Dice *d) {
     return !dice_exist(d);
 }
 
-Dice *dice_create(int minimum, int maximum) {
+Dice *dice_create(Arena *a, int minimum, int maximum, Rng *r) {
 	if (maximum < minimum) return NULL;
 	
-    Dice *d = malloc(sizeof(struct dice));
-    if (dice_not_exist(d))
+    Rng *own = (r == NULL) ? rng_create((uint64_t)time(NULL)) : NULL;
+    if (r == NULL && own == NULL)
+        return NULL;
+
+    Dice *d = (a != NULL) ? arena_alloc(a, sizeof(struct dice)) : malloc(sizeof(struct dice));
+    if (dice_not_exist(d)) {
+        rng_destroy(&own);
         return NULL;
+    }
+
+    d->arena = a;
 
     d->minimum = minimum;
     d->maximum = maximum;
     d->last_roll = -1;
-    srand(time(NULL));
+    d->rng = (r != NULL) ? r : own;
+    d->own_rng = (r == NULL) ? TRUE : FALSE;
     return d;
 }
 
@@ -47,7 +61,10 @@ STATUS dice_destroy(Dice **d) {
         return ERROR;
     }
 
-    free(*d);
+    if ((*d)->own_rng == TRUE)
+        rng_destroy(&(*d)->rng);
+    if ((*d)->arena == NULL)
+        free(*d);
     *d = NULL;
 
     return OK;
@@ -56,10 +73,22 @@ STATUS dice_destroy(Dice **d) {
 int dice_roll(Dice *d) {
     if (dice_not_exist(d))
         return -1;
-    d->last_roll = (rand() % d->maximum) + d->minimum;
+
+    d->last_roll = d->minimum + (int)rng_bounded(d->rng, (uint32_t)(d->maximum - d->minimum) + 1);
     return d->last_roll;
 }
 
+STATUS dice_set_rng(Dice *d, Rng *r) {
+    if (dice_not_exist(d) || r == NULL)
+        return ERROR;
+
+    if (d->own_rng == TRUE && d->rng != r)
+        rng_destroy(&d->rng);
+    d->rng = r;
+    d->own_rng = FALSE;
+    return OK;
+}
+
 int dice_get_last_roll(Dice *d) {
     return dice_exist(d) ? d->last_roll : -1;
 }
@@ -71,6 +100,14 @@ STATUS dice_set_last_roll(Dice* d, int roll) {
 	return OK;
 }
 
+int dice_get_minimum(Dice *d) {
+    return dice_exist(d) ? d->minimum : -1;
+}
+
+int dice_get_maximum(Dice *d) {
+    return dice_exist(d) ? d->maximum : -1;
+}
+
 void dice_print(Dice *d) {
     if (dice_not_exist(d))
         return;
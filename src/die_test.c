@@ -16,17 +16,18 @@
 #include "../include/types.h"
 
 void test_die_create() {
-    Dice* d = dice_create(1, 6);
+    Dice* d = dice_create(NULL, 1, 6, NULL);
     PRINT_TEST_RESULT(d != NULL);
+    dice_destroy(&d);
 }
 
 void test_die_create_wrong() {
-    Dice* d = dice_create(6, 1);
+    Dice* d = dice_create(NULL, 6, 1, NULL);
     PRINT_TEST_RESULT(d == NULL);
 }
 
 void test_die_destroy_inicialized() {
-    Dice* d = dice_create(1, 6);
+    Dice* d = dice_create(NULL, 1, 6, NULL);
     dice_destroy(&d);
     PRINT_TEST_RESULT(d == NULL);
 }
@@ -38,7 +39,7 @@ void test_die_destroy_null() {
 }
 
 void test_die_roll() {
-    Dice* d = dice_create(1, 6);
+    Dice* d = dice_create(NULL, 1, 6, NULL);
 	int a = dice_roll(d);
     PRINT_TEST_RESULT(1 <= a && 6>= a);
     dice_destroy(&d);
@@ -52,7 +53,7 @@ void test_die_roll_null() {
 }
 
 void test_die_last_roll() {
-    Dice* d = dice_create(3, 42);
+    Dice* d = dice_create(NULL, 3, 42, NULL);
 	int a = dice_roll(d);
 	int b = dice_get_last_roll(d);
     PRINT_TEST_RESULT(a == b);
@@ -60,13 +61,56 @@ void test_die_last_roll() {
 }
 
 void test_die_last_roll_initialized() {
-    Dice* d = dice_create(3, 42);
+    Dice* d = dice_create(NULL, 3, 42, NULL);
 	int a = dice_get_last_roll(d);
     PRINT_TEST_RESULT(a == -1);
     dice_destroy(&d);
 }
 
+void test_die_minimum_maximum() {
+    Dice* d = dice_create(NULL, 3, 42, NULL);
+    PRINT_TEST_RESULT(dice_get_minimum(d) == 3 && dice_get_maximum(d) == 42);
+    dice_destroy(&d);
+}
+
+void test_die_minimum_maximum_null() {
+    PRINT_TEST_RESULT(dice_get_minimum(NULL) == -1 && dice_get_maximum(NULL) == -1);
+}
+
+void test_die_roll_rng() {
+    Rng* ra = rng_create(11);
+    Rng* rb = rng_create(11);
+    Dice* a = dice_create(NULL, 1, 6, ra);
+    Dice* b = dice_create(NULL, 1, 6, NULL);
+    BOOL same = TRUE;
+
+    // b gives up the generator it created for itself
+    dice_set_rng(b, rb);
+    // The same seed rolls the same, every face in the range
+    for (int i = 0; i < 100; i++) {
+        int roll = dice_roll(a);
+        if (roll != dice_roll(b) || roll < 1 || roll > 6)
+            same = FALSE;
+    }
+    PRINT_TEST_RESULT(same == TRUE && dice_set_rng(NULL, ra) == ERROR && dice_set_rng(a, NULL) == ERROR);
+    dice_destroy(&a);
+    dice_destroy(&b);
+    rng_destroy(&ra);
+    rng_destroy(&rb);
+}
+
+void test_die_roll_range() {
+    Dice* d = dice_create(NULL, 3, 5, NULL);
+    BOOL inside = TRUE;
 
+    for (int i = 0; i < 200; i++) {
+        int roll = dice_roll(d);
+        if (roll < 3 || roll > 5)
+            inside = FALSE;
+    }
+    PRINT_TEST_RESULT(inside == TRUE);
+    dice_destroy(&d);
+}
 
 void test_all() {
     test_die_create();
@@ -77,6 +121,10 @@ void test_all() {
 	test_die_roll_null();
 	test_die_last_roll();
 	test_die_last_roll_initialized();
+	test_die_minimum_maximum();
+	test_die_minimum_maximum_null();
+	test_die_roll_rng();
+	test_die_roll_range();
 
     PRINT_PASSED_PERCENTAGE;
 }
@@ -120,6 +168,18 @@ int main(int argc, char **argv) {
 			case 8:
 				test_die_last_roll_initialized();
 				break;
+			case 9:
+				test_die_minimum_maximum();
+				break;
+			case 10:
+				test_die_minimum_maximum_null();
+				break;
+			case 11:
+				test_die_roll_rng();
+				break;
+			case 12:
+				test_die_roll_range();
+				break;
             default:
                 break;
         }
@@ -0,0 +1,129 @@
+/**
+ * @brief It implements the dirty list, a growable array of entries. When it
+ * is full it first drops the repeated entries and only grows if that does
+ * not free half of it, so an entity that is dirtied, evicted and built
+ * again many times while nothing is saved does not make it grow forever
+ *
+ * @file dirty_list.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/dirty_list.h"
+
+#include <stdlib.h>
+
+#define DIRTY_LIST_MIN_CAPACITY 16
+
+struct _DirtyList {
+    DirtyEntry* entries;
+    int n;
+    int capacity;
+};
+
+/** Private functions definitions */
+
+/**
+ * @brief compares entries by kind, id and spaces, for qsort
+ */
+static int dirty_list_compare(const void* a, const void* b);
+
+/**
+ * @brief sorts the entries and leaves each one once
+ *
+ * @param l pointer to list
+ */
+static void dirty_list_unique(DirtyList* l);
+
+/** Private functions implementation */
+
+static int dirty_list_compare(const void* a, const void* b) {
+    const DirtyEntry* x = a;
+    const DirtyEntry* y = b;
+
+    if (x->kind != y->kind)
+        return (x->kind > y->kind) ? 1 : -1;
+    if (x->id != y->id)
+        return (x->id > y->id) ? 1 : -1;
+    if (x->first != y->first)
+        return (x->first > y->first) ? 1 : -1;
+    return (x->second > y->second) - (x->second < y->second);
+}
+
+static void dirty_list_unique(DirtyList* l) {
+    int n = 0;
+
+    qsort(l->entries, l->n, sizeof(DirtyEntry), dirty_list_compare);
+    for (int i = 0; i < l->n; i++) {
+        if (n == 0 || dirty_list_compare(&l->entries[n - 1], &l->entries[i]) != 0)
+            l->entries[n++] = l->entries[i];
+    }
+    l->n = n;
+}
+
+/** Public functions implementation */
+
+DirtyList* dirty_list_create() {
+    DirtyList* l = calloc(1, sizeof(DirtyList));
+
+    if (l == NULL)
+        return NULL;
+    l->entries = malloc(sizeof(DirtyEntry) * DIRTY_LIST_MIN_CAPACITY);
+    if (l->entries == NULL) {
+        free(l);
+        return NULL;
+    }
+    l->capacity = DIRTY_LIST_MIN_CAPACITY;
+    return l;
+}
+
+STATUS dirty_list_destroy(DirtyList** l) {
+    if (l == NULL || *l == NULL)
+        return ERROR;
+
+    free((*l)->entries);
+    free(*l);
+    *l = NULL;
+    return OK;
+}
+
+STATUS dirty_list_push(DirtyList* l, DirtyKind kind, Id id, Id first, Id second) {
+    // A link can have no id, its spaces tell it
+    if (l == NULL)
+        return ERROR;
+
+    if (l->n == l->capacity) {
+        dirty_list_unique(l);
+        if (2 * l->n > l->capacity) {
+            DirtyEntry* grown = realloc(l->entries, sizeof(DirtyEntry) * 2 * l->capacity);
+            if (grown == NULL)
+                return ERROR;
+            l->entries = grown;
+            l->capacity *= 2;
+        }
+    }
+    l->entries[l->n].kind = kind;
+    l->entries[l->n].id = id;
+    l->entries[l->n].first = first;
+    l->entries[l->n].second = second;
+    l->n++;
+    return OK;
+}
+
+const DirtyEntry* dirty_list_view(DirtyList* l, int* n) {
+    if (l == NULL || n == NULL)
+        return NULL;
+
+    *n = l->n;
+    return l->entries;
+}
+
+STATUS dirty_list_clear(DirtyList* l) {
+    if (l == NULL)
+        return ERROR;
+
+    l->n = 0;
+    return OK;
+}
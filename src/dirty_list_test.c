@@ -0,0 +1,158 @@
+/**
+ * @brief It tests the dirty list module
+ *
+ * @file dirty_list_test.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/dirty_list.h"
+#include "../include/test.h"
+#include "../include/types.h"
+
+void test_dirty_list_create() {
+    DirtyList* l = dirty_list_create();
+    int n = -1;
+    PRINT_TEST_RESULT(l != NULL && dirty_list_view(l, &n) != NULL && n == 0);
+    dirty_list_destroy(&l);
+}
+
+void test_dirty_list_destroy_null() {
+    DirtyList* l = NULL;
+    PRINT_TEST_RESULT(dirty_list_destroy(&l) == ERROR && dirty_list_destroy(NULL) == ERROR);
+}
+
+void test_dirty_list_push() {
+    DirtyList* l = dirty_list_create();
+    const DirtyEntry* e = NULL;
+    int n = 0;
+    dirty_list_push(l, DIRTY_SPACE, 11, NO_ID, NO_ID);
+    dirty_list_push(l, DIRTY_LINK, 5, 11, 12);
+    e = dirty_list_view(l, &n);
+    PRINT_TEST_RESULT(n == 2 && e[0].kind == DIRTY_SPACE && e[0].id == 11 && e[1].kind == DIRTY_LINK &&
+                      e[1].first == 11 && e[1].second == 12);
+    dirty_list_destroy(&l);
+}
+
+void test_dirty_list_push_null() {
+    PRINT_TEST_RESULT(dirty_list_push(NULL, DIRTY_OBJECT, 1, NO_ID, NO_ID) == ERROR);
+}
+
+void test_dirty_list_push_link_no_id() {
+    DirtyList* l = dirty_list_create();
+    int n = 0;
+    // A link without an id is told by its spaces
+    PRINT_TEST_RESULT(dirty_list_push(l, DIRTY_LINK, NO_ID, 1, 2) == OK && dirty_list_view(l, &n) != NULL && n == 1);
+    dirty_list_destroy(&l);
+}
+
+void test_dirty_list_grow() {
+    DirtyList* l = dirty_list_create();
+    STATUS status = OK;
+    int n = 0;
+    for (int i = 0; i < 1000 && status == OK; i++)
+        status = dirty_list_push(l, DIRTY_OBJECT, i, NO_ID, NO_ID);
+    dirty_list_view(l, &n);
+    PRINT_TEST_RESULT(status == OK && n == 1000);
+    dirty_list_destroy(&l);
+}
+
+void test_dirty_list_repeated() {
+    DirtyList* l = dirty_list_create();
+    const DirtyEntry* e = NULL;
+    int n = 0;
+    BOOL found = FALSE;
+    // The same few entities over and over, the repeated ones are dropped
+    for (int i = 0; i < 10000; i++)
+        dirty_list_push(l, DIRTY_SPACE, i % 10, NO_ID, NO_ID);
+    dirty_list_push(l, DIRTY_OBJECT, 77, NO_ID, NO_ID);
+    e = dirty_list_view(l, &n);
+    for (int i = 0; i < n; i++)
+        found = (e[i].kind == DIRTY_OBJECT && e[i].id == 77) ? TRUE : found;
+    PRINT_TEST_RESULT(n <= 32 && found == TRUE);
+    dirty_list_destroy(&l);
+}
+
+void test_dirty_list_clear() {
+    DirtyList* l = dirty_list_create();
+    int n = -1;
+    dirty_list_push(l, DIRTY_OBJECT, 3, NO_ID, NO_ID);
+    PRINT_TEST_RESULT(dirty_list_clear(l) == OK && dirty_list_view(l, &n) != NULL && n == 0 &&
+                      dirty_list_clear(NULL) == ERROR);
+    dirty_list_destroy(&l);
+}
+
+void test_dirty_list_view_null() {
+    int n = 0;
+    PRINT_TEST_RESULT(dirty_list_view(NULL, &n) == NULL);
+}
+
+void test_all() {
+    test_dirty_list_create();
+    test_dirty_list_destroy_null();
+    test_dirty_list_push();
+    test_dirty_list_push_null();
+    test_dirty_list_push_link_no_id();
+    test_dirty_list_grow();
+    test_dirty_list_repeated();
+    test_dirty_list_clear();
+    test_dirty_list_view_null();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for DIRTY LIST unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("Dirty list test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_dirty_list_create();
+                break;
+            case 2:
+                test_dirty_list_destroy_null();
+                break;
+            case 3:
+                test_dirty_list_push();
+                break;
+            case 4:
+                test_dirty_list_push_null();
+                break;
+            case 5:
+                test_dirty_list_push_link_no_id();
+                break;
+            case 6:
+                test_dirty_list_grow();
+                break;
+            case 7:
+                test_dirty_list_repeated();
+                break;
+            case 8:
+                test_dirty_list_clear();
+                break;
+            case 9:
+                test_dirty_list_view_null();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
@@ -11,49 +11,80 @@
 
 #include "../include/game.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <time.h>
+
+#include "../include/arena.h"
+#include "../include/dirty_list.h"
+#include "../include/id_table.h"
+#include "../include/intern.h"
+#include "../include/world_image.h"
+#include "../include/game_state.h"
 
 struct _Game
 {
     Player *player;
-    Object *objects[MAX_OBJECTS];
-    Space *spaces[MAX_SPACES + 1];
+    Object **objects; //Growable array of objects, in loading order
+    int n_objects;
+    int objects_capacity;
+    IdTable *object_index; //Slot in objects of each object, indexed by its id
+    IdTable *object_names; //Objects indexed by the interned handle of their name
+    Space **spaces; //Growable array of spaces, in loading order
+    int n_spaces;
+    int spaces_capacity;
+    IdTable *space_index; //Slot in spaces of each space, indexed by its id
+    Link **links; //Growable array of links, each one shared by the two spaces it connects
+    int n_links;
+    int links_capacity;
+    IdTable *link_slots; //Slot in links of each link, indexed by its address, as a link may have no id
+    IdTable *link_index; //Links indexed by their id
+    IdTable *link_names; //Links indexed by the interned handle of their folded name
     T_Command last_cmd;
     T_Command prev_cmd;
     T_Rules last_rule;
+    Id rule_target; //Space the last rule sends the player to, NO_ID if it does not
+    RuleTable *rule_table; //Random rules of the world, NULL until one is added
+    WorldEvent *events; //Growable array of the events of the world
+    TimerId *event_timers; //Timer of each event, NO_TIMER if it is not scheduled
+    int n_events;
+    int events_capacity;
+    TimerWheel *timers; //Timers of the events, NULL until an event is added
+    Vocabulary *vocabulary; //Words of the commands with the synonyms of the world, NULL if it has none
     Dice *dice;
+    Rng *rng; //Generator of the dice and of the random rules
     FILE *log;
     char description[50];
     char *argument; //Argument used after a command
     BOOL rules;
+    Arena *arena; //Memory of the argument and of the world loaded into the game
+    ArenaMark world; //Start of the world in the arena, game_clear rewinds to it
+    InternPool *strings; //Texts of the world, game_clear forgets them
+    BOOL foreign; //Some entity of the world was not taken from the arena
+    WorldStream *stream; //Image the world is built from as it is needed, NULL if it is all in memory
+    GameJournal *journal; //Journal the game is saved to, NULL if there is none
+    StateView *view; //World in order of id for the saved states, NULL until one is saved or loaded
+    DirtyList *changes; //Spaces, links and objects that stopped being clean since the game was last saved
 };
 
-typedef enum
-{
-    NORTH,
-    SOUTH,
-    EAST,
-    WEST,
-    UP,
-    DOWN
-} direction;
+#define GAME_ARENA_CHUNK 65536
 
 #define N_CALLBACK 12
 
 /**
    Define the function type for the callbacks
 */
-typedef STATUS (*callback_fn)(Game *game);
+typedef STATUS (*callback_fn)(Game *game, const ParsedCommand *cmd);
 
 /**
    List of callbacks for each command in the game 
 */
 
-STATUS game_callback_unknown(Game *game);
-STATUS game_callback_exit(Game *game);
+STATUS game_callback_unknown(Game *game, const ParsedCommand *cmd);
+STATUS game_callback_exit(Game *game, const ParsedCommand *cmd);
 
 /**
  * @brief take command, object from space, where player is, is taken. 
@@ -64,7 +95,7 @@ STATUS game_callback_exit(Game *game);
  * 
  * @param game pointer to game
  */
-STATUS game_callback_take(Game *game);
+STATUS game_callback_take(Game *game, const ParsedCommand *cmd);
 
 /**
  * @brief callback for drop command, player's object is dropped.
@@ -76,7 +107,7 @@ STATUS game_callback_take(Game *game);
  * 
  * @param game pointer to game
  */
-STATUS game_callback_drop(Game *game);
+STATUS game_callback_drop(Game *game, const ParsedCommand *cmd);
 
 /**
  * @brief callback for roll command, player is able to move to left if possible.
@@ -86,21 +117,21 @@ STATUS game_callback_drop(Game *game);
  * 
  * @param game pointer to game
  */
-STATUS game_callback_roll(Game *game);
+STATUS game_callback_roll(Game *game, const ParsedCommand *cmd);
 
-STATUS game_callback_move(Game *game);
+STATUS game_callback_move(Game *game, const ParsedCommand *cmd);
 
-STATUS game_callback_inspect(Game *game);
+STATUS game_callback_inspect(Game *game, const ParsedCommand *cmd);
 
-STATUS game_callback_turn_on(Game *game);
+STATUS game_callback_turn_on(Game *game, const ParsedCommand *cmd);
 
-STATUS game_callback_turn_off(Game *game);
+STATUS game_callback_turn_off(Game *game, const ParsedCommand *cmd);
 
-STATUS game_callback_open_link_with_obj(Game *game);
+STATUS game_callback_open_link_with_obj(Game *game, const ParsedCommand *cmd);
 
-STATUS game_callback_save(Game *game);
+STATUS game_callback_save(Game *game, const ParsedCommand *cmd);
 
-STATUS game_callback_load(Game *game);
+STATUS game_callback_load(Game *game, const ParsedCommand *cmd);
 
 static callback_fn game_callback_fn_list[N_CALLBACK] = {
     game_callback_unknown,
@@ -123,9 +154,44 @@ static callback_fn game_callback_fn_list[N_CALLBACK] = {
 /**
  * @brief Selects a random rule and returns it
  * 
+ * @param game pointer to game, whose generator draws it
  * @return T_Rules 
  */
-T_Rules game_random_rule();
+T_Rules game_random_rule(Game *game);
+
+/**
+ * @brief frees the events of the world and their timers
+ *
+ * @param game pointer to game
+ */
+static void game_clear_events(Game *game);
+
+/**
+ * @brief keeps the word a command was used with, cut to the room there is
+ *
+ * @param game pointer to game
+ * @param word the word
+ */
+static void game_set_argument(Game *game, const char *word);
+
+/**
+ * @brief schedules again the events a command starts, the ones that were
+ * scheduled are cancelled
+ *
+ * @param game pointer to game
+ * @param trigger the command
+ * @param target id of what the command acted on
+ */
+static void game_trigger_events(Game *game, T_Command trigger, Id target);
+
+/**
+ * @brief makes an event happen, called by its timer
+ *
+ * @param context pointer to game
+ * @param target id of what the event acts on
+ * @param event position of the event
+ */
+static void game_event_fire(void *context, Id target, int event);
 
 /**
  * @brief player location setter 
@@ -149,12 +215,64 @@ STATUS game_set_player_location(Game *game, Id id);
  * @param direction direction
  * @return id of space or NO_ID
  */
-Id choose_direction(Game *game, direction dir);
+Id choose_direction(Game *game, T_Direction dir);
 
-STATUS game_move(Game *game, direction dir);
+STATUS game_move(Game *game, T_Direction dir);
 
 void game_drop_object(Game *game, Space *space, Object *obj);
 
+/**
+ * @brief marks the game as having to destroy its entities one by one
+ * when the entity was not taken from the arena of the game
+ *
+ * @param game pointer to game
+ * @param entity pointer to the entity added to the game
+ */
+static void game_check_owner(Game *game, const void *entity);
+
+/**
+ * @brief forgets the view of the saved states once a space, link or object
+ * is added or removed. A streamed world is viewed as its image has it, the
+ * regions built and evicted do not change it
+ *
+ * @param game pointer to game
+ */
+static void game_world_changed(Game *game);
+
+/**
+ * @brief destroys the world entities one by one, only needed when some of
+ * them were not taken from the arena
+ *
+ * @param game pointer to game
+ */
+static void game_destroy_entities(Game *game);
+
+/**
+ * @brief frees everything the game holds, but not the game itself
+ *
+ * @param game pointer to game, its members set by game_create
+ */
+static void game_free(Game *game);
+
+/**
+ * @brief slot an entity was stored at in its array
+ *
+ * @param index table of slots
+ * @param key key of the entity in the table
+ * @return the slot, -1 if it is not in the table
+ */
+static int game_slot_get(IdTable *index, Id key);
+
+/**
+ * @brief stores the slot of an entity in its array
+ *
+ * @param index table of slots
+ * @param key key of the entity in the table
+ * @param slot position of the entity in its array
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS game_slot_put(IdTable *index, Id key, int slot);
+
 /**
    Game interface implementation
 */
@@ -169,24 +287,70 @@ Game *game_init()
 
 STATUS game_create(Game *game)
 {
-    for (int i = 0; i < MAX_SPACES; i++)
-    {
-        game->spaces[i] = NULL;
-    }
-    for (int i = 0; i < MAX_OBJECTS; i++)
-    {
-        game->objects[i] = NULL;
-    }
+    // Every member is set before anything is allocated, so a failure frees what there is
+    game->spaces = NULL;
+    game->n_spaces = 0;
+    game->spaces_capacity = 0;
+    game->objects = NULL;
+    game->n_objects = 0;
+    game->objects_capacity = 0;
+    game->links = NULL;
+    game->n_links = 0;
+    game->links_capacity = 0;
+    game->space_index = NULL;
+    game->object_index = NULL;
+    game->object_names = NULL;
+    game->link_slots = NULL;
+    game->link_index = NULL;
+    game->link_names = NULL;
+    game->dice = NULL;
+    game->rng = NULL;
+    game->arena = NULL;
+    game->strings = NULL;
     game->log = NULL;
+    game->stream = NULL;
+    game->journal = NULL;
+    game->view = NULL;
+    game->changes = NULL;
     game->last_cmd = NO_CMD;
     game->prev_cmd = NO_CMD;
     game->last_rule = NO_RULE;
-    game->dice = dice_create(1, 6);
-    game->argument = (char *)malloc(sizeof(char) * 21);
-    if (game->argument == NULL)
-        return ERROR;
+    game->rule_target = NO_ID;
+    game->rule_table = NULL;
+    game->events = NULL;
+    game->event_timers = NULL;
+    game->n_events = 0;
+    game->events_capacity = 0;
+    game->timers = NULL;
+    game->vocabulary = NULL;
+    game->player = NULL;
+    game->foreign = FALSE;
     memset(game->description, '\0', 50);
 
+    game->space_index = id_table_create(NULL, MAX_SPACES);
+    game->object_index = id_table_create(NULL, MAX_OBJECTS);
+    game->object_names = id_table_create(NULL, MAX_OBJECTS);
+    game->link_slots = id_table_create(NULL, MAX_SPACES);
+    game->link_index = id_table_create(NULL, MAX_SPACES);
+    game->link_names = id_table_create(NULL, MAX_SPACES);
+    game->arena = arena_create(GAME_ARENA_CHUNK);
+    game->strings = intern_create();
+    game->changes = dirty_list_create();
+    // Seeded from the clock until game_get_rng is seeded again
+    game->rng = rng_create((uint64_t)time(NULL));
+    game->argument = (char *)arena_alloc(game->arena, sizeof(char) * 21);
+    if (game_reserve(game, MAX_SPACES, MAX_OBJECTS) == ERROR || game->space_index == NULL || game->object_index == NULL ||
+        game->object_names == NULL || game->link_slots == NULL || game->link_index == NULL ||
+        game->link_names == NULL || game->rng == NULL || game->argument == NULL ||
+        game->strings == NULL || game->changes == NULL)
+    {
+        game_free(game);
+        return ERROR;
+    }
+    game->world = arena_mark(game->arena);
+
+    game->dice = dice_create(game->arena, 1, 6, game->rng);
+
     return OK;
 }
 
@@ -201,24 +365,81 @@ STATUS game_create_from_file(Game *game, char *filename)
     return OK;
 }
 
-STATUS game_destroy(Game *game)
+static void game_check_owner(Game *game, const void *entity)
+{
+    if (!arena_owns(game->arena, entity))
+        game->foreign = TRUE;
+}
+
+static void game_world_changed(Game *game)
+{
+    if (game->stream == NULL && game->view != NULL)
+        game_state_view_destroy(&game->view);
+}
+
+static void game_destroy_entities(Game *game)
 {
-    for (int i = 0; (i < MAX_SPACES) && (game->spaces[i] != NULL); i++)
+    player_destroy(&game->player);
+    for (int i = 0; i < game->n_spaces; i++)
     {
         space_destroy(game->spaces + i);
     }
-
-    for (int i = 0; i < MAX_OBJECTS && game->objects[i] != NULL; i++)
+    for (int i = 0; i < game->n_objects; i++)
+    {
+        object_destroy(game->objects + i);
+    }
+    for (int i = 0; i < game->n_links; i++)
     {
-        object_destroy(&game->objects[i]);
+        link_destroy(game->links + i);
     }
-    player_destroy(&game->player);
     dice_destroy(&game->dice);
+}
+
+static int game_slot_get(IdTable *index, Id key)
+{
+    // Slots are kept one up, so that slot 0 is not a NULL value
+    return (int)(intptr_t)id_table_get(index, key) - 1;
+}
+
+static STATUS game_slot_put(IdTable *index, Id key, int slot)
+{
+    return id_table_put(index, key, (void *)(intptr_t)(slot + 1));
+}
+
+static void game_free(Game *game)
+{
+    // The journal is closed before the world it saves
+    game_state_journal_close(&game->journal);
+    game_state_view_destroy(&game->view);
+    world_stream_close(&game->stream);
+    // Entities taken from the arena are freed with it
+    if (game->foreign)
+        game_destroy_entities(game);
+    free(game->spaces);
+    free(game->objects);
+    free(game->links);
+    id_table_destroy(&game->space_index);
+    id_table_destroy(&game->object_index);
+    id_table_destroy(&game->object_names);
+    id_table_destroy(&game->link_slots);
+    id_table_destroy(&game->link_index);
+    id_table_destroy(&game->link_names);
 
     if (game_logfile_exist(game))
         fclose(game->log);
 
-    free(game->argument);
+    rng_destroy(&game->rng);
+    rule_table_destroy(&game->rule_table);
+    game_clear_events(game);
+    vocabulary_destroy(&game->vocabulary);
+    arena_destroy(&game->arena);
+    intern_destroy(&game->strings);
+    dirty_list_destroy(&game->changes);
+}
+
+STATUS game_destroy(Game *game)
+{
+    game_free(game);
     free(game);
 
     return OK;
@@ -226,18 +447,30 @@ STATUS game_destroy(Game *game)
 
 STATUS game_clear(Game *game)
 {
-    player_destroy(&game->player);
-    for (int i = 0; (i < MAX_SPACES) && (game->spaces[i] != NULL); i++)
-    {
-        space_destroy(game->spaces + i);
-        game->spaces[i] = NULL;
-    }
-    for (int i = 0; (i < MAX_OBJECTS) && (game->objects[i] != NULL); i++)
-    {
-        object_destroy(game->objects + i);
-        game->objects[i] = NULL;
-    }
-    dice_destroy(&game->dice);
+    game_state_journal_close(&game->journal);
+    // The rules, the events and the synonyms belong to the world
+    rule_table_destroy(&game->rule_table);
+    game_clear_events(game);
+    vocabulary_destroy(&game->vocabulary);
+    game_state_view_destroy(&game->view);
+    world_stream_close(&game->stream);
+    if (game->foreign)
+        game_destroy_entities(game);
+    game->player = NULL;
+    game->dice = NULL;
+    game->n_spaces = 0;
+    game->n_objects = 0;
+    game->n_links = 0;
+    id_table_clear(game->space_index);
+    id_table_clear(game->object_index);
+    id_table_clear(game->object_names);
+    id_table_clear(game->link_slots);
+    id_table_clear(game->link_index);
+    id_table_clear(game->link_names);
+    arena_rewind(game->arena, game->world);
+    intern_clear(game->strings);
+    dirty_list_clear(game->changes);
+    game->foreign = FALSE;
     game->description[0] = '\0';
 
     if (game_logfile_exist(game))
@@ -250,47 +483,75 @@ STATUS game_clear(Game *game)
 
 Space *game_get_space(Game *game, Id id)
 {
-    if (id == NO_ID)
+    if (game == NULL || id == NO_ID)
     {
         return NULL;
     }
 
-    for (int i = 0; i < MAX_SPACES && game->spaces[i] != NULL; i++)
+    int slot = game_slot_get(game->space_index, id);
+    Space *space = (slot >= 0) ? game->spaces[slot] : NULL;
+    // A streamed world builds the region of the space the first time it is needed
+    if (space == NULL && game->stream != NULL)
     {
-        if (id == space_get_id(game->spaces[i]))
-        {
-            return game->spaces[i];
-        }
+        space = world_stream_get_space(game->stream, game, id);
     }
-
-    return NULL;
+    return space;
 }
 
 Object *game_get_object(Game *game, Id id)
 {
-    if (id == NO_ID)
+    if (game == NULL || id == NO_ID)
     {
         return NULL;
     }
 
-    for (int i = 0; i < MAX_OBJECTS && game->objects[i] != NULL; i++)
+    int slot = game_slot_get(game->object_index, id);
+    Object *obj = (slot >= 0) ? game->objects[slot] : NULL;
+    if (obj == NULL && game->stream != NULL)
     {
-        if (id == object_get_id(game->objects[i]))
-        {
-            return game->objects[i];
-        }
+        obj = world_stream_get_object(game->stream, game, id);
     }
-    return NULL;
+    return obj;
 }
 
 Object *game_get_object_at_position(Game *game, int id)
 {
-    if (game == NULL || id < 0 || id >= MAX_OBJECTS)
+    if (game == NULL || id < 0 || id >= game->n_objects)
         return NULL;
 
     return game->objects[id];
 }
 
+Space *game_get_space_at_position(Game *game, int position)
+{
+    if (game == NULL || position < 0 || position >= game->n_spaces)
+        return NULL;
+
+    return game->spaces[position];
+}
+
+int game_get_number_space(Game *game)
+{
+    if (game == NULL)
+        return -1;
+    return game->n_spaces;
+}
+
+Link *game_get_link_at_position(Game *game, int position)
+{
+    if (game == NULL || position < 0 || position >= game->n_links)
+        return NULL;
+
+    return game->links[position];
+}
+
+int game_get_number_link(Game *game)
+{
+    if (game == NULL)
+        return -1;
+    return game->n_links;
+}
+
 Player *game_get_player(Game *game)
 {
     return game != NULL ? game->player : NULL;
@@ -301,21 +562,20 @@ Dice *game_get_dice(Game *game)
     return game != NULL ? game->dice : NULL;
 }
 
-Object *game_get_object_by_name(Game *game, char *name)
+Object *game_get_object_by_name(Game *game, const char *name)
 {
-    if (name == NULL)
+    if (game == NULL || name == NULL)
     {
         return NULL;
     }
 
-    for (int i = 0; i < MAX_OBJECTS && game->objects[i] != NULL; i++)
+    // A name that was never interned can not be the name of an object
+    const char *h = intern_find(game->strings, name);
+    if (h == NULL)
     {
-        if (strcmp(name, object_get_name(game->objects[i])) == 0)
-        {
-            return game->objects[i];
-        }
+        return NULL;
     }
-    return NULL;
+    return (Object *)id_table_get(game->object_names, intern_key(h));
 }
 
 STATUS game_set_player_location(Game *game, Id s)
@@ -329,46 +589,19 @@ Link *game_get_link_by_name(Game *game, const char *name)
         return NULL;
 	}
 
-	Space* s = game_get_space(game, game_get_player_location(game));
-    
-	Link *east = space_get_east(s);
-	if (east != NULL)
-	{
-		if (strcasecmp(link_get_name(east), name) == 0)
-			return east;
-	}
-	Link *west = space_get_west(s);
-	if (west != NULL)
-	{
-		if (strcasecmp(link_get_name(west), name) == 0)
-			return west;
-	}
-	Link *north = space_get_north(s);
-	if (north != NULL)
-	{
-		if (strcasecmp(link_get_name(north), name) == 0)
-			return north;
-	}
-	Link *south = space_get_south(s);
-	if (south != NULL)
-	{
-		if (strcasecmp(link_get_name(south), name) == 0)
-			return south;
-	}
-	Link *up = space_get_up(s);
-	if (up != NULL)
-	{
-		if (strcasecmp(link_get_name(up), name) == 0)
-			return up;
-	}
-	Link *down = space_get_down(s);
-	if (down != NULL)
-	{
-		if (strcasecmp(link_get_name(down), name) == 0)
-			return down;
-	}
-    
-    return NULL;
+    Id location = game_get_player_location(game);
+    const char *folded = intern_find_folded(game->strings, name);
+    if (folded == NULL) {
+        return NULL;
+    }
+
+    // Most names are used by one link, the space is asked only when the
+    // first one with the name is somewhere else
+    Link *link = (Link *)id_table_get(game->link_names, intern_key(folded));
+    if (link != NULL && link_get_destination(link, location) != NO_ID) {
+        return link;
+    }
+	return space_get_link_by_name(game_get_space(game, location), (char *)name);
 }
 
 void game_drop_object(Game *game, Space *space, Object *obj)
@@ -390,11 +623,17 @@ Id game_get_player_location(Game *game)
     return player_get_location(game->player);
 }
 
-STATUS game_update(Game *game, T_Command cmd)
+STATUS game_update(Game *game, const ParsedCommand *cmd)
 {
-    game->last_cmd = cmd;
-    game->last_rule = game_random_rule();
-    return (*game_callback_fn_list[cmd])(game);
+    if (game == NULL)
+        return ERROR;
+
+    game->last_cmd = (cmd != NULL) ? cmd->verb : NO_CMD;
+    game->last_rule = game_random_rule(game);
+    // No command has no callback, there was nothing to read
+    if (game->last_cmd < UNKNOWN || game->last_cmd >= N_CALLBACK)
+        return ERROR;
+    return (*game_callback_fn_list[game->last_cmd])(game, cmd);
 }
 
 T_Rules game_get_last_rule(Game *game)
@@ -402,33 +641,229 @@ T_Rules game_get_last_rule(Game *game)
     return game->last_rule;
 }
 
-T_Rules game_random_rule()
+T_Rules game_random_rule(Game *game)
 {
-    Dice *dice = NULL;
-    int num;
+    // Constant time, whatever the number of rules of the world
+    return rule_table_sample(game->rule_table, game->rng, player_get_location(game->player), &game->rule_target);
+}
 
-    // Create a dice to select the random command
-    dice = dice_create(0, 100);
-    if (!dice)
-        return NO_RULE;
+/* names of the effects and triggers of the events in the data files */
+static const char *event_names[] = {"off", "on", "close", "open", "toggle"};
+static const char *trigger_names[] = {"start", "turnon", "turnoff", "open"};
+static const T_Command triggers[] = {NO_CMD, TURNON, TURNOFF, OPEN};
 
-    num = dice_roll(dice);
-    dice_destroy(&dice);
+static void game_clear_events(Game *game)
+{
+    timer_wheel_destroy(&game->timers);
+    free(game->events);
+    free(game->event_timers);
+    game->events = NULL;
+    game->event_timers = NULL;
+    game->n_events = 0;
+    game->events_capacity = 0;
+}
 
-    if (num >= 0 && num < 5)
-        return TAKERULE;
-    else if (num == 5)
-        return DIERULE;
-    else if (num > 5 && num <= 10)
-        return DROPRULE;
-    else if (num > 20 && num <= 25)
-        return ONRULE;
-    else if (num > 25 && num <= 30)
-        return OFFRULE;
-    else
-        return NO_RULE;
+STATUS game_add_event(Game *game, const WorldEvent *event)
+{
+    BOOL known = FALSE;
+
+    if (game == NULL || event == NULL || event->effect < EVENT_OFF || event->effect > EVENT_TOGGLE)
+        return ERROR;
+    if (event->target == NO_ID || event->delay < 0 || event->period < 0)
+        return ERROR;
+    for (size_t i = 0; i < sizeof(triggers) / sizeof(triggers[0]); i++)
+    {
+        if (event->trigger == triggers[i])
+            known = TRUE;
+    }
+    if (known == FALSE)
+        return ERROR;
+    if (game->timers == NULL && (game->timers = timer_wheel_create()) == NULL)
+        return ERROR;
+
+    if (game->n_events == game->events_capacity)
+    {
+        int capacity = (game->events_capacity > 0) ? 2 * game->events_capacity : 8;
+        WorldEvent *events = realloc(game->events, sizeof(WorldEvent) * capacity);
+        if (events == NULL)
+            return ERROR;
+        game->events = events;
+        TimerId *event_timers = realloc(game->event_timers, sizeof(TimerId) * capacity);
+        if (event_timers == NULL)
+            return ERROR;
+        game->event_timers = event_timers;
+        game->events_capacity = capacity;
+    }
+    game->events[game->n_events] = *event;
+    game->event_timers[game->n_events] = NO_TIMER;
+    game->n_events++;
+    return OK;
+}
+
+STATUS game_start_events(Game *game)
+{
+    if (game == NULL)
+        return ERROR;
+
+    game_trigger_events(game, NO_CMD, NO_ID);
+    return OK;
+}
+
+static void game_trigger_events(Game *game, T_Command trigger, Id target)
+{
+    // Only the commands that can start an event look through them
+    for (int i = 0; i < game->n_events; i++)
+    {
+        WorldEvent *e = &game->events[i];
+        if (e->trigger != trigger || (trigger != NO_CMD && e->target != target))
+            continue;
+        timer_wheel_cancel(game->timers, game->event_timers[i]);
+        game->event_timers[i] = timer_wheel_schedule(game->timers, e->delay, e->period, game_event_fire, game, e->target, i);
+    }
+}
+
+static void game_event_fire(void *context, Id target, int event)
+{
+    Game *game = context;
+
+    switch (game->events[event].effect)
+    {
+    case EVENT_OFF:
+    case EVENT_ON:
+        object_set_turnedOn(game_get_object(game, target), game->events[event].effect == EVENT_ON);
+        break;
+
+    case EVENT_CLOSE:
+    case EVENT_OPEN:
+        link_set_opened(id_table_get(game->link_index, target), game->events[event].effect == EVENT_OPEN);
+        break;
+
+    case EVENT_TOGGLE:
+    {
+        Space *space = game_get_space(game, target);
+        if (space != NULL)
+            space_set_illumination(space, !space_get_illumination(space));
+        break;
+    }
+
+    default:
+        break;
+    }
+    if (game->events[event].period == 0)
+        game->event_timers[event] = NO_TIMER;
+}
+
+int game_tick(Game *game)
+{
+    if (game == NULL)
+        return -1;
 
-    return NO_RULE;
+    // A world without events has no timers to go through
+    return (game->timers != NULL) ? timer_wheel_advance(game->timers) : 0;
+}
+
+TimerWheel *game_get_timers(Game *game)
+{
+    return (game != NULL) ? game->timers : NULL;
+}
+
+int game_get_number_event(Game *game)
+{
+    return (game != NULL) ? game->n_events : -1;
+}
+
+const WorldEvent *game_get_event_at_position(Game *game, int position)
+{
+    if (game == NULL || position < 0 || position >= game->n_events)
+        return NULL;
+    return &game->events[position];
+}
+
+STATUS game_event_from_names(const char *effect, const char *trigger, WorldEvent *event)
+{
+    int e = -1, t = (trigger == NULL) ? 0 : -1;
+
+    if (effect == NULL || event == NULL)
+        return ERROR;
+    for (int i = 0; i < (int)(sizeof(event_names) / sizeof(event_names[0])); i++)
+    {
+        if (strcasecmp(effect, event_names[i]) == 0)
+            e = i;
+    }
+    for (int i = 0; trigger != NULL && i < (int)(sizeof(trigger_names) / sizeof(trigger_names[0])); i++)
+    {
+        if (strcasecmp(trigger, trigger_names[i]) == 0)
+            t = i;
+    }
+    if (e < 0 || t < 0)
+        return ERROR;
+
+    event->effect = (T_Event)e;
+    event->trigger = triggers[t];
+    return OK;
+}
+
+Id game_get_last_rule_target(Game *game)
+{
+    return game != NULL ? game->rule_target : NO_ID;
+}
+
+STATUS game_add_rule(Game *game, const Rule *rule)
+{
+    if (game == NULL)
+        return ERROR;
+    if (game->rule_table == NULL && (game->rule_table = rule_table_create()) == NULL)
+        return ERROR;
+
+    return rule_table_add(game->rule_table, rule);
+}
+
+STATUS game_compile_rules(Game *game)
+{
+    if (game == NULL)
+        return ERROR;
+    if (game->rule_table == NULL)
+    {
+        if ((game->rule_table = rule_table_create()) == NULL || rule_table_add_default(game->rule_table) == ERROR)
+            return ERROR;
+    }
+
+    return rule_table_compile(game->rule_table);
+}
+
+RuleTable *game_get_rule_table(Game *game)
+{
+    return game != NULL ? game->rule_table : NULL;
+}
+
+STATUS game_add_synonym(Game *game, const char *word, const char *of)
+{
+    if (game == NULL)
+        return ERROR;
+    if (game->vocabulary == NULL)
+    {
+        if ((game->vocabulary = vocabulary_create()) == NULL || command_add_words(game->vocabulary) == ERROR)
+        {
+            vocabulary_destroy(&game->vocabulary);
+            return ERROR;
+        }
+    }
+
+    return vocabulary_add_synonym(game->vocabulary, word, of);
+}
+
+STATUS game_compile_vocabulary(Game *game)
+{
+    if (game == NULL)
+        return ERROR;
+
+    // Without synonyms the words are the ones every game knows, compiled once
+    return (game->vocabulary != NULL) ? vocabulary_compile(game->vocabulary) : OK;
+}
+
+Vocabulary *game_get_vocabulary(Game *game)
+{
+    return (game != NULL && game->vocabulary != NULL) ? game->vocabulary : command_get_vocabulary();
 }
 
 T_Command game_get_last_command(Game *game)
@@ -450,44 +885,283 @@ STATUS game_set_prev_command(Game *game, T_Command cmd)
     return OK;
 }
 
-STATUS game_add_space(Game *game, Space *space)
+STATUS game_reserve(Game *game, int n_spaces, int n_objects)
 {
-    int i = 0;
+    if (game == NULL || n_spaces < 0 || n_objects < 0)
+        return ERROR;
+
+    if (n_spaces > game->spaces_capacity)
+    {
+        Space **spaces = (Space **)realloc(game->spaces, sizeof(Space *) * n_spaces);
+        if (spaces == NULL)
+            return ERROR;
+        game->spaces = spaces;
+        game->spaces_capacity = n_spaces;
+    }
 
-    if (space == NULL)
+    if (n_objects > game->objects_capacity)
+    {
+        Object **objects = (Object **)realloc(game->objects, sizeof(Object *) * n_objects);
+        if (objects == NULL)
+            return ERROR;
+        game->objects = objects;
+        game->objects_capacity = n_objects;
+    }
+
+    return OK;
+}
+
+Arena *game_get_arena(Game *game)
+{
+    return game != NULL ? game->arena : NULL;
+}
+
+InternPool *game_get_strings(Game *game)
+{
+    return game != NULL ? game->strings : NULL;
+}
+
+STATUS game_add_space(Game *game, Space *space)
+{
+    if (game == NULL || space == NULL)
     {
         return ERROR;
     }
 
-    while ((i < MAX_SPACES) && (game->spaces[i] != NULL))
+    // Doubling the capacity keeps the insertion amortized O(1)
+    if (game->n_spaces == game->spaces_capacity)
     {
-        i++;
+        if (game_reserve(game, 2 * game->spaces_capacity, 0) == ERROR)
+            return ERROR;
     }
 
-    if (i >= MAX_SPACES)
+    // The first space added with an id is the one found by it
+    if (game_slot_get(game->space_index, space_get_id(space)) < 0 && game_slot_put(game->space_index, space_get_id(space), game->n_spaces) == ERROR)
     {
         return ERROR;
     }
 
-    game->spaces[i] = space;
+    game->spaces[game->n_spaces++] = space;
+    game_check_owner(game, space);
+    space_set_dirty_list(space, game->changes);
+    game_world_changed(game);
+
+    return OK;
+}
+
+STATUS game_add_link(Game *game, Link *link)
+{
+    if (game == NULL || link == NULL)
+        return ERROR;
+
+    if (game->n_links == game->links_capacity)
+    {
+        int capacity = (game->links_capacity > 0) ? 2 * game->links_capacity : MAX_SPACES;
+        Link **links = (Link **)realloc(game->links, sizeof(Link *) * capacity);
+        if (links == NULL)
+            return ERROR;
+        game->links = links;
+        game->links_capacity = capacity;
+    }
+
+    // The first link added with an id is the one found by it
+    if (link_get_id(link) != NO_ID && id_table_get(game->link_index, link_get_id(link)) == NULL &&
+        id_table_put(game->link_index, link_get_id(link), link) == ERROR)
+        return ERROR;
+    if (game_slot_put(game->link_slots, (Id)(intptr_t)link, game->n_links) == ERROR)
+        return ERROR;
 
+    game->links[game->n_links++] = link;
+    game_check_owner(game, link);
+    link_set_dirty_list(link, game->changes);
+    game_world_changed(game);
     return OK;
 }
 
+STATUS game_index_link(Game *game, Link *link)
+{
+    if (game == NULL || link == NULL || intern_length(link_get_name(link)) == 0)
+        return ERROR;
+
+    // A link read from a text file is given its id with its name
+    if (link_get_id(link) != NO_ID && id_table_get(game->link_index, link_get_id(link)) == NULL &&
+        id_table_put(game->link_index, link_get_id(link), link) == ERROR)
+        return ERROR;
+    Id key = intern_key(intern_fold(link_get_name(link)));
+    // The first link indexed with a name is the one found by it
+    if (id_table_get(game->link_names, key) != NULL)
+        return OK;
+    return id_table_put(game->link_names, key, link);
+}
+
 STATUS game_add_object(Game *game, Object *obj)
 {
+    if (game == NULL || obj == NULL)
+        return ERROR;
+
     Space *space = game_get_space(game, object_get_location(obj));
     space_add_object(space, object_get_id(obj));
 
-    for (int i = 0; i < MAX_OBJECTS; i++)
+    if (game->n_objects == game->objects_capacity)
     {
-        if (game->objects[i] == NULL)
-        {
-            game->objects[i] = obj;
-            return OK;
-        }
+        if (game_reserve(game, 0, 2 * game->objects_capacity) == ERROR)
+            return ERROR;
     }
-    return ERROR;
+
+    game->objects[game->n_objects++] = obj;
+    game_check_owner(game, obj);
+    object_set_dirty_list(obj, game->changes);
+    game_world_changed(game);
+    // The first object added with an id or a name is the one found by it
+    if (game_slot_get(game->object_index, object_get_id(obj)) < 0)
+        game_slot_put(game->object_index, object_get_id(obj), game->n_objects - 1);
+    if (game_get_object_by_name(game, (char *)object_get_name(obj)) == NULL)
+        id_table_put(game->object_names, intern_key(object_get_name(obj)), obj);
+    return OK;
+}
+
+STATUS game_remove_space(Game *game, Space *space)
+{
+    if (game == NULL || space == NULL)
+        return ERROR;
+
+    int slot = game_slot_get(game->space_index, space_get_id(space));
+    if (slot >= 0 && game->spaces[slot] == space)
+        id_table_remove(game->space_index, space_get_id(space));
+    else
+    {
+        // Only a space added with the id of another one is not indexed
+        for (slot = game->n_spaces - 1; slot >= 0 && game->spaces[slot] != space; slot--)
+            ;
+        if (slot < 0)
+            return ERROR;
+    }
+
+    // The order of a streamed world is the order its regions were built in
+    space_set_dirty_list(space, NULL);
+    Space *moved = game->spaces[--game->n_spaces];
+    game->spaces[slot] = moved;
+    if (game_slot_get(game->space_index, space_get_id(moved)) == game->n_spaces)
+        game_slot_put(game->space_index, space_get_id(moved), slot);
+    game_world_changed(game);
+    return OK;
+}
+
+STATUS game_remove_object(Game *game, Object *obj)
+{
+    if (game == NULL || obj == NULL)
+        return ERROR;
+
+    int slot = game_slot_get(game->object_index, object_get_id(obj));
+    if (slot >= 0 && game->objects[slot] == obj)
+        id_table_remove(game->object_index, object_get_id(obj));
+    else
+    {
+        // Only an object added with the id of another one is not indexed
+        for (slot = game->n_objects - 1; slot >= 0 && game->objects[slot] != obj; slot--)
+            ;
+        if (slot < 0)
+            return ERROR;
+    }
+    if (id_table_get(game->object_names, intern_key(object_get_name(obj))) == obj)
+        id_table_remove(game->object_names, intern_key(object_get_name(obj)));
+
+    object_set_dirty_list(obj, NULL);
+    Object *moved = game->objects[--game->n_objects];
+    game->objects[slot] = moved;
+    if (game_slot_get(game->object_index, object_get_id(moved)) == game->n_objects)
+        game_slot_put(game->object_index, object_get_id(moved), slot);
+    game_world_changed(game);
+    return OK;
+}
+
+STATUS game_remove_link(Game *game, Link *link)
+{
+    if (game == NULL || link == NULL)
+        return ERROR;
+
+    int slot = game_slot_get(game->link_slots, (Id)(intptr_t)link);
+    if (slot < 0)
+        return ERROR;
+    id_table_remove(game->link_slots, (Id)(intptr_t)link);
+    if (id_table_get(game->link_index, link_get_id(link)) == link)
+        id_table_remove(game->link_index, link_get_id(link));
+    Id key = intern_key(intern_fold(link_get_name(link)));
+    if (key != NO_ID && id_table_get(game->link_names, key) == link)
+        id_table_remove(game->link_names, key);
+
+    link_set_dirty_list(link, NULL);
+    Link *moved = game->links[--game->n_links];
+    game->links[slot] = moved;
+    if (moved != link)
+        game_slot_put(game->link_slots, (Id)(intptr_t)moved, slot);
+    game_world_changed(game);
+    return OK;
+}
+
+STATUS game_set_stream(Game *game, WorldStream *ws)
+{
+    if (game == NULL)
+        return ERROR;
+
+    // The view was made before the world was streamed
+    game_state_view_destroy(&game->view);
+    game->stream = ws;
+    return OK;
+}
+
+WorldStream *game_get_stream(Game *game)
+{
+    return game != NULL ? game->stream : NULL;
+}
+
+STATUS game_set_journal(Game *game, GameJournal *j)
+{
+    if (game == NULL)
+        return ERROR;
+
+    game->journal = j;
+    return OK;
+}
+
+GameJournal *game_get_journal(Game *game)
+{
+    return game != NULL ? game->journal : NULL;
+}
+
+STATUS game_set_state_view(Game *game, StateView *v)
+{
+    if (game == NULL)
+        return ERROR;
+
+    game->view = v;
+    return OK;
+}
+
+StateView *game_get_state_view(Game *game)
+{
+    return game != NULL ? game->view : NULL;
+}
+
+DirtyList *game_get_dirty_list(Game *game)
+{
+    return game != NULL ? game->changes : NULL;
+}
+
+STATUS game_mark_saved(Game *game)
+{
+    if (game == NULL)
+        return ERROR;
+
+    for (int i = 0; i < game->n_spaces; i++)
+        space_set_dirty(game->spaces[i], FALSE);
+    for (int i = 0; i < game->n_links; i++)
+        link_set_dirty(game->links[i], FALSE);
+    for (int i = 0; i < game->n_objects; i++)
+        object_set_dirty(game->objects[i], FALSE);
+    player_set_dirty(game->player, FALSE);
+    dirty_list_clear(game->changes);
+    return OK;
 }
 
 STATUS game_set_player(Game *game, Player *p)
@@ -496,6 +1170,7 @@ STATUS game_set_player(Game *game, Player *p)
         return ERROR;
 
     game->player = p;
+    game_check_owner(game, p);
     return OK;
 }
 
@@ -504,9 +1179,16 @@ STATUS game_set_dice(Game *game, Dice *dice)
     if (game == NULL || dice == NULL)
         return ERROR;
     game->dice = dice;
+    game_check_owner(game, dice);
+    dice_set_rng(dice, game->rng);
     return OK;
 }
 
+Rng *game_get_rng(Game *game)
+{
+    return game != NULL ? game->rng : NULL;
+}
+
 void game_print_data(Game *game)
 {
     int i = 0;
@@ -514,7 +1196,7 @@ void game_print_data(Game *game)
     printf("\n\n-------------\n\n");
 
     printf("=> Spaces: \n");
-    for (i = 0; i < MAX_SPACES && game->spaces[i] != NULL; i++)
+    for (i = 0; i < game->n_spaces; i++)
     {
         space_print(game->spaces[i]);
     }
@@ -527,12 +1209,14 @@ int game_get_number_object(Game *game)
 {
     if (game == NULL)
         return -1;
-    int counter = 0;
-    while ((counter < MAX_OBJECTS) && (game->objects[counter] != NULL))
-    {
-        counter++;
-    }
-    return counter;
+    return game->n_objects;
+}
+
+static void game_set_argument(Game *game, const char *word)
+{
+    // The room game_create takes for it, with the '\0'
+    strncpy(game->argument, word, 20);
+    game->argument[20] = '\0';
 }
 
 char *game_get_argument(Game *game)
@@ -552,24 +1236,10 @@ char *game_get_description(Game *game)
 
 char *game_get_space_description(Game *game)
 {
-    Id location;
-    Space *user_space;
-
     if (game == NULL)
         return NULL;
 
-    location = player_get_location(game->player);
-
-    for(int i=0; i < MAX_SPACES; i++)
-    {
-        if(space_get_id(game->spaces[i])== location)
-        {
-            user_space= game->spaces[i];
-            break;
-        }
-    }
-
-    return (char*)space_get_description(user_space);
+    return (char *)space_get_description(game_get_space(game, player_get_location(game->player)));
 }
 
 void game_open_log_file(Game *game, char *filename)
@@ -601,15 +1271,36 @@ STATUS game_save(FILE *fp, Game *g)
 {
     if (g == NULL || fp == NULL)
         return ERROR;
+    // A saved game has the whole world, also the regions never visited
+    if (g->stream != NULL && world_stream_load_all(g->stream, g) == ERROR)
+        return ERROR;
 
-    for (int i = 0; i < MAX_SPACES; i++)
+    fprintf(fp, "#w:%d|%d\n", g->n_spaces, g->n_objects);
+    for (int i = 0; i < g->n_spaces; i++)
     {
-        if (g->spaces[i] != NULL)
-            space_save(fp, g->spaces[i]);
-        else
-            break;
+        space_save(fp, g->spaces[i]);
+    }
+    // One line names every link between two spaces, the ones without a
+    // name had no line in the file
+    for (int i = 0; i < g->n_links; i++)
+    {
+        Link *l = g->links[i];
+        Id first = link_get_first_space(l);
+        if (intern_length(link_get_name(l)) > 0 && space_get_exit_to(game_get_space(g, first), link_get_destination(l, first)) == l)
+            link_save(fp, l);
     }
     dice_save(fp, g->dice);
+    rule_table_save(fp, g->rule_table);
+    if (g->vocabulary != NULL)
+        vocabulary_save(fp, g->vocabulary);
+    for (int i = 0; i < g->n_events; i++)
+    {
+        const WorldEvent *e = &g->events[i];
+        int t = 0;
+        while (triggers[t] != e->trigger)
+            t++;
+        fprintf(fp, "#e:%s|%ld|%ld|%ld|%s|\n", event_names[e->effect], e->target, e->delay, e->period, trigger_names[t]);
+    }
     for (int i = 0; i < game_get_number_object(g); i++)
     {
         object_save(fp, g->objects[i]);
@@ -618,40 +1309,16 @@ STATUS game_save(FILE *fp, Game *g)
     return OK;
 }
 
-Id choose_direction(Game *game, direction dir)
+Id choose_direction(Game *game, T_Direction dir)
 {
     Space *location = game_get_space(game, game_get_player_location(game));
-    Id direction = NO_ID;
-    Link *l = NULL;
-    switch (dir)
-    {
-    case NORTH:
-        l = space_get_north(location);
-        break;
-    case SOUTH:
-        l = space_get_south(location);
-        break;
-    case EAST:
-        l = space_get_east(location);
-        break;
-    case WEST:
-        l = space_get_west(location);
-        break;
-    case UP:
-        l = space_get_up(location);
-        break;
-    case DOWN:
-        l = space_get_down(location);
-        break;
-    default:
-        break;
-    }
+    Link *l = space_get_exit(location, dir);
     if (link_get_opened(l) == TRUE)
-        direction = link_get_second_space(l);
-    return direction;
+        return link_get_destination(l, space_get_id(location));
+    return NO_ID;
 }
 
-STATUS game_move(Game *game, direction dir)
+STATUS game_move(Game *game, T_Direction dir)
 {
     Id next_location = choose_direction(game, dir);
     if (next_location == NO_ID)
@@ -661,16 +1328,15 @@ STATUS game_move(Game *game, direction dir)
 }
 
 BOOL game_player_has_light(Game* game) {
-	Id* inventory_ids = inventory_get_elements(player_get_inventory(game->player));
+	int n = 0;
+	const Id* inventory_ids = inventory_view(player_get_inventory(game->player), &n);
 	Object* o = NULL;
-	for (int i = 0; i < inventory_get_nObjects(player_get_inventory(game->player)); i++) {
+	for (int i = 0; i < n; i++) {
 		o = game_get_object(game, inventory_ids[i]);
 		if (object_get_illuminate(o) == TRUE && object_get_turnedOn(o) == TRUE) {
-			free(inventory_ids);
 			return TRUE;
 		}
 	}
-	free(inventory_ids);
 	return FALSE;
 }
 
@@ -678,115 +1344,95 @@ BOOL game_player_has_light(Game* game) {
    Callbacks implementation for each action 
 */
 
-STATUS game_callback_unknown(Game *game)
+STATUS game_callback_unknown(Game *game, const ParsedCommand *cmd)
 {
     (void)game;
+    (void)cmd;
     return OK;
 }
 
-STATUS game_callback_exit(Game *game)
+STATUS game_callback_exit(Game *game, const ParsedCommand *cmd)
 {
     (void)game;
+    (void)cmd;
     return OK;
 }
 
-STATUS game_callback_take(Game *game)
+STATUS game_callback_take(Game *game, const ParsedCommand *cmd)
 {
-    char input[20];
     Space *location = game_get_space(game, game_get_player_location(game));
 
-    if (space_objects_count(location) == 0)
+    if (space_objects_count(location) == 0 || cmd->argc < 1)
         return ERROR;
 
-    if (scanf("%s", input) > 0)
-    {
-        strcpy(game->argument, input);
-        if (player_inventory_full(game->player))
-            return ERROR;
+    const char *input = cmd->args[0];
+    game_set_argument(game, input);
+    if (player_inventory_full(game->player))
+        return ERROR;
 
-        Object *obj = game_get_object_by_name(game, input);
-        if (obj == NULL || object_get_movable(obj) == FALSE)
-            return ERROR;
+    Object *obj = game_get_object_by_name(game, input);
+    if (obj == NULL || object_get_movable(obj) == FALSE)
+        return ERROR;
 
-        if (space_remove_object(location, object_get_id(obj)) == ERROR)
-            return ERROR;
+    if (space_remove_object(location, object_get_id(obj)) == ERROR)
+        return ERROR;
 
-        player_add_object(game->player, obj);
-    }
+    player_add_object(game->player, obj);
     return OK;
 }
 
-STATUS game_callback_drop(Game *game)
+STATUS game_callback_drop(Game *game, const ParsedCommand *cmd)
 {
-    char input[20];
-    if (scanf("%s", input) > 0)
-    {
-        strcpy(game->argument, input);
-        Object *obj = game_get_object_by_name(game, input);
-        if (obj == NULL)
-            return ERROR;
+    if (cmd->argc < 1)
+        return ERROR;
 
-        Space *s = game_get_space(game, game_get_player_location(game));
-        if (player_delete_object(game->player, obj) == ERROR)
-            return ERROR;
+    const char *input = cmd->args[0];
+    game_set_argument(game, input);
+    Object *obj = game_get_object_by_name(game, input);
+    if (obj == NULL)
+        return ERROR;
 
-        game_drop_object(game, s, obj);
-    }
+    Space *s = game_get_space(game, game_get_player_location(game));
+    if (player_delete_object(game->player, obj) == ERROR)
+        return ERROR;
+
+    game_drop_object(game, s, obj);
     return OK;
 }
 
-STATUS game_callback_roll(Game *game)
+STATUS game_callback_roll(Game *game, const ParsedCommand *cmd)
 {
+    (void)cmd;
     dice_roll(game->dice);
     return OK;
 }
 
-STATUS game_callback_move(Game *game)
+STATUS game_callback_move(Game *game, const ParsedCommand *cmd)
 {
-    char input[20];
-
-    if (scanf("%s", input) <= 0)
+    if (cmd->argc < 1)
         return ERROR;
 
-    strcpy(game->argument, input);
-    if (strcmp(input, "north") == 0 || strcmp(input, "n") == 0)
+    const char *input = cmd->args[0];
+    game_set_argument(game, input);
+    int dir = vocabulary_find(game_get_vocabulary(game), input, WORD_DIRECTION);
+    if (dir != NO_MEANING)
     {
-        return game_move(game, NORTH);
-    }
-    else if (strcmp(input, "south") == 0 || strcmp(input, "s") == 0)
-    {
-        return game_move(game, SOUTH);
-    }
-    else if (strcmp(input, "west") == 0 || strcmp(input, "w") == 0)
-    {
-        return game_move(game, WEST);
-    }
-    else if (strcmp(input, "east") == 0 || strcmp(input, "e") == 0)
-    {
-        return game_move(game, EAST);
-    }
-    else if (strcmp(input, "up") == 0 || strcmp(input, "u") == 0)
-    {
-        return game_move(game, UP);
-    }
-    else if (strcmp(input, "down") == 0 || strcmp(input, "d") == 0)
-    {
-        return game_move(game, DOWN);
+        return game_move(game, (T_Direction)dir);
     }
 
     return ERROR;
 }
 
-STATUS game_callback_inspect(Game *game)
+STATUS game_callback_inspect(Game *game, const ParsedCommand *cmd)
 {
-    char input[20];
     memset(game->description, '\0', 50);
 
     Space *space = game_get_space(game, game_get_player_location(game));
 
-    if (scanf("%s", input) > 0)
+    if (cmd->argc > 0)
     {
-        strcpy(game->argument, input);
+        const char *input = cmd->args[0];
+        game_set_argument(game, input);
         if (strcasecmp(input, "s") == 0 || strcasecmp(input, "space") == 0)
         {
             if (space_get_illumination(space))
@@ -817,13 +1463,12 @@ STATUS game_callback_inspect(Game *game)
     return ERROR;
 }
 
-STATUS game_callback_turn_on(Game *game)
+STATUS game_callback_turn_on(Game *game, const ParsedCommand *cmd)
 {
-    char input[20];
-
-    if (scanf("%s", input) > 0)
+    if (cmd->argc > 0)
     {
-        strcpy(game->argument, input);
+        const char *input = cmd->args[0];
+        game_set_argument(game, input);
         Object *obj = game_get_object_by_name(game, input);
         if (obj == NULL || object_get_illuminate(obj) == FALSE)
             return ERROR;
@@ -836,6 +1481,7 @@ STATUS game_callback_turn_on(Game *game)
         if (space_hasObject(playerLocation, object_get_id(obj)) == TRUE || player_search_inventory(game->player, obj) == TRUE)
         {
             object_set_turnedOn(obj, TRUE);
+            game_trigger_events(game, TURNON, object_get_id(obj));
             return OK;
         }
     }
@@ -843,13 +1489,12 @@ STATUS game_callback_turn_on(Game *game)
     return ERROR;
 }
 
-STATUS game_callback_turn_off(Game *game)
+STATUS game_callback_turn_off(Game *game, const ParsedCommand *cmd)
 {
-    char input[20];
-
-    if (scanf("%s", input) > 0)
+    if (cmd->argc > 0)
     {
-        strcpy(game->argument, input);
+        const char *input = cmd->args[0];
+        game_set_argument(game, input);
         Object *obj = game_get_object_by_name(game, input);
         if (obj == NULL || object_get_illuminate(obj) == FALSE)
             return ERROR;
@@ -858,6 +1503,7 @@ STATUS game_callback_turn_off(Game *game)
         if (space_hasObject(playerLocation, object_get_id(obj)) == TRUE || player_search_inventory(game->player, obj) == TRUE)
         {
             object_set_turnedOn(obj, FALSE);
+            game_trigger_events(game, TURNOFF, object_get_id(obj));
             return OK;
         }
     }
@@ -865,29 +1511,24 @@ STATUS game_callback_turn_off(Game *game)
     return ERROR;
 }
 
-void open_link(Game* game, Link* link) {
-	link_set_opened(link, TRUE);
-	Space* s = game_get_space(game, link_get_second_space(link));
-	link_set_opened(space_get_link_by_name(s, (char *)link_get_name(link)), TRUE);
-}
-
-STATUS game_callback_open_link_with_obj(Game *game)
+STATUS game_callback_open_link_with_obj(Game *game, const ParsedCommand *cmd)
 {
-    char input[20] = {0};
+    // open <link> with <object>
+    if (cmd->argc < 3)
+        return ERROR;
 
-    scanf("%s", input);
-    Link *link = game_get_link_by_name(game, input);
-    if (link == NULL || player_get_location(game->player) != link_get_first_space(link))
+    Link *link = game_get_link_by_name(game, cmd->args[0]);
+    if (link == NULL || link_get_destination(link, player_get_location(game->player)) == NO_ID)
         return ERROR;
 
-    scanf("%s", input);
-    if (strcasecmp(input, "with") != 0)
+    if (strcasecmp(cmd->args[1], "with") != 0)
         return ERROR;
 
-    scanf("%s", input);
+    const char *input = cmd->args[2];
 
 	if (strcasecmp(link_get_name(link), "SafeDoor") == 0 && strcmp(input, "495") == 0) {
-		open_link(game, link);
+		link_set_opened(link, TRUE);
+		game_trigger_events(game, OPEN, link_get_id(link));
     	return OK;
 	}
 
@@ -895,31 +1536,42 @@ STATUS game_callback_open_link_with_obj(Game *game)
     if (object == NULL || player_search_inventory(game->player, object) == FALSE || object_get_openLink(object) != link_get_id(link))
         return ERROR;
 
-    open_link(game, link);
+    // Both spaces share the link, so it is open from both sides
+    link_set_opened(link, TRUE);
+    game_trigger_events(game, OPEN, link_get_id(link));
     return OK;
 }
 
-STATUS game_callback_save(Game *game)
+STATUS game_callback_save(Game *game, const ParsedCommand *cmd)
 {
-    char input[20] = {0};
-
-    if (scanf("%s", input) > 0)
+    if (cmd->argc > 0)
     {
-        return game_management_save(input, game);
+        const char *input = cmd->args[0];
+        // A .dat file is a whole world again, anything else only the state of this one
+        size_t len = strlen(input);
+        if (len > 4 && strcmp(input + len - 4, ".dat") == 0)
+            return game_management_save(input, game);
+        // The file of the journal only gets what changed since it was last saved
+        const char *journal = game_state_journal_get_filename(game->journal);
+        if (journal != NULL && strcmp(input, journal) == 0)
+            return game_state_journal_append(game->journal, game);
+        return game_state_save(input, game);
     }
     return ERROR;
 }
 
-STATUS game_callback_load(Game *game)
+STATUS game_callback_load(Game *game, const ParsedCommand *cmd)
 {
-    char input[20] = {0};
-
-    game_clear(game);
-
-    if (scanf("%s", input) > 0)
+    if (cmd->argc > 0)
     {
+        const char *input = cmd->args[0];
+        // A saved state is restored on the world being played
+        if (game_state_check(input) == TRUE)
+            return game_state_load(input, game);
+        game_clear(game);
         return game_management_load(input, game);
     }
+    game_clear(game);
     return ERROR;
 }
 
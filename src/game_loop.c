@@ -14,6 +14,10 @@
 
 #include "../include/game_rules.h"
 #include "../include/graphic_engine.h"
+#include "../include/game_state.h"
+
+/* commands between two saves to the journal, set with -a <turns> */
+static int autosave_turns = 5;
 
 // Prototypes
 
@@ -61,8 +65,41 @@ void game_loop_run(Game *game, Graphic_engine *gengine);
  */
 void game_loop_cleanup(Game *game, Graphic_engine *gengine);
 
+/**
+ * @brief reads the options that need the game loaded: -l <file> opens a
+ * log, -s <seed> seeds the dice and the random rules, -j <file> resumes
+ * the game saved in a journal, if there is one, and keeps saving to it,
+ * -a <turns> sets how often it is saved to
+ *
+ * @param game pointer to game
+ * @param argc number of arguments
+ * @param argv arguments of the program
+ */
 void game_init_from_arguments(Game *game, int argc, char **argv);
 
+/**
+ * @brief resumes a game from a journal and opens it to save the game
+ *
+ * @author Jiri Zak
+ * @date 27-05-2021
+ *
+ * @param game pointer to game
+ * @param filename name of the journal, it is created if it does not exist
+ */
+void game_init_journal(Game *game, char *filename);
+
+/**
+ * @brief chooses how the world is loaded. With -m <regions> a compiled
+ * world is streamed keeping at most that many regions, 0 for no limit
+ *
+ * @author Jiri Zak
+ * @date 26-05-2021
+ *
+ * @param argc number of arguments
+ * @param argv arguments of the program
+ */
+void game_init_loading(int argc, char **argv);
+
 int main(int argc, char *argv[])
 {
     Game *game = game_init();
@@ -76,6 +113,7 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    game_init_loading(argc, argv);
     if (!game_loop_init(game, &gengine, argv[1]))
     {
         game_init_rules(game, argc, argv);
@@ -112,24 +150,34 @@ int game_loop_init(Game *game, Graphic_engine **gengine, char *file_name)
 void game_loop_run(Game *game, Graphic_engine *gengine)
 {
     T_Command command = NO_CMD;
+    ParsedCommand parsed;
+    char line[CMD_LINE];
     T_Rules rule = NO_RULE;
     STATUS s = ERROR;
     BOOL b = TRUE;
-
-    
+    int turns = 0;
 
     while ((command != EXIT) && !game_is_over(game))
     {
         graphic_engine_paint_game(gengine, game, s);
-        command = get_user_input();
-        s = game_update(game, command);
+        command = get_user_input(game_get_vocabulary(game), line, &parsed);
+        // The input is over, there is nothing more to play
+        if (command == NO_CMD)
+            break;
+        s = game_update(game, &parsed);
         b = game_rules_get(game);
         if (b == TRUE)
         {
             rule = game_get_last_rule(game);
             game_rules_random_command(rule, game);
         }
+        // Nothing to do in the turns no event is due in
+        game_tick(game);
+        // Cheap, only what changed in the last turns is written
+        if (++turns % autosave_turns == 0)
+            game_state_journal_append(game_get_journal(game), game);
     }
+    game_state_journal_append(game_get_journal(game), game);
 }
 
 void game_loop_cleanup(Game *game, Graphic_engine *gengine)
@@ -146,9 +194,40 @@ void game_init_from_arguments(Game *game, int argc, char **argv)
         {
             game_open_log_file(game, argv[i + 1]);
         }
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            rng_seed(game_get_rng(game), strtoull(argv[i + 1], NULL, 10));
+        }
+        else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+        {
+            autosave_turns = atoi(argv[i + 1]);
+        }
+    }
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "-j") == 0)
+        {
+            game_init_journal(game, argv[i + 1]);
+        }
     }
 }
 
+void game_init_journal(Game *game, char *filename)
+{
+    GameJournal *j = NULL;
+
+    if (game_state_check(filename) == TRUE && game_state_load(filename, game) == ERROR)
+        fprintf(stderr, "The journal %s is not of this world, it is started again.\n", filename);
+
+    j = game_state_journal_open(filename, game);
+    if (j == NULL)
+    {
+        fprintf(stderr, "Error while opening the journal %s.\n", filename);
+        return;
+    }
+    game_set_journal(game, j);
+}
+
 void game_init_rules(Game *game, int argc, char **argv)
 {
     for (int i = 2; i < argc; i += 2)
@@ -162,4 +241,16 @@ void game_init_rules(Game *game, int argc, char **argv)
 
     game_rules_sel(game, TRUE);
     return;
+}
+
+void game_init_loading(int argc, char **argv)
+{
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "-m") == 0)
+        {
+            game_management_set_stream(atoi(argv[i + 1]));
+            return;
+        }
+    }
 }
\ No newline at end of file
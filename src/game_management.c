@@ -8,11 +8,114 @@
  * @copyright GNU Public License
  */
 
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#define GAME_MANAGEMENT_MMAP
+#define GAME_MANAGEMENT_THREADS
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef GAME_MANAGEMENT_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef GAME_MANAGEMENT_THREADS
+#include <pthread.h>
+#endif
+
 #include "../include/game.h"
+#include "../include/id_table.h"
+#include "../include/intern.h"
+#include "../include/scan.h"
+#include "../include/world_image.h"
+
+/* bytes of a mapped file scanned at once, grows for longer lines */
+#define LOAD_WINDOW 65536
+/* a file is split in as many chunks as threads, each of at least this size */
+#define LOAD_CHUNK_MIN (1 << 20)
+#define LOAD_MAX_THREADS 16
+/* fields and lines a chunk has room for at first, it grows as needed */
+#define LOAD_CHUNK_FIELDS 1024
+
+/* a field of a line, never empty. It is a slice of the line, which is never
+ * written, so it can be part of a mapped file and the texts are interned
+ * from it. Its number is read where the line is split, on the thread of
+ * its chunk */
+typedef struct {
+    const char* start;
+    unsigned int len;
+    long value;     // the field read with scan_long, 0 if it is a text
+} LoadField;
+
+/* fields of a line separated by '|', read one after the other. Empty
+ * fields were left out like strtok does */
+typedef struct {
+    const LoadField* field;
+    int n;
+    int next;
+    InternPool* strings;  // pool the texts are interned in, the one of the game
+} Fields;
+
+/* a line split into fields, loaded into the game later */
+typedef struct {
+    char tag;       // character after the '#'
+    BOOL tagged;    // the tag is followed by ':'
+    int first;      // first field of the line in the fields of its chunk
+    int n;          // number of fields
+} LoadRecord;
+
+/* a slice of a data file that ends at the end of a line, and the lines
+ * split from it by one thread, in order */
+typedef struct {
+    const char* data;
+    size_t size;
+    LoadRecord* records;
+    int n_records;
+    int records_capacity;
+    LoadField* fields;
+    int n_fields;
+    int fields_capacity;
+    STATUS status;
+} LoadChunk;
+
+/* a link line, the link is named once every space is loaded */
+typedef struct {
+    Id id;
+    const char* name;
+    Id first;
+    Id second;
+    int open;           // 0 = opened, like in the file
+} LoadEdge;
+
+/* the links lines of a data file, in order */
+typedef struct {
+    LoadEdge* edge;
+    int n;
+    int capacity;
+} LoadEdges;
+
+/* a game loaded line by line as the lines are found */
+typedef struct {
+    Game* game;
+    LoadEdges* edges;   // where the links lines go
+    LoadChunk line;     // room for the fields of the line being loaded
+} LoadSerial;
+
+/* called for every line of a block, see game_management_scan */
+typedef STATUS (*LoadLineFn)(void* arg, const char* base, const char* line, const char* end, const unsigned int* bars, int n_bars);
+
+/* threads to load a file with, 0 to choose by its size */
+static int load_threads = 0;
+/* regions a streamed world keeps, -1 to load worlds whole */
+static int stream_regions = -1;
+/* links lines of the last file loaded that were left out */
+static int link_errors = 0;
 
 // Private functions
 /**
@@ -22,10 +125,10 @@
  * @date 08-03-2021
  * 
  * @param game pointer to game
- * @param line string with space description
+ * @param f fields of the line after the tag
  * @return STATUS ERROR = 0, OK = 1
  */
-STATUS game_load_space(Game* game, char* line);
+STATUS game_load_space(Game* game, Fields* f);
 
 /**
  * @brief load object string description, add it to game
@@ -34,10 +137,10 @@ STATUS game_load_space(Game* game, char* line);
  * @date 08-03-2021
  * 
  * @param game pointer to game
- * @param line string with object description
+ * @param f fields of the line after the tag
  * @return STATUS ERROR = 0, OK = 1
  */
-STATUS game_load_object(Game* game, char* line);
+STATUS game_load_object(Game* game, Fields* f);
 
 /**
  * @brief load player string description, add it to game
@@ -46,55 +149,559 @@ STATUS game_load_object(Game* game, char* line);
  * @date 22-03-2021
  * 
  * @param game pointer to game
- * @param line string with player description
+ * @param f fields of the line after the tag
  * @return STATUS ERROR = 0, OK = 1
  */
-STATUS game_load_player(Game* game, char* line);
+STATUS game_load_player(Game* game, Fields* f);
 
 /**
- * @brief load link string description, add it to game
+ * @brief load link string description, keep it to name the link once
+ * every space is loaded
  *
  * @author Eva Moresova
- * @date 19-04-2021
+ * @date 27-05-2021
  * 
+ * @param edges links lines of the file
+ * @param f fields of the line after the tag
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_load_links(LoadEdges* edges, Fields* f);
+
+/**
+ * @brief names the links of the spaces after the links lines, in one pass.
+ * A line whose spaces have no exit between them or whose id was already
+ * used is left out and reported
+ *
+ * @author Eva Moresova
+ * @date 27-05-2021
+ *
+ * @param game pointer to game with every space loaded
+ * @param edges links lines of the file
+ * @return number of lines left out
+ */
+int game_management_resolve_links(Game* game, LoadEdges* edges);
+
+/**
+ * @brief load the world size hint, storage for that many spaces and
+ * objects is reserved before they are read
+ *
+ * @author Eva Moresova
+ * @date 14-05-2021
+ * 
+ * @param game pointer to game
+ * @param f fields with number of spaces and number of objects
+ * @return STATUS ERROR = 0, OK = 1
+ */
+STATUS game_load_world_size(Game* game, Fields* f);
+
+STATUS game_management_load_inventory(Game* game, Fields* f);
+STATUS game_management_load_dice(Game* game, Fields* f);
+
+/**
+ * @brief load a random rule: effect, weight, target of a teleport and the
+ * first and last spaces it applies in. The fields left out are -1
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @param f fields of the line after the tag
+ * @return STATUS ERROR = 0 if the rule is not valid, OK = 1
+ */
+STATUS game_load_rule(Game* game, Fields* f);
+
+/**
+ * @brief load an event: effect, target, delay, period and the command that
+ * starts it. A period left out is 0, a command left out is start
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @param f fields of the line after the tag
+ * @return STATUS ERROR = 0 if the event is not valid, OK = 1
+ */
+STATUS game_load_event(Game* game, Fields* f);
+
+/**
+ * @brief load a synonym: the new word and the word it means the same as
+ *
+ * @author Jiri Zak
+ * @date 28-05-2021
+ *
+ * @param game pointer to game
+ * @param f fields of the line after the tag
+ * @return STATUS ERROR = 0 if the word it means the same as is not known, OK = 1
+ */
+STATUS game_load_synonym(Game* game, Fields* f);
+
+/**
+ * @brief next field of the line
+ *
+ * @param f fields of the line
+ * @param start set to the first character of the field
+ * @param len set to the number of characters of the field
+ * @return TRUE if there was a field, FALSE at the end of the line
+ */
+static BOOL fields_next(Fields* f, const char** start, size_t* len);
+
+/**
+ * @brief next field as a number, read like atol does when the line was split
+ *
+ * @param f fields of the line
+ * @param missing value if there are no more fields
+ * @return the number
+ */
+static long fields_long(Fields* f, long missing);
+
+/**
+ * @brief next field as an interned text
+ *
+ * @param f fields of the line
+ * @param max the text is cut to this many characters
+ * @return handle of the text or NULL if there are no more fields
+ */
+static const char* fields_text(Fields* f, size_t max);
+
+/**
+ * @brief splits one line of a data file into its fields, the line does not
+ * need to end with '\0'
+ *
+ * @param base the offsets in bars are counted from here
+ * @param line first character of the line
+ * @param end character after the line
+ * @param bars offsets of the '|' of the line, in order
+ * @param n_bars number of offsets
+ * @param out room for n_bars + 1 fields
+ * @param r set to the tag and number of fields of the line
+ * @return TRUE if the line has a tag, FALSE if it is empty or a comment
+ */
+static BOOL game_management_split_line(const char* base, const char* line, const char* end, const unsigned int* bars, int n_bars, LoadField* out, LoadRecord* r);
+
+/**
+ * @brief loads a line split into fields into the game
+ *
+ * @param game pointer to game
+ * @param edges where the links lines go
+ * @param r tag and number of fields of the line
+ * @param fields fields of the line
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS game_management_load_record(Game* game, LoadEdges* edges, const LoadRecord* r, const LoadField* fields);
+
+/**
+ * @brief makes room in a chunk for one more line and its fields
+ *
+ * @param c chunk
+ * @param n_fields fields of the line
+ * @return STATUS ERROR = 0 if there is no memory, OK = 1
+ */
+static STATUS game_management_chunk_reserve(LoadChunk* c, int n_fields);
+
+/**
+ * @brief LoadLineFn that loads the line into the game of a LoadSerial
+ *
+ * @return STATUS ERROR = 0 if there is no memory, OK = 1 even if the line
+ * is not valid
+ */
+static STATUS game_management_load_line(void* arg, const char* base, const char* line, const char* end, const unsigned int* bars, int n_bars);
+
+/**
+ * @brief LoadLineFn that keeps the line in a LoadChunk, to load it later
+ *
+ * @return STATUS ERROR = 0 if there is no memory, OK = 1
+ */
+static STATUS game_management_keep_line(void* arg, const char* base, const char* line, const char* end, const unsigned int* bars, int n_bars);
+
+/**
+ * @brief finds every line of a block of text, scanning a window of it at a
+ * time for the delimiters
+ *
+ * @param data start of the block
+ * @param size number of bytes of the block
+ * @param fn called for every line with the '|' found in it
+ * @param arg first argument of fn
+ * @return STATUS ERROR = 0 if there is no memory or fn fails, OK = 1
+ */
+static STATUS game_management_scan(const char* data, size_t size, LoadLineFn fn, void* arg);
+
+/**
+ * @brief loads every line of a block of text as it is found
+ *
+ * @param game pointer to game
+ * @param edges where the links lines go
+ * @param data start of the block
+ * @param size number of bytes of the block
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS game_management_load_block(Game* game, LoadEdges* edges, const char* data, size_t size);
+
+/**
+ * @brief number of threads to load a block of text with
+ *
+ * @param size number of bytes of the block
+ * @return 1 or more
+ */
+static int game_management_threads(size_t size);
+
+/**
+ * @brief loads a block of text split in chunks. The chunks are parsed at
+ * the same time, one per thread, into records with their fields and
+ * numbers. Then the records are loaded into the game in the order of the
+ * file: only interning the texts, creating the entities and linking them
+ * is serial, and the result is the same as with game_management_load_block
+ *
+ * @param game pointer to game
+ * @param edges where the links lines go
+ * @param data start of the block
+ * @param size number of bytes of the block
+ * @param n_threads number of chunks
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS game_management_load_parallel(Game* game, LoadEdges* edges, const char* data, size_t size, int n_threads);
+
+#ifdef GAME_MANAGEMENT_THREADS
+/**
+ * @brief thread function, parses the lines of a LoadChunk into records
+ *
+ * @param arg the chunk, its status is set to the result
+ * @return NULL
+ */
+static void* game_management_split_chunk(void* arg);
+#endif
+
+/**
+ * @brief loads a data file line by line with fgets
+ *
+ * @param filename name of the file
  * @param game pointer to game
- * @param line string with link description
+ * @param edges where the links lines go
  * @return STATUS ERROR = 0, OK = 1
  */
-STATUS game_load_links(Game* game, char* line);
+static STATUS game_management_load_stream(const char* filename, Game* game, LoadEdges* edges);
 
-STATUS game_management_load_inventory(Game* game, char* line);
-STATUS game_management_load_dice(Game* game, char* line);
+#ifdef GAME_MANAGEMENT_MMAP
+/**
+ * @brief maps a data file into memory to read it in place
+ *
+ * @param filename name of the file
+ * @param size set to the size of the file
+ * @return start of the mapping or NULL if the file can not be mapped, it
+ * may be empty or not a regular file
+ */
+static const char* game_management_map(const char* filename, size_t* size);
+
+/**
+ * @brief unmaps a file mapped by game_management_map, the release function
+ * of a streamed world
+ *
+ * @param data start of the mapping
+ * @param size size of the file
+ */
+static void game_management_unmap(const char* data, size_t size);
+#endif
 
 // Implementation
-STATUS game_management_load(char* filename, Game* game) {
-    FILE* file = NULL;
-    char line[WORD_SIZE] = "";
-    STATUS status = OK;
+static BOOL fields_next(Fields* f, const char** start, size_t* len) {
+    if (f->next >= f->n)
+        return FALSE;
 
-    if (!filename) {
+    *start = f->field[f->next].start;
+    *len = f->field[f->next].len;
+    f->next++;
+    return TRUE;
+}
+
+static long fields_long(Fields* f, long missing) {
+    if (f->next >= f->n)
+        return missing;
+    return f->field[f->next++].value;
+}
+
+static const char* fields_text(Fields* f, size_t max) {
+    const char* c = NULL;
+    size_t len = 0;
+
+    if (fields_next(f, &c, &len) == FALSE)
+        return NULL;
+    return intern_string_n(f->strings, c, (len < max) ? len : max);
+}
+
+static BOOL game_management_split_line(const char* base, const char* line, const char* end, const unsigned int* bars, int n_bars, LoadField* out, LoadRecord* r) {
+    while (end > line && (end[-1] == '\n' || end[-1] == '\r'))
+        end--;
+    if (end - line < 2 || line[0] != '#')
+        return FALSE;
+
+    r->tag = line[1];
+    r->tagged = (end - line > 2 && line[2] == ':') ? TRUE : FALSE;
+    r->n = 0;
+
+    // The fields start after the tag, a '|' inside it or after the line is not a field
+    const char* cur = (end - line > 3) ? line + 3 : end;
+    int k = 0;
+    while (k < n_bars && base + bars[k] < cur)
+        k++;
+    for (; cur < end; k++) {
+        const char* stop = (k < n_bars && base + bars[k] < end) ? base + bars[k] : end;
+        if (stop > cur) {
+            out[r->n].start = cur;
+            out[r->n].len = (unsigned int)(stop - cur);
+            out[r->n].value = scan_long(cur, (size_t)(stop - cur));
+            r->n++;
+        }
+        cur = stop + 1;
+    }
+    return TRUE;
+}
+
+static STATUS game_management_load_record(Game* game, LoadEdges* edges, const LoadRecord* r, const LoadField* fields) {
+    Fields f = {fields, r->n, 0, game_get_strings(game)};
+
+    switch (r->tag) {
+        case 'w':
+            return r->tagged ? game_load_world_size(game, &f) : OK;
+        case 's':
+            return r->tagged ? game_load_space(game, &f) : OK;
+        case 'o':
+            return r->tagged ? game_load_object(game, &f) : OK;
+        case 'p':
+            return r->tagged ? game_load_player(game, &f) : OK;
+        case 'l':
+            return r->tagged ? game_load_links(edges, &f) : OK;
+        case 'i':
+            return game_management_load_inventory(game, &f);
+        case 'd':
+            return game_management_load_dice(game, &f);
+        case 'r':
+            return r->tagged ? game_load_rule(game, &f) : OK;
+        case 'e':
+            return r->tagged ? game_load_event(game, &f) : OK;
+        case 'v':
+            return r->tagged ? game_load_synonym(game, &f) : OK;
+        default:
+            return OK;
+    }
+}
+
+static STATUS game_management_chunk_reserve(LoadChunk* c, int n_fields) {
+    if (c->n_fields + n_fields > c->fields_capacity) {
+        int capacity = (c->fields_capacity > 0) ? c->fields_capacity : LOAD_CHUNK_FIELDS;
+        while (c->n_fields + n_fields > capacity)
+            capacity *= 2;
+        LoadField* fields = realloc(c->fields, sizeof(LoadField) * capacity);
+        if (fields == NULL)
+            return ERROR;
+        c->fields = fields;
+        c->fields_capacity = capacity;
+    }
+    if (c->n_records == c->records_capacity) {
+        int capacity = (c->records_capacity > 0) ? c->records_capacity * 2 : LOAD_CHUNK_FIELDS;
+        LoadRecord* records = realloc(c->records, sizeof(LoadRecord) * capacity);
+        if (records == NULL)
+            return ERROR;
+        c->records = records;
+        c->records_capacity = capacity;
+    }
+    return OK;
+}
+
+static STATUS game_management_load_line(void* arg, const char* base, const char* line, const char* end, const unsigned int* bars, int n_bars) {
+    LoadSerial* s = arg;
+    LoadRecord r;
+
+    if (game_management_chunk_reserve(&s->line, n_bars + 1) == ERROR)
+        return ERROR;
+    // A line that is not valid is left out, like before
+    if (game_management_split_line(base, line, end, bars, n_bars, s->line.fields, &r) == TRUE)
+        game_management_load_record(s->game, s->edges, &r, s->line.fields);
+    return OK;
+}
+
+static STATUS game_management_keep_line(void* arg, const char* base, const char* line, const char* end, const unsigned int* bars, int n_bars) {
+    LoadChunk* c = arg;
+    LoadRecord r;
+
+    if (game_management_chunk_reserve(c, n_bars + 1) == ERROR)
+        return ERROR;
+    if (game_management_split_line(base, line, end, bars, n_bars, c->fields + c->n_fields, &r) == FALSE)
+        return OK;
+    r.first = c->n_fields;
+    c->n_fields += r.n;
+    c->records[c->n_records++] = r;
+    return OK;
+}
+
+static STATUS game_management_scan(const char* data, size_t size, LoadLineFn fn, void* arg) {
+    const char* end = data + size;
+    size_t window = LOAD_WINDOW;
+    STATUS status = OK;
+    unsigned int* pos = malloc(sizeof(unsigned int) * window);
+    if (pos == NULL) {
         return ERROR;
     }
 
+    const char* p = data;
+    while (p < end && status == OK) {
+        // A window never has more delimiters than bytes, so it is scanned whole
+        size_t len = ((size_t)(end - p) < window) ? (size_t)(end - p) : window;
+        size_t n = scan_delimiters(p, len, pos, window, NULL);
+
+        const char* line = p;
+        size_t first = 0;
+        for (size_t k = 0; k < n && status == OK; k++) {
+            if (p[pos[k]] != '\n')
+                continue;
+            status = fn(arg, p, line, p + pos[k], pos + first, (int)(k - first));
+            line = p + pos[k] + 1;
+            first = k + 1;
+        }
+
+        if (p + len == end) {
+            if (line < end && status == OK)
+                status = fn(arg, p, line, end, pos + first, (int)(n - first));
+            break;
+        }
+        if (line == p) {
+            // No line ends in the window, it is scanned again twice as big
+            unsigned int* bigger = realloc(pos, sizeof(unsigned int) * window * 2);
+            if (bigger == NULL) {
+                free(pos);
+                return ERROR;
+            }
+            pos = bigger;
+            window *= 2;
+            continue;
+        }
+        // The line cut by the end of the window starts the next one
+        p = line;
+    }
+
+    free(pos);
+    return status;
+}
+
+static STATUS game_management_load_block(Game* game, LoadEdges* edges, const char* data, size_t size) {
+    LoadSerial s;
+
+    memset(&s, 0, sizeof(LoadSerial));
+    s.game = game;
+    s.edges = edges;
+    STATUS status = game_management_scan(data, size, game_management_load_line, &s);
+    free(s.line.fields);
+    free(s.line.records);
+    return status;
+}
+
+static int game_management_threads(size_t size) {
+    long n = load_threads;
+
+#ifdef GAME_MANAGEMENT_THREADS
+    if (n == 0) {
+        n = sysconf(_SC_NPROCESSORS_ONLN);
+        if (n > (long)(size / LOAD_CHUNK_MIN))
+            n = (long)(size / LOAD_CHUNK_MIN);
+    }
+#else
+    n = 1;
+#endif
+    if (n > LOAD_MAX_THREADS)
+        n = LOAD_MAX_THREADS;
+    if ((size_t)n > size)
+        n = (long)size;
+    return (n > 1) ? (int)n : 1;
+}
+
+#ifdef GAME_MANAGEMENT_THREADS
+static void* game_management_split_chunk(void* arg) {
+    LoadChunk* c = arg;
+
+    c->status = game_management_scan(c->data, c->size, game_management_keep_line, c);
+    return NULL;
+}
+#endif
+
+static STATUS game_management_load_parallel(Game* game, LoadEdges* edges, const char* data, size_t size, int n_threads) {
+    LoadChunk chunks[LOAD_MAX_THREADS];
+    const char* end = data + size;
+    const char* p = data;
+    STATUS status = OK;
+
+    if (n_threads > LOAD_MAX_THREADS)
+        n_threads = LOAD_MAX_THREADS;
+    memset(chunks, 0, sizeof(chunks));
+    for (int i = 0; i < n_threads; i++) {
+        // Every chunk but the last one ends with a line
+        const char* stop = (i == n_threads - 1) ? end : data + size / n_threads * (i + 1);
+        if (stop < p) {
+            stop = p;
+        } else if (stop < end) {
+            const char* eol = memchr(stop, '\n', (size_t)(end - stop));
+            stop = (eol != NULL) ? eol + 1 : end;
+        }
+        chunks[i].data = p;
+        chunks[i].size = (size_t)(stop - p);
+        chunks[i].status = OK;
+        p = stop;
+    }
+
+#ifdef GAME_MANAGEMENT_THREADS
+    pthread_t threads[LOAD_MAX_THREADS];
+    BOOL started[LOAD_MAX_THREADS] = {FALSE};
+
+    // The scanner chooses its instruction set once, before the threads use it
+    scan_get_isa();
+    for (int i = 1; i < n_threads; i++)
+        started[i] = (pthread_create(&threads[i], NULL, game_management_split_chunk, &chunks[i]) == 0) ? TRUE : FALSE;
+    game_management_split_chunk(&chunks[0]);
+    // A chunk without a thread is split here
+    for (int i = 1; i < n_threads; i++) {
+        if (started[i] == TRUE)
+            pthread_join(threads[i], NULL);
+        else
+            game_management_split_chunk(&chunks[i]);
+    }
+#else
+    for (int i = 0; i < n_threads; i++)
+        chunks[i].status = game_management_scan(chunks[i].data, chunks[i].size, game_management_keep_line, &chunks[i]);
+#endif
+
+    for (int i = 0; i < n_threads; i++) {
+        if (chunks[i].status == ERROR)
+            status = ERROR;
+    }
+    // Only now the lines are loaded, in order, so the links and inventories
+    // find the spaces and objects of the lines before them
+    for (int i = 0; i < n_threads && status == OK; i++) {
+        for (int k = 0; k < chunks[i].n_records; k++)
+            game_management_load_record(game, edges, &chunks[i].records[k], chunks[i].fields + chunks[i].records[k].first);
+    }
+
+    for (int i = 0; i < n_threads; i++) {
+        free(chunks[i].records);
+        free(chunks[i].fields);
+    }
+    return status;
+}
+
+static STATUS game_management_load_stream(const char* filename, Game* game, LoadEdges* edges) {
+    FILE* file = NULL;
+    char line[WORD_SIZE] = "";
+    unsigned int bars[WORD_SIZE];
+    LoadField fields[WORD_SIZE + 1];
+    LoadRecord r;
+    STATUS status = OK;
+
     file = fopen(filename, "r");
     if (file == NULL) {
         return ERROR;
     }
 
     while (fgets(line, WORD_SIZE, file)) {
-        if (strncmp("#s:", line, 3) == 0) {
-            game_load_space(game, line);
-        } else if (strncmp("#o:", line, 3) == 0) {
-            game_load_object(game, line);
-        } else if (strncmp("#p:", line, 3) == 0) {
-            game_load_player(game, line);
-        } else if (strncmp("#l:", line, 3) == 0) {
-            game_load_links(game, line);
-        } else if (strncmp("#i", line, 2) == 0) {
-			game_management_load_inventory(game, line);
-		} else if (strncmp("#d", line, 2) == 0) {
-			game_management_load_dice(game, line);
-		}
+        size_t len = strlen(line);
+        size_t n = scan_delimiters(line, len, bars, WORD_SIZE, NULL);
+        if (game_management_split_line(line, line, line + len, bars, (int)n, fields, &r) == TRUE)
+            game_management_load_record(game, edges, &r, fields);
     }
 
     if (ferror(file)) {
@@ -106,7 +713,107 @@ STATUS game_management_load(char* filename, Game* game) {
     return status;
 }
 
-STATUS game_management_save(char* filename, Game* game) {
+#ifdef GAME_MANAGEMENT_MMAP
+static const char* game_management_map(const char* filename, size_t* size) {
+    struct stat st;
+    void* data = MAP_FAILED;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // The mapping stays valid after closing the file
+    close(fd);
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+
+    posix_madvise(data, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+    *size = (size_t)st.st_size;
+    return (const char*)data;
+}
+
+static void game_management_unmap(const char* data, size_t size) {
+    munmap((void*)data, size);
+}
+#endif
+
+STATUS game_management_load(const char* filename, Game* game) {
+    STATUS status = OK;
+    LoadEdges edges;
+
+    if (!filename) {
+        return ERROR;
+    }
+
+    memset(&edges, 0, sizeof(LoadEdges));
+#ifdef GAME_MANAGEMENT_MMAP
+    size_t size = 0;
+    const char* data = game_management_map(filename, &size);
+    if (data != NULL) {
+        // The texts are interned straight from the mapping, nothing is copied per line.
+        // A compiled world is read in place, it only needs to be mapped
+        int n_threads = game_management_threads(size);
+        if (world_image_check(data, size) == TRUE && stream_regions >= 0) {
+            // The regions are read when the player gets near them, in any order
+            posix_madvise((void*)data, size, POSIX_MADV_RANDOM);
+            status = world_stream_open(data, size, game, stream_regions, game_management_unmap);
+            // The stream unmaps the file when the game is cleared
+            if (status == OK)
+                data = NULL;
+        } else if (world_image_check(data, size) == TRUE)
+            status = world_image_load(data, size, game);
+        else if (n_threads > 1)
+            status = game_management_load_parallel(game, &edges, data, size, n_threads);
+        else
+            status = game_management_load_block(game, &edges, data, size);
+        if (data != NULL)
+            game_management_unmap(data, size);
+    } else
+#endif
+        status = game_management_load_stream(filename, game, &edges);
+
+    // The links are named when every space is there, wherever their lines were
+    link_errors = (status == OK) ? game_management_resolve_links(game, &edges) : 0;
+    free(edges.edge);
+    // The rules are drawn from a table built once, not looked through every turn
+    if (status == OK)
+        status = game_compile_rules(game);
+    if (status == OK)
+        status = game_start_events(game);
+    if (status == OK)
+        status = game_compile_vocabulary(game);
+    // What was set while loading is not a change
+    if (status == OK)
+        game_mark_saved(game);
+
+    return status;
+}
+
+STATUS game_management_set_threads(int n_threads) {
+    if (n_threads < 0)
+        return ERROR;
+
+    load_threads = n_threads;
+    return OK;
+}
+
+int game_management_get_link_errors() {
+    return link_errors;
+}
+
+STATUS game_management_set_stream(int max_regions) {
+    if (max_regions < -1)
+        return ERROR;
+
+    stream_regions = max_regions;
+    return OK;
+}
+
+STATUS game_management_save(const char* filename, Game* game) {
 	FILE* out = fopen(filename, "w");
 	if (out == NULL) return ERROR;
 	
@@ -117,157 +824,110 @@ STATUS game_management_save(char* filename, Game* game) {
 	return OK;
 }
 
-STATUS game_load_space(Game* game, char* line) {
-    char name[WORD_SIZE] = "";
-    char* toks = NULL;
-    char first[8], second[8], third[8];
-    memset(first, '\0', 8);
-    memset(second, '\0', 8);
-    memset(third, '\0', 8);
-    Id id = NO_ID, north = NO_ID, east = NO_ID, south = NO_ID, west = NO_ID, up = NO_ID, down = NO_ID;
+STATUS game_load_world_size(Game* game, Fields* f) {
+    int n_spaces = 0, n_objects = 0;
+
+    n_spaces = (int)fields_long(f, -1);
+    if (n_spaces < 0)
+        return ERROR;
+    n_objects = (int)fields_long(f, 0);
+
+    return game_reserve(game, n_spaces, n_objects);
+}
+
+STATUS game_load_space(Game* game, Fields* f) {
+    const char* name = NULL;
+    const char* description = NULL;
+    const char* detailed_description = NULL;
+    const char* gdesc[3] = {NULL, NULL, NULL};
+    Id id = NO_ID;
+    Id exits[N_DIRECTIONS];
 	int illuminated = 0;
     Space* space = NULL;
     Link* link = NULL;
-    char description[WORD_SIZE+1];
-    char detailed_description[WORD_SIZE+1];
-
-    toks = strtok(line + 3, "|");
-    id = atol(toks);
-    toks = strtok(NULL, "|");
-    strcpy(name, toks);
-    toks = strtok(NULL, "|");
-    strcpy(description, toks);
-    toks = strtok(NULL, "|");
-    strcpy(detailed_description, toks);
-    toks = strtok(NULL, "|");
-    north = atol(toks);
-    toks = strtok(NULL, "|");
-    east = atol(toks);
-    toks = strtok(NULL, "|");
-    south = atol(toks);
-    toks = strtok(NULL, "|");
-    west = atol(toks);
-    toks = strtok(NULL, "|");
-	up = atol(toks);
-    toks = strtok(NULL, "|");
-	down = atol(toks);
-    toks = strtok(NULL, "|");
-	illuminated = atoi(toks);
-    toks = strtok(NULL, "|");
-    if (toks != NULL) {
-        strncpy(first, toks, 7);
-        toks = strtok(NULL, "|");
-        strncpy(second, toks, 7);
-        toks = strtok(NULL, "|");
-        strncpy(third, toks, 7);
+
+    id = fields_long(f, NO_ID);
+    name = fields_text(f, WORD_SIZE);
+    description = fields_text(f, WORD_SIZE);
+    detailed_description = fields_text(f, WORD_SIZE);
+    if (detailed_description == NULL)
+        return ERROR;
+    exits[NORTH] = fields_long(f, NO_ID);
+    exits[EAST] = fields_long(f, NO_ID);
+    exits[SOUTH] = fields_long(f, NO_ID);
+    exits[WEST] = fields_long(f, NO_ID);
+	exits[UP] = fields_long(f, NO_ID);
+	exits[DOWN] = fields_long(f, NO_ID);
+	illuminated = (int)fields_long(f, 0);
+    for (int i = 0; i < 3; i++) {
+        gdesc[i] = fields_text(f, 7);
     }
 
-    space = space_create(id);
+    space = space_create(game_get_arena(game), game_get_strings(game), id);
     if (space != NULL) {
-        space_set_name(space, name);
-        space_set_description(space,description);
-        space_set_detailed_description(space,detailed_description);
+        space_set_name(space, (char*)name);
+        space_set_description(space, (char*)description);
+        space_set_detailed_description(space, (char*)detailed_description);
 		space_set_illumination(space, illuminated);
-        if (north != NO_ID) {
-            link = link_create();
-            if (link == NULL)
-                return ERROR;
-            link_set_first_space(link, id);
-            link_set_second_space(link, north);
-			space_set_north(space, link);
+        for (int i = 0; i < N_DIRECTIONS; i++) {
+            if (exits[i] == NO_ID)
+                continue;
+            // One link per connection, the space loaded second reuses it
+            link = space_get_exit_to(game_get_space(game, exits[i]), id);
+            if (link == NULL) {
+                link = link_create(game_get_arena(game), game_get_strings(game));
+                if (link == NULL)
+                    return ERROR;
+                link_set_first_space(link, id);
+                link_set_second_space(link, exits[i]);
+                game_add_link(game, link);
+            }
+            space_set_exit(space, i, link);
         }
-		if (east != NO_ID) {
-            link = link_create();
-            if (link == NULL)
-                return ERROR;
-            link_set_first_space(link, id);
-            link_set_second_space(link, east);
-			space_set_east(space, link);
-        }
-		if (south != NO_ID) {
-            link = link_create();
-            if (link == NULL)
-                return ERROR;
-            link_set_first_space(link, id);
-            link_set_second_space(link, south);
-			space_set_south(space, link);
-		}
-		if (west != NO_ID) {
-            link = link_create();
-            if (link == NULL)
-                return ERROR;
-            link_set_first_space(link, id);
-            link_set_second_space(link, west);
-			space_set_west(space, link);
-		} if (up != NO_ID) {
-            link = link_create();
-            if (link == NULL)
-                return ERROR;
-            link_set_first_space(link, id);
-            link_set_second_space(link, up);
-			space_set_up(space, link);
-		} if (down != NO_ID) {
-            link = link_create();
-            if (link == NULL)
-                return ERROR;
-            link_set_first_space(link, id);
-            link_set_second_space(link, down);
-			space_set_down(space, link);
-		}
-        if (toks != NULL) {
-            space_set_gdesc(space, 0, first);
-            space_set_gdesc(space, 1, second);
-            space_set_gdesc(space, 2, third);
+        if (gdesc[0] != NULL) {
+            for (int i = 0; i < 3; i++) {
+                space_set_gdesc(space, i, (char*)(gdesc[i] != NULL ? gdesc[i] : ""));
+            }
         }
         game_add_space(game, space);
     }
     return OK;
 }
 
-STATUS game_load_object(Game* game, char* line) {
-    char* toks = NULL;
-    char name[WORD_SIZE] = "";
-	char description[4*WORD_SIZE] = "";
+STATUS game_load_object(Game* game, Fields* f) {
+    const char* name = NULL;
+	const char* description = NULL;
     Id id = NO_ID;
     Id space = NO_ID;
 
-    toks = strtok(line + 3, "|");
-    id = atol(toks);
-    toks = strtok(NULL, "|");
-    strcpy(name, toks);
-	toks = strtok(NULL, "|");
-    strcpy(description, toks);
-    toks = strtok(NULL, "|");
-    space = atol(toks);
+    id = fields_long(f, NO_ID);
+    name = fields_text(f, WORD_SIZE);
+    description = fields_text(f, 4*WORD_SIZE);
+    if (description == NULL)
+        return ERROR;
+    space = fields_long(f, NO_ID);
 
-    Object* obj = object_create(id);
+    Object* obj = object_create(game_get_arena(game), game_get_strings(game), id);
     if(obj == NULL)
         return ERROR;
     object_set_name(obj, name);
     object_set_location(obj, space);
-	object_set_description(obj, description);
+	object_set_description(obj, (char*)description);
 	
-    toks = strtok(NULL, "|");
-	if (atoi(toks) == 1)
+	if (fields_long(f, 0) == 1)
 		object_set_movable(obj, TRUE);
 	else
 		object_set_movable(obj, FALSE);
 
-	toks = strtok(NULL, "|");
-	id = atol(toks);
-	object_set_dependency(obj, id);
-	toks = strtok(NULL, "|");
-	id = atol(toks);
-	object_set_openLink(obj, id);
+	object_set_dependency(obj, fields_long(f, NO_ID));
+	object_set_openLink(obj, fields_long(f, NO_ID));
 
-	toks = strtok(NULL, "|");
-	if (atoi(toks) == 1)
+	if (fields_long(f, 0) == 1)
 		object_set_illuminate(obj, TRUE);
 	else
 		object_set_illuminate(obj, FALSE);
 
-	toks = strtok(NULL, "|");
-	if (atoi(toks) == 1)
+	if (fields_long(f, 0) == 1)
 		object_set_turnedOn(obj, TRUE);
 	else
 		object_set_turnedOn(obj, FALSE);
@@ -275,122 +935,164 @@ STATUS game_load_object(Game* game, char* line) {
     return game_add_object(game, obj);
 }
 
-STATUS game_load_player(Game* game, char* line) {
-    char* toks = NULL;
-    char name[WORD_SIZE] = "";
+STATUS game_load_player(Game* game, Fields* f) {
+    const char* name = NULL;
     Id id = NO_ID;
     Id space = NO_ID;
     int cap = 0;
 
-    toks = strtok(line + 3, "|");
-    id = atol(toks);
-    toks = strtok(NULL, "|");
-    strcpy(name, toks);
-    toks = strtok(NULL, "|");
-    space = atol(toks);
-    toks = strtok(NULL, "|");
-    cap = atoi(toks);
+    id = fields_long(f, NO_ID);
+    name = fields_text(f, WORD_SIZE);
+    space = fields_long(f, NO_ID);
+    cap = (int)fields_long(f, 0);
+    if (name == NULL)
+        return ERROR;
 
-    Player* p = player_create(id, cap);
+    Player* p = player_create(game_get_arena(game), id, cap);
     player_set_name(p, name);
     player_set_location(p, space);
 
     return game_set_player(game, p);
 }
 
-void modify_link(Link* link, Id id, char* name, int open) {
+void modify_link(Link* link, Id id, const char* name, int open) {
 	link_set_id(link, id);
-	link_set_name(link, name);
+	link_set_name(link, (char*)name);
 	if (open == 0) 
 		link_set_opened(link, TRUE);
 	else 
 		link_set_opened(link, FALSE);
 }
 
-BOOL cmp_link(Id id1, Id id2, Link* link) {
-	if ((link_get_first_space(link) == id1 && link_get_second_space(link) == id2)
-		|| (link_get_first_space(link) == id2 && link_get_second_space(link) == id1)) {
-			return TRUE;
+void complete_links(Game* game, Space* space, Id other, Id id, const char* name, int open) {
+	for (int i = 0; i < N_DIRECTIONS; i++) {
+		Link* link = space_get_exit(space, i);
+		if (link != NULL && link_get_destination(link, space_get_id(space)) == other) {
+			modify_link(link, id, name, open);
+			// Named now, so it can be found by name from this space
+			space_add_link(space, link);
+			game_index_link(game, link);
+		}
 	}
-	return FALSE;
 }
 
-void complete_links(Space* space, Id id1, Id id2, Id id, char* name, int open) {
-	if (cmp_link(id1, id2, space_get_north(space)) == TRUE) {
-		modify_link(space_get_north(space), id, name, open);
-	}
-	if (cmp_link(id1, id2, space_get_west(space)) == TRUE) {
-		modify_link(space_get_west(space), id, name, open);
-	}
-	if (cmp_link(id1, id2, space_get_south(space)) == TRUE) {
-		modify_link(space_get_south(space), id, name, open);
-	}
-	if (cmp_link(id1, id2, space_get_east(space)) == TRUE) {
-		modify_link(space_get_east(space), id, name, open);
-	}
-    if (cmp_link(id1, id2, space_get_up(space)) == TRUE) {
-		modify_link(space_get_up(space), id, name, open);
-	}
-    if (cmp_link(id1, id2, space_get_down(space)) == TRUE) {
-		modify_link(space_get_down(space), id, name, open);
+STATUS game_load_links(LoadEdges* edges, Fields* f) {
+    LoadEdge e;
+
+	e.id = fields_long(f, NO_ID);
+	e.name = fields_text(f, WORD_SIZE);
+	e.first = fields_long(f, NO_ID);
+	e.second = fields_long(f, NO_ID);
+	e.open = (int)fields_long(f, -1);
+	if (e.name == NULL) return ERROR;
+
+	if (edges->n == edges->capacity) {
+		int capacity = (edges->capacity > 0) ? 2 * edges->capacity : 64;
+		LoadEdge* edge = realloc(edges->edge, sizeof(LoadEdge) * capacity);
+		if (edge == NULL) return ERROR;
+		edges->edge = edge;
+		edges->capacity = capacity;
 	}
+	edges->edge[edges->n++] = e;
+
+    return OK;
 }
 
-STATUS game_load_links(Game* game, char* line) {
-	char* toks = NULL;
-    char name[WORD_SIZE] = "";
-    Id id = NO_ID, firstId = NO_ID, secondId = NO_ID;
-	int open = -1;
+int game_management_resolve_links(Game* game, LoadEdges* edges) {
+	IdTable* seen = NULL;
+	int errors = 0;
 
-	toks = strtok(line + 3, "|");
-	id = atol(toks);
-	toks = strtok(NULL, "|");
-	strcpy(name, toks);
-    toks = strtok(NULL, "|");
-	firstId = atol(toks);
-	toks = strtok(NULL, "|");
-	secondId = atol(toks);
-	toks = strtok(NULL, "|");
-	open = atoi(toks);
+	if (edges->n == 0) return 0;
+	// Only needed while resolving, it does not belong to the arena of the game
+	seen = id_table_create(NULL, edges->n);
+	if (seen == NULL) return edges->n;
 
-	Space* firstSpace = game_get_space(game, firstId);
-	Space* secondSpace = game_get_space(game, secondId);
-	if (firstSpace == NULL || secondSpace == NULL) return ERROR;
+	for (int i = 0; i < edges->n; i++) {
+		const LoadEdge* e = &edges->edge[i];
+		Space* firstSpace = game_get_space(game, e->first);
+		Space* secondSpace = game_get_space(game, e->second);
 
-	complete_links(firstSpace, firstId, secondId, id, name, open);
-	complete_links(secondSpace, secondId, firstId, id, name, open);
+		if (e->id != NO_ID && id_table_get(seen, e->id) != NULL) {
+			fprintf(stderr, "Link %ld is defined twice, the second one is left out\n", e->id);
+			errors++;
+			continue;
+		}
+		// The spaces made the link from their exits, a line only names it
+		if (firstSpace == NULL || secondSpace == NULL || space_get_exit_to(firstSpace, e->second) == NULL) {
+			fprintf(stderr, "Link %ld joins %ld and %ld, which have no exit between them\n", e->id, e->first, e->second);
+			errors++;
+			continue;
+		}
+		id_table_put(seen, e->id, (void*)e);
+		complete_links(game, firstSpace, e->second, e->id, e->name, e->open);
+		complete_links(game, secondSpace, e->first, e->id, e->name, e->open);
+	}
 
-    return OK;
+	id_table_destroy(&seen);
+	return errors;
 }
 
-STATUS game_management_load_inventory(Game* game, char* line) {
-	char* toks = NULL;
-    Id id = NO_ID;
-
-	toks = strtok(line + 3, "|");
-	while (toks != NULL) {
-		id = atol(toks);
-		player_add_object(game_get_player(game), game_get_object(game, id));
-		toks = strtok(NULL, "|");
+STATUS game_management_load_inventory(Game* game, Fields* f) {
+	// One object id per field. A carried object is not in the space it was taken from
+	while (f->next < f->n) {
+		Object* obj = game_get_object(game, fields_long(f, NO_ID));
+		if (player_add_object(game_get_player(game), obj) == OK)
+			space_remove_object(game_get_space(game, object_get_location(obj)), object_get_id(obj));
 	}
 	return OK;
 }
 
-STATUS game_management_load_dice(Game* game, char* line) {
-	char* toks = NULL;
+STATUS game_management_load_dice(Game* game, Fields* f) {
 	int last_roll = -1;
     int min = 0;
 	int max = 0;
 
-	toks = strtok(line + 3, "|");
-	last_roll = atoi(toks);
-	toks = strtok(NULL, "|");
-	min = atoi(toks);
-	toks = strtok(NULL, "|");
-	max = atoi(toks);
+	last_roll = (int)fields_long(f, 0);
+	min = (int)fields_long(f, 0);
+	max = (int)fields_long(f, 0);
 
-	Dice* dice = dice_create(min, max);
+	Dice* dice = dice_create(game_get_arena(game), min, max, game_get_rng(game));
 	dice_set_last_roll(dice, last_roll);
 	if (dice != NULL) game_set_dice(game, dice);
 	return OK;
-}
\ No newline at end of file
+}
+
+STATUS game_load_rule(Game* game, Fields* f) {
+    Rule rule;
+    const char* effect = fields_text(f, WORD_SIZE);
+
+    if (rule_effect_from_name(effect, &rule.effect) == ERROR) {
+        fprintf(stderr, "Rule %s is not an effect, it is left out\n", effect != NULL ? effect : "");
+        return ERROR;
+    }
+    rule.weight = (int)fields_long(f, 1);
+    rule.target = fields_long(f, NO_ID);
+    rule.first = fields_long(f, NO_ID);
+    rule.last = fields_long(f, NO_ID);
+    return game_add_rule(game, &rule);
+}
+
+STATUS game_load_event(Game* game, Fields* f) {
+    WorldEvent event;
+    const char* effect = fields_text(f, WORD_SIZE);
+
+    event.target = fields_long(f, NO_ID);
+    event.delay = fields_long(f, -1);
+    event.period = fields_long(f, 0);
+    if (game_event_from_names(effect, fields_text(f, WORD_SIZE), &event) == ERROR || game_add_event(game, &event) == ERROR) {
+        fprintf(stderr, "Event %s of %ld is not valid, it is left out\n", effect != NULL ? effect : "", event.target);
+        return ERROR;
+    }
+    return OK;
+}
+
+STATUS game_load_synonym(Game* game, Fields* f) {
+    const char* word = fields_text(f, WORD_SIZE);
+    const char* of = fields_text(f, WORD_SIZE);
+
+    if (game_add_synonym(game, word, of) == ERROR) {
+        fprintf(stderr, "Synonym %s of %s is not valid, it is left out\n", word != NULL ? word : "", of != NULL ? of : "");
+        return ERROR;
+    }
+    return OK;
+}
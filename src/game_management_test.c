@@ -1,25 +1,430 @@
-
-#include "../include/game.h"
+/**
+ * @brief It tests the game management module
+ *
+ * The tests load datanew.dat, so they are run from the root of the project.
+ * Two games are compared through their world images, which are the same
+ * byte by byte when the games are
+ *
+ * @file game_management_test.c
+ * @author Eva Moresova
+ * @version 1.0
+ * @date 26-05-2021
+ * @copyright GNU Public License
+ */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "../include/game.h"
+#include "../include/world_image.h"
+#include "../include/link.h"
+#include "../include/command.h"
+#include "../include/test.h"
+#include "../include/types.h"
+
+#define TEST_WORLD "datanew.dat"
+#define TEST_IMAGE_A "/tmp/game_management_test_a.gwc"
+#define TEST_IMAGE_B "/tmp/game_management_test_b.gwc"
+#define TEST_LINKS "/tmp/game_management_test_links.dat"
+
+/**
+ * @brief game loaded from a file with some number of threads
+ *
+ * @param filename name of the file
+ * @param n_threads threads to load it with
+ * @return the game, NULL if error
+ */
+static Game* load_game(char* filename, int n_threads) {
+    Game* game = game_init();
+
+    game_management_set_threads(n_threads);
+    if (game != NULL && game_create_from_file(game, filename) == ERROR) {
+        game_destroy(game);
+        game = NULL;
+    }
+    game_management_set_threads(0);
+    return game;
+}
+
+/**
+ * @brief TRUE if two files have the same contents
+ *
+ * @param a name of a file
+ * @param b name of the other file
+ * @return BOOL
+ */
+static BOOL same_file(const char* a, const char* b) {
+    FILE* fa = fopen(a, "rb");
+    FILE* fb = fopen(b, "rb");
+    BOOL same = (fa != NULL && fb != NULL) ? TRUE : FALSE;
+    int ca = 0, cb = 0;
+
+    while (same == TRUE && ca != EOF) {
+        ca = fgetc(fa);
+        cb = fgetc(fb);
+        if (ca != cb)
+            same = FALSE;
+    }
+    if (fa != NULL)
+        fclose(fa);
+    if (fb != NULL)
+        fclose(fb);
+    return same;
+}
+
+/**
+ * @brief TRUE if loading a file with some threads gives the same game as
+ * loading it with one
+ *
+ * @param filename name of the file
+ * @param n_threads threads to load it with
+ * @return BOOL
+ */
+static BOOL same_as_serial(char* filename, int n_threads) {
+    Game* serial = load_game(filename, 1);
+    Game* parallel = load_game(filename, n_threads);
+    BOOL same = FALSE;
+
+    if (serial != NULL && parallel != NULL &&
+        world_image_save(TEST_IMAGE_A, serial) == OK && world_image_save(TEST_IMAGE_B, parallel) == OK)
+        same = same_file(TEST_IMAGE_A, TEST_IMAGE_B);
+
+    if (serial != NULL)
+        game_destroy(serial);
+    if (parallel != NULL)
+        game_destroy(parallel);
+    remove(TEST_IMAGE_A);
+    remove(TEST_IMAGE_B);
+    return same;
+}
+
+/**
+ * @brief game loaded from some lines of a data file
+ *
+ * @param lines contents of the file
+ * @return the game, NULL if error
+ */
+static Game* load_lines(const char* lines) {
+    FILE* f = fopen(TEST_LINKS, "w");
+    Game* game = NULL;
+
+    if (f == NULL)
+        return NULL;
+    fputs(lines, f);
+    fclose(f);
+    game = load_game(TEST_LINKS, 1);
+    remove(TEST_LINKS);
+    return game;
+}
+
+void test_game_management_load() {
+    Game* game = load_game(TEST_WORLD, 1);
+    PRINT_TEST_RESULT(game != NULL && game_get_number_object(game) > 0 && game_get_player(game) != NULL);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_management_load_null() {
+    Game* game = game_init();
+    game_create(game);
+    PRINT_TEST_RESULT(game_management_load(NULL, game) == ERROR);
+    game_destroy(game);
+}
+
+void test_game_management_load_missing() {
+    Game* game = load_game("./saved_game.dat", 1);
+    PRINT_TEST_RESULT(game == NULL);
+}
+
+void test_game_management_set_threads() {
+    PRINT_TEST_RESULT(game_management_set_threads(4) == OK && game_management_set_threads(0) == OK);
+}
+
+void test_game_management_set_threads_negative() {
+    PRINT_TEST_RESULT(game_management_set_threads(-1) == ERROR);
+}
+
+void test_game_management_load_threads() {
+    PRINT_TEST_RESULT(same_as_serial(TEST_WORLD, 3) == TRUE);
+}
+
+void test_game_management_load_threads_many() {
+    // More threads than lines, some chunks are left empty
+    PRINT_TEST_RESULT(same_as_serial(TEST_WORLD, 16) == TRUE);
+}
 
+void test_game_management_set_stream() {
+    PRINT_TEST_RESULT(game_management_set_stream(-2) == ERROR && game_management_set_stream(-1) == OK);
+}
 
+void test_game_management_load_stream() {
+    Game* original = load_game(TEST_WORLD, 1);
+    Game* game = NULL;
+
+    // An image is streamed, a text file is still loaded whole
+    if (original != NULL && world_image_save(TEST_IMAGE_A, original) == OK && game_management_set_stream(1) == OK)
+        game = load_game(TEST_IMAGE_A, 1);
+    Game* text = load_game(TEST_WORLD, 1);
+    game_management_set_stream(-1);
+    PRINT_TEST_RESULT(game != NULL && game_get_stream(game) != NULL && text != NULL && game_get_stream(text) == NULL &&
+                      game_get_player_location(game) == game_get_player_location(original));
+
+    if (original != NULL)
+        game_destroy(original);
+    if (game != NULL)
+        game_destroy(game);
+    if (text != NULL)
+        game_destroy(text);
+    remove(TEST_IMAGE_A);
+}
+
+void test_game_management_links_first() {
+    // The links lines can come before the spaces they join
+    Game* game = load_lines("#l:7|Door|1|2|0|\n"
+                            "#s:1|One|First|First room|2|-1|-1|-1|-1|-1|1\n"
+                            "#s:2|Two|Second|Second room|-1|-1|1|-1|-1|-1|1\n"
+                            "#p:1|Goose|1|3|\n");
+    Link* link = (game != NULL) ? game_get_link_by_name(game, "Door") : NULL;
+    PRINT_TEST_RESULT(link != NULL && link_get_id(link) == 7 && link_get_opened(link) == TRUE &&
+                      game_management_get_link_errors() == 0);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_management_links_errors() {
+    // One line joins spaces without an exit between them, one repeats an id
+    Game* game = load_lines("#s:1|One|First|First room|2|-1|-1|-1|-1|-1|1\n"
+                            "#s:2|Two|Second|Second room|-1|-1|1|-1|-1|-1|1\n"
+                            "#s:3|Three|Third|Third room|-1|-1|-1|-1|-1|-1|1\n"
+                            "#p:1|Goose|1|3|\n"
+                            "#l:7|Door|1|2|1|\n"
+                            "#l:8|Ghost|1|3|0|\n"
+                            "#l:7|Again|2|1|0|\n");
+    Link* link = (game != NULL) ? game_get_link_by_name(game, "Door") : NULL;
+    PRINT_TEST_RESULT(link != NULL && link_get_opened(link) == FALSE && game_get_link_by_name(game, "Again") == NULL &&
+                      game_management_get_link_errors() == 2);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_management_rules() {
+    // Only a teleport happens in the first space, nothing at all in the second
+    Game* game = load_lines("#s:1|One|First|First room|-1|-1|-1|-1|-1|-1|1\n"
+                            "#s:2|Two|Second|Second room|-1|-1|-1|-1|-1|-1|1\n"
+                            "#p:1|Goose|1|3|\n"
+                            "#r:teleport|1|2|1|1|\n"
+                            "#r:none|1|\n"
+                            "#r:fly|1|\n");
+    BOOL right = (game != NULL) ? TRUE : FALSE;
+
+    for (int i = 0; i < 20 && right == TRUE; i++) {
+        if (rule_table_sample(game_get_rule_table(game), game_get_rng(game), 1, NULL) != TELEPORTRULE ||
+            rule_table_sample(game_get_rule_table(game), game_get_rng(game), 2, NULL) != NO_RULE)
+            right = FALSE;
+    }
+    PRINT_TEST_RESULT(right == TRUE && rule_table_count(game_get_rule_table(game)) == 2);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_management_rules_default() {
+    Game* game = load_lines("#s:1|One|First|First room|-1|-1|-1|-1|-1|-1|1\n"
+                            "#p:1|Goose|1|3|\n");
+    // A world without rules has the ones every world had
+    PRINT_TEST_RESULT(game != NULL && rule_table_count(game_get_rule_table(game)) == 6);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_management_events() {
+    // The light of the first space flickers, the door closes after being opened
+    Game* game = load_lines("#s:1|One|First|First room|2|-1|-1|-1|-1|-1|1\n"
+                            "#s:2|Two|Second|Second room|-1|-1|1|-1|-1|-1|1\n"
+                            "#p:1|Goose|1|3|\n"
+                            "#l:7|Door|1|2|1|\n"
+                            "#e:toggle|1|2|2|\n"
+                            "#e:close|7|3|0|open|\n"
+                            "#e:melt|7|3|\n");
+    BOOL lit[4];
+
+    for (int i = 0; i < 4 && game != NULL; i++) {
+        game_tick(game);
+        lit[i] = space_get_illumination(game_get_space(game, 1));
+    }
+    PRINT_TEST_RESULT(game != NULL && game_get_number_event(game) == 2 && timer_wheel_count(game_get_timers(game)) == 1 &&
+                      lit[0] == TRUE && lit[1] == FALSE && lit[2] == FALSE && lit[3] == TRUE);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_management_events_link() {
+    // The door closes by itself on the second turn
+    Game* game = load_lines("#s:1|One|First|First room|2|-1|-1|-1|-1|-1|1\n"
+                            "#s:2|Two|Second|Second room|-1|-1|1|-1|-1|-1|1\n"
+                            "#p:1|Goose|1|3|\n"
+                            "#l:7|Door|1|2|0|\n"
+                            "#e:close|7|2|0|\n");
+    BOOL opened[2] = {FALSE, TRUE};
+
+    for (int i = 0; i < 2 && game != NULL; i++) {
+        game_tick(game);
+        opened[i] = link_get_opened(game_get_link_at_position(game, 0));
+    }
+    PRINT_TEST_RESULT(game != NULL && opened[0] == TRUE && opened[1] == FALSE);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_management_commands() {
+    // The commands come from a buffer, not from the keyboard
+    Game* game = load_lines("#s:1|One|First|First room|-1|-1|-1|-1|-1|-1|1\n"
+                            "#o:1|keys|Keys|1|1|-1|-1|0|0\n"
+                            "#p:1|Goose|1|3|\n");
+    char take[] = "take keys";
+    char drop[] = "drop";
+    ParsedCommand cmd;
+    BOOL taken = FALSE, dropped = TRUE;
+
+    if (game != NULL && command_parse(take, NULL, &cmd) == OK && game_update(game, &cmd) == OK)
+        taken = player_has_object(game_get_player(game), 1);
+    if (game != NULL && command_parse(drop, NULL, &cmd) == OK && game_update(game, &cmd) == OK)
+        dropped = FALSE;
+    // A parsed line without words is no command and nothing happens
+    cmd.verb = NO_CMD;
+    PRINT_TEST_RESULT(taken == TRUE && dropped == TRUE && game_update(game, &cmd) == ERROR &&
+                      game_get_last_command(game) == NO_CMD);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_management_synonyms() {
+    // The words of the world mean what the ones every game knows mean
+    Game* game = load_lines("#s:1|One|First|First room|-1|-1|-1|-1|-1|-1|1\n"
+                            "#o:1|keys|Keys|1|1|-1|-1|0|0\n"
+                            "#p:1|Goose|1|3|\n"
+                            "#v:grab|take|\n"
+                            "#v:upstairs|up|\n");
+    char grab[] = "Grab keys";
+    ParsedCommand cmd;
+    BOOL taken = FALSE;
+
+    if (game != NULL && command_parse(grab, game_get_vocabulary(game), &cmd) == OK && game_update(game, &cmd) == OK)
+        taken = player_has_object(game_get_player(game), 1);
+    PRINT_TEST_RESULT(taken == TRUE && vocabulary_find(game_get_vocabulary(game), "upstairs", WORD_DIRECTION) == UP &&
+                      vocabulary_get_synonym(game_get_vocabulary(game), 2, NULL) == NULL);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_management_space_twice() {
+    // A repeated id finds the space loaded first, like the objects
+    Game* game = load_lines("#s:1|One|First|First room|-1|-1|-1|-1|-1|-1|1\n"
+                            "#s:1|Again|Second|Second room|-1|-1|-1|-1|-1|-1|1\n"
+                            "#p:1|Goose|1|3|\n");
+    PRINT_TEST_RESULT(game != NULL && game_get_number_space(game) == 2 &&
+                      strcmp(space_get_name(game_get_space(game, game_get_player_location(game))), "One") == 0);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_all() {
+    test_game_management_load();
+    test_game_management_load_null();
+    test_game_management_load_missing();
+    test_game_management_set_threads();
+    test_game_management_set_threads_negative();
+    test_game_management_load_threads();
+    test_game_management_load_threads_many();
+    test_game_management_set_stream();
+    test_game_management_load_stream();
+    test_game_management_links_first();
+    test_game_management_links_errors();
+    test_game_management_rules();
+    test_game_management_rules_default();
+    test_game_management_events();
+    test_game_management_commands();
+    test_game_management_synonyms();
+    test_game_management_space_twice();
+    test_game_management_events_link();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for GAME MANAGEMENT unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
 int main(int argc, char** argv) {
-	// Game* game = game_init();
-	// game_create(game);
-	// game_create_from_file(game, "./test_data.dat");
-	
-	// FILE* fout = fopen("./saved_game.dat", "w");
-	// game_save(fout, game);
-
-	Game* game1 = game_init();
-	game_create(game1);
-	game_create_from_file(game1, "./saved_game.dat");
-	
-	
-	game_destroy(game1);
-	//game_destroy(game);
-	//fclose(fout);
-	return 0;
-}
\ No newline at end of file
+    printf("Game management test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_game_management_load();
+                break;
+            case 2:
+                test_game_management_load_null();
+                break;
+            case 3:
+                test_game_management_load_missing();
+                break;
+            case 4:
+                test_game_management_set_threads();
+                break;
+            case 5:
+                test_game_management_set_threads_negative();
+                break;
+            case 6:
+                test_game_management_load_threads();
+                break;
+            case 7:
+                test_game_management_load_threads_many();
+                break;
+            case 8:
+                test_game_management_set_stream();
+                break;
+            case 9:
+                test_game_management_load_stream();
+                break;
+            case 10:
+                test_game_management_links_first();
+                break;
+            case 11:
+                test_game_management_links_errors();
+                break;
+            case 12:
+                test_game_management_rules();
+                break;
+            case 13:
+                test_game_management_rules_default();
+                break;
+            case 14:
+                test_game_management_events();
+                break;
+            case 15:
+                test_game_management_commands();
+                break;
+            case 16:
+                test_game_management_synonyms();
+                break;
+            case 17:
+                test_game_management_space_twice();
+                break;
+            case 18:
+                test_game_management_events_link();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
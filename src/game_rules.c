@@ -64,6 +64,22 @@ STATUS _game_rules_onlight_room(Game *game);
  */
 STATUS _game_rules_offlight_room(Game *game);
 
+/**
+ * @brief Suddenly switches the light of the current room
+ * 
+ * @param game Pointer to game
+ * @return STATUS 
+ */
+STATUS _game_rules_togglelight_room(Game *game);
+
+/**
+ * @brief Sends the player to the space the rule was drawn with
+ * 
+ * @param game Pointer to game
+ * @return STATUS 
+ */
+STATUS _game_rules_teleport(Game *game);
+
 /**********************************
  *        Public Functions        *
  *********************************/
@@ -102,6 +118,14 @@ STATUS game_rules_random_command(T_Rules rule, Game *game)
         return _game_rules_offlight_room(game);
         break;
 
+    case TOGGLERULE:
+        return _game_rules_togglelight_room(game);
+        break;
+
+    case TELEPORTRULE:
+        return _game_rules_teleport(game);
+        break;
+
     default:
 
         break;
@@ -119,7 +143,7 @@ STATUS _game_rules_take_first_object(Game *game)
 
     Space *space = NULL;
     Player *player = NULL;
-    Id *ids = NULL;
+    const Id *ids = NULL;
     Id id = NO_ID;
     Inventory *inv = NULL;
 
@@ -135,7 +159,7 @@ STATUS _game_rules_take_first_object(Game *game)
     if ((space_objects_count(space) > 0) && (player_inventory_full(player) == FALSE))
     {
         // Gets set of IDS in the space
-        ids = space_get_objects(space);
+        ids = space_objects_view(space, NULL);
         if (!ids)
         {
             return ERROR;
@@ -145,7 +169,6 @@ STATUS _game_rules_take_first_object(Game *game)
         // If the ID is NO_ID there's a problem
         if (id == NO_ID)
         {
-            free(ids);
             return ERROR;
         }
 
@@ -153,7 +176,6 @@ STATUS _game_rules_take_first_object(Game *game)
         inv = player_get_inventory(player);
         if (!inv)
         {
-            free(ids);
             return ERROR;
         }
 
@@ -172,17 +194,14 @@ STATUS _game_rules_take_first_object(Game *game)
 
     if (space_remove_object(space, id) == ERROR)
     {
-        free(ids);
         return ERROR;
     }
 
     if (inventory_add_id(inv, id) == ERROR)
     {
-        free(ids);
         return ERROR;
     }
 
-    free(ids);
     return OK;
 }
 
@@ -201,7 +220,7 @@ STATUS _game_rules_drop_first_object(Game *game)
 {
     Space *space = NULL;
     Player *player = NULL;
-    Id *ids = NULL;
+    const Id *ids = NULL;
     Id id = NO_ID;
     Inventory *inv = NULL;
 
@@ -220,7 +239,7 @@ STATUS _game_rules_drop_first_object(Game *game)
 
     if (inventory_isEmpty(inv) == FALSE)
     {
-        ids = inventory_get_elements(inv);
+        ids = inventory_view(inv, NULL);
         if (!ids)
         {
             return ERROR;
@@ -229,16 +248,16 @@ STATUS _game_rules_drop_first_object(Game *game)
 
         if (id != NO_ID)
         {
-            free(ids);
             if (space_add_object(space, id) == ERROR)
                 return ERROR;
             if (inventory_del_id(inv, id) == ERROR)
                 return ERROR;
+            // Like a dropped object, so a saved game puts it back here
+            object_set_location(game_get_object(game, id), space_get_id(space));
 
             return OK;
         }
 
-        free(ids);
         return ERROR;
     }
 
@@ -288,3 +307,26 @@ STATUS _game_rules_offlight_room(Game *game)
 
     return ERROR;
 }
+
+STATUS _game_rules_togglelight_room(Game *game)
+{
+    Space *space;
+
+    space = game_get_space(game, game_get_player_location(game));
+    if (!space)
+        return ERROR;
+
+    return space_set_illumination(space, !space_get_illumination(space));
+}
+
+STATUS _game_rules_teleport(Game *game)
+{
+    Id target;
+
+    target = game_get_last_rule_target(game);
+    // A rule of the world may name a space that is not in it
+    if (!game_get_space(game, target))
+        return ERROR;
+
+    return player_set_location(game_get_player(game), target);
+}
@@ -0,0 +1,1599 @@
+/**
+ * @brief It implements the saved game format. A save is a header followed
+ * by its sections, in this order: location of each object, number of
+ * objects in each space, the objects in the spaces, the inventory and the
+ * bits of the illuminated spaces, opened links and turned on objects.
+ * Spaces, links and objects are taken in order of id, so the positions in
+ * a save do not depend on the order the world was loaded in. That order and
+ * the world hash are worked out once per world and kept in the game. A
+ * streamed world is ordered from its image: what is not in memory is saved
+ * as the image has it, and only the regions a save changes are built to
+ * restore it.
+ *
+ * A journal is a save followed by deltas. Each delta is a header and a run
+ * of records of int64_t words, one record for each space, link, object or
+ * the player changed since the previous one was appended, found from the
+ * dirty list of the game:
+ *   space:  DELTA_SPACE, position, illuminated, n, n positions of objects
+ *   link:   DELTA_LINK, position, opened
+ *   object: DELTA_OBJECT, position, location, turned on
+ *   player: DELTA_PLAYER, location, n, n positions of objects
+ * Reading stops at the first delta that is not whole, so a write cut in
+ * the middle loses that delta and nothing else
+ *
+ * @file game_state.c
+ * @author Jiri Zak
+ * @version 2.0
+ * @date 27-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/game_state.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/dirty_list.h"
+#include "../include/world_image.h"
+
+#define STATE_MAGIC "GOOSESV"
+#define STATE_VERSION 1
+/* written as is, a save from a machine with other byte order is rejected */
+#define STATE_ORDER 0x01020304u
+#define STATE_ALIGN 8
+/* FNV-1a, for the world hash and the checksum */
+#define STATE_FNV_BASIS 14695981039346656037ull
+#define STATE_FNV_PRIME 1099511628211ull
+#define JOURNAL_MAGIC "GOOSEJR"
+/* a journal is written again as a single save once it is this many times
+   the size of the save it starts with */
+#define JOURNAL_COMPACT 4
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t order;
+    uint64_t size;              // bytes of the whole save
+    uint64_t world;             // game_state_world_hash of the world it was saved from
+    uint64_t checksum;          // of the whole save with this field set to 0
+    int64_t player_location;
+    int32_t dice_last;
+    uint32_t n_spaces;
+    uint32_t n_links;
+    uint32_t n_objects;
+    uint32_t n_inventory;
+    uint32_t n_held;            // objects in the spaces, as many as the counts add up to
+} StateHeader;
+
+typedef struct {
+    char magic[8];
+    uint64_t size;              // bytes of the delta, this header included
+    uint64_t world;             // game_state_world_hash of the world, as in the save
+    uint64_t checksum;          // of the whole delta with this field set to 0
+    int32_t dice_last;
+    uint32_t n_records;
+} StateDelta;
+
+/* kinds of the records of a delta */
+typedef enum {
+    DELTA_SPACE = 1,
+    DELTA_LINK,
+    DELTA_OBJECT,
+    DELTA_PLAYER
+} DeltaKind;
+
+/* growable run of words of a delta */
+typedef struct {
+    int64_t *word;
+    size_t n;
+    size_t capacity;
+} StateWords;
+
+/* what orders a space, link or object and identifies it in the world hash */
+typedef struct {
+    Id id;
+    Id first;                   // spaces of a link
+    Id second;
+    Id location;                // location of an object, as the image has it if the world is streamed
+    const char *name;           // name of an object
+    Id exits[N_DIRECTIONS];     // space each exit of a space leads to
+    int position;               // in the game or in the image
+} StateKey;
+
+/* the entities of a world in order of id, kept by the game until they change */
+struct _StateView {
+    WorldStream *ws;    // stream of the world, NULL if it is all in memory
+    Space **spaces;     // the entities, if the world is all in memory
+    Link **links;
+    Object **objects;
+    int *space_at;      // position in the image of each one, if the world is streamed
+    int *link_at;
+    int *object_at;
+    Id *space_ids;      // id of each space, to find its position
+    Id *object_ids;     // id of each object, to find its position
+    StateKey *link_keys;    // key of each link, to find its position by its id and spaces
+    int *held_first;    // per space and one more, first of its objects in held, if the world is streamed
+    int *held;          // positions of the objects the image puts in each space, space after space
+    int n_spaces;
+    int n_links;
+    int n_objects;
+    uint64_t hash;      // hash of the world
+};
+
+/* where each section of a save starts */
+typedef struct {
+    int64_t *location;      // per object
+    uint32_t *counts;       // per space, objects in it
+    uint32_t *held;         // position of each object in a space, space after space
+    uint32_t *inventory;    // position of each object of the inventory
+    uint8_t *lit;           // a bit per space
+    uint8_t *opened;        // a bit per link
+    uint8_t *on;            // a bit per object
+} StateSections;
+
+struct _GameJournal {
+    char *filename;
+    uint64_t world;     // hash of the world
+    size_t base;        // bytes of the save the journal starts with
+    size_t size;        // bytes of the whole journal
+    int dice_last;      // last roll written
+};
+
+/* an entity of a delta, by its kind and its position in the view */
+typedef struct {
+    DeltaKind kind;
+    int position;
+} StateChange;
+
+/**
+ * @brief compares keys by id and then by their spaces, for qsort. Two
+ * links between the same spaces can share an id
+ */
+static int state_key_compare(const void *a, const void *b);
+
+/**
+ * @brief position of a key in keys sorted by id
+ *
+ * @param keys sorted keys
+ * @param n number of keys
+ * @param id id looked for
+ * @return the position or -1 if there is no such key
+ */
+static int state_key_find(const StateKey *keys, int n, Id id);
+
+/**
+ * @brief keys of the spaces, links and objects of a game, in the order
+ * they were added
+ *
+ * @param game pointer to game with the whole world in memory
+ * @param spaces set to a key per space
+ * @param links set to a key per link
+ * @param objects set to a key per object
+ */
+static void state_keys_game(Game *game, StateKey *spaces, StateKey *links, StateKey *objects);
+
+/**
+ * @brief keys of the spaces, links and objects of a streamed world, in the
+ * order of its image. Nothing is built
+ *
+ * @param v view with the stream and the numbers of each
+ * @param spaces set to a key per space
+ * @param links set to a key per link
+ * @param objects set to a key per object
+ * @return STATUS ERROR = 0 if a record is not valid, OK = 1
+ */
+static STATUS state_keys_stream(const StateView *v, StateKey *spaces, StateKey *links, StateKey *objects);
+
+/**
+ * @brief makes the view of the world of a game
+ *
+ * @param game pointer to game
+ * @return the view or NULL if there is no memory
+ */
+static StateView *state_view_create(Game *game);
+
+/**
+ * @brief the view of the world of a game, made the first time it is needed
+ *
+ * @param game pointer to game
+ * @return the view or NULL if there is no memory
+ */
+static StateView *state_view(Game *game);
+
+/**
+ * @brief position of an id in ids sorted in increasing order
+ *
+ * @param ids sorted ids
+ * @param n number of ids
+ * @param id id looked for
+ * @return the position or -1 if it is not there
+ */
+static int state_id_find(const Id *ids, int n, Id id);
+
+/**
+ * @brief position of a space in a view
+ *
+ * @param v view
+ * @param id id of the space
+ * @return the position or -1 if there is no such space
+ */
+static int state_space_find(const StateView *v, Id id);
+
+/**
+ * @brief first position of a link in a view. Two links between the same
+ * spaces can share an id, the ones right after it may have its key too
+ *
+ * @param v view
+ * @param id id of the link, NO_ID if it has none
+ * @param first its first space
+ * @param second its second space
+ * @return the position or -1 if there is no such link
+ */
+static int state_link_find(const StateView *v, Id id, Id first, Id second);
+
+/**
+ * @brief position of an object in a view
+ *
+ * @param v view
+ * @param id id of the object
+ * @return the position or -1 if there is no such object
+ */
+static int state_object_find(const StateView *v, Id id);
+
+/**
+ * @brief space at a position of a view
+ *
+ * @param game pointer to game
+ * @param v view
+ * @param i position in order of id
+ * @param build TRUE to build its region if it is not in memory
+ * @return the space, NULL if it is not in memory
+ */
+static Space *state_space_at(Game *game, const StateView *v, int i, BOOL build);
+
+/**
+ * @brief link at a position of a view
+ *
+ * @param game pointer to game
+ * @param v view
+ * @param i position in order of id
+ * @param build TRUE to build the region of its first space if it is not in memory
+ * @return the link, NULL if it is not in memory
+ */
+static Link *state_link_at(Game *game, const StateView *v, int i, BOOL build);
+
+/**
+ * @brief object at a position of a view
+ *
+ * @param game pointer to game
+ * @param v view
+ * @param i position in order of id
+ * @param build TRUE to build its region if it is not in memory
+ * @return the object, NULL if it is not in memory
+ */
+static Object *state_object_at(Game *game, const StateView *v, int i, BOOL build);
+
+/**
+ * @brief adds bytes to a FNV-1a hash
+ *
+ * @param hash hash so far
+ * @param data bytes
+ * @param size number of bytes
+ * @return the new hash
+ */
+static uint64_t state_fnv(uint64_t hash, const void *data, size_t size);
+
+/**
+ * @brief adds a number to a FNV-1a hash
+ */
+static uint64_t state_fnv_id(uint64_t hash, Id id);
+
+/**
+ * @brief hash of a world from the keys of its spaces, links and objects,
+ * each sorted by id
+ */
+static uint64_t state_world_hash(const StateKey *spaces, int n_spaces, const StateKey *links, int n_links,
+                                 const StateKey *objects, int n_objects);
+
+/**
+ * @brief bytes a section takes, rounded up to STATE_ALIGN
+ */
+static size_t state_round(size_t size);
+
+/**
+ * @brief size of a save and where its sections are
+ *
+ * @param h header with the counts
+ * @param base start of the save, NULL to only get the size
+ * @param s set to the sections, can be NULL
+ * @return bytes of the whole save
+ */
+static size_t state_layout(const StateHeader *h, char *base, StateSections *s);
+
+/**
+ * @brief checksum of a save or a delta, the checksum field counts as 0
+ *
+ * @param data start of the save or delta
+ * @param size bytes of the save or delta
+ * @param at offset of the checksum field
+ * @return the checksum
+ */
+static uint64_t state_checksum(const char *data, size_t size, size_t at);
+
+/**
+ * @brief checks a save against the world it is restored on
+ *
+ * @param data start of the save, aligned to 8 bytes
+ * @param size bytes of the save
+ * @param v view of the world
+ * @return TRUE if it can be restored
+ */
+static BOOL state_valid(const char *data, size_t size, const StateView *v);
+
+/**
+ * @brief empties the set of objects of a space
+ *
+ * @param space pointer to space
+ */
+static void state_space_clear(Space *space);
+
+/**
+ * @brief takes every object out of an inventory
+ *
+ * @param inv pointer to inventory
+ */
+static void state_inventory_clear(Inventory *inv);
+
+/**
+ * @brief TRUE if a space of a streamed world is saved as its image has it,
+ * so it does not need to be built to be restored
+ *
+ * @param v view
+ * @param i position of the space in order of id
+ * @param lit saved illumination
+ * @param held saved positions of its objects
+ * @param n number of objects
+ * @return BOOL
+ */
+static BOOL state_space_as_image(const StateView *v, int i, BOOL lit, const uint32_t *held, uint32_t n);
+
+/**
+ * @brief writes a save of a game
+ *
+ * @param filename name of the file
+ * @param game pointer to game
+ * @param v view of the world of the game
+ * @param size set to the bytes written, can be NULL
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS state_snapshot_write(const char *filename, Game *game, const StateView *v, size_t *size);
+
+/**
+ * @brief adds a word to a delta
+ *
+ * @param words words so far
+ * @param word the word
+ * @return STATUS ERROR = 0 if there is no memory, OK = 1
+ */
+static STATUS state_words_add(StateWords *words, int64_t word);
+
+/**
+ * @brief adds the positions of some objects to a delta
+ *
+ * @param words words so far
+ * @param v view of the world
+ * @param ids ids of the objects
+ * @param n number of ids
+ * @return STATUS ERROR = 0 if there is no memory or an object is not in
+ * the world, OK = 1
+ */
+static STATUS state_words_add_objects(StateWords *words, const StateView *v, const Id *ids, int n);
+
+/**
+ * @brief compares changes by kind and then by position, for qsort
+ */
+static int state_change_compare(const void *a, const void *b);
+
+/**
+ * @brief changes of an entry of a dirty list: the position of its entity
+ * in a view, or of each link with its key, as which of them changed is
+ * not known. None if it was taken out of the world
+ *
+ * @param v view
+ * @param e entry
+ * @param c set to the changes if not NULL
+ * @return the number of changes
+ */
+static int state_entry_changes(const StateView *v, const DirtyEntry *e, StateChange *c);
+
+/**
+ * @brief the entities of the dirty list of a game by their position in a
+ * view, in order of kind and position and each of them once
+ *
+ * @param game pointer to game
+ * @param v view
+ * @param changes set to the changes, to be freed
+ * @param n set to the number of them
+ * @return STATUS ERROR = 0 if there is no memory, OK = 1
+ */
+static STATUS state_changes(Game *game, const StateView *v, StateChange **changes, int *n);
+
+/**
+ * @brief adds the record of a change to a delta and marks the entity
+ * clean. One that is not in memory is written as the image has it
+ *
+ * @param words run of words of the delta
+ * @param game pointer to game
+ * @param v view
+ * @param c change
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS state_words_add_change(StateWords *words, Game *game, const StateView *v, const StateChange *c);
+
+/**
+ * @brief checks a delta and, if a game is given, applies it
+ *
+ * @param data start of the delta, aligned to 8 bytes
+ * @param size bytes from the start of the delta to the end of the file
+ * @param world hash of the world of the save the delta follows
+ * @param v view of the world
+ * @param game pointer to game to apply it to, NULL to only check it
+ * @return bytes of the delta, 0 if it is not whole or not valid
+ */
+static size_t state_delta_read(const char *data, size_t size, uint64_t world, const StateView *v, Game *game);
+
+/**
+ * @brief writes the journal again as a single save, first to a temporary
+ * file that then takes its place
+ *
+ * @param j journal
+ * @param game pointer to game
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS state_journal_compact(GameJournal *j, Game *game);
+
+static int state_key_compare(const void *a, const void *b)
+{
+    const StateKey *x = a;
+    const StateKey *y = b;
+
+    if (x->id != y->id)
+        return (x->id > y->id) ? 1 : -1;
+    if (x->first != y->first)
+        return (x->first > y->first) ? 1 : -1;
+    return (x->second > y->second) - (x->second < y->second);
+}
+
+static int state_key_find(const StateKey *keys, int n, Id id)
+{
+    int low = 0, high = n - 1;
+
+    while (low <= high)
+    {
+        int mid = low + (high - low) / 2;
+        if (keys[mid].id == id)
+            return mid;
+        if (keys[mid].id < id)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+    return -1;
+}
+
+static void state_keys_game(Game *game, StateKey *spaces, StateKey *links, StateKey *objects)
+{
+    for (int i = 0; i < game_get_number_space(game); i++)
+    {
+        Space *space = game_get_space_at_position(game, i);
+        spaces[i].id = space_get_id(space);
+        spaces[i].first = spaces[i].second = spaces[i].location = NO_ID;
+        spaces[i].name = NULL;
+        for (int d = 0; d < N_DIRECTIONS; d++)
+            spaces[i].exits[d] = link_get_destination(space_get_exit(space, (T_Direction)d), spaces[i].id);
+        spaces[i].position = i;
+    }
+    for (int i = 0; i < game_get_number_link(game); i++)
+    {
+        Link *link = game_get_link_at_position(game, i);
+        links[i].id = link_get_id(link);
+        links[i].first = link_get_first_space(link);
+        links[i].second = link_get_second_space(link);
+        links[i].location = NO_ID;
+        links[i].name = NULL;
+        links[i].position = i;
+    }
+    for (int i = 0; i < game_get_number_object(game); i++)
+    {
+        Object *o = game_get_object_at_position(game, i);
+        objects[i].id = object_get_id(o);
+        objects[i].first = objects[i].second = NO_ID;
+        objects[i].location = object_get_location(o);
+        objects[i].name = object_get_name(o);
+        objects[i].position = i;
+    }
+}
+
+static STATUS state_keys_stream(const StateView *v, StateKey *spaces, StateKey *links, StateKey *objects)
+{
+    StreamRecord r;
+
+    for (int i = 0; i < v->n_spaces; i++)
+    {
+        if (world_stream_get_space_record(v->ws, i, &r) == ERROR)
+            return ERROR;
+        spaces[i].id = r.id;
+        spaces[i].first = spaces[i].second = spaces[i].location = NO_ID;
+        spaces[i].name = NULL;
+        memcpy(spaces[i].exits, r.exits, sizeof(r.exits));
+        spaces[i].position = i;
+    }
+    for (int i = 0; i < v->n_links; i++)
+    {
+        if (world_stream_get_link_record(v->ws, i, &r) == ERROR)
+            return ERROR;
+        links[i].id = r.id;
+        links[i].first = r.first;
+        links[i].second = r.second;
+        links[i].location = NO_ID;
+        links[i].name = NULL;
+        links[i].position = i;
+    }
+    for (int i = 0; i < v->n_objects; i++)
+    {
+        if (world_stream_get_object_record(v->ws, i, &r) == ERROR)
+            return ERROR;
+        objects[i].id = r.id;
+        objects[i].first = objects[i].second = NO_ID;
+        objects[i].location = r.first;
+        objects[i].name = r.name;
+        objects[i].position = i;
+    }
+    return OK;
+}
+
+static StateView *state_view_create(Game *game)
+{
+    StateView *v = calloc(1, sizeof(StateView));
+    StateKey *spaces = NULL, *links = NULL, *objects = NULL;
+    STATUS status = OK;
+
+    if (v == NULL)
+        return NULL;
+    v->ws = game_get_stream(game);
+    if (v->ws == NULL)
+    {
+        v->n_spaces = game_get_number_space(game);
+        v->n_links = game_get_number_link(game);
+        v->n_objects = game_get_number_object(game);
+    }
+    else if (world_stream_get_size(v->ws, &v->n_spaces, &v->n_links, &v->n_objects) == ERROR)
+        status = ERROR;
+
+    spaces = malloc(sizeof(StateKey) * (v->n_spaces + 1));
+    links = malloc(sizeof(StateKey) * (v->n_links + 1));
+    objects = malloc(sizeof(StateKey) * (v->n_objects + 1));
+    v->space_ids = malloc(sizeof(Id) * (v->n_spaces + 1));
+    v->object_ids = malloc(sizeof(Id) * (v->n_objects + 1));
+    if (spaces == NULL || links == NULL || objects == NULL || v->space_ids == NULL || v->object_ids == NULL)
+        status = ERROR;
+    if (status == OK && v->ws == NULL)
+        state_keys_game(game, spaces, links, objects);
+    else if (status == OK)
+        status = state_keys_stream(v, spaces, links, objects);
+
+    if (status == OK)
+    {
+        qsort(spaces, v->n_spaces, sizeof(StateKey), state_key_compare);
+        qsort(links, v->n_links, sizeof(StateKey), state_key_compare);
+        qsort(objects, v->n_objects, sizeof(StateKey), state_key_compare);
+        v->hash = state_world_hash(spaces, v->n_spaces, links, v->n_links, objects, v->n_objects);
+        for (int i = 0; i < v->n_spaces; i++)
+            v->space_ids[i] = spaces[i].id;
+        for (int i = 0; i < v->n_objects; i++)
+            v->object_ids[i] = objects[i].id;
+    }
+
+    if (status == OK && v->ws == NULL)
+    {
+        v->spaces = malloc(sizeof(Space *) * (v->n_spaces + 1));
+        v->links = malloc(sizeof(Link *) * (v->n_links + 1));
+        v->objects = malloc(sizeof(Object *) * (v->n_objects + 1));
+        if (v->spaces == NULL || v->links == NULL || v->objects == NULL)
+            status = ERROR;
+        for (int i = 0; i < v->n_spaces && status == OK; i++)
+            v->spaces[i] = game_get_space_at_position(game, spaces[i].position);
+        for (int i = 0; i < v->n_links && status == OK; i++)
+            v->links[i] = game_get_link_at_position(game, links[i].position);
+        for (int i = 0; i < v->n_objects && status == OK; i++)
+            v->objects[i] = game_get_object_at_position(game, objects[i].position);
+    }
+    else if (status == OK)
+    {
+        v->space_at = malloc(sizeof(int) * (v->n_spaces + 1));
+        v->link_at = malloc(sizeof(int) * (v->n_links + 1));
+        v->object_at = malloc(sizeof(int) * (v->n_objects + 1));
+        v->held_first = calloc(v->n_spaces + 2, sizeof(int));
+        v->held = malloc(sizeof(int) * (v->n_objects + 1));
+        if (v->space_at == NULL || v->link_at == NULL || v->object_at == NULL || v->held_first == NULL || v->held == NULL)
+            status = ERROR;
+        for (int i = 0; i < v->n_spaces && status == OK; i++)
+            v->space_at[i] = spaces[i].position;
+        for (int i = 0; i < v->n_links && status == OK; i++)
+            v->link_at[i] = links[i].position;
+        for (int i = 0; i < v->n_objects && status == OK; i++)
+            v->object_at[i] = objects[i].position;
+
+        // The objects the image puts in each space, for the spaces that
+        // are not in memory: counted in held_first[space + 2], then summed
+        // so each space fills its run moving held_first[space + 1]
+        for (int i = 0; i < v->n_objects && status == OK; i++)
+        {
+            int space = state_key_find(spaces, v->n_spaces, objects[i].location);
+            if (space >= 0)
+                v->held_first[space + 2]++;
+        }
+        for (int i = 2; i < v->n_spaces + 2 && status == OK; i++)
+            v->held_first[i] += v->held_first[i - 1];
+        for (int i = 0; i < v->n_objects && status == OK; i++)
+        {
+            int space = state_key_find(spaces, v->n_spaces, objects[i].location);
+            if (space >= 0)
+                v->held[v->held_first[space + 1]++] = i;
+        }
+    }
+
+    // The links are kept whole, a link is found by its spaces as well
+    v->link_keys = links;
+    free(spaces);
+    free(objects);
+    if (status == ERROR)
+        game_state_view_destroy(&v);
+    return v;
+}
+
+static StateView *state_view(Game *game)
+{
+    StateView *v = game_get_state_view(game);
+
+    if (v == NULL && (v = state_view_create(game)) != NULL && game_set_state_view(game, v) == ERROR)
+        game_state_view_destroy(&v);
+    return v;
+}
+
+STATUS game_state_view_destroy(StateView **v)
+{
+    if (v == NULL || *v == NULL)
+        return ERROR;
+
+    free((*v)->spaces);
+    free((*v)->links);
+    free((*v)->objects);
+    free((*v)->space_at);
+    free((*v)->link_at);
+    free((*v)->object_at);
+    free((*v)->space_ids);
+    free((*v)->object_ids);
+    free((*v)->link_keys);
+    free((*v)->held_first);
+    free((*v)->held);
+    free(*v);
+    *v = NULL;
+    return OK;
+}
+
+static int state_id_find(const Id *ids, int n, Id id)
+{
+    int low = 0, high = n - 1;
+
+    while (low <= high)
+    {
+        int mid = low + (high - low) / 2;
+        if (ids[mid] == id)
+            return mid;
+        if (ids[mid] < id)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+    return -1;
+}
+
+static int state_space_find(const StateView *v, Id id)
+{
+    return state_id_find(v->space_ids, v->n_spaces, id);
+}
+
+static int state_link_find(const StateView *v, Id id, Id first, Id second)
+{
+    StateKey key;
+    const StateKey *found = NULL;
+
+    key.id = id;
+    key.first = first;
+    key.second = second;
+    found = bsearch(&key, v->link_keys, v->n_links, sizeof(StateKey), state_key_compare);
+    while (found != NULL && found > v->link_keys && state_key_compare(found - 1, &key) == 0)
+        found--;
+    return (found != NULL) ? (int)(found - v->link_keys) : -1;
+}
+
+static int state_object_find(const StateView *v, Id id)
+{
+    return state_id_find(v->object_ids, v->n_objects, id);
+}
+
+static Space *state_space_at(Game *game, const StateView *v, int i, BOOL build)
+{
+    StreamRecord r;
+    Space *space = NULL;
+
+    if (v->ws == NULL)
+        return v->spaces[i];
+    space = world_stream_get_space_at(v->ws, v->space_at[i]);
+    if (space == NULL && build == TRUE && world_stream_get_space_record(v->ws, v->space_at[i], &r) == OK)
+        space = game_get_space(game, r.id);
+    return space;
+}
+
+static Link *state_link_at(Game *game, const StateView *v, int i, BOOL build)
+{
+    StreamRecord r;
+    Link *link = NULL;
+
+    if (v->ws == NULL)
+        return v->links[i];
+    link = world_stream_get_link_at(v->ws, v->link_at[i]);
+    // A link is built with the region of either of its spaces
+    if (link == NULL && build == TRUE && world_stream_get_link_record(v->ws, v->link_at[i], &r) == OK)
+    {
+        game_get_space(game, r.first);
+        if ((link = world_stream_get_link_at(v->ws, v->link_at[i])) == NULL)
+        {
+            game_get_space(game, r.second);
+            link = world_stream_get_link_at(v->ws, v->link_at[i]);
+        }
+    }
+    return link;
+}
+
+static Object *state_object_at(Game *game, const StateView *v, int i, BOOL build)
+{
+    Object *o = NULL;
+
+    if (v->ws == NULL)
+        return v->objects[i];
+    o = world_stream_get_object_at(v->ws, v->object_at[i]);
+    if (o == NULL && build == TRUE)
+        o = game_get_object(game, v->object_ids[i]);
+    return o;
+}
+
+static uint64_t state_fnv(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *p = data;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= p[i];
+        hash *= STATE_FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint64_t state_fnv_id(uint64_t hash, Id id)
+{
+    int64_t n = (int64_t)id;
+    return state_fnv(hash, &n, sizeof(n));
+}
+
+static uint64_t state_world_hash(const StateKey *spaces, int n_spaces, const StateKey *links, int n_links,
+                                 const StateKey *objects, int n_objects)
+{
+    uint64_t hash = STATE_FNV_BASIS;
+
+    hash = state_fnv_id(hash, n_spaces);
+    hash = state_fnv_id(hash, n_links);
+    hash = state_fnv_id(hash, n_objects);
+    for (int i = 0; i < n_spaces; i++)
+    {
+        hash = state_fnv_id(hash, spaces[i].id);
+        for (int d = 0; d < N_DIRECTIONS; d++)
+            hash = state_fnv_id(hash, spaces[i].exits[d]);
+    }
+    for (int i = 0; i < n_links; i++)
+    {
+        hash = state_fnv_id(hash, links[i].id);
+        hash = state_fnv_id(hash, links[i].first);
+        hash = state_fnv_id(hash, links[i].second);
+    }
+    for (int i = 0; i < n_objects; i++)
+    {
+        // The name of an object of an image is not interned
+        const char *name = (objects[i].name != NULL) ? objects[i].name : "";
+        hash = state_fnv_id(hash, objects[i].id);
+        hash = state_fnv(hash, name, strlen(name) + 1);
+    }
+    // 0 is left for errors
+    return (hash != 0) ? hash : 1;
+}
+
+static size_t state_round(size_t size)
+{
+    return (size + STATE_ALIGN - 1) / STATE_ALIGN * STATE_ALIGN;
+}
+
+static size_t state_layout(const StateHeader *h, char *base, StateSections *s)
+{
+    size_t offset = sizeof(StateHeader);
+    StateSections unused;
+
+    if (s == NULL)
+        s = &unused;
+    s->location = (int64_t *)(base + offset);
+    offset += state_round(sizeof(int64_t) * h->n_objects);
+    s->counts = (uint32_t *)(base + offset);
+    offset += state_round(sizeof(uint32_t) * h->n_spaces);
+    s->held = (uint32_t *)(base + offset);
+    offset += state_round(sizeof(uint32_t) * h->n_held);
+    s->inventory = (uint32_t *)(base + offset);
+    offset += state_round(sizeof(uint32_t) * h->n_inventory);
+    s->lit = (uint8_t *)(base + offset);
+    offset += state_round((h->n_spaces + 7) / 8);
+    s->opened = (uint8_t *)(base + offset);
+    offset += state_round((h->n_links + 7) / 8);
+    s->on = (uint8_t *)(base + offset);
+    offset += state_round((h->n_objects + 7) / 8);
+    return offset;
+}
+
+static uint64_t state_checksum(const char *data, size_t size, size_t at)
+{
+    static const uint64_t zero = 0;
+
+    uint64_t hash = state_fnv(STATE_FNV_BASIS, data, at);
+    hash = state_fnv(hash, &zero, sizeof(zero));
+    return state_fnv(hash, data + at + sizeof(zero), size - at - sizeof(zero));
+}
+
+uint64_t game_state_world_hash(Game *game)
+{
+    StateView *v = NULL;
+
+    if (game == NULL || (v = state_view(game)) == NULL)
+        return 0;
+    return v->hash;
+}
+
+
+static STATUS state_snapshot_write(const char *filename, Game *game, const StateView *v, size_t *size)
+{
+    StateHeader h;
+    StateSections s;
+    StreamRecord r;
+    const Id *inventory = NULL;
+    int n_inventory = 0;
+    STATUS status = OK;
+
+    memset(&h, 0, sizeof(StateHeader));
+    memcpy(h.magic, STATE_MAGIC, sizeof(STATE_MAGIC));
+    h.version = STATE_VERSION;
+    h.order = STATE_ORDER;
+    h.world = v->hash;
+    h.player_location = player_get_location(game_get_player(game));
+    h.dice_last = (game_get_dice(game) != NULL) ? dice_get_last_roll(game_get_dice(game)) : -1;
+    h.n_spaces = (uint32_t)v->n_spaces;
+    h.n_links = (uint32_t)v->n_links;
+    h.n_objects = (uint32_t)v->n_objects;
+    inventory = inventory_view(player_get_inventory(game_get_player(game)), &n_inventory);
+    h.n_inventory = (inventory != NULL) ? (uint32_t)n_inventory : 0;
+    for (int i = 0; i < v->n_spaces; i++)
+    {
+        Space *space = state_space_at(game, v, i, FALSE);
+        h.n_held += (uint32_t)((space != NULL) ? space_objects_count(space) : v->held_first[i + 1] - v->held_first[i]);
+    }
+    h.size = state_layout(&h, NULL, NULL);
+
+    char *data = calloc(1, h.size);
+    if (data == NULL)
+        return ERROR;
+    state_layout(&h, data, &s);
+
+    // What is not in memory is as the image has it, it is not built to be saved
+    for (int i = 0; i < v->n_objects; i++)
+    {
+        Object *o = state_object_at(game, v, i, FALSE);
+        BOOL on = FALSE;
+        if (o != NULL)
+        {
+            s.location[i] = object_get_location(o);
+            on = object_get_turnedOn(o);
+        }
+        else if (world_stream_get_object_record(v->ws, v->object_at[i], &r) == OK)
+        {
+            s.location[i] = r.first;
+            on = r.on;
+        }
+        if (on == TRUE)
+            s.on[i / 8] |= (uint8_t)(1u << (i % 8));
+    }
+    for (int i = 0; i < v->n_links; i++)
+    {
+        Link *link = state_link_at(game, v, i, FALSE);
+        BOOL opened = FALSE;
+        if (link != NULL)
+            opened = link_get_opened(link);
+        else if (world_stream_get_link_record(v->ws, v->link_at[i], &r) == OK)
+            opened = r.on;
+        if (opened == TRUE)
+            s.opened[i / 8] |= (uint8_t)(1u << (i % 8));
+    }
+    uint32_t held = 0;
+    for (int i = 0; i < v->n_spaces && status == OK; i++)
+    {
+        Space *space = state_space_at(game, v, i, FALSE);
+        BOOL lit = FALSE;
+        if (space == NULL)
+        {
+            if (world_stream_get_space_record(v->ws, v->space_at[i], &r) == OK)
+                lit = r.on;
+            s.counts[i] = (uint32_t)(v->held_first[i + 1] - v->held_first[i]);
+            for (int k = v->held_first[i]; k < v->held_first[i + 1]; k++)
+                s.held[held++] = (uint32_t)v->held[k];
+        }
+        else
+        {
+            int n = 0;
+            const Id *ids = space_objects_view(space, &n);
+            lit = space_get_illumination(space);
+            s.counts[i] = (uint32_t)n;
+            for (int k = 0; k < n && ids != NULL; k++)
+            {
+                int position = state_object_find(v, ids[k]);
+                if (position < 0)
+                    status = ERROR;
+                s.held[held++] = (uint32_t)position;
+            }
+        }
+        if (lit == TRUE)
+            s.lit[i / 8] |= (uint8_t)(1u << (i % 8));
+    }
+    for (uint32_t i = 0; i < h.n_inventory && status == OK; i++)
+    {
+        int position = state_object_find(v, inventory[i]);
+        if (position < 0)
+            status = ERROR;
+        s.inventory[i] = (uint32_t)position;
+    }
+
+    memcpy(data, &h, sizeof(StateHeader));
+    h.checksum = state_checksum(data, h.size, offsetof(StateHeader, checksum));
+    memcpy(data, &h, sizeof(StateHeader));
+
+    if (status == OK)
+    {
+        FILE *out = fopen(filename, "wb");
+        if (out == NULL || fwrite(data, 1, h.size, out) != h.size)
+            status = ERROR;
+        if (out != NULL && fclose(out) != 0)
+            status = ERROR;
+    }
+    if (status == OK && size != NULL)
+        *size = h.size;
+
+    free(data);
+    return status;
+}
+
+STATUS game_state_save(const char *filename, Game *game)
+{
+    StateView *v = NULL;
+
+    if (filename == NULL || game == NULL || game_get_player(game) == NULL || (v = state_view(game)) == NULL)
+        return ERROR;
+
+    return state_snapshot_write(filename, game, v, NULL);
+}
+
+BOOL game_state_check(const char *filename)
+{
+    char magic[sizeof(STATE_MAGIC)] = "";
+    FILE *in = NULL;
+    BOOL found = FALSE;
+
+    if (filename == NULL || (in = fopen(filename, "rb")) == NULL)
+        return FALSE;
+    if (fread(magic, 1, sizeof(magic), in) == sizeof(magic) && memcmp(magic, STATE_MAGIC, sizeof(magic)) == 0)
+        found = TRUE;
+    fclose(in);
+    return found;
+}
+
+static BOOL state_valid(const char *data, size_t size, const StateView *v)
+{
+    const StateHeader *h = (const StateHeader *)data;
+    StateSections s;
+
+    // The save can be followed by the deltas of a journal
+    if (size < sizeof(StateHeader) || memcmp(h->magic, STATE_MAGIC, sizeof(STATE_MAGIC)) != 0 ||
+        h->version != STATE_VERSION || h->order != STATE_ORDER || h->size > size || h->size < sizeof(StateHeader))
+        return FALSE;
+    size = (size_t)h->size;
+    if (h->checksum != state_checksum(data, size, offsetof(StateHeader, checksum)))
+        return FALSE;
+    // Another world, or the same one changed since it was saved
+    if (h->n_spaces != (uint32_t)v->n_spaces || h->n_links != (uint32_t)v->n_links ||
+        h->n_objects != (uint32_t)v->n_objects || h->world != v->hash)
+        return FALSE;
+    if (state_layout(h, NULL, NULL) != size)
+        return FALSE;
+
+    state_layout(h, (char *)data, &s);
+    uint64_t held = 0;
+    for (uint32_t i = 0; i < h->n_spaces; i++)
+        held += s.counts[i];
+    if (held != h->n_held)
+        return FALSE;
+    for (uint32_t i = 0; i < h->n_held; i++)
+    {
+        if (s.held[i] >= h->n_objects)
+            return FALSE;
+    }
+    for (uint32_t i = 0; i < h->n_inventory; i++)
+    {
+        if (s.inventory[i] >= h->n_objects)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static void state_space_clear(Space *space)
+{
+    int n = 0;
+    const Id *ids = NULL;
+
+    while ((ids = space_objects_view(space, &n)) != NULL && n > 0)
+        space_remove_object(space, ids[n - 1]);
+}
+
+static void state_inventory_clear(Inventory *inv)
+{
+    int n = 0;
+    const Id *ids = NULL;
+
+    while ((ids = inventory_view(inv, &n)) != NULL && n > 0)
+    {
+        if (inventory_del_id(inv, ids[n - 1]) == ERROR)
+            break;
+    }
+}
+
+static BOOL state_space_as_image(const StateView *v, int i, BOOL lit, const uint32_t *held, uint32_t n)
+{
+    StreamRecord r, o;
+
+    if (world_stream_get_space_record(v->ws, v->space_at[i], &r) == ERROR || r.on != lit ||
+        n != (uint32_t)(v->held_first[i + 1] - v->held_first[i]))
+        return FALSE;
+    // As many objects as the image puts in it, so the same ones if each is one of them
+    for (uint32_t k = 0; k < n; k++)
+    {
+        if (world_stream_get_object_record(v->ws, v->object_at[held[k]], &o) == ERROR || o.first != r.id)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static size_t state_delta_read(const char *data, size_t size, uint64_t world, const StateView *v, Game *game)
+{
+    const StateDelta *d = (const StateDelta *)data;
+
+    if (size < sizeof(StateDelta) || memcmp(d->magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 ||
+        d->size < sizeof(StateDelta) || d->size > size || d->size % sizeof(int64_t) != 0 || d->world != world)
+        return 0;
+    // Checked already when it is applied
+    if (game == NULL && d->checksum != state_checksum(data, (size_t)d->size, offsetof(StateDelta, checksum)))
+        return 0;
+
+    const int64_t *word = (const int64_t *)(data + sizeof(StateDelta));
+    size_t n = ((size_t)d->size - sizeof(StateDelta)) / sizeof(int64_t);
+    size_t at = 0;
+    Player *player = (game != NULL) ? game_get_player(game) : NULL;
+    Space *space = NULL;
+    Link *link = NULL;
+    Object *o = NULL;
+
+    for (uint32_t r = 0; r < d->n_records; r++)
+    {
+        if (at + 3 > n)
+            return 0;
+        int64_t kind = word[at];
+        int64_t position = word[at + 1];
+        int64_t count = 0;
+
+        switch (kind)
+        {
+        case DELTA_SPACE:
+            if (at + 4 > n || position < 0 || position >= v->n_spaces || (count = word[at + 3]) < 0 ||
+                count > v->n_objects || (size_t)count > n - at - 4)
+                return 0;
+            for (int64_t k = 0; k < count; k++)
+            {
+                if (word[at + 4 + k] < 0 || word[at + 4 + k] >= v->n_objects)
+                    return 0;
+            }
+            // The region of what a delta changed is built to change it
+            if (game != NULL && (space = state_space_at(game, v, (int)position, TRUE)) != NULL)
+            {
+                state_space_clear(space);
+                space_set_illumination(space, word[at + 2] ? TRUE : FALSE);
+                for (int64_t k = 0; k < count; k++)
+                    space_add_object(space, v->object_ids[word[at + 4 + k]]);
+            }
+            at += 4 + (size_t)count;
+            break;
+        case DELTA_LINK:
+            if (position < 0 || position >= v->n_links)
+                return 0;
+            if (game != NULL && (link = state_link_at(game, v, (int)position, TRUE)) != NULL)
+                link_set_opened(link, word[at + 2] ? TRUE : FALSE);
+            at += 3;
+            break;
+        case DELTA_OBJECT:
+            if (at + 4 > n || position < 0 || position >= v->n_objects)
+                return 0;
+            if (game != NULL && (o = state_object_at(game, v, (int)position, TRUE)) != NULL)
+            {
+                object_set_location(o, (Id)word[at + 2]);
+                object_set_turnedOn(o, word[at + 3] ? TRUE : FALSE);
+            }
+            at += 4;
+            break;
+        case DELTA_PLAYER:
+            // The location takes the place of the position
+            if ((count = word[at + 2]) < 0 || count > v->n_objects || (size_t)count > n - at - 3)
+                return 0;
+            for (int64_t k = 0; k < count; k++)
+            {
+                if (word[at + 3 + k] < 0 || word[at + 3 + k] >= v->n_objects)
+                    return 0;
+            }
+            if (player != NULL)
+            {
+                Inventory *inv = player_get_inventory(player);
+                player_set_location(player, (Id)position);
+                state_inventory_clear(inv);
+                for (int64_t k = 0; k < count; k++)
+                    inventory_add_id(inv, v->object_ids[word[at + 3 + k]]);
+            }
+            at += 3 + (size_t)count;
+            break;
+        default:
+            return 0;
+        }
+    }
+    if (at != n)
+        return 0;
+
+    if (game != NULL && game_get_dice(game) != NULL)
+        dice_set_last_roll(game_get_dice(game), d->dice_last);
+    return (size_t)d->size;
+}
+
+STATUS game_state_load(const char *filename, Game *game)
+{
+    FILE *in = NULL;
+    char *data = NULL;
+    long size = 0;
+    StateView *v = NULL;
+    StateSections s;
+    StreamRecord r;
+
+    if (filename == NULL || game == NULL || game_get_player(game) == NULL)
+        return ERROR;
+    in = fopen(filename, "rb");
+    if (in == NULL)
+        return ERROR;
+    if (fseek(in, 0, SEEK_END) == 0 && (size = ftell(in)) > 0 && fseek(in, 0, SEEK_SET) == 0)
+    {
+        // malloc aligns it for the int64_t sections
+        data = malloc((size_t)size);
+        if (data != NULL && fread(data, 1, (size_t)size, in) != (size_t)size)
+        {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(in);
+    if (data == NULL)
+        return ERROR;
+
+    // Nothing is changed until the whole save is known to be right
+    if ((v = state_view(game)) == NULL || state_valid(data, (size_t)size, v) == FALSE)
+    {
+        free(data);
+        return ERROR;
+    }
+
+    const StateHeader *h = (const StateHeader *)data;
+    Player *player = game_get_player(game);
+    Inventory *inv = player_get_inventory(player);
+
+    // The deltas of a journal up to the first one that is not whole
+    size_t end = (size_t)h->size, delta = 0;
+    while (end < (size_t)size && (delta = state_delta_read(data + end, (size_t)size - end, h->world, v, NULL)) > 0)
+        end += delta;
+
+    state_layout(h, data, &s);
+    state_inventory_clear(inv);
+    for (uint32_t i = 0; i < h->n_inventory; i++)
+        inventory_add_id(inv, v->object_ids[s.inventory[i]]);
+
+    // Of a streamed world, what is not in memory is only built if the save
+    // has it other than the image. Each one is changed as soon as it is
+    // built: a region that is evicted meanwhile was as the save has it
+    uint32_t held = 0;
+    for (uint32_t i = 0; i < h->n_spaces; i++)
+    {
+        BOOL lit = (s.lit[i / 8] >> (i % 8)) & 1u ? TRUE : FALSE;
+        Space *space = state_space_at(game, v, (int)i, FALSE);
+        if (space == NULL && state_space_as_image(v, (int)i, lit, s.held + held, s.counts[i]) == FALSE)
+            space = state_space_at(game, v, (int)i, TRUE);
+        if (space != NULL)
+        {
+            state_space_clear(space);
+            space_set_illumination(space, lit);
+            for (uint32_t k = 0; k < s.counts[i]; k++)
+                space_add_object(space, v->object_ids[s.held[held + k]]);
+        }
+        held += s.counts[i];
+    }
+    for (uint32_t i = 0; i < h->n_links; i++)
+    {
+        BOOL opened = (s.opened[i / 8] >> (i % 8)) & 1u ? TRUE : FALSE;
+        Link *link = state_link_at(game, v, (int)i, FALSE);
+        if (link == NULL && (world_stream_get_link_record(v->ws, v->link_at[i], &r) == ERROR || r.on != opened))
+            link = state_link_at(game, v, (int)i, TRUE);
+        if (link != NULL)
+            link_set_opened(link, opened);
+    }
+    for (uint32_t i = 0; i < h->n_objects; i++)
+    {
+        BOOL on = (s.on[i / 8] >> (i % 8)) & 1u ? TRUE : FALSE;
+        Object *o = state_object_at(game, v, (int)i, FALSE);
+        if (o == NULL && (world_stream_get_object_record(v->ws, v->object_at[i], &r) == ERROR ||
+                          r.first != (Id)s.location[i] || r.on != on))
+            o = state_object_at(game, v, (int)i, TRUE);
+        if (o != NULL)
+        {
+            object_set_location(o, (Id)s.location[i]);
+            object_set_turnedOn(o, on);
+        }
+    }
+    player_set_location(player, (Id)h->player_location);
+    if (game_get_dice(game) != NULL)
+        dice_set_last_roll(game_get_dice(game), h->dice_last);
+
+    for (size_t at = (size_t)h->size; at < end; at += delta)
+        delta = state_delta_read(data + at, end - at, h->world, v, game);
+
+    free(data);
+    return OK;
+}
+
+static STATUS state_words_add(StateWords *words, int64_t word)
+{
+    if (words->n == words->capacity)
+    {
+        size_t capacity = (words->capacity > 0) ? 2 * words->capacity : 64;
+        int64_t *grown = realloc(words->word, sizeof(int64_t) * capacity);
+        if (grown == NULL)
+            return ERROR;
+        words->word = grown;
+        words->capacity = capacity;
+    }
+    words->word[words->n++] = word;
+    return OK;
+}
+
+static STATUS state_words_add_objects(StateWords *words, const StateView *v, const Id *ids, int n)
+{
+    STATUS status = state_words_add(words, n);
+
+    for (int k = 0; k < n && ids != NULL && status == OK; k++)
+    {
+        int position = state_object_find(v, ids[k]);
+        status = (position < 0) ? ERROR : state_words_add(words, position);
+    }
+    return status;
+}
+
+static int state_change_compare(const void *a, const void *b)
+{
+    const StateChange *x = a;
+    const StateChange *y = b;
+
+    if (x->kind != y->kind)
+        return (x->kind > y->kind) ? 1 : -1;
+    return (x->position > y->position) - (x->position < y->position);
+}
+
+static int state_entry_changes(const StateView *v, const DirtyEntry *e, StateChange *c)
+{
+    int position = -1, n = 0;
+
+    if (e->kind == DIRTY_LINK)
+    {
+        position = state_link_find(v, e->id, e->first, e->second);
+        for (int i = position; i >= 0 && i < v->n_links && state_key_compare(&v->link_keys[i], &v->link_keys[position]) == 0; i++)
+        {
+            if (c != NULL)
+            {
+                c[n].kind = DELTA_LINK;
+                c[n].position = i;
+            }
+            n++;
+        }
+        return n;
+    }
+
+    position = (e->kind == DIRTY_SPACE) ? state_space_find(v, e->id) : state_object_find(v, e->id);
+    if (position >= 0 && c != NULL)
+    {
+        c->kind = (e->kind == DIRTY_SPACE) ? DELTA_SPACE : DELTA_OBJECT;
+        c->position = position;
+    }
+    return (position >= 0) ? 1 : 0;
+}
+
+static STATUS state_changes(Game *game, const StateView *v, StateChange **changes, int *n)
+{
+    int n_entries = 0, k = 0;
+    const DirtyEntry *e = dirty_list_view(game_get_dirty_list(game), &n_entries);
+    StateChange *c = NULL;
+
+    *changes = NULL;
+    *n = 0;
+    if (e == NULL)
+        return ERROR;
+    for (int i = 0; i < n_entries; i++)
+        k += state_entry_changes(v, &e[i], NULL);
+    c = malloc(sizeof(StateChange) * (k + 1));
+    if (c == NULL)
+        return ERROR;
+
+    k = 0;
+    for (int i = 0; i < n_entries; i++)
+        k += state_entry_changes(v, &e[i], &c[k]);
+    // Spaces, links and objects as the records were always written, an
+    // entity pushed again after it was marked clean is written once
+    qsort(c, k, sizeof(StateChange), state_change_compare);
+    for (int i = 0; i < k; i++)
+    {
+        if (*n == 0 || state_change_compare(&c[*n - 1], &c[i]) != 0)
+            c[(*n)++] = c[i];
+    }
+    *changes = c;
+    return OK;
+}
+
+static STATUS state_words_add_change(StateWords *words, Game *game, const StateView *v, const StateChange *c)
+{
+    StreamRecord r;
+    STATUS status = OK;
+
+    if (state_words_add(words, c->kind) == ERROR || state_words_add(words, c->position) == ERROR)
+        return ERROR;
+
+    // Only a clean region is evicted, what is not in memory is as the
+    // image has it
+    if (c->kind == DELTA_SPACE)
+    {
+        Space *space = state_space_at(game, v, c->position, FALSE);
+        if (space != NULL)
+        {
+            int n = 0;
+            const Id *ids = space_objects_view(space, &n);
+            status = state_words_add(words, space_get_illumination(space) == TRUE);
+            if (status == OK)
+                status = state_words_add_objects(words, v, ids, (ids != NULL) ? n : 0);
+            space_set_dirty(space, FALSE);
+        }
+        else if (world_stream_get_space_record(v->ws, v->space_at[c->position], &r) == ERROR ||
+                 state_words_add(words, r.on == TRUE) == ERROR ||
+                 state_words_add(words, v->held_first[c->position + 1] - v->held_first[c->position]) == ERROR)
+            status = ERROR;
+        else
+        {
+            for (int k = v->held_first[c->position]; k < v->held_first[c->position + 1] && status == OK; k++)
+                status = state_words_add(words, v->held[k]);
+        }
+    }
+    else if (c->kind == DELTA_LINK)
+    {
+        Link *link = state_link_at(game, v, c->position, FALSE);
+        if (link != NULL)
+        {
+            status = state_words_add(words, link_get_opened(link) == TRUE);
+            link_set_dirty(link, FALSE);
+        }
+        else if (world_stream_get_link_record(v->ws, v->link_at[c->position], &r) == ERROR ||
+                 state_words_add(words, r.on == TRUE) == ERROR)
+            status = ERROR;
+    }
+    else
+    {
+        Object *o = state_object_at(game, v, c->position, FALSE);
+        if (o != NULL)
+        {
+            if (state_words_add(words, object_get_location(o)) == ERROR ||
+                state_words_add(words, object_get_turnedOn(o) == TRUE) == ERROR)
+                status = ERROR;
+            object_set_dirty(o, FALSE);
+        }
+        else if (world_stream_get_object_record(v->ws, v->object_at[c->position], &r) == ERROR ||
+                 state_words_add(words, r.first) == ERROR || state_words_add(words, r.on == TRUE) == ERROR)
+            status = ERROR;
+    }
+    return status;
+}
+
+static STATUS state_journal_compact(GameJournal *j, Game *game)
+{
+    size_t length = strlen(j->filename);
+    char *temporary = malloc(length + sizeof(".tmp"));
+    size_t size = 0;
+    StateView *v = state_view(game);
+    STATUS status = ERROR;
+
+    if (temporary == NULL || v == NULL)
+    {
+        free(temporary);
+        return ERROR;
+    }
+    memcpy(temporary, j->filename, length);
+    memcpy(temporary + length, ".tmp", sizeof(".tmp"));
+
+    // The journal is never left half written, the new one replaces it whole
+    if (state_snapshot_write(temporary, game, v, &size) == OK && rename(temporary, j->filename) == 0)
+    {
+        j->base = j->size = size;
+        j->dice_last = (game_get_dice(game) != NULL) ? dice_get_last_roll(game_get_dice(game)) : -1;
+        game_mark_saved(game);
+        status = OK;
+    }
+    else
+        remove(temporary);
+
+    free(temporary);
+    return status;
+}
+
+GameJournal *game_state_journal_open(const char *filename, Game *game)
+{
+    GameJournal *j = NULL;
+    StateView *v = NULL;
+
+    if (filename == NULL || game == NULL || game_get_player(game) == NULL)
+        return NULL;
+    j = calloc(1, sizeof(GameJournal));
+    if (j == NULL)
+        return NULL;
+    j->filename = malloc(strlen(filename) + 1);
+    if (j->filename == NULL || (v = state_view(game)) == NULL)
+    {
+        free(j->filename);
+        free(j);
+        return NULL;
+    }
+    strcpy(j->filename, filename);
+    j->world = v->hash;
+
+    if (state_journal_compact(j, game) == ERROR)
+    {
+        game_state_journal_close(&j);
+        return NULL;
+    }
+    return j;
+}
+
+STATUS game_state_journal_append(GameJournal *j, Game *game)
+{
+    StateWords words = {NULL, 0, 0};
+    StateDelta d;
+    Player *player = NULL;
+    StateView *v = NULL;
+    StateChange *changes = NULL;
+    int n_changes = 0;
+    STATUS status = OK;
+
+    if (j == NULL || game == NULL || (player = game_get_player(game)) == NULL || (v = state_view(game)) == NULL)
+        return ERROR;
+
+    memset(&d, 0, sizeof(StateDelta));
+    memcpy(d.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    d.world = j->world;
+    d.dice_last = (game_get_dice(game) != NULL) ? dice_get_last_roll(game_get_dice(game)) : -1;
+    // Room for the header, written last
+    for (size_t k = 0; k < sizeof(StateDelta) / sizeof(int64_t) && status == OK; k++)
+        status = state_words_add(&words, 0);
+
+    // Only what changed since the last delta, the entities of the dirty
+    // list, found by their ids so the regions evicted since are not built.
+    // They are marked clean as the records are made: if the delta is not
+    // written the whole journal is, and with it every change
+    if (status == OK)
+        status = state_changes(game, v, &changes, &n_changes);
+    for (int i = 0; i < n_changes && status == OK; i++)
+    {
+        status = state_words_add_change(&words, game, v, &changes[i]);
+        d.n_records++;
+    }
+    free(changes);
+    if (status == OK)
+        dirty_list_clear(game_get_dirty_list(game));
+    if (player_get_dirty(player) == TRUE && status == OK)
+    {
+        int n = 0;
+        const Id *ids = inventory_view(player_get_inventory(player), &n);
+        if (state_words_add(&words, DELTA_PLAYER) == ERROR || state_words_add(&words, player_get_location(player)) == ERROR)
+            status = ERROR;
+        else
+            status = state_words_add_objects(&words, v, ids, (ids != NULL) ? n : 0);
+        player_set_dirty(player, FALSE);
+        d.n_records++;
+    }
+
+    if (d.n_records == 0 && d.dice_last == j->dice_last)
+    {
+        free(words.word);
+        return OK;
+    }
+    if (status == ERROR)
+    {
+        free(words.word);
+        return state_journal_compact(j, game);
+    }
+
+    d.size = words.n * sizeof(int64_t);
+    memcpy(words.word, &d, sizeof(StateDelta));
+    d.checksum = state_checksum((const char *)words.word, (size_t)d.size, offsetof(StateDelta, checksum));
+    memcpy(words.word, &d, sizeof(StateDelta));
+
+    FILE *out = fopen(j->filename, "ab");
+    if (out == NULL || fwrite(words.word, 1, (size_t)d.size, out) != (size_t)d.size)
+        status = ERROR;
+    if (out != NULL && fclose(out) != 0)
+        status = ERROR;
+    free(words.word);
+
+    if (status == OK)
+    {
+        j->size += (size_t)d.size;
+        j->dice_last = d.dice_last;
+        if (j->size > JOURNAL_COMPACT * j->base)
+            status = state_journal_compact(j, game);
+    }
+    else
+        // A delta cut in the middle would hide the ones after it
+        status = state_journal_compact(j, game);
+    return status;
+}
+
+const char *game_state_journal_get_filename(GameJournal *j)
+{
+    return (j != NULL) ? j->filename : NULL;
+}
+
+STATUS game_state_journal_close(GameJournal **j)
+{
+    if (j == NULL || *j == NULL)
+        return ERROR;
+
+    free((*j)->filename);
+    free(*j);
+    *j = NULL;
+    return OK;
+}
@@ -0,0 +1,593 @@
+/**
+ * @brief It tests the game state module
+ *
+ * The tests load datanew.dat, so they are run from the root of the project.
+ * The state of a game is changed, saved and restored on a game loaded again,
+ * from a save or from a journal
+ *
+ * @file game_state_test.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 27-05-2021
+ * @copyright GNU Public License
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/game_state.h"
+#include "../include/world_image.h"
+#include "../include/game.h"
+#include "../include/space.h"
+#include "../include/link.h"
+#include "../include/object.h"
+#include "../include/player.h"
+#include "../include/die.h"
+#include "../include/test.h"
+#include "../include/types.h"
+
+#define TEST_WORLD "datanew.dat"
+#define TEST_STATE "/tmp/game_state_test.gsv"
+#define TEST_IMAGE "/tmp/game_state_test.gwc"
+#define TEST_OTHER "/tmp/game_state_test.dat"
+#define TEST_JOURNAL "/tmp/game_state_test.gjr"
+
+/**
+ * @brief game with the world of the test data file
+ *
+ * @return the game, NULL if error
+ */
+static Game* load_world() {
+    Game* game = game_init();
+    if (game != NULL && game_create_from_file(game, TEST_WORLD) == ERROR) {
+        game_destroy(game);
+        return NULL;
+    }
+    return game;
+}
+
+/**
+ * @brief game with the world of the test data file streamed from its image,
+ * two spaces to a region
+ *
+ * @param max_regions regions kept in memory, 0 for no limit
+ * @return the game, NULL if error
+ */
+static Game* stream_world(int max_regions) {
+    Game* game = load_world();
+    Game* streamed = NULL;
+
+    world_image_set_region_spaces(2);
+    game_management_set_stream(max_regions);
+    if (game != NULL && world_image_save(TEST_IMAGE, game) == OK && (streamed = game_init()) != NULL &&
+        game_create_from_file(streamed, TEST_IMAGE) == ERROR) {
+        game_destroy(streamed);
+        streamed = NULL;
+    }
+    game_management_set_stream(-1);
+    remove(TEST_IMAGE);
+    if (game != NULL)
+        game_destroy(game);
+    return streamed;
+}
+
+/**
+ * @brief changes every kind of state of the test world: the player takes
+ * the torch and moves, the torch is turned on, a link is opened, a space
+ * lit and an object moved to another space
+ *
+ * @param game pointer to game with the test world
+ */
+static void play(Game* game) {
+    Object* torch = game_get_object(game, 2);
+    Object* soap = game_get_object(game, 6);
+    Space* here = game_get_space(game, game_get_player_location(game));
+
+    space_remove_object(here, object_get_id(torch));
+    player_add_object(game_get_player(game), torch);
+    object_set_turnedOn(torch, TRUE);
+    space_remove_object(game_get_space(game, object_get_location(soap)), object_get_id(soap));
+    space_add_object(here, object_get_id(soap));
+    object_set_location(soap, space_get_id(here));
+    link_set_opened(game_get_link_by_name(game, "BedroomDoor"), TRUE);
+    space_set_illumination(game_get_space(game, 1), TRUE);
+    player_set_location(game_get_player(game), 10);
+    dice_set_last_roll(game_get_dice(game), 4);
+}
+
+/**
+ * @brief TRUE if two games with the same world are in the same state
+ *
+ * @param a pointer to game
+ * @param b pointer to the other game
+ * @return BOOL
+ */
+static BOOL same_state(Game* a, Game* b) {
+    if (a == NULL || b == NULL || game_get_player_location(a) != game_get_player_location(b) ||
+        player_getnObjects(game_get_player(a)) != player_getnObjects(game_get_player(b)) ||
+        dice_get_last_roll(game_get_dice(a)) != dice_get_last_roll(game_get_dice(b)))
+        return FALSE;
+
+    for (int i = 0; i < game_get_number_space(a); i++) {
+        Space* sa = game_get_space_at_position(a, i);
+        Space* sb = game_get_space(b, space_get_id(sa));
+        if (sb == NULL || space_get_illumination(sa) != space_get_illumination(sb) ||
+            space_objects_count(sa) != space_objects_count(sb))
+            return FALSE;
+        for (int d = 0; d < N_DIRECTIONS; d++) {
+            if (link_get_opened(space_get_exit(sa, (T_Direction)d)) != link_get_opened(space_get_exit(sb, (T_Direction)d)))
+                return FALSE;
+        }
+    }
+    for (int i = 0; i < game_get_number_object(a); i++) {
+        Object* oa = game_get_object_at_position(a, i);
+        Object* ob = game_get_object(b, object_get_id(oa));
+        if (ob == NULL || object_get_location(oa) != object_get_location(ob) ||
+            object_get_turnedOn(oa) != object_get_turnedOn(ob) ||
+            player_has_object(game_get_player(a), object_get_id(oa)) != player_has_object(game_get_player(b), object_get_id(ob)))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief changes one byte of a file
+ *
+ * @param filename name of the file
+ * @param offset position of the byte
+ */
+static void damage(const char* filename, long offset) {
+    FILE* f = fopen(filename, "r+b");
+    if (f == NULL)
+        return;
+    if (fseek(f, offset, SEEK_SET) == 0) {
+        int c = fgetc(f);
+        fseek(f, offset, SEEK_SET);
+        fputc(c ^ 0x5a, f);
+    }
+    fclose(f);
+}
+
+/**
+ * @brief size of a file
+ *
+ * @param filename name of the file
+ * @return bytes, -1 if it cannot be opened
+ */
+static long file_size(const char* filename) {
+    FILE* f = fopen(filename, "rb");
+    long size = -1;
+
+    if (f == NULL)
+        return -1;
+    if (fseek(f, 0, SEEK_END) == 0)
+        size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+/**
+ * @brief takes bytes off the end of a file, like a write cut in the middle
+ *
+ * @param filename name of the file
+ * @param bytes bytes taken off
+ */
+static void cut(const char* filename, long bytes) {
+    long size = file_size(filename);
+    char* data = NULL;
+    FILE* f = NULL;
+
+    if (size < bytes || (data = malloc((size_t)size + 1)) == NULL)
+        return;
+    if ((f = fopen(filename, "rb")) != NULL) {
+        size = (long)fread(data, 1, (size_t)size, f);
+        fclose(f);
+        if ((f = fopen(filename, "wb")) != NULL) {
+            fwrite(data, 1, (size_t)(size - bytes), f);
+            fclose(f);
+        }
+    }
+    free(data);
+}
+
+void test_game_state_save() {
+    Game* game = load_world();
+    PRINT_TEST_RESULT(game != NULL && game_state_save(TEST_STATE, game) == OK);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_state_save_null() {
+    PRINT_TEST_RESULT(game_state_save(TEST_STATE, NULL) == ERROR);
+}
+
+void test_game_state_check() {
+    Game* game = load_world();
+    game_state_save(TEST_STATE, game);
+    PRINT_TEST_RESULT(game_state_check(TEST_STATE) == TRUE && game_state_check(TEST_WORLD) == FALSE);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_state_size() {
+    Game* game = load_world();
+    FILE* f = NULL;
+    long size = 0;
+
+    game_state_save(TEST_STATE, game);
+    if ((f = fopen(TEST_STATE, "rb")) != NULL) {
+        fseek(f, 0, SEEK_END);
+        size = ftell(f);
+        fclose(f);
+    }
+    // A few hundred bytes, nothing of the world that does not change
+    PRINT_TEST_RESULT(size > 0 && size < 512);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_state_load() {
+    Game* game = load_world();
+    Game* restored = load_world();
+
+    play(game);
+    PRINT_TEST_RESULT(game != NULL && restored != NULL && same_state(game, restored) == FALSE &&
+                      game_state_save(TEST_STATE, game) == OK && game_state_load(TEST_STATE, restored) == OK &&
+                      same_state(game, restored) == TRUE);
+    if (game != NULL)
+        game_destroy(game);
+    if (restored != NULL)
+        game_destroy(restored);
+}
+
+void test_game_state_load_damaged() {
+    Game* game = load_world();
+    Game* restored = load_world();
+
+    play(game);
+    game_state_save(TEST_STATE, game);
+    damage(TEST_STATE, 100);
+    // The checksum finds it and nothing is restored
+    PRINT_TEST_RESULT(game_state_load(TEST_STATE, restored) == ERROR && game_get_player_location(restored) != 10);
+    if (game != NULL)
+        game_destroy(game);
+    if (restored != NULL)
+        game_destroy(restored);
+}
+
+void test_game_state_load_other_world() {
+    FILE* f = fopen(TEST_OTHER, "w");
+    Game* game = load_world();
+    Game* other = game_init();
+
+    if (f != NULL) {
+        fputs("#s:1|One|First|First room|2|-1|-1|-1|-1|-1|1\n"
+              "#s:2|Two|Second|Second room|-1|-1|1|-1|-1|-1|1\n"
+              "#p:1|Goose|1|3|\n", f);
+        fclose(f);
+    }
+    game_state_save(TEST_STATE, game);
+    PRINT_TEST_RESULT(other != NULL && game_create_from_file(other, TEST_OTHER) == OK &&
+                      game_state_load(TEST_STATE, other) == ERROR);
+    remove(TEST_OTHER);
+    if (game != NULL)
+        game_destroy(game);
+    if (other != NULL)
+        game_destroy(other);
+}
+
+void test_game_state_load_missing() {
+    Game* game = load_world();
+    PRINT_TEST_RESULT(game_state_load("/tmp/game_state_test_missing.gsv", game) == ERROR);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_state_world_hash() {
+    // The same world streamed from its image, the region of the player first
+    Game* game = load_world();
+    Game* image = NULL;
+
+    world_image_set_region_spaces(2);
+    game_management_set_stream(0);
+    if (game != NULL && world_image_save(TEST_IMAGE, game) == OK && (image = game_init()) != NULL &&
+        game_create_from_file(image, TEST_IMAGE) == ERROR) {
+        game_destroy(image);
+        image = NULL;
+    }
+    game_management_set_stream(-1);
+    PRINT_TEST_RESULT(image != NULL && game_state_world_hash(game) != 0 &&
+                      game_state_world_hash(game) == game_state_world_hash(image));
+    remove(TEST_IMAGE);
+    if (game != NULL)
+        game_destroy(game);
+    if (image != NULL)
+        game_destroy(image);
+}
+
+void test_game_state_save_streamed() {
+    Game* game = stream_world(1);
+    Game* restored = load_world();
+    int resident = (game != NULL) ? world_stream_get_resident(game_get_stream(game)) : -1;
+
+    // The regions never visited are saved as the image has them
+    PRINT_TEST_RESULT(game != NULL && restored != NULL && game_state_save(TEST_STATE, game) == OK &&
+                      world_stream_get_resident(game_get_stream(game)) == resident &&
+                      game_state_load(TEST_STATE, restored) == OK && same_state(restored, game) == TRUE);
+    if (game != NULL)
+        game_destroy(game);
+    if (restored != NULL)
+        game_destroy(restored);
+}
+
+void test_game_state_load_streamed() {
+    Game* game = load_world();
+    Game* restored = stream_world(1);
+
+    play(game);
+    // Only the regions the save changed are built, the limit still holds for the others
+    PRINT_TEST_RESULT(game != NULL && restored != NULL && game_state_save(TEST_STATE, game) == OK &&
+                      game_state_load(TEST_STATE, restored) == OK &&
+                      world_stream_get_resident(game_get_stream(restored)) < game_get_number_space(game) / 2 &&
+                      same_state(game, restored) == TRUE);
+    if (game != NULL)
+        game_destroy(game);
+    if (restored != NULL)
+        game_destroy(restored);
+}
+
+void test_game_state_journal_open() {
+    Game* game = load_world();
+    GameJournal* j = NULL;
+
+    if (game != NULL)
+        player_set_location(game_get_player(game), 10);
+    j = game_state_journal_open(TEST_JOURNAL, game);
+    // It starts with a save, after which nothing is dirty
+    PRINT_TEST_RESULT(j != NULL && game_state_check(TEST_JOURNAL) == TRUE &&
+                      player_get_dirty(game_get_player(game)) == FALSE &&
+                      strcmp(game_state_journal_get_filename(j), TEST_JOURNAL) == 0);
+    game_state_journal_close(&j);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_state_journal_append() {
+    Game* game = load_world();
+    Game* restored = load_world();
+    GameJournal* j = game_state_journal_open(TEST_JOURNAL, game);
+    long base = file_size(TEST_JOURNAL);
+
+    play(game);
+    PRINT_TEST_RESULT(j != NULL && restored != NULL && game_state_journal_append(j, game) == OK &&
+                      file_size(TEST_JOURNAL) - base < base && game_state_load(TEST_JOURNAL, restored) == OK &&
+                      same_state(game, restored) == TRUE);
+    game_state_journal_close(&j);
+    if (game != NULL)
+        game_destroy(game);
+    if (restored != NULL)
+        game_destroy(restored);
+}
+
+void test_game_state_journal_unchanged() {
+    Game* game = load_world();
+    GameJournal* j = game_state_journal_open(TEST_JOURNAL, game);
+    long size = 0;
+
+    play(game);
+    game_state_journal_append(j, game);
+    size = file_size(TEST_JOURNAL);
+    // Setting what is already there is not a change
+    if (game != NULL)
+        player_set_location(game_get_player(game), 10);
+    PRINT_TEST_RESULT(j != NULL && game_state_journal_append(j, game) == OK && file_size(TEST_JOURNAL) == size);
+    game_state_journal_close(&j);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_game_state_journal_torn() {
+    Game* game = load_world();
+    Game* restored = load_world();
+    GameJournal* j = game_state_journal_open(TEST_JOURNAL, game);
+
+    play(game);
+    game_state_journal_append(j, game);
+    if (game != NULL)
+        player_set_location(game_get_player(game), 1);
+    game_state_journal_append(j, game);
+    game_state_journal_close(&j);
+    cut(TEST_JOURNAL, 8);
+    // The last delta is lost, the one before it is not
+    PRINT_TEST_RESULT(restored != NULL && game_state_load(TEST_JOURNAL, restored) == OK &&
+                      game_get_player_location(restored) == 10 &&
+                      object_get_turnedOn(game_get_object(restored, 2)) == TRUE);
+    if (game != NULL)
+        game_destroy(game);
+    if (restored != NULL)
+        game_destroy(restored);
+}
+
+void test_game_state_journal_compact() {
+    Game* game = load_world();
+    Game* restored = load_world();
+    GameJournal* j = game_state_journal_open(TEST_JOURNAL, game);
+    long base = file_size(TEST_JOURNAL);
+    long largest = 0;
+
+    for (int i = 0; i < 200 && game != NULL; i++) {
+        player_set_location(game_get_player(game), (i % 2 == 0) ? 10 : 1);
+        game_state_journal_append(j, game);
+        if (file_size(TEST_JOURNAL) > largest)
+            largest = file_size(TEST_JOURNAL);
+    }
+    // Written again as a single save every few hundred bytes of deltas
+    PRINT_TEST_RESULT(j != NULL && base > 0 && largest <= 5 * base && restored != NULL &&
+                      game_state_load(TEST_JOURNAL, restored) == OK && same_state(game, restored) == TRUE);
+    game_state_journal_close(&j);
+    if (game != NULL)
+        game_destroy(game);
+    if (restored != NULL)
+        game_destroy(restored);
+}
+
+void test_game_state_journal_streamed() {
+    Game* game = stream_world(1);
+    Game* whole = load_world();
+    Game* restored = load_world();
+    GameJournal* j = NULL;
+    int resident = (game != NULL) ? world_stream_get_resident(game_get_stream(game)) : -1;
+    BOOL built = FALSE;
+
+    j = game_state_journal_open(TEST_JOURNAL, game);
+    built = (game != NULL && world_stream_get_resident(game_get_stream(game)) != resident) ? TRUE : FALSE;
+    if (game != NULL && whole != NULL) {
+        play(game);
+        game_state_journal_append(j, game);
+        // Lit back as in the image, its region is clean and can be evicted
+        // while the change waits in the dirty list
+        space_set_illumination(game_get_space(game, 1), FALSE);
+        for (int i = 0; i < game_get_number_space(whole); i++)
+            game_get_space(game, space_get_id(game_get_space_at_position(whole, i)));
+        game_state_journal_append(j, game);
+        play(whole);
+        space_set_illumination(game_get_space(whole, 1), FALSE);
+    }
+    PRINT_TEST_RESULT(j != NULL && built == FALSE && restored != NULL &&
+                      game_state_load(TEST_JOURNAL, restored) == OK && same_state(whole, restored) == TRUE);
+    game_state_journal_close(&j);
+    if (game != NULL)
+        game_destroy(game);
+    if (whole != NULL)
+        game_destroy(whole);
+    if (restored != NULL)
+        game_destroy(restored);
+}
+
+void test_game_state_journal_twin_links() {
+    Game* game = load_world();
+    Game* restored = load_world();
+    GameJournal* j = game_state_journal_open(TEST_JOURNAL, game);
+    T_Direction twins[2] = {NORTH, DOWN};
+
+    // Two links of the test world lead from space 9 to 14 with the same id,
+    // each is closed and opened again with a delta in between
+    for (int i = 0; i < 2 && game != NULL; i++) {
+        Link* l = space_get_exit(game_get_space(game, 9), twins[i]);
+        link_set_opened(l, FALSE);
+        game_state_journal_append(j, game);
+        link_set_opened(l, TRUE);
+        game_state_journal_append(j, game);
+    }
+    PRINT_TEST_RESULT(j != NULL && restored != NULL && game_state_load(TEST_JOURNAL, restored) == OK &&
+                      same_state(game, restored) == TRUE);
+    game_state_journal_close(&j);
+    if (game != NULL)
+        game_destroy(game);
+    if (restored != NULL)
+        game_destroy(restored);
+}
+
+void test_all() {
+    test_game_state_save();
+    test_game_state_save_null();
+    test_game_state_check();
+    test_game_state_size();
+    test_game_state_load();
+    test_game_state_load_damaged();
+    test_game_state_load_other_world();
+    test_game_state_load_missing();
+    test_game_state_world_hash();
+    test_game_state_save_streamed();
+    test_game_state_load_streamed();
+    test_game_state_journal_open();
+    test_game_state_journal_append();
+    test_game_state_journal_unchanged();
+    test_game_state_journal_torn();
+    test_game_state_journal_compact();
+    test_game_state_journal_streamed();
+    test_game_state_journal_twin_links();
+
+    remove(TEST_STATE);
+    remove(TEST_JOURNAL);
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for GAME STATE unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("Game state test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_game_state_save();
+                break;
+            case 2:
+                test_game_state_save_null();
+                break;
+            case 3:
+                test_game_state_check();
+                break;
+            case 4:
+                test_game_state_size();
+                break;
+            case 5:
+                test_game_state_load();
+                break;
+            case 6:
+                test_game_state_load_damaged();
+                break;
+            case 7:
+                test_game_state_load_other_world();
+                break;
+            case 8:
+                test_game_state_load_missing();
+                break;
+            case 9:
+                test_game_state_world_hash();
+                break;
+            case 10:
+                test_game_state_journal_open();
+                break;
+            case 11:
+                test_game_state_journal_append();
+                break;
+            case 12:
+                test_game_state_journal_unchanged();
+                break;
+            case 13:
+                test_game_state_journal_torn();
+                break;
+            case 14:
+                test_game_state_journal_compact();
+                break;
+            case 15:
+                test_game_state_save_streamed();
+                break;
+            case 16:
+                test_game_state_load_streamed();
+                break;
+            case 17:
+                test_game_state_journal_streamed();
+                break;
+            case 18:
+                test_game_state_journal_twin_links();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * @brief It defines goose-compile, the tool that turns a text data file
+ * into a compiled world (.gwc). The game loads both, choosing by the
+ * first bytes of the file
+ *
+ * Usage: ./goose-compile [-r spaces] world.dat [world.gwc]
+ *
+ * -r sets the spaces of each region a streamed world is built by
+ *
+ * @file goose_compile.c
+ * @author Jiri Zak
+ * @version 2.0
+ * @date 26-05-2021
+ * @copyright GNU Public License
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/game.h"
+#include "../include/world_image.h"
+
+/**
+ * @brief name of the image when none is given, the data file name with
+ * its extension changed to .gwc
+ *
+ * @author Jiri Zak
+ * @date 25-05-2021
+ *
+ * @param input name of the data file
+ * @return new string to free or NULL if error
+ */
+char *goose_compile_output(const char *input);
+
+char *goose_compile_output(const char *input)
+{
+    const char *dot = strrchr(input, '.');
+    size_t len = (dot != NULL && strchr(dot, '/') == NULL) ? (size_t)(dot - input) : strlen(input);
+    char *output = malloc(len + sizeof(".gwc"));
+
+    if (output == NULL)
+        return NULL;
+    memcpy(output, input, len);
+    strcpy(output + len, ".gwc");
+    return output;
+}
+
+int main(int argc, char **argv)
+{
+    int first = 1;
+    if (argc > 2 && strcmp(argv[1], "-r") == 0)
+    {
+        if (world_image_set_region_spaces(atoi(argv[2])) == ERROR)
+        {
+            fprintf(stderr, "Wrong region size %s\n", argv[2]);
+            return 1;
+        }
+        first = 3;
+    }
+
+    if (argc - first < 1 || argc - first > 2)
+    {
+        fprintf(stderr, "Use: %s [-r spaces] <world.dat> [world.gwc]\n", argv[0]);
+        return 1;
+    }
+
+    char *output = (argc - first == 2) ? argv[first + 1] : goose_compile_output(argv[first]);
+    Game *game = game_init();
+    if (output == NULL || game == NULL || game_create_from_file(game, argv[first]) == ERROR)
+    {
+        fprintf(stderr, "Error loading %s\n", argv[first]);
+        return 1;
+    }
+
+    int status = 0;
+    if (world_image_save(output, game) == ERROR)
+    {
+        fprintf(stderr, "Error writing %s\n", output);
+        status = 1;
+    }
+    else
+    {
+        printf("%s: %d spaces, %d links, %d objects\n", output, game_get_number_space(game), game_get_number_link(game), game_get_number_object(game));
+    }
+
+    game_destroy(game);
+    if (argc - first == 1)
+        free(output);
+    return status;
+}
@@ -78,22 +78,23 @@ void graphic_engine_destroy(Graphic_engine *ge)
 
 char *graphic_engine_get_space_objects(Game *g, Space *s)
 {
-    if (space_objects_count(s) == 0)
+    int n = 0;
+    const Id *obj_ids = space_objects_view(s, &n);
+    if (n == 0)
         return NULL;
 
-    Id *obj_ids = space_get_objects(s);
     char *res = (char *)malloc(40);
-    char *object_names = res;
+    if (res == NULL)
+        return NULL;
     Object *obj = game_get_object(g, obj_ids[0]);
+    size_t used = (size_t)snprintf(res, 40, "%s", object_get_name(obj));
 
-    object_names += sprintf(object_names, "%s", object_get_name(obj));
-
-    for (int i = 1; i < space_objects_count(s); i++)
+    // The names that do not fit in the area are cut
+    for (int i = 1; i < n && used < 40; i++)
     {
         obj = game_get_object(g, obj_ids[i]);
-        object_names += sprintf(object_names, ", %s", object_get_name(obj));
+        used += (size_t)snprintf(res + used, 40 - used, ", %s", object_get_name(obj));
     }
-    free(obj_ids);
     return res;
 }
 
@@ -112,8 +113,8 @@ void graphic_engine_paint_game(Graphic_engine *ge, Game *game, STATUS s)
     if ((id_act = game_get_player_location(game)) != NO_ID)
     {
         space_act = game_get_space(game, id_act);
-        id_back = link_get_second_space(space_get_north(space_act));
-        id_next = link_get_second_space(space_get_south(space_act));
+        id_back = link_get_destination(space_get_exit(space_act, NORTH), id_act);
+        id_next = link_get_destination(space_get_exit(space_act, SOUTH), id_act);
         objects = graphic_engine_get_space_objects(game, space_act);
 
         if (id_back != NO_ID)
@@ -239,19 +240,19 @@ void graphic_engine_paint_description_area(Graphic_engine *ge, Game *game)
         screen_area_puts(ge->descript, str);
     }
 
-    Id *objectsOfPlayer = inventory_get_elements(player_get_inventory(game_get_player(game)));
+    int nObjectsOfPlayer = 0;
+    const Id *objectsOfPlayer = inventory_view(player_get_inventory(game_get_player(game)), &nObjectsOfPlayer);
     if (objectsOfPlayer != NULL)
     {
         sprintf(str, " ");
         screen_area_puts(ge->descript, str);
         sprintf(str, " Player objects: %s", object_get_name(game_get_object(game, objectsOfPlayer[0])));
         screen_area_puts(ge->descript, str);
-        for (int i = 1; i < inventory_get_nObjects(player_get_inventory(game_get_player(game))); i++)
+        for (int i = 1; i < nObjectsOfPlayer; i++)
         {
             sprintf(str, "                 %s", object_get_name(game_get_object(game, objectsOfPlayer[i])));
             screen_area_puts(ge->descript, str);
         }
-        free(objectsOfPlayer);
     }
 
     char *space_description = game_get_space_description(game);
@@ -0,0 +1,204 @@
+/**
+ * @brief Contains the implementation of the id table, an open addressing
+ * hash table with linear probing
+ *
+ * @file id_table.c
+ * @author Eva Moresova
+ * @version 1.0
+ * @date 12-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/id_table.h"
+
+#include <stdlib.h>
+
+#include "../include/arena.h"
+
+#define ID_TABLE_MIN_CAPACITY 4
+
+typedef struct _Entry {
+	Id id;          // NO_ID marks an empty slot
+	void* value;
+} Entry;
+
+struct _IdTable {
+	Entry* entries;
+	int capacity;   // always a power of two
+	int size;
+	Arena* arena;   // arena the table was created in, NULL if it was malloc'd
+};
+
+/** Private functions definitions */
+
+/**
+ * @brief index of the first slot to probe for the id
+ *
+ * @param t pointer to table
+ * @param id key
+ * @return slot index
+ */
+static int id_table_slot(IdTable* t, Id id);
+
+/**
+ * @brief allocates a new slot array and moves all the entries into it
+ *
+ * @param t pointer to table
+ * @param capacity new capacity, a power of two
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS id_table_rehash(IdTable* t, int capacity);
+
+/** Private functions implementation */
+
+static int id_table_slot(IdTable* t, Id id) {
+	/* Fibonacci hashing spreads consecutive ids over the whole table */
+	unsigned long long h = (unsigned long long)id * 11400714819323198485ull;
+	return (int)((h >> 32) & (unsigned long long)(t->capacity - 1));
+}
+
+static STATUS id_table_rehash(IdTable* t, int capacity) {
+	Entry* old = t->entries;
+	int old_capacity = t->capacity;
+
+	Entry* entries = (Entry*)((t->arena != NULL) ? arena_alloc(t->arena, sizeof(Entry) * capacity) : malloc(sizeof(Entry) * capacity));
+	if (entries == NULL)
+		return ERROR;
+	for (int i = 0; i < capacity; i++) {
+		entries[i].id = NO_ID;
+		entries[i].value = NULL;
+	}
+
+	t->entries = entries;
+	t->capacity = capacity;
+	for (int i = 0; i < old_capacity; i++) {
+		if (old[i].id == NO_ID)
+			continue;
+		int j = id_table_slot(t, old[i].id);
+		while (entries[j].id != NO_ID)
+			j = (j + 1) & (capacity - 1);
+		entries[j] = old[i];
+	}
+	if (t->arena == NULL)
+		free(old);
+	return OK;
+}
+
+/** Interface implementation */
+
+IdTable* id_table_create(Arena* a, int capacity) {
+	IdTable* t = (IdTable*)((a != NULL) ? arena_alloc(a, sizeof(IdTable)) : malloc(sizeof(IdTable)));
+	if (t == NULL)
+		return NULL;
+
+	int c = ID_TABLE_MIN_CAPACITY;
+	while (c < capacity * 2)
+		c *= 2;
+
+	t->entries = NULL;
+	t->capacity = 0;
+	t->size = 0;
+	t->arena = a;
+	if (id_table_rehash(t, c) == ERROR) {
+		if (a == NULL)
+			free(t);
+		return NULL;
+	}
+	return t;
+}
+
+STATUS id_table_destroy(IdTable** t) {
+	if (t == NULL || *t == NULL)
+		return OK;
+
+	if ((*t)->arena == NULL) {
+		free((*t)->entries);
+		free(*t);
+	}
+	*t = NULL;
+	return OK;
+}
+
+STATUS id_table_put(IdTable* t, Id id, void* value) {
+	if (t == NULL || id == NO_ID)
+		return ERROR;
+
+	/* keep the load factor under 3/4 */
+	if ((t->size + 1) * 4 > t->capacity * 3) {
+		if (id_table_rehash(t, t->capacity * 2) == ERROR)
+			return ERROR;
+	}
+
+	int i = id_table_slot(t, id);
+	while (t->entries[i].id != NO_ID) {
+		if (t->entries[i].id == id) {
+			t->entries[i].value = value;
+			return OK;
+		}
+		i = (i + 1) & (t->capacity - 1);
+	}
+	t->entries[i].id = id;
+	t->entries[i].value = value;
+	t->size++;
+	return OK;
+}
+
+void* id_table_get(IdTable* t, Id id) {
+	if (t == NULL || id == NO_ID)
+		return NULL;
+
+	int i = id_table_slot(t, id);
+	while (t->entries[i].id != NO_ID) {
+		if (t->entries[i].id == id)
+			return t->entries[i].value;
+		i = (i + 1) & (t->capacity - 1);
+	}
+	return NULL;
+}
+
+STATUS id_table_remove(IdTable* t, Id id) {
+	if (t == NULL || id == NO_ID)
+		return ERROR;
+
+	int mask = t->capacity - 1;
+	int i = id_table_slot(t, id);
+	while (t->entries[i].id != id) {
+		if (t->entries[i].id == NO_ID)
+			return ERROR;
+		i = (i + 1) & mask;
+	}
+
+	/* backward shift deletion, no tombstones are left behind */
+	int j = i;
+	for (;;) {
+		j = (j + 1) & mask;
+		if (t->entries[j].id == NO_ID)
+			break;
+		int k = id_table_slot(t, t->entries[j].id);
+		/* move the entry back only if its home slot is not between i and j */
+		if ((i <= j) ? (i < k && k <= j) : (i < k || k <= j))
+			continue;
+		t->entries[i] = t->entries[j];
+		i = j;
+	}
+	t->entries[i].id = NO_ID;
+	t->entries[i].value = NULL;
+	t->size--;
+	return OK;
+}
+
+STATUS id_table_clear(IdTable* t) {
+	if (t == NULL)
+		return ERROR;
+
+	for (int i = 0; i < t->capacity; i++) {
+		t->entries[i].id = NO_ID;
+		t->entries[i].value = NULL;
+	}
+	t->size = 0;
+	return OK;
+}
+
+int id_table_get_size(IdTable* t) {
+	return (t == NULL) ? -1 : t->size;
+}
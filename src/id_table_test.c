@@ -0,0 +1,172 @@
+/**
+ * @brief It tests id table module
+ *
+ * @file id_table_test.c
+ * @author Eva Moresova
+ * @version 1.0
+ * @date 12-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/id_table.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/test.h"
+#include "../include/types.h"
+
+void test_id_table_init() {
+    IdTable *t = id_table_create(NULL, 0);
+    PRINT_TEST_RESULT(t != NULL && id_table_get_size(t) == 0);
+    id_table_destroy(&t);
+}
+
+void test_id_table_destroy_null() {
+    IdTable *t = NULL;
+    id_table_destroy(&t);
+    PRINT_TEST_RESULT(t == NULL);
+}
+
+void test_id_table_put_get() {
+    IdTable *t = id_table_create(NULL, 4);
+    int a = 1, b = 2;
+    id_table_put(t, 7, &a);
+    id_table_put(t, 9, &b);
+    PRINT_TEST_RESULT(id_table_get(t, 7) == &a && id_table_get(t, 9) == &b);
+    id_table_destroy(&t);
+}
+
+void test_id_table_put_replace() {
+    IdTable *t = id_table_create(NULL, 4);
+    int a = 1, b = 2;
+    id_table_put(t, 7, &a);
+    id_table_put(t, 7, &b);
+    PRINT_TEST_RESULT(id_table_get(t, 7) == &b && id_table_get_size(t) == 1);
+    id_table_destroy(&t);
+}
+
+void test_id_table_put_no_id() {
+    IdTable *t = id_table_create(NULL, 4);
+    int a = 1;
+    PRINT_TEST_RESULT(id_table_put(t, NO_ID, &a) == ERROR);
+    id_table_destroy(&t);
+}
+
+void test_id_table_get_missing() {
+    IdTable *t = id_table_create(NULL, 4);
+    PRINT_TEST_RESULT(id_table_get(t, 3) == NULL);
+    id_table_destroy(&t);
+}
+
+void test_id_table_grow() {
+    IdTable *t = id_table_create(NULL, 0);
+    static int values[1000];
+    BOOL ok = TRUE;
+    for (int i = 0; i < 1000; i++)
+        id_table_put(t, i * 3, &values[i]);
+    for (int i = 0; i < 1000; i++)
+        if (id_table_get(t, i * 3) != &values[i])
+            ok = FALSE;
+    PRINT_TEST_RESULT(ok == TRUE && id_table_get_size(t) == 1000);
+    id_table_destroy(&t);
+}
+
+void test_id_table_remove() {
+    IdTable *t = id_table_create(NULL, 0);
+    static int values[100];
+    BOOL ok = TRUE;
+    for (int i = 0; i < 100; i++)
+        id_table_put(t, i, &values[i]);
+    for (int i = 0; i < 100; i += 2)
+        id_table_remove(t, i);
+    for (int i = 0; i < 100; i++)
+        if (id_table_get(t, i) != ((i % 2) ? &values[i] : NULL))
+            ok = FALSE;
+    PRINT_TEST_RESULT(ok == TRUE && id_table_get_size(t) == 50);
+    id_table_destroy(&t);
+}
+
+void test_id_table_remove_missing() {
+    IdTable *t = id_table_create(NULL, 0);
+    PRINT_TEST_RESULT(id_table_remove(t, 5) == ERROR);
+    id_table_destroy(&t);
+}
+
+void test_id_table_clear() {
+    IdTable *t = id_table_create(NULL, 0);
+    int a = 1;
+    id_table_put(t, 1, &a);
+    id_table_clear(t);
+    PRINT_TEST_RESULT(id_table_get(t, 1) == NULL && id_table_get_size(t) == 0);
+    id_table_destroy(&t);
+}
+
+void test_all() {
+    test_id_table_init();
+    test_id_table_destroy_null();
+    test_id_table_put_get();
+    test_id_table_put_replace();
+    test_id_table_put_no_id();
+    test_id_table_get_missing();
+    test_id_table_grow();
+    test_id_table_remove();
+    test_id_table_remove_missing();
+    test_id_table_clear();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for ID TABLE unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("Id table test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_id_table_init();
+                break;
+            case 2:
+                test_id_table_destroy_null();
+                break;
+            case 3:
+                test_id_table_put_get();
+                break;
+            case 4:
+                test_id_table_put_replace();
+                break;
+            case 5:
+                test_id_table_put_no_id();
+                break;
+            case 6:
+                test_id_table_get_missing();
+                break;
+            case 7:
+                test_id_table_grow();
+                break;
+            case 8:
+                test_id_table_remove();
+                break;
+            case 9:
+                test_id_table_remove_missing();
+                break;
+            case 10:
+                test_id_table_clear();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * @brief It implements the string interning interface. The texts of a pool
+ * are kept in an arena of its own, each one after a small header with its
+ * length and its lower case handle. A name table finds them by text.
+ *
+ * @file intern.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 21-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/intern.h"
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/arena.h"
+#include "../include/name_table.h"
+
+#define INTERN_TABLE_SIZE 256
+#define INTERN_CHUNK 16384
+/* texts up to this length are lowered on the stack */
+#define INTERN_BUFFER 256
+
+typedef struct {
+    const char *self;    // the handle, to recognize a handle given back to intern_string
+    const char *folded;  // handle of the lower case text, itself if it has no upper case
+    size_t length;
+} InternHeader;
+
+struct _InternPool {
+    NameTable *strings;  // text -> handle, the keys are the handles themselves
+    Arena *storage;
+};
+
+/**
+ * @brief header stored before a handle
+ *
+ * @param h handle
+ * @return pointer to the header
+ */
+static InternHeader *intern_header(const char *h);
+
+/**
+ * @brief calls fn with the lower case version of s
+ *
+ * @param p pointer to InternPool
+ * @param s text
+ * @param fn intern_string or intern_find
+ * @return what fn returns or NULL if error
+ */
+static const char *intern_lowered(InternPool *p, const char *s, const char *(*fn)(InternPool *, const char *));
+
+static InternHeader *intern_header(const char *h) {
+    return (InternHeader *)h - 1;
+}
+
+static const char *intern_lowered(InternPool *p, const char *s, const char *(*fn)(InternPool *, const char *)) {
+    char buffer[INTERN_BUFFER];
+    size_t len = strlen(s);
+    char *lower = (len < INTERN_BUFFER) ? buffer : malloc(len + 1);
+    if (lower == NULL)
+        return NULL;
+
+    for (size_t i = 0; i <= len; i++)
+        lower[i] = (char)tolower((unsigned char)s[i]);
+    const char *h = fn(p, lower);
+
+    if (lower != buffer)
+        free(lower);
+    return h;
+}
+
+InternPool *intern_create() {
+    InternPool *p = malloc(sizeof(InternPool));
+    if (p == NULL)
+        return NULL;
+
+    p->strings = name_table_create(INTERN_TABLE_SIZE, FALSE);
+    p->storage = arena_create(INTERN_CHUNK);
+    if (p->strings == NULL || p->storage == NULL) {
+        intern_destroy(&p);
+        return NULL;
+    }
+    return p;
+}
+
+STATUS intern_destroy(InternPool **p) {
+    if (p == NULL || *p == NULL)
+        return ERROR;
+
+    name_table_destroy(&(*p)->strings);
+    arena_destroy(&(*p)->storage);
+    free(*p);
+    *p = NULL;
+    return OK;
+}
+
+STATUS intern_clear(InternPool *p) {
+    if (p == NULL)
+        return ERROR;
+
+    name_table_clear(p->strings);
+    arena_reset(p->storage);
+    return OK;
+}
+
+const char *intern_string(InternPool *p, const char *s) {
+    if (p == NULL || s == NULL)
+        return NULL;
+
+    // The setters intern what they are given, often a handle already
+    if (arena_owns(p->storage, s) && intern_header(s)->self == s)
+        return s;
+
+    const char *h = name_table_get(p->strings, s);
+    if (h != NULL)
+        return h;
+
+    size_t len = strlen(s);
+    InternHeader *header = arena_alloc(p->storage, sizeof(InternHeader) + len + 1);
+    if (header == NULL)
+        return NULL;
+    char *text = (char *)(header + 1);
+    memcpy(text, s, len + 1);
+    header->self = text;
+    header->length = len;
+    header->folded = text;
+
+    for (size_t i = 0; i < len; i++) {
+        if (isupper((unsigned char)s[i])) {
+            header->folded = intern_lowered(p, s, intern_string);
+            break;
+        }
+    }
+    if (header->folded == NULL || name_table_put(p->strings, text, text) == ERROR)
+        return NULL;
+    return text;
+}
+
+const char *intern_string_n(InternPool *p, const char *s, size_t len) {
+    char buffer[INTERN_BUFFER];
+    if (p == NULL || s == NULL)
+        return NULL;
+
+    char *text = (len < INTERN_BUFFER) ? buffer : malloc(len + 1);
+    if (text == NULL)
+        return NULL;
+    memcpy(text, s, len);
+    text[len] = '\0';
+    const char *h = intern_string(p, text);
+
+    if (text != buffer)
+        free(text);
+    return h;
+}
+
+const char *intern_find(InternPool *p, const char *s) {
+    if (p == NULL || s == NULL)
+        return NULL;
+
+    return name_table_get(p->strings, s);
+}
+
+const char *intern_find_folded(InternPool *p, const char *s) {
+    if (p == NULL || s == NULL)
+        return NULL;
+
+    return intern_lowered(p, s, intern_find);
+}
+
+const char *intern_fold(const char *h) {
+    return h != NULL ? intern_header(h)->folded : NULL;
+}
+
+size_t intern_length(const char *h) {
+    return h != NULL ? intern_header(h)->length : 0;
+}
+
+Id intern_key(const char *h) {
+    return h != NULL ? (Id)(intptr_t)h : NO_ID;
+}
+
+int intern_get_count(InternPool *p) {
+    return p != NULL ? name_table_get_size(p->strings) : -1;
+}
@@ -0,0 +1,217 @@
+/**
+ * @brief It tests the intern module
+ *
+ * @file intern_test.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 21-05-2021
+ * @copyright GNU Public License
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/intern.h"
+#include "../include/test.h"
+#include "../include/types.h"
+
+void test_intern_string() {
+    InternPool* p = intern_create();
+    const char* h = intern_string(p, "Hall");
+    PRINT_TEST_RESULT(h != NULL && strcmp(h, "Hall") == 0);
+    intern_destroy(&p);
+}
+
+void test_intern_string_null() {
+    InternPool* p = intern_create();
+    PRINT_TEST_RESULT(intern_string(p, NULL) == NULL);
+    intern_destroy(&p);
+}
+
+void test_intern_same_handle() {
+    InternPool* p = intern_create();
+    char copy[] = "Kitchen";
+    PRINT_TEST_RESULT(intern_string(p, "Kitchen") == intern_string(p, copy));
+    intern_destroy(&p);
+}
+
+void test_intern_different_handle() {
+    InternPool* p = intern_create();
+    PRINT_TEST_RESULT(intern_string(p, "Door") != intern_string(p, "door"));
+    intern_destroy(&p);
+}
+
+void test_intern_stored_once() {
+    InternPool* p = intern_create();
+    int before = 0;
+    intern_string(p, "Garden");
+    before = intern_get_count(p);
+    intern_string(p, "Garden");
+    PRINT_TEST_RESULT(intern_get_count(p) == before);
+    intern_destroy(&p);
+}
+
+void test_intern_find() {
+    InternPool* p = intern_create();
+    intern_string(p, "Cellar");
+    PRINT_TEST_RESULT(intern_find(p, "Cellar") == intern_string(p, "Cellar") && intern_find(p, "Attic") == NULL);
+    intern_destroy(&p);
+}
+
+void test_intern_fold() {
+    InternPool* p = intern_create();
+    const char* a = intern_string(p, "SafeDoor");
+    const char* b = intern_string(p, "SAFEdoor");
+    PRINT_TEST_RESULT(a != b && intern_fold(a) == intern_fold(b) && intern_fold(a) == intern_string(p, "safedoor"));
+    intern_destroy(&p);
+}
+
+void test_intern_fold_lower() {
+    InternPool* p = intern_create();
+    const char* h = intern_string(p, "lamp");
+    PRINT_TEST_RESULT(intern_fold(h) == h);
+    intern_destroy(&p);
+}
+
+void test_intern_find_folded() {
+    InternPool* p = intern_create();
+    intern_string(p, "Bedroom");
+    PRINT_TEST_RESULT(intern_find_folded(p, "BEDROOM") == intern_find(p, "bedroom") && intern_find_folded(p, "Nowhere") == NULL);
+    intern_destroy(&p);
+}
+
+void test_intern_length() {
+    InternPool* p = intern_create();
+    PRINT_TEST_RESULT(intern_length(intern_string(p, "Hall")) == 4 && intern_length(NULL) == 0);
+    intern_destroy(&p);
+}
+
+void test_intern_key() {
+    InternPool* p = intern_create();
+    const char* h = intern_string(p, "Hall");
+    PRINT_TEST_RESULT(intern_key(h) == intern_key(intern_string(p, "Hall")) && intern_key(h) != intern_key(intern_string(p, "Kitchen")) && intern_key(NULL) == NO_ID);
+    intern_destroy(&p);
+}
+
+void test_intern_string_n() {
+    InternPool* p = intern_create();
+    const char* line = "Hall|Kitchen|";
+    PRINT_TEST_RESULT(intern_string_n(p, line, 4) == intern_string(p, "Hall") && intern_string_n(p, line + 5, 7) == intern_string(p, "Kitchen"));
+    intern_destroy(&p);
+}
+
+void test_intern_pools() {
+    InternPool* p = intern_create();
+    InternPool* q = intern_create();
+    const char* h = intern_string(p, "Hall");
+    // A text is stored once per pool, the other pool does not know it
+    PRINT_TEST_RESULT(h != intern_string(q, "Hall") && intern_find(q, "Kitchen") == NULL &&
+                      intern_string(q, h) != h && intern_string(p, h) == h);
+    intern_destroy(&p);
+    intern_destroy(&q);
+}
+
+void test_intern_clear() {
+    InternPool* p = intern_create();
+    intern_string(p, "Hall");
+    intern_string(p, "Kitchen");
+    PRINT_TEST_RESULT(intern_clear(p) == OK && intern_get_count(p) == 0 && intern_find(p, "Hall") == NULL &&
+                      intern_length(intern_string(p, "Hall")) == 4 && intern_clear(NULL) == ERROR);
+    intern_destroy(&p);
+}
+
+void test_intern_null() {
+    InternPool* p = NULL;
+    PRINT_TEST_RESULT(intern_destroy(&p) == ERROR && intern_string(NULL, "Hall") == NULL && intern_find(NULL, "Hall") == NULL &&
+                      intern_get_count(NULL) == -1);
+}
+
+void test_all() {
+    test_intern_string();
+    test_intern_string_null();
+    test_intern_same_handle();
+    test_intern_different_handle();
+    test_intern_stored_once();
+    test_intern_find();
+    test_intern_fold();
+    test_intern_fold_lower();
+    test_intern_find_folded();
+    test_intern_length();
+    test_intern_key();
+    test_intern_string_n();
+    test_intern_pools();
+    test_intern_clear();
+    test_intern_null();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for INTERN unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("Intern test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_intern_string();
+                break;
+            case 2:
+                test_intern_string_null();
+                break;
+            case 3:
+                test_intern_same_handle();
+                break;
+            case 4:
+                test_intern_different_handle();
+                break;
+            case 5:
+                test_intern_stored_once();
+                break;
+            case 6:
+                test_intern_find();
+                break;
+            case 7:
+                test_intern_fold();
+                break;
+            case 8:
+                test_intern_fold_lower();
+                break;
+            case 9:
+                test_intern_find_folded();
+                break;
+            case 10:
+                test_intern_length();
+                break;
+            case 11:
+                test_intern_key();
+                break;
+            case 12:
+                test_intern_string_n();
+                break;
+            case 13:
+                test_intern_pools();
+                break;
+            case 14:
+                test_intern_clear();
+                break;
+            case 15:
+                test_intern_null();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
@@ -13,37 +13,44 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include "../include/arena.h"
+
 
 
 struct _Inventory
 {
 	Set *objects; //Pointer to the set of items
 	int capacity; //Capacity of the inventory
+	BOOL dirty; //Changed since the game was loaded or saved
+	Arena *arena; //Arena the inventory was taken from, NULL if it was malloc'd
 };
 
 
 
-Inventory *inventory_create(int cap)
+Inventory *inventory_create(Arena *a, int cap)
 {
 	Inventory *i = NULL;
 
 	if (cap < MIN_CAP_INV)
 		return NULL;
 
-	i = (Inventory *)malloc(sizeof(Inventory));
+	i = (Inventory *)((a != NULL) ? arena_alloc(a, sizeof(Inventory)) : malloc(sizeof(Inventory)));
 	if (i == NULL)
 	{
 		return NULL;
 	}
+	i->arena = a;
 
-	i->objects = set_create();
+	i->objects = set_create(a);
 	if (i->objects == NULL)
 	{
-		free(i);
+		if (a == NULL)
+			free(i);
 		return NULL;
 	}
 
 	i->capacity = cap;
+	i->dirty = FALSE;
 
 	return i;
 }
@@ -55,7 +62,8 @@ void inventory_destroy(Inventory **i)
 		return;
 	}
 	set_destroy(&(*i)->objects);
-	free(*i);
+	if ((*i)->arena == NULL)
+		free(*i);
 	*i = NULL;
 	return;
 }
@@ -91,7 +99,12 @@ STATUS inventory_add_id(Inventory *i, Id id)
 		return ERROR;
 	}
 
-	return set_add(i->objects, id);
+	if (set_add(i->objects, id) == ERROR)
+	{
+		return ERROR;
+	}
+	i->dirty = TRUE;
+	return OK;
 }
 
 STATUS inventory_del_id(Inventory *i, Id id)
@@ -101,7 +114,31 @@ STATUS inventory_del_id(Inventory *i, Id id)
 		return ERROR;
 	}
 
-	return (set_delete(i->objects, id));
+	if (set_delete(i->objects, id) == ERROR)
+	{
+		return ERROR;
+	}
+	i->dirty = TRUE;
+	return OK;
+}
+
+BOOL inventory_get_dirty(Inventory *i)
+{
+	if (i == NULL)
+	{
+		return FALSE;
+	}
+	return i->dirty;
+}
+
+STATUS inventory_set_dirty(Inventory *i, BOOL dirty)
+{
+	if (i == NULL)
+	{
+		return ERROR;
+	}
+	i->dirty = dirty;
+	return OK;
 }
 
 STATUS inventory_add_object(Inventory *i, Object *o)
@@ -142,26 +179,26 @@ Id *inventory_get_elements(Inventory *i)
 	return set_get_elements(i->objects);
 }
 
-BOOL inventory_has_id(Inventory *i, Id id)
+const Id *inventory_view(Inventory *i, int *count)
 {
-	Id *ids = inventory_get_elements(i);
-
-	if (i == NULL || id == NO_ID || ids == NULL)
+	if (i == NULL)
 	{
-		return FALSE;
+		if (count != NULL)
+			*count = 0;
+		return NULL;
 	}
 
-	for (int j = 0; j < i->capacity; j++)
+	return set_iter(i->objects, count);
+}
+
+BOOL inventory_has_id(Inventory *i, Id id)
+{
+	if (i == NULL || id == NO_ID)
 	{
-		if (ids[j] == id)
-		{
-			free(ids);
-			return TRUE;
-		}
+		return FALSE;
 	}
 
-	free(ids);
-	return FALSE;
+	return set_element_exists(i->objects, id);
 }
 
 int inventory_print(Inventory *inv, FILE *f)
@@ -182,14 +219,14 @@ STATUS inventory_save(FILE* fp, Inventory* i) {
 	if (i == NULL || fp == NULL) return ERROR;
 
 	//#i|1|2|3|4...
-	Id* ids = inventory_get_elements(i);
+	int n = 0;
+	const Id* ids = inventory_view(i, &n);
 	if (ids != NULL) {
 		fprintf(fp, "#i");
-		for (int j = 0; j < inventory_get_nObjects(i); j++) {
+		for (int j = 0; j < n; j++) {
 			fprintf(fp, "|%ld", ids[j]);
 		}
 		fprintf(fp, "\n");
-		free(ids);
 	}
 	return OK;
 }
\ No newline at end of file
@@ -16,21 +16,23 @@
 #include "../include/test.h"
 #include "../include/types.h"
 
+static InternPool *strings = NULL; //Pool the tested entities intern their texts in
+
 void test_inventory_create()
 {
-    Inventory *i = inventory_create(5);
+    Inventory *i = inventory_create(NULL, 5);
     PRINT_TEST_RESULT(i != NULL);
 }
 
 void test_inventory_create_wrong_cap()
 {
-    Inventory *i = inventory_create(-1);
+    Inventory *i = inventory_create(NULL, -1);
     PRINT_TEST_RESULT(i == NULL);
 }
 
 void test_inventory_destroy()
 {
-    Inventory *i = inventory_create(5);
+    Inventory *i = inventory_create(NULL, 5);
     inventory_destroy(&i);
     PRINT_TEST_RESULT(i == NULL);
 }
@@ -44,7 +46,7 @@ void test_inventory_destroy_null()
 
 void test_inventory_get_capacity()
 {
-    Inventory *i = inventory_create(5);
+    Inventory *i = inventory_create(NULL, 5);
     PRINT_TEST_RESULT(inventory_get_capacity(i) == 5);
     inventory_destroy(&i);
 }
@@ -57,14 +59,14 @@ void test_inventory_get_capacity_null()
 
 void test_inventory_add_id()
 {
-    Inventory *i = inventory_create(5);
+    Inventory *i = inventory_create(NULL, 5);
     PRINT_TEST_RESULT(inventory_add_id(i, 123) == OK);
     inventory_destroy(&i);
 }
 
 void test_inventory_add_no_id()
 {
-    Inventory *i = inventory_create(5);
+    Inventory *i = inventory_create(NULL, 5);
     PRINT_TEST_RESULT(inventory_add_id(i, NO_ID) == ERROR);
     inventory_destroy(&i);
 }
@@ -77,7 +79,7 @@ void test_inventory_add_id_to_null()
 
 void test_inventory_del_id()
 {
-    Inventory *i = inventory_create(5);
+    Inventory *i = inventory_create(NULL, 5);
     inventory_add_id(i, 123);
     PRINT_TEST_RESULT(inventory_del_id(i, 123) == OK);
     inventory_destroy(&i);
@@ -85,7 +87,7 @@ void test_inventory_del_id()
 
 void test_inventory_del_notexisting_id()
 {
-    Inventory *i = inventory_create(5);
+    Inventory *i = inventory_create(NULL, 5);
     inventory_add_id(i, 123);
     PRINT_TEST_RESULT(inventory_del_id(i, 124) == ERROR);
     inventory_destroy(&i);
@@ -93,7 +95,7 @@ void test_inventory_del_notexisting_id()
 
 void test_inventory_del_noid()
 {
-    Inventory *i = inventory_create(5);
+    Inventory *i = inventory_create(NULL, 5);
     inventory_add_id(i, 123);
     PRINT_TEST_RESULT(inventory_del_id(i, NO_ID) == ERROR);
     inventory_destroy(&i);
@@ -107,7 +109,7 @@ void test_inventory_del_id_from_null()
 
 void test_inventory_isFull_it_is()
 {
-    Inventory *i = inventory_create(1);
+    Inventory *i = inventory_create(NULL, 1);
     inventory_add_id(i, 123);
     PRINT_TEST_RESULT(inventory_isFull(i) == TRUE);
     inventory_destroy(&i);
@@ -115,7 +117,7 @@ void test_inventory_isFull_it_is()
 
 void test_inventory_isFull_it_is_not()
 {
-    Inventory *i = inventory_create(2);
+    Inventory *i = inventory_create(NULL, 2);
     inventory_add_id(i, 123);
     PRINT_TEST_RESULT(inventory_isFull(i) == FALSE);
     inventory_destroy(&i);
@@ -129,14 +131,14 @@ void test_inventory_isFull_from_null()
 
 void test_inventory_isEmpty_it_is()
 {
-    Inventory *i = inventory_create(1);
+    Inventory *i = inventory_create(NULL, 1);
     PRINT_TEST_RESULT(inventory_isEmpty(i) == TRUE);
     inventory_destroy(&i);
 }
 
 void test_inventory_isEmpty_it_is_not()
 {
-    Inventory *i = inventory_create(1);
+    Inventory *i = inventory_create(NULL, 1);
     inventory_add_id(i, 123);
     PRINT_TEST_RESULT(inventory_isEmpty(i) == FALSE);
     inventory_destroy(&i);
@@ -150,8 +152,8 @@ void test_inventory_isEmpty_from_null()
 
 void test_inventory_add_object()
 {
-    Inventory *i = inventory_create(4);
-    Object *o = object_create(12);
+    Inventory *i = inventory_create(NULL, 4);
+    Object *o = object_create(NULL, strings, 12);
     PRINT_TEST_RESULT(inventory_add_object(i, o) == OK);
     object_destroy(&o);
     inventory_destroy(&i);
@@ -159,7 +161,7 @@ void test_inventory_add_object()
 
 void test_inventory_add_object_null_obj()
 {
-    Inventory *i = inventory_create(4);
+    Inventory *i = inventory_create(NULL, 4);
     Object *o = NULL;
     PRINT_TEST_RESULT(inventory_add_object(i, o) == ERROR);
     inventory_destroy(&i);
@@ -168,15 +170,15 @@ void test_inventory_add_object_null_obj()
 void test_inventory_add_object_to_null()
 {
     Inventory *i = NULL;
-    Object *o = object_create(12);
+    Object *o = object_create(NULL, strings, 12);
     PRINT_TEST_RESULT(inventory_add_object(i, o) == ERROR);
     object_destroy(&o);
 }
 
 void test_inventory_get_nobjects()
 {
-    Inventory *i = inventory_create(4);
-    Object *o = object_create(12);
+    Inventory *i = inventory_create(NULL, 4);
+    Object *o = object_create(NULL, strings, 12);
     inventory_add_object(i, o);
     inventory_add_id(i, 13);
     PRINT_TEST_RESULT(inventory_get_nObjects(i) == 2);
@@ -192,7 +194,7 @@ void test_inventory_get_nobjects_from_null()
 
 void test_inventory_get_elements()
 {
-    Inventory *i = inventory_create(4);
+    Inventory *i = inventory_create(NULL, 4);
     inventory_add_id(i, 13);
     PRINT_TEST_RESULT(inventory_get_elements(i) != NULL);
     inventory_destroy(&i);
@@ -206,7 +208,7 @@ void test_inventory_get_elements_null()
 
 void test_inventory_has_id()
 {
-    Inventory *i = inventory_create(4);
+    Inventory *i = inventory_create(NULL, 4);
     inventory_add_id(i, 14);
     PRINT_TEST_RESULT(inventory_has_id(i, 14) == TRUE);
     inventory_destroy(&i);
@@ -214,7 +216,7 @@ void test_inventory_has_id()
 
 void test_inventory_has_id_no()
 {
-    Inventory *i = inventory_create(4);
+    Inventory *i = inventory_create(NULL, 4);
     inventory_add_id(i, 14);
     PRINT_TEST_RESULT(inventory_has_id(i, 13) == FALSE);
     inventory_destroy(&i);
@@ -222,7 +224,7 @@ void test_inventory_has_id_no()
 
 void test_inventory_has_id_noid()
 {
-    Inventory *i = inventory_create(4);
+    Inventory *i = inventory_create(NULL, 4);
     inventory_add_id(i, 14);
     PRINT_TEST_RESULT(inventory_has_id(i, NO_ID) == FALSE);
     inventory_destroy(&i);
@@ -281,10 +283,12 @@ void test_all()
  */
 int main()
 {
+    strings = intern_create();
     printf("Inventory test\n");
     printf("=========================\n");
 
     test_all();
 
+    intern_destroy(&strings);
     return 0;
 }
\ No newline at end of file
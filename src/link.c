@@ -14,14 +14,30 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../include/arena.h"
+#include "../include/dirty_list.h"
+#include "../include/intern.h"
+
 struct _Link {
     Id id;
-    char name[WORD_SIZE + 1];
+    const char *name;  // interned
     Id first;
     Id second;
     BOOL opened;
+    BOOL dirty;  // changed since the game was loaded or saved
+    Arena *arena;  // arena the link was taken from, NULL if it was malloc'd
+    InternPool *strings;  // pool its name is interned in
+    DirtyList *changes;  // list it is pushed on when it stops being clean, NULL if none
 };
 
+/**
+ * @brief marks a link as changed, pushing it on its dirty list if it was
+ * clean
+ *
+ * @param l pointer to Link
+ */
+static void link_mark_dirty(Link* l);
+
 BOOL link_exist(Link* l) {
     return l == NULL ? FALSE : TRUE;
 }
@@ -30,16 +46,24 @@ BOOL link_not_exist(Link* l) {
     return !link_exist(l);
 }
 
-Link* link_create() {
-    Link* l = malloc(sizeof(Link));
+Link* link_create(Arena* a, InternPool* strings) {
+    if (strings == NULL)
+        return NULL;
+
+    Link* l = (a != NULL) ? arena_alloc(a, sizeof(Link)) : malloc(sizeof(Link));
     if (link_not_exist(l))
         return NULL;
 
+    l->arena = a;
+    l->strings = strings;
+
     l->id = NO_ID;
-    l->name[0] = '\0';
+    l->name = intern_string(strings, "");
     l->first = -1;
     l->second = -1;
     l->opened = TRUE;
+    l->dirty = FALSE;
+    l->changes = NULL;
     return l;
 }
 
@@ -57,7 +81,8 @@ STATUS link_destroy(Link** l) {
         return ERROR;
     }
 
-    free(*l);
+    if ((*l)->arena == NULL)
+        free(*l);
     *l = NULL;
 
     return OK;
@@ -68,9 +93,11 @@ STATUS link_set_name(Link* l, char* name) {
         return ERROR;
     }
 
-    if (!strcpy(l->name, name)) {
+    const char* h = intern_string(l->strings, name);
+    if (h == NULL) {
         return ERROR;
     }
+    l->name = h;
 
     return OK;
 }
@@ -108,13 +135,55 @@ Id link_get_second_space(Link* l) {
     return l->second;
 }
 
+Id link_get_destination(Link* l, Id from) {
+    if (link_not_exist(l))
+        return NO_ID;
+    if (l->first == from)
+        return l->second;
+    if (l->second == from)
+        return l->first;
+    return NO_ID;
+}
+
 STATUS link_set_opened(Link* l, BOOL opened) {
     if (link_not_exist(l))
         return FALSE;
+    if (l->opened != opened)
+        link_mark_dirty(l);
     l->opened = opened;
     return OK;
 }
 
+STATUS link_set_dirty(Link* l, BOOL dirty) {
+    if (link_not_exist(l))
+        return ERROR;
+    if (dirty == TRUE)
+        link_mark_dirty(l);
+    else
+        l->dirty = FALSE;
+    return OK;
+}
+
+STATUS link_set_dirty_list(Link* l, DirtyList* changes) {
+    if (link_not_exist(l))
+        return ERROR;
+    l->changes = changes;
+    return OK;
+}
+
+static void link_mark_dirty(Link* l) {
+    // A link is told by its spaces too, two of them can share an id
+    if (l->dirty == FALSE && l->changes != NULL)
+        dirty_list_push(l->changes, DIRTY_LINK, l->id, l->first, l->second);
+    l->dirty = TRUE;
+}
+
+BOOL link_get_dirty(Link* l) {
+    if (link_not_exist(l))
+        return FALSE;
+    return l->dirty;
+}
+
 BOOL link_get_opened(Link* l) {
     if (link_not_exist(l))
         return FALSE;
@@ -128,7 +197,7 @@ void link_print(Link* l) {
 STATUS link_save(FILE* fp, Link* l) {
 	if (l == NULL || fp == NULL) return ERROR;
 	
-	//#l:1|Lnk1|1|2|0|
-	fprintf(fp, "#l:%ld|%s|%ld|%ld|%d|\n", l->id, l->name, l->first, l->second, l->opened);
+	//#l:1|Lnk1|1|2|0|, 0 is opened
+	fprintf(fp, "#l:%ld|%s|%ld|%ld|%d|\n", l->id, l->name, l->first, l->second, l->opened == TRUE ? 0 : 1);
 	return OK;
 } 
\ No newline at end of file
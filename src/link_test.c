@@ -17,13 +17,15 @@
 #include "../include/test.h"
 #include "../include/types.h"
 
+static InternPool *strings = NULL; //Pool the tested entities intern their texts in
+
 void test_link_init() {
-    Link *l = link_create();
+    Link *l = link_create(NULL, strings);
     PRINT_TEST_RESULT(l != NULL);
 }
 
 void test_link_destroy() {
-    Link *l = link_create();
+    Link *l = link_create(NULL, strings);
     link_destroy(&l);
     PRINT_TEST_RESULT(l == NULL);
 }
@@ -35,13 +37,13 @@ void test_link_destroy_null() {
 }
 
 void test_link_set_id() {
-	Link *l = link_create();
+	Link *l = link_create(NULL, strings);
 	link_set_id(l, 1);
 	PRINT_TEST_RESULT(link_get_id(l) == 1);
 }
 
 void test_link_get_id() {
-    Link *l = link_create();
+    Link *l = link_create(NULL, strings);
     PRINT_TEST_RESULT(link_get_id(l) == NO_ID);
 }
 
@@ -51,7 +53,7 @@ void test_link_get_id_from_null() {
 }
 
 void test_link_set_name() {
-    Link *l = link_create();
+    Link *l = link_create(NULL, strings);
     PRINT_TEST_RESULT(link_set_name(l, "name") == 1);
 }
 
@@ -61,7 +63,7 @@ void test_link_set_name_to_null() {
 }
 
 void test_link_get_name() {
-    Link *l = link_create();
+    Link *l = link_create(NULL, strings);
     link_set_name(l, "name");
     PRINT_TEST_RESULT(strcmp(link_get_name(l), "name") == 0);
 }
@@ -72,7 +74,7 @@ void test_link_get_name_from_null() {
 }
 
 void test_link_set_first_space_id() {
-    Link *l = link_create();
+    Link *l = link_create(NULL, strings);
     PRINT_TEST_RESULT(link_set_first_space(l, 2) == 1);
 }
 
@@ -82,7 +84,7 @@ void test_link_set_first_space_id_to_null() {
 }
 
 void test_link_get_first_space_id() {
-    Link *l = link_create();
+    Link *l = link_create(NULL, strings);
     link_set_first_space(l, 2);
     PRINT_TEST_RESULT(link_get_first_space(l) == 2);
 }
@@ -93,7 +95,7 @@ void test_link_get_first_space_id_from_null() {
 }
 
 void test_link_set_second_space_id() {
-    Link *l = link_create();
+    Link *l = link_create(NULL, strings);
     PRINT_TEST_RESULT(link_set_second_space(l, 2) == 1);
 }
 
@@ -103,7 +105,7 @@ void test_link_set_second_space_id_to_null() {
 }
 
 void test_link_get_second_space_id() {
-    Link *l = link_create();
+    Link *l = link_create(NULL, strings);
     link_set_second_space(l, 2);
     PRINT_TEST_RESULT(link_get_second_space(l) == 2);
 }
@@ -114,7 +116,7 @@ void test_link_get_second_space_id_from_null() {
 }
 
 void test_link_set_opened() {
-    Link *l = link_create();
+    Link *l = link_create(NULL, strings);
     PRINT_TEST_RESULT(link_set_opened(l, FALSE) == 1);
 }
 
@@ -124,7 +126,7 @@ void test_link_set_opened_to_null() {
 }
 
 void test_link_get_opened() {
-    Link *l = link_create();
+    Link *l = link_create(NULL, strings);
     link_set_opened(l, FALSE);
     PRINT_TEST_RESULT(link_get_opened(l) == FALSE);
 }
@@ -134,6 +136,35 @@ void test_link_get_opened_from_null() {
     PRINT_TEST_RESULT(link_get_opened(l) == FALSE);
 }
 
+void test_link_get_destination() {
+    Link *l = link_create(NULL, strings);
+    link_set_first_space(l, 1);
+    link_set_second_space(l, 2);
+    PRINT_TEST_RESULT(link_get_destination(l, 1) == 2 && link_get_destination(l, 2) == 1);
+}
+
+void test_link_get_destination_not_touching() {
+    Link *l = link_create(NULL, strings);
+    link_set_first_space(l, 1);
+    link_set_second_space(l, 2);
+    PRINT_TEST_RESULT(link_get_destination(l, 3) == NO_ID);
+}
+
+void test_link_get_dirty() {
+    Link *l = link_create(NULL, strings);
+    BOOL created = link_get_dirty(l);
+    link_set_opened(l, FALSE);
+    PRINT_TEST_RESULT(created == FALSE && link_get_dirty(l) == TRUE);
+}
+
+void test_link_set_dirty() {
+    Link *l = link_create(NULL, strings);
+    link_set_opened(l, FALSE);
+    link_set_dirty(l, FALSE);
+    link_set_opened(l, FALSE);
+    PRINT_TEST_RESULT(link_get_dirty(l) == FALSE && link_set_dirty(NULL, TRUE) == ERROR);
+}
+
 void test_all() {
     test_link_init();
     test_link_destroy();
@@ -156,6 +187,10 @@ void test_all() {
     test_link_set_opened_to_null();
     test_link_get_opened();
     test_link_get_opened_from_null();
+    test_link_get_destination();
+    test_link_get_destination_not_touching();
+    test_link_get_dirty();
+    test_link_set_dirty();
 
     PRINT_PASSED_PERCENTAGE;
 }
@@ -170,6 +205,7 @@ void test_all() {
  *  
  */
 int main(int argc, char **argv) {
+    strings = intern_create();
     printf("Link test\n");
     printf("=========================\n");
 
@@ -238,6 +274,18 @@ int main(int argc, char **argv) {
             case 21:
                 test_link_get_opened_from_null();
                 break;
+            case 22:
+                test_link_get_destination();
+                break;
+            case 23:
+                test_link_get_destination_not_touching();
+                break;
+            case 24:
+                test_link_get_dirty();
+                break;
+            case 25:
+                test_link_set_dirty();
+                break;
 
             default:
                 break;
@@ -245,5 +293,6 @@ int main(int argc, char **argv) {
     } else
         test_all();
 
+    intern_destroy(&strings);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,221 @@
+/**
+ * @brief Contains the implementation of the name table, an open addressing
+ * hash table with linear probing keyed by strings
+ *
+ * @file name_table.c
+ * @author Eva Moresova
+ * @version 1.0
+ * @date 13-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/name_table.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define NAME_TABLE_MIN_CAPACITY 16
+
+typedef struct _NameEntry {
+	const char* name;    // NULL marks an empty slot
+	unsigned int hash;
+	void* value;
+} NameEntry;
+
+struct _NameTable {
+	NameEntry* entries;
+	int capacity;        // always a power of two
+	int size;
+	BOOL fold_case;
+};
+
+/** Private functions definitions */
+
+/**
+ * @brief FNV-1a hash of the name, folded to lower case if the table
+ * ignores case
+ *
+ * @param t pointer to table
+ * @param name string to hash
+ * @return hash of the name
+ */
+static unsigned int name_table_hash(NameTable* t, const char* name);
+
+/**
+ * @brief compares two names with the case rules of the table
+ *
+ * @param t pointer to table
+ * @param a first name
+ * @param b second name
+ * @return TRUE if the names are the same key
+ */
+static BOOL name_table_equal(NameTable* t, const char* a, const char* b);
+
+/**
+ * @brief allocates a new slot array and moves all the entries into it
+ *
+ * @param t pointer to table
+ * @param capacity new capacity, a power of two
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS name_table_rehash(NameTable* t, int capacity);
+
+/** Private functions implementation */
+
+static unsigned int name_table_hash(NameTable* t, const char* name) {
+	unsigned int h = 2166136261u;
+	for (const unsigned char* c = (const unsigned char*)name; *c != '\0'; c++) {
+		h ^= (t->fold_case == TRUE) ? (unsigned int)tolower(*c) : *c;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+static BOOL name_table_equal(NameTable* t, const char* a, const char* b) {
+	if (t->fold_case == TRUE)
+		return strcasecmp(a, b) == 0 ? TRUE : FALSE;
+	return strcmp(a, b) == 0 ? TRUE : FALSE;
+}
+
+static STATUS name_table_rehash(NameTable* t, int capacity) {
+	NameEntry* old = t->entries;
+	int old_capacity = t->capacity;
+
+	NameEntry* entries = (NameEntry*)calloc(capacity, sizeof(NameEntry));
+	if (entries == NULL)
+		return ERROR;
+
+	t->entries = entries;
+	t->capacity = capacity;
+	for (int i = 0; i < old_capacity; i++) {
+		if (old[i].name == NULL)
+			continue;
+		int j = (int)(old[i].hash & (unsigned int)(capacity - 1));
+		while (entries[j].name != NULL)
+			j = (j + 1) & (capacity - 1);
+		entries[j] = old[i];
+	}
+	free(old);
+	return OK;
+}
+
+/** Interface implementation */
+
+NameTable* name_table_create(int capacity, BOOL fold_case) {
+	NameTable* t = (NameTable*)malloc(sizeof(NameTable));
+	if (t == NULL)
+		return NULL;
+
+	int c = NAME_TABLE_MIN_CAPACITY;
+	while (c < capacity * 2)
+		c *= 2;
+
+	t->entries = NULL;
+	t->capacity = 0;
+	t->size = 0;
+	t->fold_case = fold_case;
+	if (name_table_rehash(t, c) == ERROR) {
+		free(t);
+		return NULL;
+	}
+	return t;
+}
+
+STATUS name_table_destroy(NameTable** t) {
+	if (t == NULL || *t == NULL)
+		return OK;
+
+	free((*t)->entries);
+	free(*t);
+	*t = NULL;
+	return OK;
+}
+
+STATUS name_table_put(NameTable* t, const char* name, void* value) {
+	if (t == NULL || name == NULL)
+		return ERROR;
+
+	/* keep the load factor under 3/4 */
+	if ((t->size + 1) * 4 > t->capacity * 3) {
+		if (name_table_rehash(t, t->capacity * 2) == ERROR)
+			return ERROR;
+	}
+
+	unsigned int h = name_table_hash(t, name);
+	int i = (int)(h & (unsigned int)(t->capacity - 1));
+	while (t->entries[i].name != NULL) {
+		if (t->entries[i].hash == h && name_table_equal(t, t->entries[i].name, name)) {
+			t->entries[i].name = name;
+			t->entries[i].value = value;
+			return OK;
+		}
+		i = (i + 1) & (t->capacity - 1);
+	}
+	t->entries[i].name = name;
+	t->entries[i].hash = h;
+	t->entries[i].value = value;
+	t->size++;
+	return OK;
+}
+
+void* name_table_get(NameTable* t, const char* name) {
+	if (t == NULL || name == NULL)
+		return NULL;
+
+	unsigned int h = name_table_hash(t, name);
+	int i = (int)(h & (unsigned int)(t->capacity - 1));
+	while (t->entries[i].name != NULL) {
+		if (t->entries[i].hash == h && name_table_equal(t, t->entries[i].name, name))
+			return t->entries[i].value;
+		i = (i + 1) & (t->capacity - 1);
+	}
+	return NULL;
+}
+
+STATUS name_table_remove(NameTable* t, const char* name) {
+	if (t == NULL || name == NULL)
+		return ERROR;
+
+	int mask = t->capacity - 1;
+	unsigned int h = name_table_hash(t, name);
+	int i = (int)(h & (unsigned int)mask);
+	while (t->entries[i].hash != h || t->entries[i].name == NULL
+		|| name_table_equal(t, t->entries[i].name, name) == FALSE) {
+		if (t->entries[i].name == NULL)
+			return ERROR;
+		i = (i + 1) & mask;
+	}
+
+	/* backward shift deletion, no tombstones are left behind */
+	int j = i;
+	for (;;) {
+		j = (j + 1) & mask;
+		if (t->entries[j].name == NULL)
+			break;
+		int k = (int)(t->entries[j].hash & (unsigned int)mask);
+		/* move the entry back only if its home slot is not between i and j */
+		if ((i <= j) ? (i < k && k <= j) : (i < k || k <= j))
+			continue;
+		t->entries[i] = t->entries[j];
+		i = j;
+	}
+	t->entries[i].name = NULL;
+	t->entries[i].value = NULL;
+	t->size--;
+	return OK;
+}
+
+STATUS name_table_clear(NameTable* t) {
+	if (t == NULL)
+		return ERROR;
+
+	memset(t->entries, 0, sizeof(NameEntry) * t->capacity);
+	t->size = 0;
+	return OK;
+}
+
+int name_table_get_size(NameTable* t) {
+	return (t == NULL) ? -1 : t->size;
+}
@@ -0,0 +1,171 @@
+/**
+ * @brief It tests name table module
+ *
+ * @file name_table_test.c
+ * @author Eva Moresova
+ * @version 1.0
+ * @date 13-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/name_table.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/test.h"
+#include "../include/types.h"
+
+void test_name_table_init() {
+    NameTable *t = name_table_create(0, FALSE);
+    PRINT_TEST_RESULT(t != NULL && name_table_get_size(t) == 0);
+    name_table_destroy(&t);
+}
+
+void test_name_table_destroy_null() {
+    NameTable *t = NULL;
+    name_table_destroy(&t);
+    PRINT_TEST_RESULT(t == NULL);
+}
+
+void test_name_table_put_get() {
+    NameTable *t = name_table_create(4, FALSE);
+    int a = 1, b = 2;
+    name_table_put(t, "torch", &a);
+    name_table_put(t, "key", &b);
+    PRINT_TEST_RESULT(name_table_get(t, "torch") == &a && name_table_get(t, "key") == &b);
+    name_table_destroy(&t);
+}
+
+void test_name_table_case_sensitive() {
+    NameTable *t = name_table_create(4, FALSE);
+    int a = 1;
+    name_table_put(t, "torch", &a);
+    PRINT_TEST_RESULT(name_table_get(t, "Torch") == NULL);
+    name_table_destroy(&t);
+}
+
+void test_name_table_fold_case() {
+    NameTable *t = name_table_create(4, TRUE);
+    int a = 1;
+    name_table_put(t, "SafeDoor", &a);
+    PRINT_TEST_RESULT(name_table_get(t, "safedoor") == &a && name_table_get(t, "SAFEDOOR") == &a);
+    name_table_destroy(&t);
+}
+
+void test_name_table_put_null() {
+    NameTable *t = name_table_create(4, FALSE);
+    int a = 1;
+    PRINT_TEST_RESULT(name_table_put(t, NULL, &a) == ERROR);
+    name_table_destroy(&t);
+}
+
+void test_name_table_grow() {
+    NameTable *t = name_table_create(0, FALSE);
+    static char names[500][8];
+    static int values[500];
+    BOOL ok = TRUE;
+    for (int i = 0; i < 500; i++) {
+        sprintf(names[i], "obj%d", i);
+        name_table_put(t, names[i], &values[i]);
+    }
+    for (int i = 0; i < 500; i++)
+        if (name_table_get(t, names[i]) != &values[i])
+            ok = FALSE;
+    PRINT_TEST_RESULT(ok == TRUE && name_table_get_size(t) == 500);
+    name_table_destroy(&t);
+}
+
+void test_name_table_remove() {
+    NameTable *t = name_table_create(0, TRUE);
+    int a = 1, b = 2;
+    name_table_put(t, "north", &a);
+    name_table_put(t, "south", &b);
+    name_table_remove(t, "NORTH");
+    PRINT_TEST_RESULT(name_table_get(t, "north") == NULL && name_table_get(t, "south") == &b);
+    name_table_destroy(&t);
+}
+
+void test_name_table_remove_missing() {
+    NameTable *t = name_table_create(0, FALSE);
+    PRINT_TEST_RESULT(name_table_remove(t, "missing") == ERROR);
+    name_table_destroy(&t);
+}
+
+void test_name_table_clear() {
+    NameTable *t = name_table_create(0, FALSE);
+    int a = 1;
+    name_table_put(t, "key", &a);
+    name_table_clear(t);
+    PRINT_TEST_RESULT(name_table_get(t, "key") == NULL && name_table_get_size(t) == 0);
+    name_table_destroy(&t);
+}
+
+void test_all() {
+    test_name_table_init();
+    test_name_table_destroy_null();
+    test_name_table_put_get();
+    test_name_table_case_sensitive();
+    test_name_table_fold_case();
+    test_name_table_put_null();
+    test_name_table_grow();
+    test_name_table_remove();
+    test_name_table_remove_missing();
+    test_name_table_clear();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for NAME TABLE unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("Name table test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_name_table_init();
+                break;
+            case 2:
+                test_name_table_destroy_null();
+                break;
+            case 3:
+                test_name_table_put_get();
+                break;
+            case 4:
+                test_name_table_case_sensitive();
+                break;
+            case 5:
+                test_name_table_fold_case();
+                break;
+            case 6:
+                test_name_table_put_null();
+                break;
+            case 7:
+                test_name_table_grow();
+                break;
+            case 8:
+                test_name_table_remove();
+                break;
+            case 9:
+                test_name_table_remove_missing();
+                break;
+            case 10:
+                test_name_table_clear();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
@@ -14,22 +14,43 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../include/arena.h"
+#include "../include/dirty_list.h"
+#include "../include/intern.h"
+
 struct _Obj {
     Id id;
-    char name[WORD_SIZE + 1];
+    const char *name; // interned
 	Id location;
-    char description[WORD_SIZE + 1];
+    const char *description; // interned
     BOOL movable;
     Id dependency;
     Id openLink;
     BOOL illuminate;
     BOOL turnedOn;
+    BOOL dirty;    // changed since the game was loaded or saved
+    Arena *arena;  // arena the object was taken from, NULL if it was malloc'd
+    InternPool *strings;  // pool its texts are interned in
+    DirtyList *changes;   // list it is pushed on when it stops being clean, NULL if none
 };
 
-Object *object_create(Id id) {
-    Object *o = (Object *)malloc(sizeof(struct _Obj));
+/**
+ * @brief marks an object as changed, pushing it on its dirty list if it
+ * was clean
+ *
+ * @param o pointer to Object
+ */
+static void object_mark_dirty(Object* o);
+
+Object *object_create(Arena *a, InternPool *strings, Id id) {
+    if (strings == NULL)
+        return NULL;
+
+    Object *o = (Object *)((a != NULL) ? arena_alloc(a, sizeof(struct _Obj)) : malloc(sizeof(struct _Obj)));
     if (o == NULL)
         return NULL;
+    o->arena = a;
+    o->strings = strings;
     o->id = id;
 	o->location = NO_ID;
     o->movable = FALSE;
@@ -37,7 +58,10 @@ Object *object_create(Id id) {
     o->openLink = NO_ID;
     o->illuminate = FALSE;
     o->turnedOn = FALSE;
-    memset(o->description, '\0', WORD_SIZE + 1);
+    o->dirty = FALSE;
+    o->changes = NULL;
+    o->name = intern_string(strings, "");
+    o->description = o->name;
     
     return o;
 }
@@ -46,7 +70,8 @@ STATUS object_destroy(Object **o) {
     if (!object_exist(*o))
         return ERROR;
 
-    free(*o);
+    if ((*o)->arena == NULL)
+        free(*o);
     *o = NULL;
 
     return OK;
@@ -71,8 +96,10 @@ const char *object_get_name(Object *o) {
 STATUS object_set_name(Object *o, const char *str) {
     if (!object_exist(o) || str == NULL)
         return ERROR;
-    if (!strcpy(o->name, str))
+    const char *h = intern_string(o->strings, str);
+    if (h == NULL)
         return ERROR;
+    o->name = h;
     return OK;
 }
 
@@ -80,6 +107,8 @@ STATUS object_set_location(Object* o, Id s) {
 	if (!object_exist(o)) 
 		return ERROR;
 
+	if (o->location != s)
+		object_mark_dirty(o);
 	o->location = s;
 	return OK;
 }
@@ -100,7 +129,10 @@ STATUS object_set_description(Object *obj, char *description){
     if(obj == NULL || description == NULL || strlen(description) > 49)
         return ERROR;
 
-    strcpy(obj->description, description);
+    const char *h = intern_string(obj->strings, description);
+    if (h == NULL)
+        return ERROR;
+    obj->description = h;
     return OK;
 }
 
@@ -163,6 +195,8 @@ STATUS object_set_turnedOn(Object* object, BOOL bool){
     if(object == NULL)
         return ERROR;
 
+    if (object->turnedOn != bool)
+        object_mark_dirty(object);
     object->turnedOn = bool;
     return OK;
 }
@@ -171,12 +205,42 @@ BOOL object_get_turnedOn(Object* object){
     return object == NULL ? FALSE : object->turnedOn;
 }
 
+STATUS object_set_dirty(Object* object, BOOL dirty){
+    if(object == NULL)
+        return ERROR;
+
+    if (dirty == TRUE)
+        object_mark_dirty(object);
+    else
+        object->dirty = FALSE;
+    return OK;
+}
+
+STATUS object_set_dirty_list(Object* object, DirtyList* changes){
+    if(object == NULL)
+        return ERROR;
+
+    object->changes = changes;
+    return OK;
+}
+
+static void object_mark_dirty(Object* o){
+    if (o->dirty == FALSE && o->changes != NULL)
+        dirty_list_push(o->changes, DIRTY_OBJECT, o->id, NO_ID, NO_ID);
+    o->dirty = TRUE;
+}
+
+BOOL object_get_dirty(Object* object){
+    return object == NULL ? FALSE : object->dirty;
+}
+
 STATUS object_save(FILE* fp, Object* o) {
 	if (o == NULL || fp == NULL) return ERROR;
 	
-	//#o:id|name|description|location|dependency|openLink|movable|illuminate|turnedOn
-	fprintf(fp, "#o:%ld|%s|%s|%ld|%ld|%ld|%d|%d|%d\n", 
-	o->id, o->name, o->description, o->location, o->dependency, o->openLink, o->movable, o->illuminate, o->turnedOn);
+	//#o:id|name|description|location|movable|dependency|openLink|illuminate|turnedOn
+	// An empty field would be skipped when loading, and the ones after it moved
+	fprintf(fp, "#o:%ld|%s|%s|%ld|%d|%ld|%ld|%d|%d\n", 
+	o->id, o->name, (o->description[0] != '\0') ? o->description : " ", o->location, o->movable, o->dependency, o->openLink, o->illuminate, o->turnedOn);
 
 	return OK;
 } 
\ No newline at end of file
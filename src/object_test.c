@@ -16,10 +16,12 @@
 #include "../include/test.h"
 #include "../include/types.h"
 
+static InternPool *strings = NULL; //Pool the tested entities intern their texts in
+
 void test1_object_create()
 {
   Object *o;
-  o = object_create(5);
+  o = object_create(NULL, strings, 5);
   PRINT_TEST_RESULT(o != NULL);
   object_destroy(&o);
 }
@@ -27,7 +29,7 @@ void test1_object_create()
 void test2_object_create()
 {
   Object *o;
-  o = object_create(4);
+  o = object_create(NULL, strings, 4);
   PRINT_TEST_RESULT(object_get_id(o) == 4);
   object_destroy(&o);
 }
@@ -35,7 +37,7 @@ void test2_object_create()
 void test1_object_get_id()
 {
   Object *o;
-  o = object_create(5);
+  o = object_create(NULL, strings, 5);
   PRINT_TEST_RESULT(object_get_id(o) == 5);
   object_destroy(&o);
 }
@@ -49,7 +51,7 @@ void test2_object_get_id()
 void test1_object_set_name()
 {
   Object *o;
-  o = object_create(5);
+  o = object_create(NULL, strings, 5);
   PRINT_TEST_RESULT(object_set_name(o, "hola") == OK);
   object_destroy(&o);
 }
@@ -57,7 +59,7 @@ void test1_object_set_name()
 void test2_object_set_name()
 {
   Object *o;
-  o = object_create(5);
+  o = object_create(NULL, strings, 5);
   PRINT_TEST_RESULT(object_set_name(o, NULL) == ERROR);
   object_destroy(&o);
 }
@@ -71,7 +73,7 @@ void test3_object_set_name()
 void test1_object_get_name()
 {
   Object *o;
-  o = object_create(5);
+  o = object_create(NULL, strings, 5);
   object_set_name(o, "hola");
   PRINT_TEST_RESULT(strcmp(object_get_name(o), "hola") == 0);
   object_destroy(&o);
@@ -86,7 +88,7 @@ void test2_object_get_name()
 void test1_object_set_description()
 {
   Object *o;
-  o = object_create(5);
+  o = object_create(NULL, strings, 5);
   PRINT_TEST_RESULT(object_set_description(o, "hola") == OK);
   object_destroy(&o);
 }
@@ -94,7 +96,7 @@ void test1_object_set_description()
 void test2_object_set_description()
 {
   Object *o;
-  o = object_create(5);
+  o = object_create(NULL, strings, 5);
   PRINT_TEST_RESULT(object_set_description(o, NULL) == ERROR);
   object_destroy(&o);
 }
@@ -108,7 +110,7 @@ void test3_object_set_description()
 void test1_object_get_description()
 {
   Object *o;
-  o = object_create(5);
+  o = object_create(NULL, strings, 5);
   object_set_description(o, "hola");
   PRINT_TEST_RESULT(strcmp(object_get_description(o), "hola") == 0);
   object_destroy(&o);
@@ -120,6 +122,27 @@ void test2_object_get_description()
   PRINT_TEST_RESULT(object_get_description(o) == ERROR);
 }
 
+void test1_object_get_dirty()
+{
+  Object *o;
+  o = object_create(NULL, strings, 5);
+  BOOL created = object_get_dirty(o);
+  object_set_location(o, 2);
+  PRINT_TEST_RESULT(created == FALSE && object_get_dirty(o) == TRUE);
+  object_destroy(&o);
+}
+
+void test2_object_get_dirty()
+{
+  Object *o;
+  o = object_create(NULL, strings, 5);
+  object_set_turnedOn(o, TRUE);
+  object_set_dirty(o, FALSE);
+  object_set_turnedOn(o, TRUE);
+  PRINT_TEST_RESULT(object_get_dirty(o) == FALSE && object_set_dirty(NULL, TRUE) == ERROR);
+  object_destroy(&o);
+}
+
 void test_all()
 {
   test1_object_create();
@@ -136,6 +159,8 @@ void test_all()
   test3_object_set_description();
   test1_object_get_description();
   test2_object_get_description();
+  test1_object_get_dirty();
+  test2_object_get_dirty();
 
   PRINT_PASSED_PERCENTAGE;
 }
@@ -145,6 +170,7 @@ void test_all()
  */
 int main(int argc, char **argv)
 {
+  strings = intern_create();
   printf("Object test\n");
   printf("=========================\n");
 
@@ -194,6 +220,12 @@ int main(int argc, char **argv)
     case 14:
       test2_object_get_description();
       break;
+    case 15:
+      test1_object_get_dirty();
+      break;
+    case 16:
+      test2_object_get_dirty();
+      break;
     default:
       break;
     }
@@ -201,5 +233,6 @@ int main(int argc, char **argv)
   else
     test_all();
 
+  intern_destroy(&strings);
   return 0;
 }
@@ -14,6 +14,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../include/arena.h"
+
 /**
  * Structure for Player
  * Id id
@@ -25,10 +27,12 @@ struct _Player {
     Id id; 		//Id of the player
     char name[WORD_SIZE + 1]; 	//Name of the player
     Id location;	 //Id of the location of the player
+    BOOL dirty;	 //The location changed since the game was loaded or saved
     Inventory *inventory; 	//Inventory of the player
+    Arena *arena; 	//Arena the player was taken from, NULL if it was malloc'd
 };
 
-Player* player_create(Id id, int cap)
+Player* player_create(Arena *a, Id id, int cap)
 {
     Player *p = NULL;
 
@@ -37,17 +41,19 @@ Player* player_create(Id id, int cap)
         return NULL;
     }
 
-    p = (Player *)malloc(sizeof(struct _Player));
+    p = (Player *)((a != NULL) ? arena_alloc(a, sizeof(struct _Player)) : malloc(sizeof(struct _Player)));
     if (p == NULL)
     {
         return NULL;
     }
+    p->arena = a;
 
-    p->inventory = inventory_create(cap);
+    p->inventory = inventory_create(a, cap);
     if (p->inventory == NULL)
         return NULL;
     p->id = id;
     p->location = NO_ID;
+    p->dirty = FALSE;
     return p;
 }
 
@@ -58,7 +64,8 @@ STATUS player_destroy(Player **p)
         return FALSE;
     }
     inventory_destroy(&(*p)->inventory);
-    free(*p);
+    if ((*p)->arena == NULL)
+        free(*p);
     *p = NULL;
     return OK;
 }
@@ -95,10 +102,27 @@ STATUS player_set_location(Player *p, Id s)
 {
     if (!player_exist(p) || s == NO_ID)
         return ERROR;
+    if (p->location != s)
+        p->dirty = TRUE;
     p->location = s;
     return OK;
 }
 
+BOOL player_get_dirty(Player *p)
+{
+    if (!player_exist(p))
+        return FALSE;
+    return (p->dirty == TRUE || inventory_get_dirty(p->inventory) == TRUE) ? TRUE : FALSE;
+}
+
+STATUS player_set_dirty(Player *p, BOOL dirty)
+{
+    if (!player_exist(p))
+        return ERROR;
+    p->dirty = dirty;
+    return inventory_set_dirty(p->inventory, dirty);
+}
+
 Id player_get_location(Player *p)
 {
     if (!player_exist(p))
@@ -12,12 +12,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../include/player.h"
+#include "../include/object.h"
 #include "../include/test.h"
 
+static InternPool *strings = NULL; //Pool the tested entities intern their texts in
+
 void test1_player_create()
 {
     Player *p;
-    p = player_create(4,1);
+    p = player_create(NULL, 4,1);
     PRINT_TEST_RESULT(p != NULL);
     player_destroy(&p);
 }
@@ -25,7 +28,7 @@ void test1_player_create()
 void test2_player_create()
 {
     Player *p;
-    p = player_create(4,1);
+    p = player_create(NULL, 4,1);
     PRINT_TEST_RESULT(player_get_id(p) == 4);
     player_destroy(&p);
 }
@@ -33,7 +36,7 @@ void test2_player_create()
 void test1_player_get_id()
 {
     Player *p;
-    p = player_create(4,1);
+    p = player_create(NULL, 4,1);
     PRINT_TEST_RESULT(player_get_id(p) == 4);
     player_destroy(&p);
 }
@@ -47,7 +50,7 @@ void test2_player_get_id()
 void test1_player_set_name()
 {
     Player *p;
-    p = player_create(4,1);
+    p = player_create(NULL, 4,1);
     PRINT_TEST_RESULT(player_set_name(p, "hola") == OK);
     player_destroy(&p);
 }
@@ -55,7 +58,7 @@ void test1_player_set_name()
 void test2_player_set_name()
 {
     Player *p;
-    p = player_create(4,1);
+    p = player_create(NULL, 4,1);
     PRINT_TEST_RESULT(player_set_name(p, NULL) == ERROR);
     player_destroy(&p);
 }
@@ -69,7 +72,7 @@ void test3_player_set_name()
 void test1_player_get_name()
 {
     Player *p;
-    p = player_create(4,1);
+    p = player_create(NULL, 4,1);
     player_set_name(p, "hola");
     PRINT_TEST_RESULT(strcmp(player_get_name(p), "hola") == 0);
     player_destroy(&p);
@@ -84,7 +87,7 @@ void test2_player_get_name()
 void test1_player_set_player_location()
 {
     Player *p;
-    p = player_create(4,1);
+    p = player_create(NULL, 4,1);
     PRINT_TEST_RESULT(player_set_location(p, 5) == OK);
     player_destroy(&p);
 }
@@ -92,7 +95,7 @@ void test1_player_set_player_location()
 void test2_player_set_player_location()
 {
     Player *p;
-    p = player_create(4,1);
+    p = player_create(NULL, 4,1);
     PRINT_TEST_RESULT(player_set_location(p, NO_ID) == ERROR);
     player_destroy(&p);
 }
@@ -107,7 +110,7 @@ void test1_player_get_player_location()
 {
     Player *p;
 
-    p = player_create(4,1);
+    p = player_create(NULL, 4,1);
     player_set_location(p, 5);
     PRINT_TEST_RESULT(player_get_location(p) == 5);
     player_destroy(&p);
@@ -123,7 +126,7 @@ void test2_player_get_player_location()
 void test1_player_get_numObj()
 {
     Player *p;
-    p = player_create(4,1);
+    p = player_create(NULL, 4,1);
     PRINT_TEST_RESULT(player_getnObjects(p) == 0);
     player_destroy(&p);
 }
@@ -134,6 +137,30 @@ void test2_player_get_numObj()
     PRINT_TEST_RESULT(player_getnObjects(p) == ERROR);
 }
 
+void test1_player_get_dirty()
+{
+    Player *p;
+    p = player_create(NULL, 4,1);
+    BOOL created = player_get_dirty(p);
+    player_set_location(p, 2);
+    PRINT_TEST_RESULT(created == FALSE && player_get_dirty(p) == TRUE);
+    player_destroy(&p);
+}
+
+void test2_player_get_dirty()
+{
+    Player *p;
+    Object *o = object_create(NULL, strings, 7);
+    p = player_create(NULL, 4,1);
+    player_set_location(p, 2);
+    player_set_dirty(p, FALSE);
+    // Picking up an object changes the player through its inventory
+    player_add_object(p, o);
+    PRINT_TEST_RESULT(player_get_dirty(p) == TRUE);
+    player_destroy(&p);
+    object_destroy(&o);
+}
+
 void test_all()
 {
     test1_player_create();
@@ -152,6 +179,8 @@ void test_all()
     test2_player_get_player_location();
     test1_player_get_numObj();
     test2_player_get_numObj();
+    test1_player_get_dirty();
+    test2_player_get_dirty();
 
     PRINT_PASSED_PERCENTAGE;
 }
@@ -161,6 +190,7 @@ void test_all()
  */
 int main(int argc, char **argv)
 {
+    strings = intern_create();
     printf("Player test\n");
     printf("=========================\n");
 
@@ -216,6 +246,12 @@ int main(int argc, char **argv)
         case 16:
             test2_player_get_numObj();
             break;
+        case 17:
+            test1_player_get_dirty();
+            break;
+        case 18:
+            test2_player_get_dirty();
+            break;
         default:
             break;
         }
@@ -223,5 +259,6 @@ int main(int argc, char **argv)
     else
         test_all();
 
+    intern_destroy(&strings);
     return 0;
 }
\ No newline at end of file
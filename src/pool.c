@@ -0,0 +1,128 @@
+/**
+ * @brief It implements the pool interface. Elements are handed out from
+ * the current block in order, freed elements are kept in a free list
+ *
+ * @file pool.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 19-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/pool.h"
+
+#include <stdlib.h>
+
+typedef struct _Block {
+    struct _Block *next;
+    /* the elements follow the header, aligned to max_align_t */
+} Block;
+
+typedef struct _FreeElem {
+    struct _FreeElem *next;
+} FreeElem;
+
+struct _Pool {
+    size_t elem_size;
+    int block_elems;
+    size_t header_size;  // size of Block rounded up to the alignment
+    Block *first;        // every block allocated, in allocation order
+    Block *current;      // block elements are being taken from
+    int next_elem;       // first never used element of current
+    FreeElem *free_list;
+    int used;
+};
+
+/**
+ * @brief rounds size up to a multiple of the alignment of max_align_t
+ *
+ * @param size size in bytes
+ * @return aligned size
+ */
+static size_t pool_align(size_t size);
+
+static size_t pool_align(size_t size) {
+    size_t a = _Alignof(max_align_t);
+    return (size + a - 1) / a * a;
+}
+
+Pool *pool_create(size_t elem_size, int block_elems) {
+    if (elem_size == 0 || block_elems <= 0)
+        return NULL;
+
+    Pool *p = malloc(sizeof(struct _Pool));
+    if (p == NULL)
+        return NULL;
+
+    if (elem_size < sizeof(FreeElem))
+        elem_size = sizeof(FreeElem);
+    p->elem_size = pool_align(elem_size);
+    p->block_elems = block_elems;
+    p->header_size = pool_align(sizeof(Block));
+    p->first = NULL;
+    p->current = NULL;
+    p->next_elem = block_elems;
+    p->free_list = NULL;
+    p->used = 0;
+    return p;
+}
+
+STATUS pool_destroy(Pool **p) {
+    if (p == NULL || *p == NULL)
+        return ERROR;
+
+    Block *b = (*p)->first;
+    while (b != NULL) {
+        Block *next = b->next;
+        free(b);
+        b = next;
+    }
+    free(*p);
+    *p = NULL;
+    return OK;
+}
+
+void *pool_alloc(Pool *p) {
+    if (p == NULL)
+        return NULL;
+
+    if (p->free_list != NULL) {
+        FreeElem *e = p->free_list;
+        p->free_list = e->next;
+        p->used++;
+        return e;
+    }
+
+    if (p->next_elem == p->block_elems) {
+        Block *b = malloc(p->header_size + p->elem_size * p->block_elems);
+        if (b == NULL)
+            return NULL;
+        b->next = NULL;
+        if (p->current != NULL)
+            p->current->next = b;
+        else
+            p->first = b;
+        p->current = b;
+        p->next_elem = 0;
+    }
+
+    void *elem = (char *)p->current + p->header_size + p->elem_size * p->next_elem;
+    p->next_elem++;
+    p->used++;
+    return elem;
+}
+
+STATUS pool_free(Pool *p, void *elem) {
+    if (p == NULL || elem == NULL)
+        return ERROR;
+
+    FreeElem *e = elem;
+    e->next = p->free_list;
+    p->free_list = e;
+    p->used--;
+    return OK;
+}
+
+int pool_get_used(Pool *p) {
+    return p == NULL ? -1 : p->used;
+}
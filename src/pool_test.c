@@ -0,0 +1,127 @@
+/**
+ * @brief It tests the pool module
+ *
+ * @file pool_test.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 19-05-2021
+ * @copyright GNU Public License
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/pool.h"
+#include "../include/test.h"
+#include "../include/types.h"
+
+void test_pool_create() {
+    Pool* p = pool_create(sizeof(Id), 8);
+    PRINT_TEST_RESULT(p != NULL && pool_get_used(p) == 0);
+    pool_destroy(&p);
+}
+
+void test_pool_create_zero_size() {
+    PRINT_TEST_RESULT(pool_create(0, 8) == NULL);
+}
+
+void test_pool_destroy_null() {
+    Pool* p = NULL;
+    PRINT_TEST_RESULT(pool_destroy(&p) == ERROR);
+}
+
+void test_pool_alloc_distinct() {
+    Pool* p = pool_create(sizeof(Id), 4);
+    Id* e[10];
+    for (int i = 0; i < 10; i++) {
+        e[i] = pool_alloc(p);
+        *e[i] = i;
+    }
+    BOOL ok = TRUE;
+    for (int i = 0; i < 10; i++) {
+        if (*e[i] != i)
+            ok = FALSE;
+    }
+    PRINT_TEST_RESULT(ok == TRUE && pool_get_used(p) == 10);
+    pool_destroy(&p);
+}
+
+void test_pool_free_reuse() {
+    Pool* p = pool_create(sizeof(Id), 4);
+    Id* a = pool_alloc(p);
+    pool_alloc(p);
+    pool_free(p, a);
+    PRINT_TEST_RESULT(pool_alloc(p) == a && pool_get_used(p) == 2);
+    pool_destroy(&p);
+}
+
+void test_pool_free_null() {
+    Pool* p = pool_create(sizeof(Id), 4);
+    PRINT_TEST_RESULT(pool_free(p, NULL) == ERROR);
+    pool_destroy(&p);
+}
+
+void test_pool_alignment() {
+    Pool* p = pool_create(3, 4);
+    char* a = pool_alloc(p);
+    char* b = pool_alloc(p);
+    PRINT_TEST_RESULT((b - a) % _Alignof(max_align_t) == 0);
+    pool_destroy(&p);
+}
+
+void test_all() {
+    test_pool_create();
+    test_pool_create_zero_size();
+    test_pool_destroy_null();
+    test_pool_alloc_distinct();
+    test_pool_free_reuse();
+    test_pool_free_null();
+    test_pool_alignment();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for POOL unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("Pool test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_pool_create();
+                break;
+            case 2:
+                test_pool_create_zero_size();
+                break;
+            case 3:
+                test_pool_destroy_null();
+                break;
+            case 4:
+                test_pool_alloc_distinct();
+                break;
+            case 5:
+                test_pool_free_reuse();
+                break;
+            case 6:
+                test_pool_free_null();
+                break;
+            case 7:
+                test_pool_alignment();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
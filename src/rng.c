@@ -0,0 +1,124 @@
+/**
+ * @brief It implements the random number generator. A bounded draw
+ * multiplies 32 random bits by the size of the range and keeps the high
+ * half, drawing again only in the few cases that would favour some numbers
+ *
+ * @file rng.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/rng.h"
+
+#include <stdlib.h>
+
+struct _Rng {
+    uint64_t s[4];
+    uint64_t seed;
+};
+
+/**
+ * @brief next number of a splitmix64 sequence, to fill the state from a
+ * seed. Any seed, 0 included, gives a state that is not all zeros
+ *
+ * @param x state of the sequence, advanced
+ * @return the number
+ */
+static uint64_t rng_splitmix(uint64_t *x);
+
+/**
+ * @brief rotates bits to the left
+ */
+static uint64_t rng_rotl(uint64_t x, int k);
+
+static uint64_t rng_splitmix(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+static uint64_t rng_rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+Rng *rng_create(uint64_t seed)
+{
+    Rng *r = malloc(sizeof(Rng));
+    if (r == NULL)
+        return NULL;
+
+    rng_seed(r, seed);
+    return r;
+}
+
+STATUS rng_destroy(Rng **r)
+{
+    if (r == NULL || *r == NULL)
+        return ERROR;
+
+    free(*r);
+    *r = NULL;
+    return OK;
+}
+
+STATUS rng_seed(Rng *r, uint64_t seed)
+{
+    uint64_t x = seed;
+
+    if (r == NULL)
+        return ERROR;
+
+    r->seed = seed;
+    for (int i = 0; i < 4; i++)
+        r->s[i] = rng_splitmix(&x);
+    return OK;
+}
+
+uint64_t rng_get_seed(Rng *r)
+{
+    return (r != NULL) ? r->seed : 0;
+}
+
+uint64_t rng_next(Rng *r)
+{
+    if (r == NULL)
+        return 0;
+
+    uint64_t *s = r->s;
+    uint64_t result = rng_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_rotl(s[3], 45);
+    return result;
+}
+
+uint32_t rng_bounded(Rng *r, uint32_t n)
+{
+    if (r == NULL || n == 0)
+        return 0;
+
+    // The high bits of xoshiro256** are the best ones
+    uint64_t m = (rng_next(r) >> 32) * (uint64_t)n;
+    uint32_t low = (uint32_t)m;
+    if (low < n)
+    {
+        // 2^32 mod n values of low would make some numbers more likely
+        uint32_t threshold = (uint32_t)(-n) % n;
+        while (low < threshold)
+        {
+            m = (rng_next(r) >> 32) * (uint64_t)n;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
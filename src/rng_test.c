@@ -0,0 +1,156 @@
+/**
+ * @brief It tests the random number generator module
+ *
+ * @file rng_test.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/rng.h"
+#include "../include/test.h"
+#include "../include/types.h"
+
+#define TEST_DRAWS 60000
+
+void test_rng_create() {
+    Rng* r = rng_create(42);
+    PRINT_TEST_RESULT(r != NULL && rng_get_seed(r) == 42);
+    rng_destroy(&r);
+}
+
+void test_rng_destroy_null() {
+    Rng* r = NULL;
+    PRINT_TEST_RESULT(rng_destroy(&r) == ERROR);
+}
+
+void test_rng_same_seed() {
+    Rng* a = rng_create(7);
+    Rng* b = rng_create(7);
+    BOOL same = TRUE;
+
+    for (int i = 0; i < 100; i++) {
+        if (rng_next(a) != rng_next(b))
+            same = FALSE;
+    }
+    PRINT_TEST_RESULT(a != NULL && b != NULL && same == TRUE);
+    rng_destroy(&a);
+    rng_destroy(&b);
+}
+
+void test_rng_other_seed() {
+    Rng* a = rng_create(7);
+    Rng* b = rng_create(8);
+    PRINT_TEST_RESULT(rng_next(a) != rng_next(b));
+    rng_destroy(&a);
+    rng_destroy(&b);
+}
+
+void test_rng_seed_again() {
+    Rng* r = rng_create(0);
+    uint64_t first = rng_next(r);
+
+    rng_next(r);
+    rng_seed(r, 0);
+    // A seed of 0 works like any other
+    PRINT_TEST_RESULT(first != 0 && rng_next(r) == first);
+    rng_destroy(&r);
+}
+
+void test_rng_bounded_range() {
+    Rng* r = rng_create(1);
+    BOOL inside = TRUE;
+
+    for (int i = 0; i < 1000; i++) {
+        if (rng_bounded(r, 6) >= 6 || rng_bounded(r, 1) != 0)
+            inside = FALSE;
+    }
+    PRINT_TEST_RESULT(inside == TRUE && rng_bounded(r, 0) == 0);
+    rng_destroy(&r);
+}
+
+void test_rng_bounded_uniform() {
+    Rng* r = rng_create(3);
+    int counts[6] = {0};
+    BOOL uniform = TRUE;
+
+    for (int i = 0; i < TEST_DRAWS; i++)
+        counts[rng_bounded(r, 6)]++;
+    // 10000 expected for each, 5 standard deviations either way
+    for (int i = 0; i < 6; i++) {
+        if (counts[i] < 9540 || counts[i] > 10460)
+            uniform = FALSE;
+    }
+    PRINT_TEST_RESULT(uniform == TRUE);
+    rng_destroy(&r);
+}
+
+void test_rng_null() {
+    PRINT_TEST_RESULT(rng_next(NULL) == 0 && rng_bounded(NULL, 6) == 0 && rng_seed(NULL, 1) == ERROR &&
+                      rng_get_seed(NULL) == 0);
+}
+
+void test_all() {
+    test_rng_create();
+    test_rng_destroy_null();
+    test_rng_same_seed();
+    test_rng_other_seed();
+    test_rng_seed_again();
+    test_rng_bounded_range();
+    test_rng_bounded_uniform();
+    test_rng_null();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for RNG unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("Rng test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_rng_create();
+                break;
+            case 2:
+                test_rng_destroy_null();
+                break;
+            case 3:
+                test_rng_same_seed();
+                break;
+            case 4:
+                test_rng_other_seed();
+                break;
+            case 5:
+                test_rng_seed_again();
+                break;
+            case 6:
+                test_rng_bounded_range();
+                break;
+            case 7:
+                test_rng_bounded_uniform();
+                break;
+            case 8:
+                test_rng_null();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
@@ -0,0 +1,343 @@
+/**
+ * @brief It implements the table of random rules. The rules of a range are
+ * compiled with Vose's alias method: each of the n columns holds a rule,
+ * the chance of keeping it and another rule, its alias, that fills the rest
+ * of the column. A draw picks a column and then one of its two rules
+ *
+ * @file rule_table.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/rule_table.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <strings.h>
+
+/* the chance of keeping the rule of a column is compared with 32 random bits */
+#define RULE_ONE 4294967296.0
+
+/* the rules of a range of spaces, as an alias table */
+typedef struct {
+    Id first;               // NO_ID for the whole world
+    Id last;
+    int n;                  // columns, one per rule of the range
+    int *rule;              // position of the rule of each column in the table
+    int *alias;             // column whose rule fills the rest of each column
+    uint64_t *keep;         // the rule of the column is drawn if 32 random bits are below it
+} RuleScope;
+
+struct _RuleTable {
+    Rule *rules;
+    int n_rules;
+    int capacity;
+    RuleScope *scopes;      // narrowest range first, the whole world last
+    int n_scopes;
+    Id cached_location;     // the player usually stays a few turns in a space
+    int cached_scope;       // scope of cached_location, -1 if no range holds it
+};
+
+/* names of the effects in the data files, in the order of T_Rules from NO_RULE */
+static const char *rule_names[] = {"none", "take", "die", "drop", "on", "off", "toggle", "teleport"};
+
+/**
+ * @brief frees the alias tables of a rule table
+ *
+ * @param t pointer to RuleTable
+ */
+static void rule_table_free_scopes(RuleTable *t);
+
+/**
+ * @brief builds the alias table of the rules of one range
+ *
+ * @param t pointer to RuleTable
+ * @param s scope with its range set, its rules are looked for in t
+ * @return STATUS ERROR = 0 if there is no memory, OK = 1
+ */
+static STATUS rule_scope_build(RuleTable *t, RuleScope *s);
+
+/**
+ * @brief orders scopes from the narrowest range to the whole world, for qsort
+ */
+static int rule_scope_compare(const void *a, const void *b);
+
+RuleTable *rule_table_create()
+{
+    RuleTable *t = calloc(1, sizeof(RuleTable));
+    if (t == NULL)
+        return NULL;
+
+    t->cached_location = NO_ID;
+    t->cached_scope = -1;
+    return t;
+}
+
+STATUS rule_table_destroy(RuleTable **t)
+{
+    if (t == NULL || *t == NULL)
+        return ERROR;
+
+    rule_table_free_scopes(*t);
+    free((*t)->rules);
+    free(*t);
+    *t = NULL;
+    return OK;
+}
+
+STATUS rule_table_add(RuleTable *t, const Rule *r)
+{
+    if (t == NULL || r == NULL || r->weight < 0 || r->effect < NO_RULE || r->effect > TELEPORTRULE)
+        return ERROR;
+    if ((r->effect == TELEPORTRULE && r->target == NO_ID) || ((r->first == NO_ID) != (r->last == NO_ID)))
+        return ERROR;
+
+    if (t->n_rules == t->capacity)
+    {
+        int capacity = (t->capacity > 0) ? 2 * t->capacity : 8;
+        Rule *rules = realloc(t->rules, sizeof(Rule) * capacity);
+        if (rules == NULL)
+            return ERROR;
+        t->rules = rules;
+        t->capacity = capacity;
+    }
+
+    Rule *added = &t->rules[t->n_rules++];
+    *added = *r;
+    if (added->first > added->last)
+    {
+        added->first = r->last;
+        added->last = r->first;
+    }
+    if (added->effect != TELEPORTRULE)
+        added->target = NO_ID;
+    return OK;
+}
+
+STATUS rule_table_add_default(RuleTable *t)
+{
+    // Out of 100, the rolls of rand() % 100 that gave them before they were in the world
+    static const Rule defaults[] = {
+        {TAKERULE, 5, NO_ID, NO_ID, NO_ID},
+        {DIERULE, 1, NO_ID, NO_ID, NO_ID},
+        {DROPRULE, 5, NO_ID, NO_ID, NO_ID},
+        {ONRULE, 5, NO_ID, NO_ID, NO_ID},
+        {OFFRULE, 5, NO_ID, NO_ID, NO_ID},
+        {NO_RULE, 79, NO_ID, NO_ID, NO_ID}};
+
+    for (size_t i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++)
+    {
+        if (rule_table_add(t, &defaults[i]) == ERROR)
+            return ERROR;
+    }
+    return OK;
+}
+
+static void rule_table_free_scopes(RuleTable *t)
+{
+    for (int i = 0; i < t->n_scopes; i++)
+    {
+        free(t->scopes[i].rule);
+        free(t->scopes[i].alias);
+        free(t->scopes[i].keep);
+    }
+    free(t->scopes);
+    t->scopes = NULL;
+    t->n_scopes = 0;
+    t->cached_location = NO_ID;
+    t->cached_scope = -1;
+}
+
+static STATUS rule_scope_build(RuleTable *t, RuleScope *s)
+{
+    double total = 0;
+    int n = 0;
+
+    for (int i = 0; i < t->n_rules; i++)
+    {
+        if (t->rules[i].first == s->first && t->rules[i].last == s->last && t->rules[i].weight > 0)
+        {
+            total += t->rules[i].weight;
+            n++;
+        }
+    }
+    // Nothing ever happens in a range without weights
+    s->n = n;
+    if (n == 0)
+        return OK;
+
+    double *p = malloc(sizeof(double) * n);
+    int *small = malloc(sizeof(int) * n);
+    int *large = malloc(sizeof(int) * n);
+    s->rule = malloc(sizeof(int) * n);
+    s->alias = malloc(sizeof(int) * n);
+    s->keep = malloc(sizeof(uint64_t) * n);
+    if (p == NULL || small == NULL || large == NULL || s->rule == NULL || s->alias == NULL || s->keep == NULL)
+    {
+        free(p);
+        free(small);
+        free(large);
+        return ERROR;
+    }
+
+    int k = 0, n_small = 0, n_large = 0;
+    for (int i = 0; i < t->n_rules; i++)
+    {
+        if (t->rules[i].first != s->first || t->rules[i].last != s->last || t->rules[i].weight <= 0)
+            continue;
+        s->rule[k] = i;
+        s->alias[k] = k;
+        // Scaled so that a column holds exactly 1
+        p[k] = t->rules[i].weight * n / total;
+        if (p[k] < 1.0)
+            small[n_small++] = k;
+        else
+            large[n_large++] = k;
+        k++;
+    }
+
+    // A column that is short of 1 is filled with a rule that has more than 1
+    while (n_small > 0 && n_large > 0)
+    {
+        int less = small[--n_small];
+        int more = large[n_large - 1];
+        s->keep[less] = (uint64_t)(p[less] * RULE_ONE);
+        s->alias[less] = more;
+        p[more] -= 1.0 - p[less];
+        if (p[more] < 1.0)
+        {
+            n_large--;
+            small[n_small++] = more;
+        }
+    }
+    // What is left is 1 but for rounding
+    while (n_large > 0)
+        s->keep[large[--n_large]] = (uint64_t)RULE_ONE;
+    while (n_small > 0)
+        s->keep[small[--n_small]] = (uint64_t)RULE_ONE;
+
+    free(p);
+    free(small);
+    free(large);
+    return OK;
+}
+
+static int rule_scope_compare(const void *a, const void *b)
+{
+    const RuleScope *x = a;
+    const RuleScope *y = b;
+
+    if ((x->first == NO_ID) != (y->first == NO_ID))
+        return (x->first == NO_ID) ? 1 : -1;
+    Id wx = x->last - x->first;
+    Id wy = y->last - y->first;
+    if (wx != wy)
+        return (wx > wy) ? 1 : -1;
+    return (x->first > y->first) - (x->first < y->first);
+}
+
+STATUS rule_table_compile(RuleTable *t)
+{
+    if (t == NULL)
+        return ERROR;
+
+    rule_table_free_scopes(t);
+    t->scopes = calloc((size_t)t->n_rules + 1, sizeof(RuleScope));
+    if (t->scopes == NULL)
+        return ERROR;
+
+    // One scope per range, in the order the ranges first appear
+    for (int i = 0; i < t->n_rules; i++)
+    {
+        int s = 0;
+        while (s < t->n_scopes && (t->scopes[s].first != t->rules[i].first || t->scopes[s].last != t->rules[i].last))
+            s++;
+        if (s == t->n_scopes)
+        {
+            t->scopes[s].first = t->rules[i].first;
+            t->scopes[s].last = t->rules[i].last;
+            t->n_scopes++;
+            if (rule_scope_build(t, &t->scopes[s]) == ERROR)
+            {
+                rule_table_free_scopes(t);
+                return ERROR;
+            }
+        }
+    }
+    qsort(t->scopes, t->n_scopes, sizeof(RuleScope), rule_scope_compare);
+    return OK;
+}
+
+T_Rules rule_table_sample(RuleTable *t, Rng *rng, Id location, Id *target)
+{
+    if (target != NULL)
+        *target = NO_ID;
+    if (t == NULL || rng == NULL)
+        return NO_RULE;
+
+    // The narrowest range is looked for when the player moves, not every turn
+    if (location != t->cached_location || t->cached_scope < 0)
+    {
+        int s = 0;
+        while (s < t->n_scopes && t->scopes[s].first != NO_ID &&
+               (location < t->scopes[s].first || location > t->scopes[s].last))
+            s++;
+        t->cached_location = location;
+        t->cached_scope = (s < t->n_scopes) ? s : -1;
+    }
+    if (t->cached_scope < 0 || t->scopes[t->cached_scope].n == 0)
+        return NO_RULE;
+
+    const RuleScope *s = &t->scopes[t->cached_scope];
+    int column = (int)rng_bounded(rng, (uint32_t)s->n);
+    if ((rng_next(rng) >> 32) >= s->keep[column])
+        column = s->alias[column];
+
+    const Rule *r = &t->rules[s->rule[column]];
+    if (target != NULL)
+        *target = r->target;
+    return r->effect;
+}
+
+int rule_table_count(RuleTable *t)
+{
+    return (t != NULL) ? t->n_rules : -1;
+}
+
+const Rule *rule_table_get(RuleTable *t, int i)
+{
+    if (t == NULL || i < 0 || i >= t->n_rules)
+        return NULL;
+    return &t->rules[i];
+}
+
+STATUS rule_effect_from_name(const char *name, T_Rules *effect)
+{
+    if (name == NULL || effect == NULL)
+        return ERROR;
+
+    for (int i = 0; i < (int)(sizeof(rule_names) / sizeof(rule_names[0])); i++)
+    {
+        if (strcasecmp(name, rule_names[i]) == 0)
+        {
+            *effect = (T_Rules)(i + NO_RULE);
+            return OK;
+        }
+    }
+    return ERROR;
+}
+
+STATUS rule_table_save(FILE *fp, RuleTable *t)
+{
+    if (fp == NULL || t == NULL)
+        return ERROR;
+
+    for (int i = 0; i < t->n_rules; i++)
+    {
+        const Rule *r = &t->rules[i];
+        fprintf(fp, "#r:%s|%d|%ld|%ld|%ld|\n", rule_names[r->effect - NO_RULE], r->weight, r->target, r->first, r->last);
+    }
+    return OK;
+}
@@ -0,0 +1,264 @@
+/**
+ * @brief It tests the random rules module
+ *
+ * @file rule_table_test.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/rule_table.h"
+#include "../include/test.h"
+#include "../include/types.h"
+
+#define TEST_DRAWS 60000
+#define TEST_FILE "/tmp/rule_table_test.dat"
+
+void test_rule_table_create() {
+    RuleTable* t = rule_table_create();
+    PRINT_TEST_RESULT(t != NULL && rule_table_count(t) == 0);
+    rule_table_destroy(&t);
+}
+
+void test_rule_table_destroy_null() {
+    RuleTable* t = NULL;
+    PRINT_TEST_RESULT(rule_table_destroy(&t) == ERROR);
+}
+
+void test_rule_table_add_invalid() {
+    RuleTable* t = rule_table_create();
+    Rule negative = {TAKERULE, -1, NO_ID, NO_ID, NO_ID};
+    Rule nowhere = {TELEPORTRULE, 1, NO_ID, NO_ID, NO_ID};
+    Rule half = {DIERULE, 1, NO_ID, 10, NO_ID};
+
+    PRINT_TEST_RESULT(rule_table_add(t, &negative) == ERROR && rule_table_add(t, &nowhere) == ERROR &&
+                      rule_table_add(t, &half) == ERROR && rule_table_add(t, NULL) == ERROR &&
+                      rule_table_count(t) == 0);
+    rule_table_destroy(&t);
+}
+
+void test_rule_table_add() {
+    RuleTable* t = rule_table_create();
+    Rule r = {ONRULE, 3, 55, 20, 10};
+    const Rule* added;
+
+    rule_table_add(t, &r);
+    added = rule_table_get(t, 0);
+    // The range is put in order and only a teleport keeps its target
+    PRINT_TEST_RESULT(rule_table_count(t) == 1 && added != NULL && added->effect == ONRULE && added->weight == 3 &&
+                      added->target == NO_ID && added->first == 10 && added->last == 20 && rule_table_get(t, 1) == NULL);
+    rule_table_destroy(&t);
+}
+
+void test_rule_table_default() {
+    RuleTable* t = rule_table_create();
+    Rng* rng = rng_create(5);
+    int counts[OFFRULE + 2] = {0};
+    BOOL near = TRUE;
+
+    rule_table_add_default(t);
+    rule_table_compile(t);
+    for (int i = 0; i < TEST_DRAWS; i++)
+        counts[rule_table_sample(t, rng, 1, NULL) + 1]++;
+    // The chances out of 100 the rules always had, 5 standard deviations either way
+    if (counts[NO_RULE + 1] < 46901 || counts[NO_RULE + 1] > 47899 || counts[DIERULE + 1] < 478 || counts[DIERULE + 1] > 722)
+        near = FALSE;
+    for (int i = 0; i <= OFFRULE; i++) {
+        if (i != DIERULE && (counts[i + 1] < 2733 || counts[i + 1] > 3267))
+            near = FALSE;
+    }
+    PRINT_TEST_RESULT(rule_table_count(t) == 6 && near == TRUE);
+    rng_destroy(&rng);
+    rule_table_destroy(&t);
+}
+
+void test_rule_table_range() {
+    RuleTable* t = rule_table_create();
+    Rng* rng = rng_create(9);
+    Rule world = {TAKERULE, 1, NO_ID, NO_ID, NO_ID};
+    Rule wide = {DROPRULE, 1, NO_ID, 1, 100};
+    Rule narrow = {DIERULE, 1, NO_ID, 40, 50};
+    BOOL right = TRUE;
+
+    rule_table_add(t, &world);
+    rule_table_add(t, &wide);
+    rule_table_add(t, &narrow);
+    rule_table_compile(t);
+    // The narrowest range a space is in has its rules
+    for (int i = 0; i < 100; i++) {
+        if (rule_table_sample(t, rng, 45, NULL) != DIERULE || rule_table_sample(t, rng, 20, NULL) != DROPRULE ||
+            rule_table_sample(t, rng, 500, NULL) != TAKERULE)
+            right = FALSE;
+    }
+    PRINT_TEST_RESULT(right == TRUE);
+    rng_destroy(&rng);
+    rule_table_destroy(&t);
+}
+
+void test_rule_table_teleport() {
+    RuleTable* t = rule_table_create();
+    Rng* rng = rng_create(2);
+    Rule r = {TELEPORTRULE, 4, 33, NO_ID, NO_ID};
+    Id target = NO_ID;
+
+    rule_table_add(t, &r);
+    rule_table_compile(t);
+    PRINT_TEST_RESULT(rule_table_sample(t, rng, 1, &target) == TELEPORTRULE && target == 33);
+    rng_destroy(&rng);
+    rule_table_destroy(&t);
+}
+
+void test_rule_table_no_weight() {
+    RuleTable* t = rule_table_create();
+    Rng* rng = rng_create(2);
+    Rule world = {TAKERULE, 1, NO_ID, NO_ID, NO_ID};
+    Rule quiet = {DIERULE, 0, NO_ID, 1, 10};
+    BOOL nothing = TRUE;
+
+    rule_table_add(t, &world);
+    rule_table_add(t, &quiet);
+    rule_table_compile(t);
+    // A range without weights is a safe place, the world does not reach it
+    for (int i = 0; i < 100; i++) {
+        if (rule_table_sample(t, rng, 5, NULL) != NO_RULE)
+            nothing = FALSE;
+    }
+    PRINT_TEST_RESULT(nothing == TRUE && rule_table_sample(t, rng, 11, NULL) == TAKERULE);
+    rng_destroy(&rng);
+    rule_table_destroy(&t);
+}
+
+void test_rule_table_weights() {
+    RuleTable* t = rule_table_create();
+    Rng* rng = rng_create(11);
+    Rule on = {ONRULE, 3, NO_ID, NO_ID, NO_ID};
+    Rule off = {OFFRULE, 1, NO_ID, NO_ID, NO_ID};
+    int n_on = 0;
+
+    rule_table_add(t, &on);
+    rule_table_add(t, &off);
+    rule_table_compile(t);
+    for (int i = 0; i < TEST_DRAWS; i++) {
+        if (rule_table_sample(t, rng, 1, NULL) == ONRULE)
+            n_on++;
+    }
+    // 45000 expected, 5 standard deviations either way
+    PRINT_TEST_RESULT(n_on > 44470 && n_on < 45530);
+    rng_destroy(&rng);
+    rule_table_destroy(&t);
+}
+
+void test_rule_effect_from_name() {
+    T_Rules effect = NO_RULE;
+    BOOL named = rule_effect_from_name("Teleport", &effect) == OK && effect == TELEPORTRULE;
+
+    PRINT_TEST_RESULT(named == TRUE && rule_effect_from_name("none", &effect) == OK && effect == NO_RULE &&
+                      rule_effect_from_name("fly", &effect) == ERROR && rule_effect_from_name(NULL, &effect) == ERROR);
+}
+
+void test_rule_table_save() {
+    RuleTable* t = rule_table_create();
+    Rule r = {TELEPORTRULE, 2, 7, 1, 3};
+    char line[100] = "";
+    FILE* fp = fopen(TEST_FILE, "w");
+
+    rule_table_add(t, &r);
+    rule_table_save(fp, t);
+    fclose(fp);
+    fp = fopen(TEST_FILE, "r");
+    if (fp != NULL) {
+        if (fgets(line, sizeof(line), fp) == NULL)
+            line[0] = '\0';
+        fclose(fp);
+    }
+    PRINT_TEST_RESULT(strcmp(line, "#r:teleport|2|7|1|3|\n") == 0 && rule_table_save(NULL, t) == ERROR);
+    remove(TEST_FILE);
+    rule_table_destroy(&t);
+}
+
+void test_rule_table_null() {
+    PRINT_TEST_RESULT(rule_table_sample(NULL, NULL, 1, NULL) == NO_RULE && rule_table_count(NULL) == -1 &&
+                      rule_table_compile(NULL) == ERROR && rule_table_add_default(NULL) == ERROR);
+}
+
+void test_all() {
+    test_rule_table_create();
+    test_rule_table_destroy_null();
+    test_rule_table_add_invalid();
+    test_rule_table_add();
+    test_rule_table_default();
+    test_rule_table_range();
+    test_rule_table_teleport();
+    test_rule_table_no_weight();
+    test_rule_table_weights();
+    test_rule_effect_from_name();
+    test_rule_table_save();
+    test_rule_table_null();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for RuleTable unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("RuleTable test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_rule_table_create();
+                break;
+            case 2:
+                test_rule_table_destroy_null();
+                break;
+            case 3:
+                test_rule_table_add_invalid();
+                break;
+            case 4:
+                test_rule_table_add();
+                break;
+            case 5:
+                test_rule_table_default();
+                break;
+            case 6:
+                test_rule_table_range();
+                break;
+            case 7:
+                test_rule_table_teleport();
+                break;
+            case 8:
+                test_rule_table_no_weight();
+                break;
+            case 9:
+                test_rule_table_weights();
+                break;
+            case 10:
+                test_rule_effect_from_name();
+                break;
+            case 11:
+                test_rule_table_save();
+                break;
+            case 12:
+                test_rule_table_null();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
@@ -0,0 +1,227 @@
+/**
+ * @brief It implements the delimiter scanner. The vector versions compare
+ * 16 or 32 bytes with '|' and '\n' at once and turn the matches into a bit
+ * mask, every set bit is a position
+ *
+ * @file scan.c
+ * @author Eva Moresova
+ * @version 1.0
+ * @date 24-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/scan.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCAN_HAVE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define SCAN_FIELD '|'
+#define SCAN_LINE '\n'
+
+/* -1 until the first scan chooses the best instruction set */
+static int current_isa = -1;
+
+/**
+ * @brief index of the lowest set bit
+ *
+ * @param bits mask, not 0
+ * @return index of the bit
+ */
+static int scan_ctz(unsigned int bits);
+
+/**
+ * @brief byte by byte scan, used for the bytes left by the vector versions
+ *
+ * @param p start of the block
+ * @param i first byte to look at
+ * @param len number of bytes of the block
+ * @param out positions
+ * @param n positions already written
+ * @param max size of out
+ * @param scanned set to the number of bytes looked at
+ * @return number of positions written in total
+ */
+static size_t scan_scalar(const char* p, size_t i, size_t len, unsigned int* out, size_t n, size_t max, size_t* scanned);
+
+#ifdef __SSE2__
+/**
+ * @brief scans the block 16 bytes at a time while there is room in out
+ *
+ * @param p start of the block
+ * @param len number of bytes of the block
+ * @param out positions
+ * @param max size of out
+ * @param i set to the first byte not scanned
+ * @return number of positions written
+ */
+static size_t scan_sse2(const char* p, size_t len, unsigned int* out, size_t max, size_t* i);
+#endif
+
+#ifdef SCAN_HAVE_AVX2
+/**
+ * @brief scans the block 32 bytes at a time while there is room in out
+ *
+ * @param p start of the block
+ * @param len number of bytes of the block
+ * @param out positions
+ * @param max size of out
+ * @param i set to the first byte not scanned
+ * @return number of positions written
+ */
+__attribute__((target("avx2"))) static size_t scan_avx2(const char* p, size_t len, unsigned int* out, size_t max, size_t* i);
+#endif
+
+/**
+ * @brief TRUE if the processor can run the instruction set
+ *
+ * @param isa instruction set
+ * @return BOOL
+ */
+static BOOL scan_supported(SCAN_ISA isa);
+
+static int scan_ctz(unsigned int bits) {
+#ifdef __GNUC__
+    return __builtin_ctz(bits);
+#else
+    int n = 0;
+    while ((bits & 1u) == 0) {
+        bits >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+static size_t scan_scalar(const char* p, size_t i, size_t len, unsigned int* out, size_t n, size_t max, size_t* scanned) {
+    for (; i < len && n < max; i++) {
+        if (p[i] == SCAN_FIELD || p[i] == SCAN_LINE)
+            out[n++] = (unsigned int)i;
+    }
+    if (scanned != NULL)
+        *scanned = i;
+    return n;
+}
+
+#ifdef __SSE2__
+static size_t scan_sse2(const char* p, size_t len, unsigned int* out, size_t max, size_t* i) {
+    const __m128i field = _mm_set1_epi8(SCAN_FIELD);
+    const __m128i line = _mm_set1_epi8(SCAN_LINE);
+    size_t n = 0;
+
+    // A block of 16 bytes is only scanned if all its positions fit
+    for (*i = 0; *i + 16 <= len && max - n >= 16; *i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + *i));
+        unsigned int bits = (unsigned int)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, field), _mm_cmpeq_epi8(v, line)));
+        while (bits != 0) {
+            out[n++] = (unsigned int)(*i + scan_ctz(bits));
+            bits &= bits - 1;
+        }
+    }
+    return n;
+}
+#endif
+
+#ifdef SCAN_HAVE_AVX2
+__attribute__((target("avx2"))) static size_t scan_avx2(const char* p, size_t len, unsigned int* out, size_t max, size_t* i) {
+    const __m256i field = _mm256_set1_epi8(SCAN_FIELD);
+    const __m256i line = _mm256_set1_epi8(SCAN_LINE);
+    size_t n = 0;
+
+    for (*i = 0; *i + 32 <= len && max - n >= 32; *i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + *i));
+        unsigned int bits = (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, field), _mm256_cmpeq_epi8(v, line)));
+        while (bits != 0) {
+            out[n++] = (unsigned int)(*i + scan_ctz(bits));
+            bits &= bits - 1;
+        }
+    }
+    return n;
+}
+#endif
+
+static BOOL scan_supported(SCAN_ISA isa) {
+    switch (isa) {
+        case SCAN_SCALAR:
+            return TRUE;
+        case SCAN_SSE2:
+#ifdef __SSE2__
+            return TRUE;
+#else
+            return FALSE;
+#endif
+        case SCAN_AVX2:
+#ifdef SCAN_HAVE_AVX2
+            return __builtin_cpu_supports("avx2") ? TRUE : FALSE;
+#else
+            return FALSE;
+#endif
+        default:
+            return FALSE;
+    }
+}
+
+size_t scan_delimiters(const char* p, size_t len, unsigned int* out, size_t max, size_t* scanned) {
+    size_t i = 0, n = 0;
+
+    if (p == NULL || out == NULL) {
+        if (scanned != NULL)
+            *scanned = 0;
+        return 0;
+    }
+
+    switch (scan_get_isa()) {
+#ifdef SCAN_HAVE_AVX2
+        case SCAN_AVX2:
+            n = scan_avx2(p, len, out, max, &i);
+            break;
+#endif
+#ifdef __SSE2__
+        case SCAN_SSE2:
+            n = scan_sse2(p, len, out, max, &i);
+            break;
+#endif
+        default:
+            break;
+    }
+    return scan_scalar(p, i, len, out, n, max, scanned);
+}
+
+long scan_long(const char* s, size_t len) {
+    long n = 0, sign = 1;
+
+    if (s == NULL)
+        return 0;
+
+    const char* end = s + len;
+    while (s < end && (*s == ' ' || *s == '\t'))
+        s++;
+    if (s < end && (*s == '-' || *s == '+')) {
+        sign = (*s == '-') ? -1 : 1;
+        s++;
+    }
+    for (; s < end && *s >= '0' && *s <= '9'; s++)
+        n = n * 10 + (*s - '0');
+    return sign * n;
+}
+
+STATUS scan_set_isa(SCAN_ISA isa) {
+    if (scan_supported(isa) == FALSE)
+        return ERROR;
+    current_isa = isa;
+    return OK;
+}
+
+SCAN_ISA scan_get_isa() {
+    if (current_isa < 0) {
+        current_isa = SCAN_SCALAR;
+        if (scan_supported(SCAN_SSE2))
+            current_isa = SCAN_SSE2;
+        if (scan_supported(SCAN_AVX2))
+            current_isa = SCAN_AVX2;
+    }
+    return (SCAN_ISA)current_isa;
+}
@@ -0,0 +1,184 @@
+/**
+ * @brief Microbenchmark of the delimiter scanner. It generates a world in
+ * the format of the data files and measures how many GB/s are scanned with
+ * each instruction set, alone and reading every number field, against the
+ * strtok and atol loop the loader used before
+ *
+ * Usage: ./scan_bench [megabytes]
+ *
+ * @file scan_bench.c
+ * @author Eva Moresova
+ * @version 1.0
+ * @date 24-05-2021
+ * @copyright GNU Public License
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/scan.h"
+
+#define BENCH_MEGABYTES 64
+#define BENCH_ROUNDS 5
+/* delimiters scanned at once, like the loader window */
+#define BENCH_WINDOW 65536
+
+static const char* isa_names[] = {"scalar", "sse2", "avx2"};
+
+/**
+ * @brief fills a buffer with spaces, objects and links lines
+ *
+ * @param size bytes to generate
+ * @param len set to the bytes written, whole lines only
+ * @return the buffer or NULL if error
+ */
+static char* bench_world(size_t size, size_t* len);
+
+/**
+ * @brief seconds since some fixed point
+ *
+ * @return seconds
+ */
+static double bench_now();
+
+/**
+ * @brief scans the whole buffer a window at a time
+ *
+ * @param data buffer
+ * @param len bytes of the buffer
+ * @param pos room for BENCH_WINDOW positions
+ * @param numbers TRUE to also read every field that starts with a digit
+ * @return sum of the positions or numbers, so nothing is optimized away
+ */
+static long bench_scan(const char* data, size_t len, unsigned int* pos, BOOL numbers);
+
+/**
+ * @brief the old way, strtok and atol over a copy of every line
+ *
+ * @param data buffer
+ * @param len bytes of the buffer
+ * @return sum of the numbers
+ */
+static long bench_strtok(const char* data, size_t len);
+
+static char* bench_world(size_t size, size_t* len) {
+    char* data = malloc(size + 256);
+    if (data == NULL)
+        return NULL;
+
+    size_t n = 0;
+    for (long i = 1; n < size; i++) {
+        switch (i % 3) {
+            case 0:
+                n += sprintf(data + n, "#s:%ld|Room %ld        |You are in room number %ld |Nothing special here |%ld|-1|%ld|-1|-1|-1|1|       |  %03ld  |       |\n", i, i, i, i + 1, i - 1, i % 1000);
+                break;
+            case 1:
+                n += sprintf(data + n, "#o:%ld|thing%ld|A thing that is not very useful|%ld|1|-1|-1|0|0\n", i, i, i / 3);
+                break;
+            default:
+                n += sprintf(data + n, "#l:%ld|Door%ld|%ld|%ld|0|\n", i, i, i / 3, i / 3 + 1);
+                break;
+        }
+    }
+    *len = n;
+    return data;
+}
+
+static double bench_now() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+}
+
+static long bench_scan(const char* data, size_t len, unsigned int* pos, BOOL numbers) {
+    long sum = 0;
+
+    for (size_t off = 0; off < len; off += BENCH_WINDOW) {
+        size_t chunk = (len - off < BENCH_WINDOW) ? len - off : BENCH_WINDOW;
+        const char* p = data + off;
+        size_t n = scan_delimiters(p, chunk, pos, BENCH_WINDOW, NULL);
+        if (numbers == FALSE) {
+            sum += (long)n;
+            continue;
+        }
+        // The field after each delimiter, up to the next one
+        for (size_t k = 0; k + 1 < n; k++) {
+            const char* field = p + pos[k] + 1;
+            if (*field >= '0' && *field <= '9')
+                sum += scan_long(field, pos[k + 1] - pos[k] - 1);
+        }
+    }
+    return sum;
+}
+
+static long bench_strtok(const char* data, size_t len) {
+    char line[1000];
+    long sum = 0;
+    const char* p = data;
+    const char* end = data + len;
+
+    while (p < end) {
+        const char* eol = memchr(p, '\n', (size_t)(end - p));
+        size_t n = (size_t)(eol - p);
+        memcpy(line, p, n);
+        line[n] = '\0';
+        for (char* tok = strtok(line + 3, "|"); tok != NULL; tok = strtok(NULL, "|")) {
+            if (*tok >= '0' && *tok <= '9')
+                sum += atol(tok);
+        }
+        p = eol + 1;
+    }
+    return sum;
+}
+
+int main(int argc, char** argv) {
+    size_t megabytes = (argc == 2) ? (size_t)atol(argv[1]) : BENCH_MEGABYTES;
+    size_t len = 0;
+    char* data = bench_world(megabytes << 20, &len);
+    unsigned int* pos = malloc(sizeof(unsigned int) * BENCH_WINDOW);
+    if (data == NULL || pos == NULL || len == 0) {
+        fprintf(stderr, "Not enough memory\n");
+        return 1;
+    }
+
+    printf("Scan benchmark, %.1f MB world, best of %d rounds\n", (double)len / (1 << 20), BENCH_ROUNDS);
+    printf("%-8s %12s %12s\n", "isa", "scan GB/s", "fields GB/s");
+
+    SCAN_ISA best = scan_get_isa();
+    for (int isa = SCAN_SCALAR; isa <= SCAN_AVX2; isa++) {
+        if (scan_set_isa(isa) == ERROR)
+            continue;
+        double rate[2] = {0, 0};
+        for (int numbers = 0; numbers < 2; numbers++) {
+            for (int r = 0; r < BENCH_ROUNDS; r++) {
+                double t = bench_now();
+                volatile long sum = bench_scan(data, len, pos, numbers);
+                (void)sum;
+                t = bench_now() - t;
+                if ((double)len / t / 1e9 > rate[numbers])
+                    rate[numbers] = (double)len / t / 1e9;
+            }
+        }
+        printf("%-8s %12.2f %12.2f%s\n", isa_names[isa], rate[0], rate[1], (isa == (int)best) ? "  (default)" : "");
+    }
+    scan_set_isa(best);
+
+    double rate = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        double t = bench_now();
+        volatile long sum = bench_strtok(data, len);
+        (void)sum;
+        t = bench_now() - t;
+        if ((double)len / t / 1e9 > rate)
+            rate = (double)len / t / 1e9;
+    }
+    printf("%-8s %12s %12.2f\n", "strtok", "-", rate);
+
+    free(pos);
+    free(data);
+    return 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * @brief It tests the scan module
+ *
+ * @file scan_test.c
+ * @author Eva Moresova
+ * @version 1.0
+ * @date 24-05-2021
+ * @copyright GNU Public License
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/scan.h"
+#include "../include/test.h"
+#include "../include/types.h"
+
+#define LONG_TEXT 1000
+
+void test_scan_delimiters() {
+    const char* line = "#l:1|Door|1|2|0|\n";
+    unsigned int out[10];
+    size_t n = scan_delimiters(line, strlen(line), out, 10, NULL);
+    PRINT_TEST_RESULT(n == 6 && out[0] == 4 && out[1] == 9 && out[4] == 15 && out[5] == 16);
+}
+
+void test_scan_delimiters_null() {
+    unsigned int out[4];
+    size_t scanned = 1;
+    PRINT_TEST_RESULT(scan_delimiters(NULL, 4, out, 4, &scanned) == 0 && scanned == 0);
+}
+
+void test_scan_delimiters_none() {
+    const char* line = "no delimiters in this text at all";
+    unsigned int out[4];
+    size_t scanned = 0;
+    PRINT_TEST_RESULT(scan_delimiters(line, strlen(line), out, 4, &scanned) == 0 && scanned == strlen(line));
+}
+
+void test_scan_delimiters_full() {
+    const char* line = "||||||||";
+    unsigned int out[3];
+    size_t scanned = 0;
+    size_t n = scan_delimiters(line, strlen(line), out, 3, &scanned);
+    PRINT_TEST_RESULT(n == 3 && scanned == 3 && out[2] == 2);
+}
+
+void test_scan_isa_agree() {
+    char text[LONG_TEXT];
+    unsigned int expected[LONG_TEXT], out[LONG_TEXT];
+    const char pick[] = "ab|\n1-";
+    BOOL ok = TRUE;
+
+    srand(7);
+    for (int i = 0; i < LONG_TEXT; i++)
+        text[i] = pick[rand() % 6];
+
+    // An odd start and length leave bytes for the scalar part
+    SCAN_ISA best = scan_get_isa();
+    scan_set_isa(SCAN_SCALAR);
+    size_t n = scan_delimiters(text + 1, LONG_TEXT - 2, expected, LONG_TEXT, NULL);
+    for (int isa = SCAN_SSE2; isa <= SCAN_AVX2; isa++) {
+        if (scan_set_isa(isa) == ERROR)
+            continue;
+        if (scan_delimiters(text + 1, LONG_TEXT - 2, out, LONG_TEXT, NULL) != n || memcmp(out, expected, n * sizeof(unsigned int)) != 0)
+            ok = FALSE;
+    }
+    scan_set_isa(best);
+    PRINT_TEST_RESULT(ok == TRUE);
+}
+
+void test_scan_long() {
+    PRINT_TEST_RESULT(scan_long("1234|", 4) == 1234 && scan_long("12|34", 2) == 12);
+}
+
+void test_scan_long_negative() {
+    PRINT_TEST_RESULT(scan_long(" -1", 3) == -1 && scan_long("+5", 2) == 5);
+}
+
+void test_scan_long_text() {
+    PRINT_TEST_RESULT(scan_long("abc", 3) == 0 && scan_long("7x", 2) == 7 && scan_long(NULL, 3) == 0);
+}
+
+void test_scan_set_isa() {
+    SCAN_ISA best = scan_get_isa();
+    BOOL ok = (scan_set_isa(SCAN_SCALAR) == OK && scan_get_isa() == SCAN_SCALAR);
+    scan_set_isa(best);
+    PRINT_TEST_RESULT(ok == TRUE && scan_get_isa() == best);
+}
+
+void test_all() {
+    test_scan_delimiters();
+    test_scan_delimiters_null();
+    test_scan_delimiters_none();
+    test_scan_delimiters_full();
+    test_scan_isa_agree();
+    test_scan_long();
+    test_scan_long_negative();
+    test_scan_long_text();
+    test_scan_set_isa();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for SCAN unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("Scan test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_scan_delimiters();
+                break;
+            case 2:
+                test_scan_delimiters_null();
+                break;
+            case 3:
+                test_scan_delimiters_none();
+                break;
+            case 4:
+                test_scan_delimiters_full();
+                break;
+            case 5:
+                test_scan_isa_agree();
+                break;
+            case 6:
+                test_scan_long();
+                break;
+            case 7:
+                test_scan_long_negative();
+                break;
+            case 8:
+                test_scan_long_text();
+                break;
+            case 9:
+                test_scan_set_isa();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
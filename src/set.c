@@ -1,10 +1,15 @@
-/** 
+/**
  * @brief Contains the implementation for set and its functions
- * 
+ *
+ * The elements are kept in a contiguous array, stored inline in the set
+ * while there are few of them. Above SET_INLINE_SIZE elements an open
+ * addressing index from id to position in the array is built, so
+ * membership, insertion and deletion stay O(1) for big sets.
+ *
  * @file set.c
  * @author Eva Moresova
- * @version 1.0 
- * @date 01-03-2021 
+ * @version 2.0
+ * @date 15-05-2021
  * @copyright GNU Public License
  */
 
@@ -12,59 +17,126 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "../include/arena.h"
 
-typedef struct _Vector {
-	Id id;
-	struct _Vector* next;
-} Vector;
+#define SET_INLINE_SIZE 32
 
 struct _Set {
-	Vector* head;
+	Id* ids;        // elements, points to inline_ids while the set is small
 	int size;
+	int capacity;
+	int* slots;     // position + 1 of the element in ids, 0 is empty. NULL while small
+	int n_slots;    // always a power of two
+	Arena* arena;   // arena the set and its arrays are taken from, NULL if they were malloc'd
+	Id inline_ids[SET_INLINE_SIZE];
 };
 
 /** Private functions definitions */
 
 /**
- * @brief for testing if element with specified id is in the set
+ * @brief getter for the position of an element in the set by its id
  *
  * @author Eva Moresova
- * @date 01-03-2021 
- * 
+ * @date 15-05-2021
+ *
  * @param s pointer to set
  * @param id Id of element
- * @return TRUE if element exists in the set, FALSE otherwise
+ * @return position of the element in the elements array or -1
  */
-BOOL set_element_exists(Set* s, Id id);
+int set_get_position(Set* s, Id id);
 
 /**
- * @brief getter for element from a set by its id
+ * @brief first slot of the index to probe for the id
  *
- * @author Eva Moresova
- * @date 01-03-2021 
- * 
  * @param s pointer to set
  * @param id Id of element
- * @return pointer to element with specified id
+ * @return slot number
  */
-Vector* set_get_element_by_id(Set* s, Id id);
+static int set_home_slot(Set* s, Id id);
 
+/**
+ * @brief builds the index of all the elements with the specified number
+ * of slots, the previous index is freed
+ *
+ * @param s pointer to set
+ * @param n_slots number of slots, a power of two
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS set_build_index(Set* s, int n_slots);
+
+/**
+ * @brief allocates memory for the arrays of the set, from its arena if it
+ * has one
+ *
+ * @param s pointer to set
+ * @param size number of bytes
+ * @return pointer to the memory or NULL if error
+ */
+static void* set_alloc(Set* s, size_t size);
 
+/**
+ * @brief frees an array of the set, memory of the arena is left to it
+ *
+ * @param s pointer to set
+ * @param p pointer to the array
+ */
+static void set_free(Set* s, void* p);
 
 /** Private functions implementation */
 
-Vector* set_get_element_by_id(Set* s, Id id) {
+static int set_home_slot(Set* s, Id id) {
+	unsigned long long h = (unsigned long long)id * 11400714819323198485ull;
+	return (int)((h >> 32) & (unsigned long long)(s->n_slots - 1));
+}
+
+static void* set_alloc(Set* s, size_t size) {
+	return (s->arena != NULL) ? arena_alloc(s->arena, size) : malloc(size);
+}
+
+static void set_free(Set* s, void* p) {
+	if (s->arena == NULL)
+		free(p);
+}
+
+static STATUS set_build_index(Set* s, int n_slots) {
+	int* slots = (int*)set_alloc(s, sizeof(int) * n_slots);
+	if (slots == NULL)
+		return ERROR;
+
+	memset(slots, 0, sizeof(int) * n_slots);
+	set_free(s, s->slots);
+	s->slots = slots;
+	s->n_slots = n_slots;
+	for (int i = 0; i < s->size; i++) {
+		int j = set_home_slot(s, s->ids[i]);
+		while (slots[j] != 0)
+			j = (j + 1) & (n_slots - 1);
+		slots[j] = i + 1;
+	}
+	return OK;
+}
+
+int set_get_position(Set* s, Id id) {
 	if (s == NULL)
-		return NULL;
+		return -1;
 
-	Vector* v = s->head;
-	for (int i=0; i < set_get_size(s); i++) {
-		if (v->id == id) {
-			return v;
+	if (s->slots == NULL) {
+		for (int i = 0; i < s->size; i++) {
+			if (s->ids[i] == id)
+				return i;
 		}
-		v = v->next;
+		return -1;
 	}
-	return NULL;
+
+	int j = set_home_slot(s, id);
+	while (s->slots[j] != 0) {
+		if (s->ids[s->slots[j] - 1] == id)
+			return s->slots[j] - 1;
+		j = (j + 1) & (s->n_slots - 1);
+	}
+	return -1;
 }
 
 
@@ -73,27 +145,29 @@ int set_get_size(Set* s) {
 	return (s == NULL) ? -1 : s->size;
 }
 
-Set* set_create() {
-	Set* s = (Set*)malloc(sizeof(struct _Set));
+Set* set_create(Arena* a) {
+	Set* s = (Set*)((a != NULL) ? arena_alloc(a, sizeof(struct _Set)) : malloc(sizeof(struct _Set)));
 	if (s != NULL) {
-		s->head = NULL;
+		s->arena = a;
+		s->ids = s->inline_ids;
 		s->size = 0;
+		s->capacity = SET_INLINE_SIZE;
+		s->slots = NULL;
+		s->n_slots = 0;
 	}
 	return s;
 }
 
 STATUS set_destroy(Set** s) {
-	if (*s == NULL) 
+	if (*s == NULL)
 		return OK;
 
-	if (!set_is_empty(*s)) {
-		for(int i = 0; i < set_get_size(*s); i++) {
-			Vector* tmp = (*s)->head;
-			(*s)->head = (*s)->head->next;
-			free(tmp);
-		}
+	if ((*s)->arena == NULL) {
+		if ((*s)->ids != (*s)->inline_ids)
+			free((*s)->ids);
+		free((*s)->slots);
+		free(*s);
 	}
-	free(*s);
 	*s = NULL;
 	return OK;
 }
@@ -106,24 +180,49 @@ BOOL set_is_empty(Set* s) {
 }
 
 BOOL set_element_exists(Set* s, Id id) {
-	return (set_get_element_by_id(s, id) != NULL);
+	return (set_get_position(s, id) != -1);
 }
 
 STATUS set_add(Set* s, Id id) {
-	if (s == NULL) 
+	if (s == NULL)
 		return ERROR;
 
-	if (set_element_exists(s, id)) 
+	if (set_element_exists(s, id))
 		return OK;
 
-	Vector* v = (Vector*)malloc(sizeof(Vector));
-	if (v == NULL) {
-		return ERROR;
+	if (s->size == s->capacity) {
+		Id* ids = NULL;
+		if (s->ids == s->inline_ids || s->arena != NULL) {
+			ids = (Id*)set_alloc(s, sizeof(Id) * s->capacity * 2);
+			if (ids != NULL)
+				memcpy(ids, s->ids, sizeof(Id) * s->size);
+		} else {
+			ids = (Id*)realloc(s->ids, sizeof(Id) * s->capacity * 2);
+		}
+		if (ids == NULL)
+			return ERROR;
+		s->ids = ids;
+		s->capacity *= 2;
+	}
+	s->ids[s->size++] = id;
+
+	if (s->slots == NULL) {
+		if (s->size > SET_INLINE_SIZE && set_build_index(s, 4 * SET_INLINE_SIZE) == ERROR) {
+			s->size--;
+			return ERROR;
+		}
+	} else if (s->size * 2 > s->n_slots) {
+		/* keep the index at most half full */
+		if (set_build_index(s, 2 * s->n_slots) == ERROR) {
+			s->size--;
+			return ERROR;
+		}
+	} else {
+		int j = set_home_slot(s, id);
+		while (s->slots[j] != 0)
+			j = (j + 1) & (s->n_slots - 1);
+		s->slots[j] = s->size;
 	}
-	v->id = id;
-	v->next = s->head;
-	s->head = v;
-	s->size++;
 
 	return OK;
 }
@@ -132,42 +231,55 @@ STATUS 	set_delete(Set* s, Id id) {
 	if (s == NULL || set_is_empty(s))
 		return ERROR;
 
-	Vector* v1 = s->head;
-	Vector* v2 = v1->next;
-	if (v1->id == id) {
-		free(v1);
-		s->head = v2;
-		s->size -= 1;
-		return OK;
-	}
-	for(int i=0; i < (set_get_size(s) - 1); i++) {
-		if (v2->id == id) {
-			v1->next = v2->next;
-			free(v2);
-			s->size -= 1;
-			return OK; 
-		} else {
-			v1 = v2;
-			v2 = v2->next;
+	int pos = set_get_position(s, id);
+	if (pos == -1)
+		return ERROR;
+
+	int last = s->size - 1;
+	if (s->slots != NULL) {
+		int mask = s->n_slots - 1;
+		int i = set_home_slot(s, id);
+		while (s->slots[i] != pos + 1)
+			i = (i + 1) & mask;
+
+		/* backward shift deletion, no tombstones are left behind */
+		int j = i;
+		for (;;) {
+			j = (j + 1) & mask;
+			if (s->slots[j] == 0)
+				break;
+			int k = set_home_slot(s, s->ids[s->slots[j] - 1]);
+			if ((i <= j) ? (i < k && k <= j) : (i < k || k <= j))
+				continue;
+			s->slots[i] = s->slots[j];
+			i = j;
+		}
+		s->slots[i] = 0;
+
+		/* the last element takes the place of the deleted one */
+		if (pos != last) {
+			j = set_home_slot(s, s->ids[last]);
+			while (s->slots[j] != last + 1)
+				j = (j + 1) & mask;
+			s->slots[j] = pos + 1;
 		}
 	}
-	return ERROR;
+	s->ids[pos] = s->ids[last];
+	s->size--;
+	return OK;
 }
 
 int set_print(Set* s, FILE* fp) {
-	if (s == NULL || fp == NULL) 
+	if (s == NULL || fp == NULL)
 		return -1;
 
 	int c = 0;
 	if (set_is_empty(s)) {
 		c += fprintf(fp, "Size 0: {}\n");
 	} else {
-		Vector* v = s->head;
-		c += fprintf(fp, "Size %d: {%ld", set_get_size(s), v->id);
-		v = v->next;
-		while (v != NULL) {
-			c += fprintf(fp, ", %ld", v->id);
-			v = v->next;
+		c += fprintf(fp, "Size %d: {%ld", set_get_size(s), s->ids[0]);
+		for (int i = 1; i < s->size; i++) {
+			c += fprintf(fp, ", %ld", s->ids[i]);
 		}
 		c += fprintf(fp, "}\n");
 	}
@@ -181,10 +293,14 @@ Id* set_get_elements(Set* s) {
 	if(elems == NULL)
 		return NULL;
 
-	Vector* v = s->head;
-	for (int i = 0; (i < set_get_size(s) && v != NULL); i++) {
-		elems[i] = v->id;
-		v = v->next;
-	}
+	memcpy(elems, s->ids, sizeof(Id) * s->size);
 	return elems;
 }
+
+const Id* set_iter(Set* s, int* count) {
+	if (count != NULL)
+		*count = (s == NULL) ? 0 : s->size;
+	if (s == NULL || set_is_empty(s))
+		return NULL;
+	return s->ids;
+}
@@ -16,12 +16,12 @@
 #include "../include/types.h"
 
 void test_set_init() {
-    Set *s = set_create();
+    Set *s = set_create(NULL);
     PRINT_TEST_RESULT(s != NULL);
 }
 
 void test_set_destroy_inicialized() {
-    Set *s = set_create();
+    Set *s = set_create(NULL);
     set_destroy(&s);
     PRINT_TEST_RESULT(s == NULL);
 }
@@ -33,7 +33,7 @@ void test_set_destroy_null() {
 }
 
 void test_set_get_size() {
-    Set *s = set_create();
+    Set *s = set_create(NULL);
     PRINT_TEST_RESULT(set_get_size(s) == 0);
 }
 
@@ -43,7 +43,7 @@ void test_set_get_size_null() {
 }
 
 void test_set_add_item() {
-    Set *s = set_create();
+    Set *s = set_create(NULL);
     PRINT_TEST_RESULT(set_add(s, 5) == OK);
 }
 
@@ -53,7 +53,7 @@ void test_set_add_to_null() {
 }
 
 void test_set_delete_item() {
-    Set *s = set_create();
+    Set *s = set_create(NULL);
     set_add(s, 5);
     PRINT_TEST_RESULT(set_delete(s, 5) == OK);
 }
@@ -64,10 +64,41 @@ void test_set_delete_to_null() {
 }
 
 void test_set_delete_non_existing_item() {
-    Set *s = set_create();
+    Set *s = set_create(NULL);
     PRINT_TEST_RESULT(set_delete(s, 5) == ERROR);
 }
 
+void test_set_add_existing_item() {
+    Set *s = set_create(NULL);
+    set_add(s, 5);
+    set_add(s, 5);
+    PRINT_TEST_RESULT(set_get_size(s) == 1);
+}
+
+void test_set_many_items() {
+    Set *s = set_create(NULL);
+    BOOL ok = TRUE;
+    for (int i = 0; i < 1000; i++)
+        set_add(s, i);
+    for (int i = 0; i < 1000; i += 2)
+        if (set_delete(s, i) == ERROR)
+            ok = FALSE;
+    for (int i = 0; i < 1000; i++)
+        set_add(s, i);
+    PRINT_TEST_RESULT(ok == TRUE && set_get_size(s) == 1000);
+}
+
+void test_set_get_elements() {
+    Set *s = set_create(NULL);
+    set_add(s, 1);
+    set_add(s, 2);
+    set_add(s, 3);
+    set_delete(s, 1);
+    Id *ids = set_get_elements(s);
+    PRINT_TEST_RESULT(ids != NULL && ids[0] + ids[1] == 5);
+    free(ids);
+}
+
 void test_all() {
     test_set_init();
     test_set_destroy_inicialized();
@@ -79,6 +110,9 @@ void test_all() {
     test_set_delete_item();
     test_set_delete_to_null();
     test_set_delete_non_existing_item();
+    test_set_add_existing_item();
+    test_set_many_items();
+    test_set_get_elements();
 
     PRINT_PASSED_PERCENTAGE;
 }
@@ -128,6 +162,15 @@ int main(int argc, char **argv) {
             case 10:
                 test_set_delete_non_existing_item();
                 break;
+            case 11:
+                test_set_add_existing_item();
+                break;
+            case 12:
+                test_set_many_items();
+                break;
+            case 13:
+                test_set_get_elements();
+                break;
             default:
                 break;
         }
@@ -6,59 +6,105 @@
 #include <string.h>
 #include <strings.h>
 
+#include "../include/arena.h"
+#include "../include/dirty_list.h"
+#include "../include/id_table.h"
+#include "../include/intern.h"
 #include "../include/set.h"
 
+/* named links a space expects, its name index grows when there are more */
+#define SPACE_LINK_NAMES 2
+
+/**
+ * Text of a space, only read when the space is described or drawn.
+ * The strings are interned, so the same text is shared by all the spaces
+ */
+typedef struct _SpaceText
+{
+    const char *name;
+    const char *description;
+    const char *detailed_description;
+    const char *gdesc[3];
+} SpaceText;
+
+/**
+ * Fields used when moving around and deciding what is in a space,
+ * the text is kept apart so a space fits in two cache lines
+ */
 struct _Space
 {
     Id id;
-    char name[WORD_SIZE + 1];
-    Link *north;
-    Link *south;
-    Link *east;
-    Link *west;
-    Link *up;
-    Link *down;
-    Set *objects;
-    char gdesc[3][8];
-    char description[WORD_SIZE + 1];
-    char detailed_description[WORD_SIZE + 1];
     BOOL illuminated;
+    BOOL dirty; // changed since the game was loaded or saved
+    Link *exits[N_DIRECTIONS]; // indexed by T_Direction, shared with the space at the other end
+    Set *objects;
+    IdTable *link_names; // links by the key of their folded name, NULL until one is added
+    SpaceText *text;
+    Arena *arena; // arena the space was taken from, NULL if it was malloc'd
+    InternPool *strings; // pool its texts are interned in
+    DirtyList *changes; // list it is pushed on when it stops being clean, NULL if none
 };
 
-Space *space_create(Id id)
+/**
+ * @brief marks a space as changed, pushing it on its dirty list if it
+ * was clean
+ *
+ * @param space pointer to space
+ */
+static void space_mark_dirty(Space *space);
+
+/* names of the directions for printing, capitalized and not */
+static const char *direction_names[N_DIRECTIONS][2] = {
+    {"North", "north"},
+    {"South", "south"},
+    {"East", "east"},
+    {"West", "west"},
+    {"Up", "up"},
+    {"Down", "down"}};
+
+Space *space_create(Arena *a, InternPool *strings, Id id)
 {
     Space *newSpace = NULL;
 
-    if (id == NO_ID)
+    if (id == NO_ID || strings == NULL)
         return NULL;
 
-    newSpace = (Space *)malloc(sizeof(Space));
+    newSpace = (Space *)((a != NULL) ? arena_alloc(a, sizeof(Space)) : malloc(sizeof(Space)));
 
     if (newSpace == NULL)
     {
         return NULL;
     }
+    newSpace->text = (SpaceText *)((a != NULL) ? arena_alloc(a, sizeof(SpaceText)) : malloc(sizeof(SpaceText)));
+    if (newSpace->text == NULL)
+    {
+        if (a == NULL)
+            free(newSpace);
+        return NULL;
+    }
     newSpace->id = id;
+    newSpace->arena = a;
+    newSpace->strings = strings;
 
-    newSpace->name[0] = '\0';
+    newSpace->text->name = intern_string(strings, "");
+    newSpace->text->description = newSpace->text->name;
+    newSpace->text->detailed_description = newSpace->text->name;
 
-    newSpace->north = NULL;
-    newSpace->south = NULL;
-    newSpace->east = NULL;
-    newSpace->west = NULL;
-    newSpace->up = NULL;
-    newSpace->down = NULL;
+    for (int i = 0; i < N_DIRECTIONS; i++)
+    {
+        newSpace->exits[i] = NULL;
+    }
 
-    newSpace->objects = set_create();
-    memset(newSpace->gdesc[0], ' ', 7);
-    memset(newSpace->gdesc[1], ' ', 7);
-    memset(newSpace->gdesc[2], ' ', 7);
-    newSpace->gdesc[0][7] = '\0';
-    newSpace->gdesc[1][7] = '\0';
-    newSpace->gdesc[2][7] = '\0';
-    memset(newSpace->description, '\0', WORD_SIZE + 1);
+    newSpace->link_names = NULL;
+    newSpace->objects = set_create(a);
+    for (int i = 0; i < 3; i++)
+    {
+        newSpace->text->gdesc[i] = intern_string(strings, "       ");
+    }
 
     newSpace->illuminated = TRUE;
+    newSpace->dirty = FALSE;
+    newSpace->changes = NULL;
 
     return newSpace;
 }
@@ -70,20 +116,14 @@ STATUS space_destroy(Space **space)
         return ERROR;
     }
 
-    if ((*space)->east != NULL)
-        link_destroy(&(*space)->east);
-    if ((*space)->west != NULL)
-        link_destroy(&(*space)->west);
-    if ((*space)->north != NULL)
-        link_destroy(&(*space)->north);
-    if ((*space)->south != NULL)
-        link_destroy(&(*space)->south);
-    if ((*space)->up != NULL)
-        link_destroy(&(*space)->up);
-    if ((*space)->down != NULL)
-        link_destroy(&(*space)->down);
+    // The links belong to the game, they are shared by two spaces
     set_destroy(&(*space)->objects);
-    free(*space);
+    id_table_destroy(&(*space)->link_names);
+    if ((*space)->arena == NULL)
+    {
+        free((*space)->text);
+        free(*space);
+    }
     *space = NULL;
 
     return OK;
@@ -96,11 +136,12 @@ STATUS space_set_name(Space *space, char *name)
         return ERROR;
     }
 
-    if (!strcpy(space->name, name))
+    const char *h = intern_string(space->strings, name);
+    if (h == NULL)
     {
         return ERROR;
     }
-
+    space->text->name = h;
     return OK;
 }
 
@@ -112,11 +153,12 @@ STATUS space_set_description(Space *space, char *description)
         return ERROR;
     }
 
-    if (!strcpy(space->description, description))
+    const char *h = intern_string(space->strings, description);
+    if (h == NULL)
     {
         return ERROR;
     }
-
+    space->text->description = h;
     return OK;
 }
 
@@ -127,73 +169,107 @@ STATUS space_set_detailed_description(Space *space, char *detailed_description)
         return ERROR;
     }
 
-    if (!strcpy(space->detailed_description, detailed_description))
+    const char *h = intern_string(space->strings, detailed_description);
+    if (h == NULL)
     {
         return ERROR;
     }
-
+    space->text->detailed_description = h;
     return OK;
 }
 
 
-STATUS space_set_north(Space *space, Link *l)
+STATUS space_set_exit(Space *space, T_Direction dir, Link *l)
 {
-    if (!space || l == NULL)
+    if (!space || l == NULL || dir < 0 || dir >= N_DIRECTIONS)
     {
         return ERROR;
     }
-    space->north = l;
+    space->exits[dir] = l;
+    if (intern_length(link_get_name(l)) > 0)
+    {
+        return space_add_link(space, l);
+    }
     return OK;
 }
 
-STATUS space_set_south(Space *space, Link *l)
+STATUS space_add_link(Space *space, Link *l)
 {
-    if (!space || l == NULL)
+    if (!space || l == NULL || intern_length(link_get_name(l)) == 0)
     {
         return ERROR;
     }
-    space->south = l;
-    return OK;
+
+    if (space->link_names == NULL)
+    {
+        // The index lives where the space lives
+        space->link_names = id_table_create(space->arena, SPACE_LINK_NAMES);
+        if (space->link_names == NULL)
+        {
+            return ERROR;
+        }
+    }
+
+    Id key = intern_key(intern_fold(link_get_name(l)));
+    // The first link added with a name is the one found by it
+    if (id_table_get(space->link_names, key) != NULL)
+    {
+        return OK;
+    }
+    return id_table_put(space->link_names, key, l);
 }
 
-STATUS space_set_east(Space *space, Link *l)
+Link *space_get_exit(Space *space, T_Direction dir)
 {
-    if (!space || l == NULL)
+    if (!space || dir < 0 || dir >= N_DIRECTIONS)
     {
-        return ERROR;
+        return NULL;
     }
-    space->east = l;
-    return OK;
+    return space->exits[dir];
 }
 
-STATUS space_set_west(Space *space, Link *l)
+Link *space_get_exit_to(Space *space, Id to)
 {
-    if (!space || l == NULL)
+    if (!space)
     {
-        return ERROR;
+        return NULL;
     }
-    space->west = l;
-    return OK;
+    for (int i = 0; i < N_DIRECTIONS; i++)
+    {
+        if (space->exits[i] != NULL && link_get_destination(space->exits[i], space->id) == to)
+            return space->exits[i];
+    }
+    return NULL;
+}
+
+STATUS space_set_north(Space *space, Link *l)
+{
+    return space_set_exit(space, NORTH, l);
+}
+
+STATUS space_set_south(Space *space, Link *l)
+{
+    return space_set_exit(space, SOUTH, l);
+}
+
+STATUS space_set_east(Space *space, Link *l)
+{
+    return space_set_exit(space, EAST, l);
+}
+
+STATUS space_set_west(Space *space, Link *l)
+{
+    return space_set_exit(space, WEST, l);
 }
 
 STATUS space_set_up(Space *space, Link *l)
 {
-    if (!space || l == NULL)
-    {
-        return ERROR;
-    }
-    space->up = l;
-    return OK;
+    return space_set_exit(space, UP, l);
 }
 
 STATUS space_set_down(Space *space, Link *l)
 {
-    if (!space || l == NULL)
-    {
-        return ERROR;
-    }
-    space->down = l;
-    return OK;
+    return space_set_exit(space, DOWN, l);
 }
 
 STATUS space_add_object(Space *space, Id id)
@@ -202,22 +278,24 @@ STATUS space_add_object(Space *space, Id id)
     {
         return ERROR;
     }
-    set_add(space->objects, id);
+    if (set_add(space->objects, id) == OK)
+        space_mark_dirty(space);
     return OK;
 }
 
 STATUS space_set_gdesc(Space *space, int line, char *name)
 {
-    if (!space || !name || line > 2)
+    if (!space || !name || line < 0 || line > 2 || strlen(name) > 7)
     {
         return ERROR;
     }
 
-    if (!strcpy(space->gdesc[line], name))
+    const char *h = intern_string(space->strings, name);
+    if (h == NULL)
     {
         return ERROR;
     }
-
+    space->text->gdesc[line] = h;
     return OK;
 }
 
@@ -227,7 +305,7 @@ const char *space_get_name(Space *space)
     {
         return NULL;
     }
-    return space->name;
+    return space->text->name;
 }
 
 Id space_get_id(Space *space)
@@ -241,56 +319,32 @@ Id space_get_id(Space *space)
 
 Link *space_get_north(Space *space)
 {
-    if (!space)
-    {
-        return NULL;
-    }
-    return space->north;
+    return space_get_exit(space, NORTH);
 }
 
 Link *space_get_south(Space *space)
 {
-    if (!space)
-    {
-        return NULL;
-    }
-    return space->south;
+    return space_get_exit(space, SOUTH);
 }
 
 Link *space_get_east(Space *space)
 {
-    if (!space)
-    {
-        return NULL;
-    }
-    return space->east;
+    return space_get_exit(space, EAST);
 }
 
 Link *space_get_west(Space *space)
 {
-    if (!space)
-    {
-        return NULL;
-    }
-    return space->west;
+    return space_get_exit(space, WEST);
 }
 
 Link *space_get_up(Space *space)
 {
-    if (!space)
-    {
-        return NULL;
-    }
-    return space->up;
+    return space_get_exit(space, UP);
 }
 
 Link *space_get_down(Space *space)
 {
-    if (!space)
-    {
-        return NULL;
-    }
-    return space->down;
+    return space_get_exit(space, DOWN);
 }
 
 STATUS space_remove_object(Space *space, Id id)
@@ -299,16 +353,19 @@ STATUS space_remove_object(Space *space, Id id)
     {
         return ERROR;
     }
-    return set_delete(space->objects, id);
+    if (set_delete(space->objects, id) == ERROR)
+        return ERROR;
+    space_mark_dirty(space);
+    return OK;
 }
 
-char *space_get_gdesc(Space *space, int line)
+const char *space_get_gdesc(Space *space, int line)
 {
     if (!space)
     {
         return NULL;
     }
-    return space->gdesc[line];
+    return space->text->gdesc[line];
 }
 
 Id *space_get_objects(Space *s)
@@ -316,6 +373,17 @@ Id *space_get_objects(Space *s)
     return s != NULL ? set_get_elements(s->objects) : NULL;
 }
 
+const Id *space_objects_view(Space *s, int *count)
+{
+    if (s == NULL)
+    {
+        if (count != NULL)
+            *count = 0;
+        return NULL;
+    }
+    return set_iter(s->objects, count);
+}
+
 int space_objects_count(Space *s)
 {
     return set_get_size(s->objects);
@@ -328,90 +396,85 @@ STATUS space_set_illumination(Space *space, BOOL illumination)
     {
         return ERROR;
     }
+    if (space->illuminated != illumination)
+        space_mark_dirty(space);
     space->illuminated = illumination;
 
     return OK;
 }
 
-BOOL space_get_illumination(Space *space)
+BOOL space_get_dirty(Space *space)
 {
-
     if (!space)
         return FALSE;
 
-    return space->illuminated;
+    return space->dirty;
 }
 
-STATUS space_print(Space *space)
+STATUS space_set_dirty(Space *space, BOOL dirty)
 {
-    Id idaux = NO_ID;
-    BOOL illumination;
-
     if (!space)
     {
         return ERROR;
     }
+    if (dirty == TRUE)
+        space_mark_dirty(space);
+    else
+        space->dirty = FALSE;
 
-    fprintf(stdout, "--> Space (Id: %ld; Name: %s)\n", space->id, space->name);
+    return OK;
+}
 
-    idaux = link_get_second_space(space_get_north(space));
-    if (NO_ID != idaux)
-    {
-        fprintf(stdout, "---> North link: %ld.\n", idaux);
-    }
-    else
+STATUS space_set_dirty_list(Space *space, DirtyList *changes)
+{
+    if (!space)
     {
-        fprintf(stdout, "---> No north link.\n");
+        return ERROR;
     }
+    space->changes = changes;
 
-    idaux = link_get_second_space(space_get_south(space));
-    if (NO_ID != idaux)
-    {
-        fprintf(stdout, "---> South link: %ld.\n", idaux);
-    }
-    else
-    {
-        fprintf(stdout, "---> No south link.\n");
-    }
+    return OK;
+}
 
-    idaux = link_get_second_space(space_get_east(space));
-    if (NO_ID != idaux)
-    {
-        fprintf(stdout, "---> East link: %ld.\n", idaux);
-    }
-    else
-    {
-        fprintf(stdout, "---> No east link.\n");
-    }
+static void space_mark_dirty(Space *space)
+{
+    if (space->dirty == FALSE && space->changes != NULL)
+        dirty_list_push(space->changes, DIRTY_SPACE, space->id, NO_ID, NO_ID);
+    space->dirty = TRUE;
+}
 
-    idaux = link_get_second_space(space_get_west(space));
-    if (NO_ID != idaux)
-    {
-        fprintf(stdout, "---> West link: %ld.\n", idaux);
-    }
-    else
-    {
-        fprintf(stdout, "---> No west link.\n");
-    }
+BOOL space_get_illumination(Space *space)
+{
 
-    idaux = link_get_second_space(space_get_up(space));
-    if (NO_ID != idaux)
-    {
-        fprintf(stdout, "---> Up link: %ld.\n", idaux);
-    }
-    else
-    {
-        fprintf(stdout, "---> No up link.\n");
-    }
+    if (!space)
+        return FALSE;
+
+    return space->illuminated;
+}
 
-    idaux = link_get_second_space(space_get_down(space));
-    if (NO_ID != idaux)
+STATUS space_print(Space *space)
+{
+    Id idaux = NO_ID;
+    BOOL illumination;
+
+    if (!space)
     {
-        fprintf(stdout, "---> Down link: %ld.\n", idaux);
+        return ERROR;
     }
-    else
+
+    fprintf(stdout, "--> Space (Id: %ld; Name: %s)\n", space->id, space_get_name(space));
+
+    for (int i = 0; i < N_DIRECTIONS; i++)
     {
-        fprintf(stdout, "---> No down link.\n");
+        idaux = link_get_destination(space->exits[i], space->id);
+        if (NO_ID != idaux)
+        {
+            fprintf(stdout, "---> %s link: %ld.\n", direction_names[i][0], idaux);
+        }
+        else
+        {
+            fprintf(stdout, "---> No %s link.\n", direction_names[i][1]);
+        }
     }
 
     illumination = space_get_illumination(space);
@@ -429,18 +492,11 @@ STATUS space_print(Space *space)
 
 BOOL space_hasObject(Space *space, Id id)
 {
-    Id *objects = space_get_objects(space);
-
-    for (int i = 0; i < space_objects_count(space); i++)
+    if (!space)
     {
-        if (objects[i] == id)
-        {
-            free(objects);
-            return TRUE;
-        }
+        return FALSE;
     }
-    free(objects);
-    return FALSE;
+    return set_element_exists(space->objects, id);
 }
 
 const char *space_get_description(Space *space)
@@ -449,7 +505,7 @@ const char *space_get_description(Space *space)
     {
         return NULL;
     }
-    return space->description;
+    return space->text->description;
 }
 
 const char *space_get_detailed_description(Space *space)
@@ -458,35 +514,19 @@ const char *space_get_detailed_description(Space *space)
     {
         return NULL;
     }
-    return space->detailed_description;
+    return space->text->detailed_description;
 }
 
 Link* space_get_link_by_name(Space* s, char* name) {
-    if(s->north != NULL)
-	    if (strcasecmp(link_get_name(s->north), name) == 0)
-		    return s->north;
-	
-    if(s->east != NULL)
-	    if (strcasecmp(link_get_name(s->east), name) == 0)
-		    return s->east;
-
-    if(s->south != NULL)
-	    if (strcasecmp(link_get_name(s->south), name) == 0)
-		    return s->south;
-
-    if(s->west != NULL)
-	    if (strcasecmp(link_get_name(s->west), name) == 0)
-		    return s->west;
+    if (s == NULL || name == NULL || s->link_names == NULL)
+        return NULL;
 
-    if(s->up != NULL)
-	    if (strcasecmp(link_get_name(s->up), name) == 0)
-		    return s->up;
-	
-    if(s->down != NULL)
-	    if (strcasecmp(link_get_name(s->down), name) == 0)
-		    return s->down;
+    // Names are compared ignoring case through their folded handles
+    const char *folded = intern_find_folded(s->strings, name);
+    if (folded == NULL)
+        return NULL;
 
-	return NULL;
+    return (Link *)id_table_get(s->link_names, intern_key(folded));
 }
 
 STATUS space_save(FILE *fp, Space *s)
@@ -494,20 +534,13 @@ STATUS space_save(FILE *fp, Space *s)
     if (s == NULL || fp == NULL)
         return ERROR;
 
-    //#s:1|Tile 1|-1|-1|2|-1
-    Link *l = space_get_north(s);
-    link_save(fp, l);
-    Id north = link_get_first_space(l) == s->id ? link_get_second_space(l) : link_get_first_space(l);
-    l = space_get_south(s);
-    link_save(fp, l);
-    Id south = link_get_first_space(l) == s->id ? link_get_second_space(l) : link_get_first_space(l);
-    l = space_get_east(s);
-    link_save(fp, l);
-    Id east = link_get_first_space(l) == s->id ? link_get_second_space(l) : link_get_first_space(l);
-    l = space_get_west(s);
-    link_save(fp, l);
-    Id west = link_get_first_space(l) == s->id ? link_get_second_space(l) : link_get_first_space(l);
-    fprintf(fp, "#s:%ld|%s|%ld|%ld|%ld|%ld|%s|%s|%s\n", s->id, s->name, north, east, south, west, s->gdesc[0], s->gdesc[1], s->gdesc[2]);
+    //#s:id|name|description|detailed|north|east|south|west|up|down|illuminated|gdesc|gdesc|gdesc
+    // The links are shared by two spaces, the game saves each one once
+    fprintf(fp, "#s:%ld|%s|%s|%s|%ld|%ld|%ld|%ld|%ld|%ld|%d|%s|%s|%s\n", s->id, s->text->name, s->text->description, s->text->detailed_description,
+            link_get_destination(s->exits[NORTH], s->id), link_get_destination(s->exits[EAST], s->id),
+            link_get_destination(s->exits[SOUTH], s->id), link_get_destination(s->exits[WEST], s->id),
+            link_get_destination(s->exits[UP], s->id), link_get_destination(s->exits[DOWN], s->id),
+            s->illuminated == TRUE ? 1 : 0, s->text->gdesc[0], s->text->gdesc[1], s->text->gdesc[2]);
 
     return OK;
 }
\ No newline at end of file
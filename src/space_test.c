@@ -18,7 +18,9 @@
 #include "../include/space.h"
 #include "../include/test.h"
 
-#define MAX_TESTS 28
+static InternPool *strings = NULL; //Pool the tested entities intern their texts in
+
+#define MAX_TESTS 40
 
 /** 
  * @brief Main function for SPACE unit tests. 
@@ -30,6 +32,7 @@
  *  
  */
 int main(int argc, char **argv) {
+    strings = intern_create();
     int test = 0;
     bool all = true;
 
@@ -73,26 +76,47 @@ int main(int argc, char **argv) {
     if (all || test == 26) test2_space_get_west();
     if (all || test == 27) test1_space_get_id();
     if (all || test == 28) test2_space_get_id();
+    if (all || test == 29) test3_space_get_name();
+    if (all || test == 30) test1_space_get_description();
+    if (all || test == 31) test2_space_get_description();
+    if (all || test == 32) test1_space_get_exit();
+    if (all || test == 33) test1_space_get_exit_to();
+    if (all || test == 34) test2_space_get_exit_to();
+    if (all || test == 35) test1_space_add_link();
+    if (all || test == 36) test2_space_add_link();
+    if (all || test == 37) test1_space_get_link_by_name();
+    if (all || test == 38) test1_space_get_dirty();
+    if (all || test == 39) test2_space_get_dirty();
+    if (all || test == 40) test3_space_create();
 
     PRINT_PASSED_PERCENTAGE;
 
+    intern_destroy(&strings);
     return 0;
 }
 
 void test1_space_create() {
-    int result = space_create(5) != NULL;
+    int result = space_create(NULL, strings, 5) != NULL;
     PRINT_TEST_RESULT(result);
 }
 
 void test2_space_create() {
     Space *s;
-    s = space_create(4);
+    s = space_create(NULL, strings, 4);
     PRINT_TEST_RESULT(space_get_id(s) == 4);
 }
 
+void test3_space_create() {
+    Arena *a = arena_create(1024);
+    Space *s = space_create(a, strings, 4);
+    PRINT_TEST_RESULT(s != NULL && arena_owns(a, s) == TRUE);
+    space_destroy(&s);
+    arena_destroy(&a);
+}
+
 void test1_space_set_name() {
     Space *s;
-    s = space_create(5);
+    s = space_create(NULL, strings, 5);
     PRINT_TEST_RESULT(space_set_name(s, "hola") == OK);
 }
 
@@ -103,65 +127,65 @@ void test2_space_set_name() {
 
 void test3_space_set_name() {
     Space *s;
-    s = space_create(5);
+    s = space_create(NULL, strings, 5);
     PRINT_TEST_RESULT(space_set_name(s, NULL) == ERROR);
 }
 
 void test1_space_set_north() {
     Space *s;
-	Link* l = link_create();
-    s = space_create(5);
+	Link* l = link_create(NULL, strings);
+    s = space_create(NULL, strings, 5);
     PRINT_TEST_RESULT(space_set_north(s, l) == OK);
 }
 
 void test2_space_set_north() {
     Space *s = NULL;
-	Link* l = link_create();
+	Link* l = link_create(NULL, strings);
     PRINT_TEST_RESULT(space_set_north(s, l) == ERROR);
 }
 
 void test1_space_set_south() {
     Space *s;
-	Link* l = link_create();
-    s = space_create(5);
+	Link* l = link_create(NULL, strings);
+    s = space_create(NULL, strings, 5);
     PRINT_TEST_RESULT(space_set_south(s, l) == OK);
 }
 
 void test2_space_set_south() {
     Space *s = NULL;
-	Link* l = link_create();
+	Link* l = link_create(NULL, strings);
     PRINT_TEST_RESULT(space_set_south(s, l) == ERROR);
 }
 
 void test1_space_set_east() {
     Space *s;
-	Link* l = link_create();
-    s = space_create(5);
+	Link* l = link_create(NULL, strings);
+    s = space_create(NULL, strings, 5);
     PRINT_TEST_RESULT(space_set_east(s, l) == OK);
 }
 
 void test2_space_set_east() {
     Space *s = NULL;
-	Link* l = link_create();
+	Link* l = link_create(NULL, strings);
     PRINT_TEST_RESULT(space_set_east(s, l) == ERROR);
 }
 
 void test1_space_set_west() {
     Space *s;
-	Link* l = link_create();
-    s = space_create(5);
+	Link* l = link_create(NULL, strings);
+    s = space_create(NULL, strings, 5);
     PRINT_TEST_RESULT(space_set_west(s, l) == OK);
 }
 
 void test2_space_set_west() {
     Space *s = NULL;
-	Link* l = link_create();
+	Link* l = link_create(NULL, strings);
     PRINT_TEST_RESULT(space_set_west(s, l) == ERROR);
 }
 
 void test1_space_set_object() {
     Space *s;
-    s = space_create(1);
+    s = space_create(NULL, strings, 1);
     PRINT_TEST_RESULT(space_add_object(s, 1) == OK);
 }
 
@@ -172,7 +196,7 @@ void test2_space_set_object() {
 
 void test1_space_get_name() {
     Space *s;
-    s = space_create(1);
+    s = space_create(NULL, strings, 1);
     space_set_name(s, "adios");
     PRINT_TEST_RESULT(strcmp(space_get_name(s), "adios") == 0);
 }
@@ -184,13 +208,13 @@ void test2_space_get_name() {
 
 void test1_space_get_object() {
     Space *s;
-    s = space_create(1);
+    s = space_create(NULL, strings, 1);
     PRINT_TEST_RESULT(space_get_objects(s) == FALSE);
 }
 
 void test2_space_get_object() {
     Space *s;
-    s = space_create(1);
+    s = space_create(NULL, strings, 1);
     space_add_object(s, 1);
     PRINT_TEST_RESULT(space_get_objects(s) != NULL);
 }
@@ -202,8 +226,8 @@ void test3_space_get_object() {
 
 void test1_space_get_north() {
     Space *s;
-	s = space_create(5);
-	Link* l = link_create();
+	s = space_create(NULL, strings, 5);
+	Link* l = link_create(NULL, strings);
 	link_set_id(l, 1);
     space_set_north(s, l);
     PRINT_TEST_RESULT(link_get_id(space_get_north(s)) == 1);
@@ -216,8 +240,8 @@ void test2_space_get_north() {
 
 void test1_space_get_south() {
     Space *s;
-	s = space_create(5);
-	Link* l = link_create();
+	s = space_create(NULL, strings, 5);
+	Link* l = link_create(NULL, strings);
 	link_set_id(l, 1);
     space_set_south(s, l);
     PRINT_TEST_RESULT(link_get_id(space_get_south(s)) == 1);
@@ -230,8 +254,8 @@ void test2_space_get_south() {
 
 void test1_space_get_east() {
     Space *s;
-	s = space_create(5);
-	Link* l = link_create();
+	s = space_create(NULL, strings, 5);
+	Link* l = link_create(NULL, strings);
 	link_set_id(l, 1);
     space_set_east(s, l);
     PRINT_TEST_RESULT(link_get_id(space_get_east(s)) == 1);
@@ -244,8 +268,8 @@ void test2_space_get_east() {
 
 void test1_space_get_west() {
     Space *s;
-	s = space_create(5);
-	Link* l = link_create();
+	s = space_create(NULL, strings, 5);
+	Link* l = link_create(NULL, strings);
 	link_set_id(l, 1);
     space_set_west(s, l);
     PRINT_TEST_RESULT(link_get_id(space_get_west(s)) == 1);
@@ -258,7 +282,7 @@ void test2_space_get_west() {
 
 void test1_space_get_id() {
     Space *s;
-    s = space_create(25);
+    s = space_create(NULL, strings, 25);
     PRINT_TEST_RESULT(space_get_id(s) == 25);
 }
 
@@ -266,3 +290,99 @@ void test2_space_get_id() {
     Space *s = NULL;
     PRINT_TEST_RESULT(space_get_id(s) == NO_ID);
 }
+
+void test3_space_get_name() {
+    Space *s;
+    s = space_create(NULL, strings, 1);
+    space_set_name(s, "hola");
+    space_set_name(s, "adios");
+    PRINT_TEST_RESULT(strcmp(space_get_name(s), "adios") == 0);
+}
+
+void test1_space_get_description() {
+    Space *s;
+    s = space_create(NULL, strings, 1);
+    PRINT_TEST_RESULT(strcmp(space_get_description(s), "") == 0);
+}
+
+void test2_space_get_description() {
+    Space *s;
+    char long_description[3000];
+    memset(long_description, 'a', 2999);
+    long_description[2999] = '\0';
+    s = space_create(NULL, strings, 1);
+    space_set_description(s, long_description);
+    PRINT_TEST_RESULT(strcmp(space_get_description(s), long_description) == 0);
+}
+
+void test1_space_get_exit() {
+    Space *s = space_create(NULL, strings, 1);
+    Link *l = link_create(NULL, strings);
+    space_set_exit(s, UP, l);
+    PRINT_TEST_RESULT(space_get_exit(s, UP) == l && space_get_up(s) == l && space_get_exit(s, DOWN) == NULL);
+}
+
+void test1_space_get_exit_to() {
+    Space *s = space_create(NULL, strings, 2);
+    Link *l = link_create(NULL, strings);
+    link_set_first_space(l, 1);
+    link_set_second_space(l, 2);
+    space_set_exit(s, WEST, l);
+    PRINT_TEST_RESULT(space_get_exit_to(s, 1) == l);
+}
+
+void test2_space_get_exit_to() {
+    Space *s = space_create(NULL, strings, 2);
+    PRINT_TEST_RESULT(space_get_exit_to(s, 1) == NULL);
+}
+
+void test1_space_add_link() {
+    Space *s = space_create(NULL, strings, 1);
+    Link *l = link_create(NULL, strings);
+    PRINT_TEST_RESULT(space_add_link(s, l) == ERROR);
+}
+
+void test2_space_add_link() {
+    Space *s = space_create(NULL, strings, 1);
+    char name[10];
+    Link *l[10];
+    BOOL ok = TRUE;
+    for (int i = 0; i < 10; i++) {
+        sprintf(name, "Vent%d", i);
+        l[i] = link_create(NULL, strings);
+        link_set_name(l[i], name);
+        space_add_link(s, l[i]);
+    }
+    for (int i = 0; i < 10; i++) {
+        sprintf(name, "VENT%d", i);
+        if (space_get_link_by_name(s, name) != l[i])
+            ok = FALSE;
+    }
+    PRINT_TEST_RESULT(ok == TRUE);
+}
+
+void test1_space_get_link_by_name() {
+    Space *s = space_create(NULL, strings, 1);
+    Link *l = link_create(NULL, strings);
+    link_set_name(l, "Hatch");
+    space_set_exit(s, DOWN, l);
+    PRINT_TEST_RESULT(space_get_link_by_name(s, "hatch") == l && space_get_link_by_name(s, "Door") == NULL);
+}
+
+void test1_space_get_dirty() {
+    Space *s = space_create(NULL, strings, 1);
+    BOOL created = space_get_dirty(s);
+    space_set_illumination(s, FALSE);
+    PRINT_TEST_RESULT(created == FALSE && space_get_dirty(s) == TRUE);
+}
+
+void test2_space_get_dirty() {
+    Space *s = space_create(NULL, strings, 1);
+    space_add_object(s, 3);
+    space_set_dirty(s, FALSE);
+    // Lighting a lit space changes nothing, taking an object does
+    space_set_illumination(s, TRUE);
+    BOOL same = space_get_dirty(s);
+    space_remove_object(s, 3);
+    PRINT_TEST_RESULT(same == FALSE && space_get_dirty(s) == TRUE && space_get_dirty(NULL) == FALSE);
+}
@@ -0,0 +1,262 @@
+/**
+ * @brief It implements the timers of a game. The timers live in a growable
+ * array and each slot of the wheel is a list of them linked by position,
+ * so a timer is taken out of its slot without looking for it. A handle
+ * holds the position of its timer and the number of times that position
+ * was used, which tells an old handle from the one of the timer now there
+ *
+ * @file timer_wheel.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/timer_wheel.h"
+
+#include <stdlib.h>
+
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_LEVELS 4
+/* end of a list of timers and slot of a timer that is free */
+#define WHEEL_NONE -1
+
+typedef struct {
+    int next;               // in the slot, or in the free list
+    int prev;
+    int slot;               // WHEEL_NONE if the timer is free
+    uint32_t generation;    // times the position was given to a timer
+    long expires;           // turn it is due in
+    long period;
+    timer_fn fn;
+    void *context;
+    Id target;
+    int event;
+} Timer;
+
+struct _TimerWheel {
+    Timer *timers;
+    int n_timers;           // scheduled
+    int capacity;
+    int free;               // first free position, WHEEL_NONE if all are used
+    long turn;
+    int slots[WHEEL_LEVELS * WHEEL_SLOTS];  // first timer of each slot
+};
+
+/**
+ * @brief position of the timer of a handle
+ *
+ * @param w pointer to TimerWheel
+ * @param id handle
+ * @return the position, WHEEL_NONE if the handle is not of a timer scheduled
+ */
+static int timer_wheel_find(TimerWheel *w, TimerId id);
+
+/**
+ * @brief puts a timer in the slot of the turn it is due in
+ *
+ * @param w pointer to TimerWheel
+ * @param i position of the timer
+ */
+static void timer_wheel_link(TimerWheel *w, int i);
+
+/**
+ * @brief takes a timer out of its slot
+ *
+ * @param w pointer to TimerWheel
+ * @param i position of the timer
+ */
+static void timer_wheel_unlink(TimerWheel *w, int i);
+
+/**
+ * @brief gives the position of a timer back to the free list
+ *
+ * @param w pointer to TimerWheel
+ * @param i position of the timer, out of any slot
+ */
+static void timer_wheel_release(TimerWheel *w, int i);
+
+TimerWheel *timer_wheel_create()
+{
+    TimerWheel *w = calloc(1, sizeof(TimerWheel));
+    if (w == NULL)
+        return NULL;
+
+    w->free = WHEEL_NONE;
+    for (int i = 0; i < WHEEL_LEVELS * WHEEL_SLOTS; i++)
+        w->slots[i] = WHEEL_NONE;
+    return w;
+}
+
+STATUS timer_wheel_destroy(TimerWheel **w)
+{
+    if (w == NULL || *w == NULL)
+        return ERROR;
+
+    free((*w)->timers);
+    free(*w);
+    *w = NULL;
+    return OK;
+}
+
+static int timer_wheel_find(TimerWheel *w, TimerId id)
+{
+    int i = (int)(uint32_t)id - 1;
+
+    if (i < 0 || i >= w->capacity || w->timers[i].slot == WHEEL_NONE || w->timers[i].generation != (uint32_t)(id >> 32))
+        return WHEEL_NONE;
+    return i;
+}
+
+static void timer_wheel_link(TimerWheel *w, int i)
+{
+    Timer *t = &w->timers[i];
+    long delta = t->expires - w->turn;
+    int level = 0;
+
+    // The lowest level whose slots reach the turn it is due in
+    while (level < WHEEL_LEVELS - 1 && delta >= (1L << (WHEEL_BITS * (level + 1))))
+        level++;
+    t->slot = level * WHEEL_SLOTS + (int)((t->expires >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1));
+    t->prev = WHEEL_NONE;
+    t->next = w->slots[t->slot];
+    if (t->next != WHEEL_NONE)
+        w->timers[t->next].prev = i;
+    w->slots[t->slot] = i;
+}
+
+static void timer_wheel_unlink(TimerWheel *w, int i)
+{
+    Timer *t = &w->timers[i];
+
+    if (t->prev != WHEEL_NONE)
+        w->timers[t->prev].next = t->next;
+    else
+        w->slots[t->slot] = t->next;
+    if (t->next != WHEEL_NONE)
+        w->timers[t->next].prev = t->prev;
+}
+
+static void timer_wheel_release(TimerWheel *w, int i)
+{
+    Timer *t = &w->timers[i];
+
+    t->slot = WHEEL_NONE;
+    t->generation++;
+    t->next = w->free;
+    w->free = i;
+    w->n_timers--;
+}
+
+TimerId timer_wheel_schedule(TimerWheel *w, long delay, long period, timer_fn fn, void *context, Id target, int event)
+{
+    if (w == NULL || fn == NULL || delay < 0 || period < 0)
+        return NO_TIMER;
+
+    if (w->free == WHEEL_NONE)
+    {
+        int capacity = (w->capacity > 0) ? 2 * w->capacity : 16;
+        Timer *timers = realloc(w->timers, sizeof(Timer) * capacity);
+        if (timers == NULL)
+            return NO_TIMER;
+        // The new positions go to the free list, the first one at its head
+        for (int i = capacity - 1; i >= w->capacity; i--)
+        {
+            timers[i].slot = WHEEL_NONE;
+            timers[i].generation = 0;
+            timers[i].next = w->free;
+            w->free = i;
+        }
+        w->timers = timers;
+        w->capacity = capacity;
+    }
+
+    int i = w->free;
+    Timer *t = &w->timers[i];
+    w->free = t->next;
+    w->n_timers++;
+    t->expires = w->turn + ((delay < 1) ? 1 : (delay > TIMER_MAX_DELAY) ? TIMER_MAX_DELAY : delay);
+    t->period = (period > TIMER_MAX_DELAY) ? TIMER_MAX_DELAY : period;
+    t->fn = fn;
+    t->context = context;
+    t->target = target;
+    t->event = event;
+    timer_wheel_link(w, i);
+    return ((TimerId)t->generation << 32) | (uint32_t)(i + 1);
+}
+
+STATUS timer_wheel_cancel(TimerWheel *w, TimerId id)
+{
+    if (w == NULL)
+        return ERROR;
+
+    int i = timer_wheel_find(w, id);
+    if (i == WHEEL_NONE)
+        return ERROR;
+    timer_wheel_unlink(w, i);
+    timer_wheel_release(w, i);
+    return OK;
+}
+
+BOOL timer_wheel_pending(TimerWheel *w, TimerId id)
+{
+    if (w == NULL)
+        return FALSE;
+    return (timer_wheel_find(w, id) != WHEEL_NONE) ? TRUE : FALSE;
+}
+
+int timer_wheel_advance(TimerWheel *w)
+{
+    int fired = 0;
+
+    if (w == NULL)
+        return -1;
+
+    w->turn++;
+    // A level comes round to its next slot when the one below wraps, its
+    // timers are due before the level above it comes round again
+    for (int level = 1; level < WHEEL_LEVELS && (w->turn & ((1L << (WHEEL_BITS * level)) - 1)) == 0; level++)
+    {
+        int *slot = &w->slots[level * WHEEL_SLOTS + (int)((w->turn >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1))];
+        int i = *slot;
+        *slot = WHEEL_NONE;
+        while (i != WHEEL_NONE)
+        {
+            int next = w->timers[i].next;
+            timer_wheel_link(w, i);
+            i = next;
+        }
+    }
+
+    int *due = &w->slots[(int)(w->turn & (WHEEL_SLOTS - 1))];
+    while (*due != WHEEL_NONE)
+    {
+        int i = *due;
+        // Copied, fn may schedule timers and move the array
+        Timer t = w->timers[i];
+
+        timer_wheel_unlink(w, i);
+        if (t.period > 0)
+        {
+            // Never back in the slot being emptied, the period is at least a turn
+            w->timers[i].expires = w->turn + t.period;
+            timer_wheel_link(w, i);
+        }
+        else
+            timer_wheel_release(w, i);
+        t.fn(t.context, t.target, t.event);
+        fired++;
+    }
+    return fired;
+}
+
+long timer_wheel_get_turn(TimerWheel *w)
+{
+    return (w != NULL) ? w->turn : -1;
+}
+
+int timer_wheel_count(TimerWheel *w)
+{
+    return (w != NULL) ? w->n_timers : -1;
+}
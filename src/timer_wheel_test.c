@@ -0,0 +1,236 @@
+/**
+ * @brief It tests the timer wheel module
+ *
+ * @file timer_wheel_test.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/timer_wheel.h"
+#include "../include/test.h"
+#include "../include/types.h"
+
+#define TEST_TIMERS 5000
+
+/* what the timers of a test did */
+typedef struct {
+    int calls;
+    long last_turn;     // turn of the last call
+    Id last_target;
+    int last_event;
+    TimerWheel* wheel;  // set to cancel from a call
+    TimerId cancel;
+    BOOL late;          // a timer was called in another turn than its event said
+} Calls;
+
+/**
+ * @brief counts the calls, a timer function
+ */
+static void count(void* context, Id target, int event) {
+    Calls* c = context;
+
+    c->calls++;
+    c->last_turn = timer_wheel_get_turn(c->wheel);
+    c->last_target = target;
+    c->last_event = event;
+    if (event >= 0 && c->last_turn != event)
+        c->late = TRUE;
+}
+
+/**
+ * @brief counts the call and cancels a timer, a timer function
+ */
+static void count_cancel(void* context, Id target, int event) {
+    Calls* c = context;
+
+    count(context, target, event);
+    timer_wheel_cancel(c->wheel, c->cancel);
+}
+
+void test_timer_wheel_create() {
+    TimerWheel* w = timer_wheel_create();
+    PRINT_TEST_RESULT(w != NULL && timer_wheel_count(w) == 0 && timer_wheel_get_turn(w) == 0);
+    timer_wheel_destroy(&w);
+}
+
+void test_timer_wheel_destroy_null() {
+    TimerWheel* w = NULL;
+    PRINT_TEST_RESULT(timer_wheel_destroy(&w) == ERROR);
+}
+
+void test_timer_wheel_schedule() {
+    TimerWheel* w = timer_wheel_create();
+    Calls c = {0, 0, NO_ID, 0, w, NO_TIMER, FALSE};
+    TimerId id = timer_wheel_schedule(w, 3, 0, count, &c, 12, -1);
+    int before = 0;
+
+    before += timer_wheel_advance(w);
+    before += timer_wheel_advance(w);
+    PRINT_TEST_RESULT(id != NO_TIMER && before == 0 && timer_wheel_advance(w) == 1 && c.calls == 1 && c.last_turn == 3 &&
+                      c.last_target == 12 && timer_wheel_pending(w, id) == FALSE && timer_wheel_count(w) == 0);
+    timer_wheel_destroy(&w);
+}
+
+void test_timer_wheel_cancel() {
+    TimerWheel* w = timer_wheel_create();
+    Calls c = {0, 0, NO_ID, 0, w, NO_TIMER, FALSE};
+    TimerId id = timer_wheel_schedule(w, 2, 0, count, &c, 1, -1);
+    BOOL cancelled = timer_wheel_cancel(w, id) == OK;
+
+    for (int i = 0; i < 5; i++)
+        timer_wheel_advance(w);
+    // A handle is not of any timer once it is cancelled
+    PRINT_TEST_RESULT(cancelled == TRUE && c.calls == 0 && timer_wheel_cancel(w, id) == ERROR && timer_wheel_count(w) == 0);
+    timer_wheel_destroy(&w);
+}
+
+void test_timer_wheel_old_handle() {
+    TimerWheel* w = timer_wheel_create();
+    Calls c = {0, 0, NO_ID, 0, w, NO_TIMER, FALSE};
+    TimerId old = timer_wheel_schedule(w, 2, 0, count, &c, 1, -1);
+    TimerId now;
+
+    timer_wheel_cancel(w, old);
+    // The new timer takes the position of the old one
+    now = timer_wheel_schedule(w, 2, 0, count, &c, 2, -1);
+    PRINT_TEST_RESULT(now != old && timer_wheel_cancel(w, old) == ERROR && timer_wheel_pending(w, now) == TRUE);
+    timer_wheel_destroy(&w);
+}
+
+void test_timer_wheel_period() {
+    TimerWheel* w = timer_wheel_create();
+    Calls c = {0, 0, NO_ID, 0, w, NO_TIMER, FALSE};
+    TimerId id = timer_wheel_schedule(w, 10, 10, count, &c, 1, -1);
+
+    for (int i = 0; i < 100; i++)
+        timer_wheel_advance(w);
+    PRINT_TEST_RESULT(c.calls == 10 && c.last_turn == 100 && timer_wheel_pending(w, id) == TRUE);
+    timer_wheel_destroy(&w);
+}
+
+void test_timer_wheel_far() {
+    TimerWheel* w = timer_wheel_create();
+    Calls c = {0, 0, NO_ID, 0, w, NO_TIMER, FALSE};
+    long delays[] = {63, 64, 65, 4095, 4096, 4097, 300000};
+
+    // Through every level of the wheel, each called in its own turn
+    for (int i = 0; i < 7; i++)
+        timer_wheel_schedule(w, delays[i], 0, count, &c, i, (int)delays[i]);
+    for (long i = 0; i < 300001; i++)
+        timer_wheel_advance(w);
+    PRINT_TEST_RESULT(c.calls == 7 && c.late == FALSE && timer_wheel_count(w) == 0);
+    timer_wheel_destroy(&w);
+}
+
+void test_timer_wheel_many() {
+    TimerWheel* w = timer_wheel_create();
+    Calls c = {0, 0, NO_ID, 0, w, NO_TIMER, FALSE};
+    TimerId* ids = malloc(sizeof(TimerId) * TEST_TIMERS);
+
+    for (int i = 0; i < TEST_TIMERS; i++)
+        ids[i] = timer_wheel_schedule(w, i + 1, 0, count, &c, i, i + 1);
+    // Half of them never happen
+    for (int i = 0; i < TEST_TIMERS; i += 2)
+        timer_wheel_cancel(w, ids[i]);
+    for (int i = 0; i < TEST_TIMERS; i++)
+        timer_wheel_advance(w);
+    PRINT_TEST_RESULT(c.calls == TEST_TIMERS / 2 && c.late == FALSE && timer_wheel_count(w) == 0);
+    free(ids);
+    timer_wheel_destroy(&w);
+}
+
+void test_timer_wheel_cancel_from_call() {
+    TimerWheel* w = timer_wheel_create();
+    Calls ca = {0, 0, NO_ID, 0, w, NO_TIMER, FALSE};
+    Calls cb = {0, 0, NO_ID, 0, w, NO_TIMER, FALSE};
+
+    // Both are due in the same turn, the first one called cancels the other
+    TimerId a = timer_wheel_schedule(w, 5, 0, count_cancel, &ca, 1, -1);
+    TimerId b = timer_wheel_schedule(w, 5, 0, count_cancel, &cb, 2, -1);
+    ca.cancel = b;
+    cb.cancel = a;
+    for (int i = 0; i < 5; i++)
+        timer_wheel_advance(w);
+    PRINT_TEST_RESULT(ca.calls + cb.calls == 1 && timer_wheel_count(w) == 0);
+    timer_wheel_destroy(&w);
+}
+
+void test_timer_wheel_null() {
+    PRINT_TEST_RESULT(timer_wheel_schedule(NULL, 1, 0, count, NULL, 1, 0) == NO_TIMER && timer_wheel_advance(NULL) == -1 &&
+                      timer_wheel_cancel(NULL, 1) == ERROR && timer_wheel_pending(NULL, 1) == FALSE &&
+                      timer_wheel_count(NULL) == -1 && timer_wheel_get_turn(NULL) == -1);
+}
+
+void test_all() {
+    test_timer_wheel_create();
+    test_timer_wheel_destroy_null();
+    test_timer_wheel_schedule();
+    test_timer_wheel_cancel();
+    test_timer_wheel_old_handle();
+    test_timer_wheel_period();
+    test_timer_wheel_far();
+    test_timer_wheel_many();
+    test_timer_wheel_cancel_from_call();
+    test_timer_wheel_null();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for TimerWheel unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("TimerWheel test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_timer_wheel_create();
+                break;
+            case 2:
+                test_timer_wheel_destroy_null();
+                break;
+            case 3:
+                test_timer_wheel_schedule();
+                break;
+            case 4:
+                test_timer_wheel_cancel();
+                break;
+            case 5:
+                test_timer_wheel_old_handle();
+                break;
+            case 6:
+                test_timer_wheel_period();
+                break;
+            case 7:
+                test_timer_wheel_far();
+                break;
+            case 8:
+                test_timer_wheel_many();
+                break;
+            case 9:
+                test_timer_wheel_cancel_from_call();
+                break;
+            case 10:
+                test_timer_wheel_null();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
@@ -0,0 +1,394 @@
+/**
+ * @brief It implements the vocabulary of the commands. While words are
+ * added they are indexed in a name table. Compiling it builds a minimal
+ * perfect hash by hash and displace: the words are put in buckets by a
+ * first hash, and the buckets with most words first look for the seed of
+ * a second hash that sends each of their words to a free slot. A bucket
+ * of one word takes the next free slot as it is, so every slot is used
+ *
+ * @file vocabulary.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/vocabulary.h"
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "../include/name_table.h"
+
+/* seeds a bucket tries before the words are given up as not hashable */
+#define VOCABULARY_MAX_SEED 1000000
+
+typedef struct {
+    char *word;                     // in lower case
+    int meaning[N_WORD_KINDS];      // NO_MEANING for the kinds it has not
+} Word;
+
+typedef struct {
+    char *word;
+    char *of;
+} Synonym;
+
+struct _Vocabulary {
+    Word *words;
+    int n_words;
+    int capacity;
+    NameTable *index;       // word -> its position + 1
+    Synonym *synonyms;
+    int n_synonyms;
+    int synonyms_capacity;
+    BOOL compiled;          // the perfect hash has every word
+    int n_slots;            // words when it was compiled
+    int32_t *displace;      // seed of the second hash of each bucket, or -(slot + 1) of its only word
+    int *slots;             // position of the word of each slot
+};
+
+/**
+ * @brief hash of a word whatever its case
+ *
+ * @param word the word
+ * @param seed 0 for the bucket, the seed of the bucket for the slot
+ * @return the hash
+ */
+static uint64_t vocabulary_hash(const char *word, uint64_t seed);
+
+/**
+ * @brief copy of a word in lower case
+ *
+ * @param word the word
+ * @return the copy or NULL if there is no memory
+ */
+static char *vocabulary_lower(const char *word);
+
+/**
+ * @brief position of a word while the vocabulary is built
+ *
+ * @param v pointer to Vocabulary
+ * @param word the word
+ * @return the position, -1 if it is not there
+ */
+static int vocabulary_position(Vocabulary *v, const char *word);
+
+Vocabulary *vocabulary_create()
+{
+    Vocabulary *v = calloc(1, sizeof(Vocabulary));
+    if (v == NULL)
+        return NULL;
+
+    v->index = name_table_create(64, TRUE);
+    if (v->index == NULL)
+    {
+        free(v);
+        return NULL;
+    }
+    return v;
+}
+
+STATUS vocabulary_destroy(Vocabulary **v)
+{
+    if (v == NULL || *v == NULL)
+        return ERROR;
+
+    for (int i = 0; i < (*v)->n_words; i++)
+        free((*v)->words[i].word);
+    for (int i = 0; i < (*v)->n_synonyms; i++)
+    {
+        free((*v)->synonyms[i].word);
+        free((*v)->synonyms[i].of);
+    }
+    name_table_destroy(&(*v)->index);
+    free((*v)->words);
+    free((*v)->synonyms);
+    free((*v)->displace);
+    free((*v)->slots);
+    free(*v);
+    *v = NULL;
+    return OK;
+}
+
+static uint64_t vocabulary_hash(const char *word, uint64_t seed)
+{
+    // FNV-1a of the lower case bytes, mixed so that every bit counts in a remainder
+    uint64_t h = 0xcbf29ce484222325ull ^ (seed * 0x9e3779b97f4a7c15ull);
+    for (; *word != '\0'; word++)
+    {
+        h ^= (unsigned char)tolower((unsigned char)*word);
+        h *= 0x100000001b3ull;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
+
+static char *vocabulary_lower(const char *word)
+{
+    size_t len = strlen(word);
+    char *lower = malloc(len + 1);
+    if (lower == NULL)
+        return NULL;
+
+    for (size_t i = 0; i <= len; i++)
+        lower[i] = (char)tolower((unsigned char)word[i]);
+    return lower;
+}
+
+static int vocabulary_position(Vocabulary *v, const char *word)
+{
+    return (int)(intptr_t)name_table_get(v->index, word) - 1;
+}
+
+STATUS vocabulary_add(Vocabulary *v, const char *word, T_WordKind kind, int meaning)
+{
+    if (v == NULL || word == NULL || word[0] == '\0' || kind < WORD_VERB || kind >= N_WORD_KINDS || meaning < 0)
+        return ERROR;
+
+    int i = vocabulary_position(v, word);
+    if (i < 0)
+    {
+        if (v->n_words == v->capacity)
+        {
+            int capacity = (v->capacity > 0) ? 2 * v->capacity : 32;
+            Word *words = realloc(v->words, sizeof(Word) * capacity);
+            if (words == NULL)
+                return ERROR;
+            v->words = words;
+            v->capacity = capacity;
+        }
+        Word *w = &v->words[v->n_words];
+        w->word = vocabulary_lower(word);
+        if (w->word == NULL)
+            return ERROR;
+        for (int k = 0; k < N_WORD_KINDS; k++)
+            w->meaning[k] = NO_MEANING;
+        // The copy is the key, it lasts as long as the word
+        if (name_table_put(v->index, w->word, (void *)(intptr_t)(v->n_words + 1)) == ERROR)
+        {
+            free(w->word);
+            return ERROR;
+        }
+        i = v->n_words++;
+        v->compiled = FALSE;
+    }
+    v->words[i].meaning[kind] = meaning;
+    return OK;
+}
+
+STATUS vocabulary_add_synonym(Vocabulary *v, const char *word, const char *of)
+{
+    if (v == NULL || word == NULL || of == NULL)
+        return ERROR;
+
+    int i = vocabulary_position(v, of);
+    if (i < 0)
+        return ERROR;
+
+    if (v->n_synonyms == v->synonyms_capacity)
+    {
+        int capacity = (v->synonyms_capacity > 0) ? 2 * v->synonyms_capacity : 8;
+        Synonym *synonyms = realloc(v->synonyms, sizeof(Synonym) * capacity);
+        if (synonyms == NULL)
+            return ERROR;
+        v->synonyms = synonyms;
+        v->synonyms_capacity = capacity;
+    }
+    Synonym *s = &v->synonyms[v->n_synonyms];
+    s->word = vocabulary_lower(word);
+    s->of = vocabulary_lower(of);
+    if (s->word == NULL || s->of == NULL)
+    {
+        free(s->word);
+        free(s->of);
+        return ERROR;
+    }
+    v->n_synonyms++;
+
+    // Copied, adding the word may move the one it means the same as
+    int meaning[N_WORD_KINDS];
+    memcpy(meaning, v->words[i].meaning, sizeof(meaning));
+    for (int k = 0; k < N_WORD_KINDS; k++)
+    {
+        if (meaning[k] != NO_MEANING && vocabulary_add(v, word, (T_WordKind)k, meaning[k]) == ERROR)
+            return ERROR;
+    }
+    return OK;
+}
+
+STATUS vocabulary_compile(Vocabulary *v)
+{
+    if (v == NULL)
+        return ERROR;
+
+    int n = v->n_words;
+    int32_t *displace = malloc(sizeof(int32_t) * (n + 1));
+    int *slots = malloc(sizeof(int) * (n + 1));
+    int *bucket = malloc(sizeof(int) * (n + 1));    // bucket of each word
+    int *first = calloc(n + 2, sizeof(int));        // start of each bucket in members
+    int *members = malloc(sizeof(int) * (n + 1));   // words, bucket after bucket
+    int *order = malloc(sizeof(int) * (n + 1));     // buckets, the ones with most words first
+    int *by_size = calloc(n + 2, sizeof(int));      // where the buckets of each size start in order
+    char *used = calloc(n + 1, 1);
+    int *tried = malloc(sizeof(int) * (n + 1));
+    STATUS status = OK;
+
+    if (displace == NULL || slots == NULL || bucket == NULL || first == NULL || members == NULL || order == NULL || by_size == NULL || used == NULL || tried == NULL)
+        status = ERROR;
+
+    if (status == OK)
+    {
+        // Counting sort of the words by bucket
+        for (int i = 0; i < n; i++)
+        {
+            bucket[i] = (int)(vocabulary_hash(v->words[i].word, 0) % (uint64_t)n);
+            first[bucket[i] + 1]++;
+        }
+        for (int b = 0; b < n; b++)
+            first[b + 1] += first[b];
+        for (int i = 0; i < n; i++)
+            members[first[bucket[i]]++] = i;
+        for (int b = n; b > 0; b--)
+            first[b] = first[b - 1];
+        first[0] = 0;
+
+        // Counting sort of the buckets by size, largest first
+        int k = 0;
+        for (int b = 0; b < n; b++)
+            by_size[first[b + 1] - first[b]]++;
+        for (int size = n; size > 0; size--)
+        {
+            int count = by_size[size];
+            by_size[size] = k;
+            k += count;
+        }
+        for (int b = 0; b < n; b++)
+        {
+            int size = first[b + 1] - first[b];
+            if (size > 0)
+                order[by_size[size]++] = b;
+        }
+        for (int b = 0; b < n; b++)
+            displace[b] = 0;
+
+        for (int o = 0; o < k && status == OK; o++)
+        {
+            int b = order[o];
+            int size = first[b + 1] - first[b];
+            if (size == 1)
+                break;
+            // A seed that sends every word of the bucket to its own free slot
+            int32_t seed = 1;
+            for (; seed < VOCABULARY_MAX_SEED; seed++)
+            {
+                int placed = 0;
+                for (; placed < size; placed++)
+                {
+                    int slot = (int)(vocabulary_hash(v->words[members[first[b] + placed]].word, (uint64_t)seed) % (uint64_t)n);
+                    if (used[slot])
+                        break;
+                    used[slot] = 1;
+                    tried[placed] = slot;
+                }
+                if (placed == size)
+                    break;
+                while (placed-- > 0)
+                    used[tried[placed]] = 0;
+            }
+            if (seed == VOCABULARY_MAX_SEED)
+                status = ERROR;
+            else
+            {
+                displace[b] = seed;
+                for (int i = 0; i < size; i++)
+                    slots[tried[i]] = members[first[b] + i];
+            }
+        }
+
+        // The words alone in their bucket go to the slots left
+        int free_slot = 0;
+        for (int o = 0; o < k && status == OK; o++)
+        {
+            int b = order[o];
+            if (first[b + 1] - first[b] != 1)
+                continue;
+            while (used[free_slot])
+                free_slot++;
+            used[free_slot] = 1;
+            slots[free_slot] = members[first[b]];
+            displace[b] = -(free_slot + 1);
+        }
+    }
+
+    free(bucket);
+    free(first);
+    free(members);
+    free(order);
+    free(by_size);
+    free(used);
+    free(tried);
+    if (status == ERROR)
+    {
+        free(displace);
+        free(slots);
+        return ERROR;
+    }
+    free(v->displace);
+    free(v->slots);
+    v->displace = displace;
+    v->slots = slots;
+    v->n_slots = n;
+    v->compiled = TRUE;
+    return OK;
+}
+
+int vocabulary_find(Vocabulary *v, const char *word, T_WordKind kind)
+{
+    int i = -1;
+
+    if (v == NULL || word == NULL || kind < WORD_VERB || kind >= N_WORD_KINDS)
+        return NO_MEANING;
+
+    if (v->compiled == FALSE)
+        i = vocabulary_position(v, word);
+    else if (v->n_slots > 0)
+    {
+        // Two hashes and one comparison, however many words there are
+        int b = (int)(vocabulary_hash(word, 0) % (uint64_t)v->n_slots);
+        int32_t d = v->displace[b];
+        int slot = (d < 0) ? -d - 1 : (int)(vocabulary_hash(word, (uint64_t)d) % (uint64_t)v->n_slots);
+        i = v->slots[slot];
+        if (strcasecmp(word, v->words[i].word) != 0)
+            i = -1;
+    }
+    return (i >= 0) ? v->words[i].meaning[kind] : NO_MEANING;
+}
+
+int vocabulary_count(Vocabulary *v)
+{
+    return (v != NULL) ? v->n_words : -1;
+}
+
+const char *vocabulary_get_synonym(Vocabulary *v, int i, const char **of)
+{
+    if (v == NULL || i < 0 || i >= v->n_synonyms)
+        return NULL;
+    if (of != NULL)
+        *of = v->synonyms[i].of;
+    return v->synonyms[i].word;
+}
+
+STATUS vocabulary_save(FILE *fp, Vocabulary *v)
+{
+    if (fp == NULL || v == NULL)
+        return ERROR;
+
+    for (int i = 0; i < v->n_synonyms; i++)
+        fprintf(fp, "#v:%s|%s|\n", v->synonyms[i].word, v->synonyms[i].of);
+    return OK;
+}
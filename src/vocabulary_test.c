@@ -0,0 +1,206 @@
+/**
+ * @brief It tests the vocabulary module
+ *
+ * @file vocabulary_test.c
+ * @author Jiri Zak
+ * @version 1.0
+ * @date 28-05-2021
+ * @copyright GNU Public License
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/vocabulary.h"
+#include "../include/test.h"
+#include "../include/types.h"
+
+#define TEST_WORDS 5000
+#define TEST_FILE "/tmp/vocabulary_test.txt"
+
+void test_vocabulary_create() {
+    Vocabulary* v = vocabulary_create();
+    PRINT_TEST_RESULT(v != NULL && vocabulary_count(v) == 0 && vocabulary_find(v, "take", WORD_VERB) == NO_MEANING);
+    vocabulary_destroy(&v);
+}
+
+void test_vocabulary_destroy_null() {
+    Vocabulary* v = NULL;
+    PRINT_TEST_RESULT(vocabulary_destroy(&v) == ERROR);
+}
+
+void test_vocabulary_add() {
+    Vocabulary* v = vocabulary_create();
+
+    vocabulary_add(v, "Take", WORD_VERB, 2);
+    PRINT_TEST_RESULT(vocabulary_find(v, "take", WORD_VERB) == 2 && vocabulary_find(v, "TAKE", WORD_VERB) == 2 &&
+                      vocabulary_find(v, "take", WORD_DIRECTION) == NO_MEANING && vocabulary_count(v) == 1);
+    vocabulary_destroy(&v);
+}
+
+void test_vocabulary_kinds() {
+    Vocabulary* v = vocabulary_create();
+
+    // One word, a meaning of each kind
+    vocabulary_add(v, "e", WORD_VERB, 1);
+    vocabulary_add(v, "e", WORD_DIRECTION, 2);
+    PRINT_TEST_RESULT(vocabulary_count(v) == 1 && vocabulary_find(v, "e", WORD_VERB) == 1 && vocabulary_find(v, "E", WORD_DIRECTION) == 2);
+    vocabulary_destroy(&v);
+}
+
+void test_vocabulary_synonym() {
+    Vocabulary* v = vocabulary_create();
+    const char* of = NULL;
+
+    vocabulary_add(v, "take", WORD_VERB, 2);
+    PRINT_TEST_RESULT(vocabulary_add_synonym(v, "Grab", "take") == OK && vocabulary_find(v, "grab", WORD_VERB) == 2 &&
+                      strcmp(vocabulary_get_synonym(v, 0, &of), "grab") == 0 && strcmp(of, "take") == 0 &&
+                      vocabulary_get_synonym(v, 1, &of) == NULL);
+    vocabulary_destroy(&v);
+}
+
+void test_vocabulary_synonym_unknown() {
+    Vocabulary* v = vocabulary_create();
+
+    PRINT_TEST_RESULT(vocabulary_add_synonym(v, "grab", "take") == ERROR && vocabulary_find(v, "grab", WORD_VERB) == NO_MEANING &&
+                      vocabulary_get_synonym(v, 0, NULL) == NULL);
+    vocabulary_destroy(&v);
+}
+
+void test_vocabulary_compile() {
+    Vocabulary* v = vocabulary_create();
+    char word[16];
+    BOOL found = TRUE;
+
+    for (int i = 0; i < TEST_WORDS; i++) {
+        sprintf(word, "w%d", i);
+        vocabulary_add(v, word, WORD_VERB, i);
+    }
+    BOOL compiled = vocabulary_compile(v) == OK;
+    // Each word in its own slot, and the words that are not there are not found
+    for (int i = 0; i < TEST_WORDS && found == TRUE; i++) {
+        sprintf(word, "W%d", i);
+        if (vocabulary_find(v, word, WORD_VERB) != i)
+            found = FALSE;
+        sprintf(word, "x%d", i);
+        if (vocabulary_find(v, word, WORD_VERB) != NO_MEANING)
+            found = FALSE;
+    }
+    PRINT_TEST_RESULT(compiled == TRUE && found == TRUE);
+    vocabulary_destroy(&v);
+}
+
+void test_vocabulary_add_after_compile() {
+    Vocabulary* v = vocabulary_create();
+
+    vocabulary_add(v, "take", WORD_VERB, 2);
+    vocabulary_compile(v);
+    vocabulary_add(v, "drop", WORD_VERB, 3);
+    BOOL before = vocabulary_find(v, "drop", WORD_VERB) == 3 && vocabulary_find(v, "take", WORD_VERB) == 2;
+    vocabulary_compile(v);
+    PRINT_TEST_RESULT(before == TRUE && vocabulary_find(v, "drop", WORD_VERB) == 3 && vocabulary_find(v, "take", WORD_VERB) == 2);
+    vocabulary_destroy(&v);
+}
+
+void test_vocabulary_save() {
+    Vocabulary* v = vocabulary_create();
+    char line[64] = "";
+    FILE* fp = fopen(TEST_FILE, "w");
+
+    vocabulary_add(v, "up", WORD_DIRECTION, 4);
+    vocabulary_add_synonym(v, "upstairs", "up");
+    if (fp != NULL) {
+        vocabulary_save(fp, v);
+        fclose(fp);
+    }
+    fp = fopen(TEST_FILE, "r");
+    if (fp != NULL) {
+        if (fgets(line, sizeof(line), fp) == NULL)
+            line[0] = '\0';
+        fclose(fp);
+    }
+    PRINT_TEST_RESULT(strcmp(line, "#v:upstairs|up|\n") == 0);
+    remove(TEST_FILE);
+    vocabulary_destroy(&v);
+}
+
+void test_vocabulary_null() {
+    Vocabulary* v = vocabulary_create();
+
+    PRINT_TEST_RESULT(vocabulary_add(NULL, "a", WORD_VERB, 0) == ERROR && vocabulary_add(v, NULL, WORD_VERB, 0) == ERROR &&
+                      vocabulary_add(v, "", WORD_VERB, 0) == ERROR && vocabulary_add(v, "a", WORD_VERB, -1) == ERROR &&
+                      vocabulary_compile(NULL) == ERROR && vocabulary_find(NULL, "a", WORD_VERB) == NO_MEANING &&
+                      vocabulary_find(v, NULL, WORD_VERB) == NO_MEANING && vocabulary_count(NULL) == -1 &&
+                      vocabulary_save(NULL, v) == ERROR);
+    vocabulary_destroy(&v);
+}
+
+void test_all() {
+    test_vocabulary_create();
+    test_vocabulary_destroy_null();
+    test_vocabulary_add();
+    test_vocabulary_kinds();
+    test_vocabulary_synonym();
+    test_vocabulary_synonym_unknown();
+    test_vocabulary_compile();
+    test_vocabulary_add_after_compile();
+    test_vocabulary_save();
+    test_vocabulary_null();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for VOCABULARY unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("Vocabulary test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_vocabulary_create();
+                break;
+            case 2:
+                test_vocabulary_destroy_null();
+                break;
+            case 3:
+                test_vocabulary_add();
+                break;
+            case 4:
+                test_vocabulary_kinds();
+                break;
+            case 5:
+                test_vocabulary_synonym();
+                break;
+            case 6:
+                test_vocabulary_synonym_unknown();
+                break;
+            case 7:
+                test_vocabulary_compile();
+                break;
+            case 8:
+                test_vocabulary_add_after_compile();
+                break;
+            case 9:
+                test_vocabulary_save();
+                break;
+            case 10:
+                test_vocabulary_null();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}
@@ -0,0 +1,1561 @@
+/**
+ * @brief It implements the compiled world format. The image is a header
+ * followed by the sections it points to, each one aligned to 8 bytes:
+ * string table, text, links, spaces, objects, inventory and the region
+ * index. A streamed world keeps the image mapped and builds a region of
+ * it the first time one of its spaces or objects is asked for
+ *
+ * @file world_image.c
+ * @author Jiri Zak
+ * @version 4.0
+ * @date 26-05-2021
+ * @copyright GNU Public License
+ */
+
+#include "../include/world_image.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/id_table.h"
+#include "../include/intern.h"
+
+#define IMAGE_MAGIC "GOOSEWC"
+#define IMAGE_VERSION 5
+/* written as is, an image from a machine with other byte order is rejected */
+#define IMAGE_ORDER 0x01020304u
+#define IMAGE_ALIGN 8
+#define IMAGE_NO_LINK -1
+/* flags of the header */
+#define IMAGE_PLAYER 1u
+#define IMAGE_DICE 2u
+/* spaces of a region unless world_image_set_region_spaces changes it */
+#define IMAGE_REGION_SPACES 64
+
+typedef struct {
+    uint32_t offset;    // from the start of the text, the text ends with '\0'
+    uint32_t length;
+} ImageString;
+
+typedef struct {
+    int64_t id;
+    int64_t first;
+    int64_t second;
+    uint32_t name;
+    int32_t opened;
+} ImageLink;
+
+typedef struct {
+    int64_t id;
+    uint32_t name;
+    uint32_t description;
+    uint32_t detailed_description;
+    uint32_t gdesc[3];
+    int32_t exits[N_DIRECTIONS];    // position in the link table or IMAGE_NO_LINK
+    int32_t illuminated;
+    int32_t unused;
+} ImageSpace;
+
+typedef struct {
+    int64_t id;
+    int64_t location;
+    int64_t dependency;
+    int64_t open_link;
+    uint32_t name;
+    uint32_t description;
+    int32_t movable;
+    int32_t illuminate;
+    int32_t turned_on;
+    int32_t unused;
+} ImageObject;
+
+typedef struct {
+    int64_t id;
+    int64_t location;
+    uint32_t name;
+    int32_t capacity;
+} ImagePlayer;
+
+typedef struct {
+    int32_t last_roll;
+    int32_t minimum;
+    int32_t maximum;
+    int32_t unused;
+} ImageDice;
+
+typedef struct {
+    int32_t effect;
+    int32_t weight;
+    int64_t target;
+    int64_t first;
+    int64_t last;
+} ImageRule;
+
+typedef struct {
+    int32_t effect;
+    int32_t trigger;
+    int64_t target;
+    int64_t delay;
+    int64_t period;
+} ImageEvent;
+
+/* a word of the world and the word it means the same as, positions in the string table */
+typedef struct {
+    uint32_t word;
+    uint32_t of;
+} ImageSynonym;
+
+/* entry of the sorted indexes from ids to positions */
+typedef struct {
+    int64_t id;
+    uint32_t position;
+    uint32_t unused;
+} ImageKey;
+
+/* objects of a region, a slice of the region objects section */
+typedef struct {
+    uint32_t first;
+    uint32_t n;
+} ImageRegion;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t n_strings;
+    uint32_t n_links;
+    uint32_t n_spaces;
+    uint32_t n_objects;
+    uint32_t n_inventory;
+    uint32_t flags;
+    /* offsets of the sections from the start of the image */
+    uint64_t strings;
+    uint64_t text;
+    uint64_t text_size;
+    uint64_t links;
+    uint64_t spaces;
+    uint64_t objects;
+    uint64_t inventory;     // ids of the objects the player carries
+    /* region index. A region is a run of consecutive spaces of the space
+     * table and the objects located in them. The last region holds the
+     * objects that are not in any space */
+    uint32_t region_spaces;
+    uint32_t n_regions;
+    uint64_t space_keys;    // ImageKey of every space, sorted by id
+    uint64_t object_keys;   // ImageKey of every object, sorted by id
+    uint64_t regions;       // ImageRegion of every region
+    uint64_t region_objects;    // positions of the objects, region after region
+    uint32_t n_rules;
+    uint32_t n_events;
+    uint64_t rules;         // random rules of the world, in the order they were added
+    uint64_t events;        // events of the world, in the order they were added
+    uint32_t n_synonyms;
+    uint32_t unused;
+    uint64_t synonyms;      // synonyms of the world, in the order they were added
+    ImagePlayer player;
+    ImageDice dice;
+} ImageHeader;
+
+/* texts of an image being written, each handle once */
+typedef struct {
+    IdTable *index;         // key of a handle -> its position + 1
+    const char **handles;
+    uint32_t n;
+    uint32_t capacity;
+    uint64_t size;          // bytes of text, '\0' included
+    InternPool *pool;       // pool of the game the handles are from
+} ImageStrings;
+
+/* an image being written, built whole in memory before writing it */
+typedef struct {
+    ImageHeader header;
+    ImageStrings strings;
+    IdTable *link_index;    // address of a link -> its position + 1
+    ImageLink *links;
+    ImageSpace *spaces;
+    ImageObject *objects;
+    int64_t *inventory;
+    ImageRule *rules;
+    ImageEvent *events;
+    ImageSynonym *synonyms;
+    ImageKey *space_keys;
+    ImageKey *object_keys;
+    ImageRegion *regions;
+    uint32_t *region_objects;
+} ImageWriter;
+
+/* a world image kept mapped while the game is played */
+struct _WorldStream {
+    const char *data;
+    size_t size;
+    void (*release)(const char *data, size_t size);
+    const ImageHeader *header;
+    const ImageString *table;
+    const char *text;
+    const ImageLink *link_records;
+    const ImageSpace *space_records;
+    const ImageObject *object_records;
+    const ImageKey *space_keys;
+    const ImageKey *object_keys;
+    const ImageRegion *regions;
+    const uint32_t *region_objects;
+    /* entities built from each record, NULL while it is not in memory */
+    Space **spaces;
+    Link **links;
+    Object **objects;
+    uint32_t *used;     // per region, tick of its last use, 0 if it is not in memory
+    uint32_t tick;
+    int n_resident;     // regions in memory, the one of the loose objects is not counted
+    int max_regions;    // 0 for no limit
+    InternPool *strings; // pool of the game the texts are interned in
+};
+
+/* spaces of a region of the images written from now on */
+static uint32_t region_spaces = IMAGE_REGION_SPACES;
+
+/**
+ * @brief position of a text in the string table, adding it the first time
+ *
+ * @param s string table
+ * @param h interned handle, NULL is the empty text
+ * @param index set to the position
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS image_string(ImageStrings *s, const char *h, uint32_t *index);
+
+/**
+ * @brief writes zeros up to the next aligned offset
+ *
+ * @param out file
+ * @param offset current offset, updated
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS image_pad(FILE *out, uint64_t *offset);
+
+/**
+ * @brief writes a section and pads it
+ *
+ * @param out file
+ * @param data section
+ * @param size bytes of the section
+ * @param offset current offset, updated
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS image_write(FILE *out, const void *data, size_t size, uint64_t *offset);
+
+/**
+ * @brief checks that a section is inside the image
+ *
+ * @param size size of the image
+ * @param offset offset of the section
+ * @param count number of elements
+ * @param elem size of an element
+ * @return TRUE if it is inside and aligned
+ */
+static BOOL image_section(size_t size, uint64_t offset, uint64_t count, size_t elem);
+
+/**
+ * @brief fills the tables and the header from the game
+ *
+ * @param w image being written, with everything set to 0
+ * @param game pointer to game
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS image_collect(ImageWriter *w, Game *game);
+
+/**
+ * @brief writes the header and the sections
+ *
+ * @param w image built by image_collect
+ * @param out file
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS image_emit(ImageWriter *w, FILE *out);
+
+/**
+ * @brief builds the region index of an image being written
+ *
+ * @param w image, with the spaces and objects collected
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS image_regions(ImageWriter *w);
+
+/**
+ * @brief qsort comparison of ImageKey by id
+ */
+static int image_key_compare(const void *a, const void *b);
+
+/**
+ * @brief position of an id in a sorted index
+ *
+ * @param keys index
+ * @param n number of keys
+ * @param id id to find
+ * @return position of the record or -1 if there is none
+ */
+static int image_key_find(const ImageKey *keys, uint32_t n, Id id);
+
+/**
+ * @brief TRUE if the sections of an image fit in it
+ *
+ * @param data start of the image, already checked
+ * @param size size of the image
+ * @return BOOL
+ */
+static BOOL image_valid(const char *data, size_t size);
+
+/**
+ * @brief adds the random rules of an image to a game
+ *
+ * @param data start of the image
+ * @param game pointer to game
+ * @return STATUS ERROR = 0 if a rule is not valid, OK = 1
+ */
+static STATUS image_rules_load(const char *data, Game *game);
+
+/**
+ * @brief adds the events of an image to a game
+ *
+ * @param data start of the image
+ * @param game pointer to game
+ * @return STATUS ERROR = 0 if an event is not valid, OK = 1
+ */
+static STATUS image_events_load(const char *data, Game *game);
+
+/**
+ * @brief adds the synonyms of an image to a game
+ *
+ * @param data start of the image
+ * @param game pointer to game
+ * @return STATUS ERROR = 0 if a synonym is not valid, OK = 1
+ */
+static STATUS image_synonyms_load(const char *data, Game *game);
+
+/**
+ * @brief text of a string of a streamed image, as it is in the image
+ *
+ * @param ws stream
+ * @param index position in the string table
+ * @return the text, the empty text if the position is not valid
+ */
+static const char *stream_image_text(WorldStream *ws, uint32_t index);
+
+/**
+ * @brief interned text of a string of a streamed image
+ *
+ * @param ws stream
+ * @param index position in the string table
+ * @return handle, the empty text if the position is not valid
+ */
+static char *stream_text(WorldStream *ws, uint32_t index);
+
+/**
+ * @brief region of a space of the image
+ *
+ * @param ws stream
+ * @param id id of the space
+ * @return region or -1 if the image has no such space
+ */
+static int stream_space_region(WorldStream *ws, Id id);
+
+/**
+ * @brief marks the region the player is in as the most recently used
+ *
+ * @param ws stream
+ * @param game pointer to game
+ */
+static void stream_touch(WorldStream *ws, Game *game);
+
+/**
+ * @brief link of the image, built the first time one of its spaces is
+ * built. The two spaces share it
+ *
+ * @param ws stream
+ * @param game pointer to game
+ * @param position position of the link
+ * @return the link or NULL if error
+ */
+static Link *stream_link(WorldStream *ws, Game *game, int position);
+
+/**
+ * @brief builds the spaces, links and objects of a region and adds them
+ * to the game. Then regions are evicted while there are too many
+ *
+ * @param ws stream
+ * @param game pointer to game
+ * @param region region
+ * @return STATUS ERROR = 0, OK = 1
+ */
+static STATUS stream_region_load(WorldStream *ws, Game *game, int region);
+
+/**
+ * @brief TRUE if a region is as in the image: nothing in it was moved,
+ * opened, turned on or lit, and the player is not in it nor carries any
+ * of its objects. Only such a region can be evicted, it is built again
+ * the same from the image
+ *
+ * @param ws stream
+ * @param game pointer to game
+ * @param region region in memory
+ * @return BOOL
+ */
+static BOOL stream_region_clean(WorldStream *ws, Game *game, int region);
+
+/**
+ * @brief removes a region from the game and destroys its entities. A
+ * link stays while the space at its other end is in memory
+ *
+ * @param ws stream
+ * @param game pointer to game
+ * @param region region in memory
+ */
+static void stream_region_evict(WorldStream *ws, Game *game, int region);
+
+/**
+ * @brief evicts the least recently used clean regions while there are
+ * more than the limit
+ *
+ * @param ws stream
+ * @param game pointer to game
+ * @param keep region that is not evicted, the one just built
+ */
+static void stream_evict(WorldStream *ws, Game *game, int keep);
+
+static STATUS image_string(ImageStrings *s, const char *h, uint32_t *index)
+{
+    if (h == NULL)
+        h = intern_string(s->pool, "");
+
+    void *found = id_table_get(s->index, intern_key(h));
+    if (found != NULL)
+    {
+        *index = (uint32_t)((intptr_t)found - 1);
+        return OK;
+    }
+
+    if (s->n == s->capacity)
+    {
+        uint32_t capacity = (s->capacity > 0) ? 2 * s->capacity : 64;
+        const char **handles = realloc(s->handles, sizeof(const char *) * capacity);
+        if (handles == NULL)
+            return ERROR;
+        s->handles = handles;
+        s->capacity = capacity;
+    }
+    s->handles[s->n] = h;
+    s->size += intern_length(h) + 1;
+    *index = s->n++;
+    return id_table_put(s->index, intern_key(h), (void *)(intptr_t)s->n);
+}
+
+static STATUS image_pad(FILE *out, uint64_t *offset)
+{
+    static const char zeros[IMAGE_ALIGN] = {0};
+    size_t n = (size_t)((IMAGE_ALIGN - *offset % IMAGE_ALIGN) % IMAGE_ALIGN);
+
+    if (n > 0 && fwrite(zeros, 1, n, out) != n)
+        return ERROR;
+    *offset += n;
+    return OK;
+}
+
+static STATUS image_write(FILE *out, const void *data, size_t size, uint64_t *offset)
+{
+    if (size > 0 && fwrite(data, 1, size, out) != size)
+        return ERROR;
+    *offset += size;
+    return image_pad(out, offset);
+}
+
+static BOOL image_section(size_t size, uint64_t offset, uint64_t count, size_t elem)
+{
+    if (offset % IMAGE_ALIGN != 0 || offset > size)
+        return FALSE;
+    return count <= (size - offset) / elem ? TRUE : FALSE;
+}
+
+static int image_key_compare(const void *a, const void *b)
+{
+    int64_t x = ((const ImageKey *)a)->id;
+    int64_t y = ((const ImageKey *)b)->id;
+    return (x > y) - (x < y);
+}
+
+static int image_key_find(const ImageKey *keys, uint32_t n, Id id)
+{
+    uint32_t low = 0, high = n;
+
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low) / 2;
+        if (keys[mid].id < id)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return (low < n && keys[low].id == id) ? (int)keys[low].position : -1;
+}
+
+static STATUS image_regions(ImageWriter *w)
+{
+    ImageHeader *header = &w->header;
+    uint32_t n_spaces = header->n_spaces;
+    uint32_t n_objects = header->n_objects;
+    uint32_t loose = (n_spaces + region_spaces - 1) / region_spaces;
+
+    header->region_spaces = region_spaces;
+    header->n_regions = loose + 1;
+    w->space_keys = calloc(n_spaces + 1, sizeof(ImageKey));
+    w->object_keys = calloc(n_objects + 1, sizeof(ImageKey));
+    w->regions = calloc(header->n_regions, sizeof(ImageRegion));
+    w->region_objects = calloc(n_objects + 1, sizeof(uint32_t));
+    uint32_t *region_of = calloc(n_objects + 1, sizeof(uint32_t));
+    if (w->space_keys == NULL || w->object_keys == NULL || w->regions == NULL || w->region_objects == NULL || region_of == NULL)
+    {
+        free(region_of);
+        return ERROR;
+    }
+
+    for (uint32_t i = 0; i < n_spaces; i++)
+    {
+        w->space_keys[i].id = w->spaces[i].id;
+        w->space_keys[i].position = i;
+    }
+    qsort(w->space_keys, n_spaces, sizeof(ImageKey), image_key_compare);
+    for (uint32_t i = 0; i < n_objects; i++)
+    {
+        w->object_keys[i].id = w->objects[i].id;
+        w->object_keys[i].position = i;
+    }
+    qsort(w->object_keys, n_objects, sizeof(ImageKey), image_key_compare);
+
+    // An object goes with the space it is in, the objects of a region are
+    // kept together by counting them first
+    for (uint32_t i = 0; i < n_objects; i++)
+    {
+        int position = image_key_find(w->space_keys, n_spaces, w->objects[i].location);
+        region_of[i] = (position >= 0) ? (uint32_t)position / region_spaces : loose;
+        w->regions[region_of[i]].n++;
+    }
+    for (uint32_t r = 1; r < header->n_regions; r++)
+        w->regions[r].first = w->regions[r - 1].first + w->regions[r - 1].n;
+    for (uint32_t r = 0; r < header->n_regions; r++)
+        w->regions[r].n = 0;
+    for (uint32_t i = 0; i < n_objects; i++)
+    {
+        ImageRegion *region = &w->regions[region_of[i]];
+        w->region_objects[region->first + region->n++] = i;
+    }
+
+    free(region_of);
+    return OK;
+}
+
+static STATUS image_collect(ImageWriter *w, Game *game)
+{
+    ImageHeader *header = &w->header;
+    int n_links = game_get_number_link(game);
+    int n_spaces = game_get_number_space(game);
+    int n_objects = game_get_number_object(game);
+    Player *player = game_get_player(game);
+    Dice *dice = game_get_dice(game);
+    int n_inventory = 0;
+    const Id *carried = inventory_view(player_get_inventory(player), &n_inventory);
+    int n_rules = rule_table_count(game_get_rule_table(game));
+    int n_events = game_get_number_event(game);
+    // Only a game with a vocabulary of its own has synonyms
+    Vocabulary *vocabulary = game_get_vocabulary(game);
+    int n_synonyms = 0;
+    while (vocabulary_get_synonym(vocabulary, n_synonyms, NULL) != NULL)
+        n_synonyms++;
+
+    // The arrays have room for one more, so they are never empty and NULL is always an error
+    w->strings.pool = game_get_strings(game);
+    w->strings.index = id_table_create(NULL, n_spaces + n_objects);
+    w->link_index = id_table_create(NULL, n_links);
+    w->links = calloc(n_links + 1, sizeof(ImageLink));
+    w->spaces = calloc(n_spaces + 1, sizeof(ImageSpace));
+    w->objects = calloc(n_objects + 1, sizeof(ImageObject));
+    w->inventory = calloc(n_inventory + 1, sizeof(int64_t));
+    if (n_rules < 0)
+        n_rules = 0;
+    w->rules = calloc(n_rules + 1, sizeof(ImageRule));
+    w->events = calloc(n_events + 1, sizeof(ImageEvent));
+    w->synonyms = calloc(n_synonyms + 1, sizeof(ImageSynonym));
+    if (w->strings.index == NULL || w->link_index == NULL || w->links == NULL || w->spaces == NULL || w->objects == NULL || w->inventory == NULL ||
+        w->rules == NULL || w->events == NULL || w->synonyms == NULL)
+        return ERROR;
+
+    memset(header, 0, sizeof(ImageHeader));
+    memcpy(header->magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    header->version = IMAGE_VERSION;
+    header->byte_order = IMAGE_ORDER;
+
+    for (int i = 0; i < n_links; i++)
+    {
+        Link *l = game_get_link_at_position(game, i);
+        ImageLink *r = &w->links[i];
+        r->id = link_get_id(l);
+        r->first = link_get_first_space(l);
+        r->second = link_get_second_space(l);
+        r->opened = link_get_opened(l);
+        if (image_string(&w->strings, link_get_name(l), &r->name) == ERROR ||
+            id_table_put(w->link_index, (Id)(intptr_t)l, (void *)(intptr_t)(i + 1)) == ERROR)
+            return ERROR;
+    }
+
+    for (int i = 0; i < n_spaces; i++)
+    {
+        Space *s = game_get_space_at_position(game, i);
+        ImageSpace *r = &w->spaces[i];
+        r->id = space_get_id(s);
+        r->illuminated = space_get_illumination(s);
+        if (image_string(&w->strings, space_get_name(s), &r->name) == ERROR ||
+            image_string(&w->strings, space_get_description(s), &r->description) == ERROR ||
+            image_string(&w->strings, space_get_detailed_description(s), &r->detailed_description) == ERROR)
+            return ERROR;
+        for (int j = 0; j < 3; j++)
+        {
+            if (image_string(&w->strings, space_get_gdesc(s, j), &r->gdesc[j]) == ERROR)
+                return ERROR;
+        }
+        for (int d = 0; d < N_DIRECTIONS; d++)
+        {
+            void *position = id_table_get(w->link_index, (Id)(intptr_t)space_get_exit(s, d));
+            r->exits[d] = (position != NULL) ? (int32_t)((intptr_t)position - 1) : IMAGE_NO_LINK;
+        }
+    }
+
+    for (int i = 0; i < n_objects; i++)
+    {
+        Object *o = game_get_object_at_position(game, i);
+        ImageObject *r = &w->objects[i];
+        r->id = object_get_id(o);
+        r->location = object_get_location(o);
+        r->dependency = object_get_dependency(o);
+        r->open_link = object_get_openLink(o);
+        r->movable = object_get_movable(o);
+        r->illuminate = object_get_illuminate(o);
+        r->turned_on = object_get_turnedOn(o);
+        if (image_string(&w->strings, object_get_name(o), &r->name) == ERROR ||
+            image_string(&w->strings, object_get_description(o), &r->description) == ERROR)
+            return ERROR;
+    }
+
+    if (player != NULL)
+    {
+        header->flags |= IMAGE_PLAYER;
+        header->player.id = player_get_id(player);
+        header->player.location = player_get_location(player);
+        header->player.capacity = inventory_get_capacity(player_get_inventory(player));
+        if (image_string(&w->strings, intern_string(w->strings.pool, player_get_name(player)), &header->player.name) == ERROR)
+            return ERROR;
+        for (int i = 0; i < n_inventory; i++)
+            w->inventory[i] = carried[i];
+        header->n_inventory = (uint32_t)n_inventory;
+    }
+    if (dice != NULL)
+    {
+        header->flags |= IMAGE_DICE;
+        header->dice.last_roll = dice_get_last_roll(dice);
+        header->dice.minimum = dice_get_minimum(dice);
+        header->dice.maximum = dice_get_maximum(dice);
+    }
+    for (int i = 0; i < n_rules; i++)
+    {
+        const Rule *rule = rule_table_get(game_get_rule_table(game), i);
+        ImageRule *r = &w->rules[i];
+        r->effect = rule->effect;
+        r->weight = rule->weight;
+        r->target = rule->target;
+        r->first = rule->first;
+        r->last = rule->last;
+    }
+    header->n_rules = (uint32_t)n_rules;
+    for (int i = 0; i < n_events; i++)
+    {
+        const WorldEvent *event = game_get_event_at_position(game, i);
+        ImageEvent *r = &w->events[i];
+        r->effect = event->effect;
+        r->trigger = event->trigger;
+        r->target = event->target;
+        r->delay = event->delay;
+        r->period = event->period;
+    }
+    header->n_events = (uint32_t)n_events;
+    for (int i = 0; i < n_synonyms; i++)
+    {
+        const char *of = NULL;
+        const char *word = vocabulary_get_synonym(vocabulary, i, &of);
+        if (image_string(&w->strings, intern_string(w->strings.pool, word), &w->synonyms[i].word) == ERROR ||
+            image_string(&w->strings, intern_string(w->strings.pool, of), &w->synonyms[i].of) == ERROR)
+            return ERROR;
+    }
+    header->n_synonyms = (uint32_t)n_synonyms;
+
+    header->n_strings = w->strings.n;
+    header->n_links = (uint32_t)n_links;
+    header->n_spaces = (uint32_t)n_spaces;
+    header->n_objects = (uint32_t)n_objects;
+    header->text_size = w->strings.size;
+    if (image_regions(w) == ERROR)
+        return ERROR;
+
+    // Every section starts aligned, the header size is a multiple of 8
+    uint64_t offset = sizeof(ImageHeader);
+    header->strings = offset;
+    offset += sizeof(ImageString) * w->strings.n;
+    offset += (IMAGE_ALIGN - offset % IMAGE_ALIGN) % IMAGE_ALIGN;
+    header->text = offset;
+    offset += w->strings.size;
+    offset += (IMAGE_ALIGN - offset % IMAGE_ALIGN) % IMAGE_ALIGN;
+    header->links = offset;
+    offset += sizeof(ImageLink) * header->n_links;
+    header->spaces = offset;
+    offset += sizeof(ImageSpace) * header->n_spaces;
+    header->objects = offset;
+    offset += sizeof(ImageObject) * header->n_objects;
+    header->inventory = offset;
+    offset += sizeof(int64_t) * header->n_inventory;
+    header->rules = offset;
+    offset += sizeof(ImageRule) * header->n_rules;
+    header->events = offset;
+    offset += sizeof(ImageEvent) * header->n_events;
+    header->synonyms = offset;
+    offset += sizeof(ImageSynonym) * header->n_synonyms;
+    header->space_keys = offset;
+    offset += sizeof(ImageKey) * header->n_spaces;
+    header->object_keys = offset;
+    offset += sizeof(ImageKey) * header->n_objects;
+    header->regions = offset;
+    offset += sizeof(ImageRegion) * header->n_regions;
+    header->region_objects = offset;
+    return OK;
+}
+
+static STATUS image_emit(ImageWriter *w, FILE *out)
+{
+    const ImageHeader *header = &w->header;
+    uint64_t offset = 0;
+    uint32_t text_offset = 0;
+
+    if (image_write(out, header, sizeof(ImageHeader), &offset) == ERROR)
+        return ERROR;
+    for (uint32_t i = 0; i < w->strings.n; i++)
+    {
+        ImageString e = {text_offset, (uint32_t)intern_length(w->strings.handles[i])};
+        if (fwrite(&e, sizeof(e), 1, out) != 1)
+            return ERROR;
+        text_offset += e.length + 1;
+    }
+    offset += sizeof(ImageString) * w->strings.n;
+    if (image_pad(out, &offset) == ERROR)
+        return ERROR;
+    for (uint32_t i = 0; i < w->strings.n; i++)
+    {
+        size_t len = intern_length(w->strings.handles[i]) + 1;
+        if (fwrite(w->strings.handles[i], 1, len, out) != len)
+            return ERROR;
+    }
+    offset += w->strings.size;
+    if (image_pad(out, &offset) == ERROR ||
+        image_write(out, w->links, sizeof(ImageLink) * header->n_links, &offset) == ERROR ||
+        image_write(out, w->spaces, sizeof(ImageSpace) * header->n_spaces, &offset) == ERROR ||
+        image_write(out, w->objects, sizeof(ImageObject) * header->n_objects, &offset) == ERROR ||
+        image_write(out, w->inventory, sizeof(int64_t) * header->n_inventory, &offset) == ERROR ||
+        image_write(out, w->rules, sizeof(ImageRule) * header->n_rules, &offset) == ERROR ||
+        image_write(out, w->events, sizeof(ImageEvent) * header->n_events, &offset) == ERROR ||
+        image_write(out, w->synonyms, sizeof(ImageSynonym) * header->n_synonyms, &offset) == ERROR ||
+        image_write(out, w->space_keys, sizeof(ImageKey) * header->n_spaces, &offset) == ERROR ||
+        image_write(out, w->object_keys, sizeof(ImageKey) * header->n_objects, &offset) == ERROR ||
+        image_write(out, w->regions, sizeof(ImageRegion) * header->n_regions, &offset) == ERROR ||
+        image_write(out, w->region_objects, sizeof(uint32_t) * header->n_objects, &offset) == ERROR)
+        return ERROR;
+    return OK;
+}
+
+STATUS world_image_save(const char *filename, Game *game)
+{
+    ImageWriter w;
+    STATUS status = ERROR;
+
+    if (filename == NULL || game == NULL)
+        return ERROR;
+    // The image of a streamed world has every region of it
+    if (game_get_stream(game) != NULL && world_stream_load_all(game_get_stream(game), game) == ERROR)
+        return ERROR;
+
+    memset(&w, 0, sizeof(w));
+    if (image_collect(&w, game) == OK)
+    {
+        FILE *out = fopen(filename, "wb");
+        if (out != NULL)
+        {
+            status = image_emit(&w, out);
+            if (fclose(out) != 0)
+                status = ERROR;
+        }
+    }
+
+    id_table_destroy(&w.strings.index);
+    id_table_destroy(&w.link_index);
+    free(w.strings.handles);
+    free(w.links);
+    free(w.spaces);
+    free(w.objects);
+    free(w.inventory);
+    free(w.rules);
+    free(w.events);
+    free(w.synonyms);
+    free(w.space_keys);
+    free(w.object_keys);
+    free(w.regions);
+    free(w.region_objects);
+    return status;
+}
+
+BOOL world_image_check(const char *data, size_t size)
+{
+    const ImageHeader *h = (const ImageHeader *)data;
+
+    if (data == NULL || size < sizeof(ImageHeader))
+        return FALSE;
+    if (memcmp(h->magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0)
+        return FALSE;
+    return (h->version == IMAGE_VERSION && h->byte_order == IMAGE_ORDER) ? TRUE : FALSE;
+}
+
+static BOOL image_valid(const char *data, size_t size)
+{
+    const ImageHeader *h = (const ImageHeader *)data;
+
+    if (h->region_spaces == 0 || h->n_regions != (h->n_spaces + h->region_spaces - 1) / h->region_spaces + 1)
+        return FALSE;
+    if (!image_section(size, h->strings, h->n_strings, sizeof(ImageString)) ||
+        !image_section(size, h->text, h->text_size, 1) ||
+        !image_section(size, h->links, h->n_links, sizeof(ImageLink)) ||
+        !image_section(size, h->spaces, h->n_spaces, sizeof(ImageSpace)) ||
+        !image_section(size, h->objects, h->n_objects, sizeof(ImageObject)) ||
+        !image_section(size, h->inventory, h->n_inventory, sizeof(int64_t)) ||
+        !image_section(size, h->rules, h->n_rules, sizeof(ImageRule)) ||
+        !image_section(size, h->events, h->n_events, sizeof(ImageEvent)) ||
+        !image_section(size, h->synonyms, h->n_synonyms, sizeof(ImageSynonym)) ||
+        !image_section(size, h->space_keys, h->n_spaces, sizeof(ImageKey)) ||
+        !image_section(size, h->object_keys, h->n_objects, sizeof(ImageKey)) ||
+        !image_section(size, h->regions, h->n_regions, sizeof(ImageRegion)) ||
+        !image_section(size, h->region_objects, h->n_objects, sizeof(uint32_t)))
+        return FALSE;
+    return TRUE;
+}
+
+static STATUS image_rules_load(const char *data, Game *game)
+{
+    const ImageHeader *h = (const ImageHeader *)data;
+    const ImageRule *rules = (const ImageRule *)(data + h->rules);
+
+    for (uint32_t i = 0; i < h->n_rules; i++)
+    {
+        Rule rule = {(T_Rules)rules[i].effect, rules[i].weight, rules[i].target, rules[i].first, rules[i].last};
+        if (game_add_rule(game, &rule) == ERROR)
+            return ERROR;
+    }
+    return OK;
+}
+
+static STATUS image_events_load(const char *data, Game *game)
+{
+    const ImageHeader *h = (const ImageHeader *)data;
+    const ImageEvent *events = (const ImageEvent *)(data + h->events);
+
+    for (uint32_t i = 0; i < h->n_events; i++)
+    {
+        WorldEvent event = {(T_Event)events[i].effect, events[i].target, events[i].delay, events[i].period, (T_Command)events[i].trigger};
+        if (game_add_event(game, &event) == ERROR)
+            return ERROR;
+    }
+    return OK;
+}
+
+static STATUS image_synonyms_load(const char *data, Game *game)
+{
+    const ImageHeader *h = (const ImageHeader *)data;
+    const ImageString *table = (const ImageString *)(data + h->strings);
+    const char *text = data + h->text;
+    const ImageSynonym *synonyms = (const ImageSynonym *)(data + h->synonyms);
+
+    for (uint32_t i = 0; i < h->n_synonyms; i++)
+    {
+        uint32_t words[2] = {synonyms[i].word, synonyms[i].of};
+        for (int j = 0; j < 2; j++)
+        {
+            if (words[j] >= h->n_strings)
+                return ERROR;
+            const ImageString *e = &table[words[j]];
+            if ((uint64_t)e->offset + e->length >= h->text_size || text[e->offset + e->length] != '\0')
+                return ERROR;
+        }
+        if (game_add_synonym(game, text + table[words[0]].offset, text + table[words[1]].offset) == ERROR)
+            return ERROR;
+    }
+    return OK;
+}
+
+STATUS world_image_load(const char *data, size_t size, Game *game)
+{
+    const ImageHeader *h = (const ImageHeader *)data;
+
+    if (game == NULL || world_image_check(data, size) == FALSE || image_valid(data, size) == FALSE)
+        return ERROR;
+
+    const ImageString *table = (const ImageString *)(data + h->strings);
+    const char *text = data + h->text;
+    const ImageLink *link_records = (const ImageLink *)(data + h->links);
+    const ImageSpace *space_records = (const ImageSpace *)(data + h->spaces);
+    const ImageObject *object_records = (const ImageObject *)(data + h->objects);
+    const int64_t *carried = (const int64_t *)(data + h->inventory);
+
+    // Every text is interned once, the records use its position
+    const char **handles = malloc(sizeof(const char *) * (h->n_strings + 1));
+    Link **links = malloc(sizeof(Link *) * (h->n_links + 1));
+    if (handles == NULL || links == NULL)
+    {
+        free(handles);
+        free(links);
+        return ERROR;
+    }
+    STATUS status = OK;
+    for (uint32_t i = 0; i < h->n_strings && status == OK; i++)
+    {
+        if ((uint64_t)table[i].offset + table[i].length >= h->text_size || text[table[i].offset + table[i].length] != '\0')
+            status = ERROR;
+        else
+            handles[i] = intern_string(game_get_strings(game), text + table[i].offset);
+    }
+#define IMAGE_TEXT(i) ((char *)((i) < h->n_strings ? handles[i] : ""))
+
+    if (status == OK)
+        status = game_reserve(game, (int)h->n_spaces, (int)h->n_objects);
+
+    for (uint32_t i = 0; i < h->n_links && status == OK; i++)
+    {
+        const ImageLink *r = &link_records[i];
+        links[i] = link_create(game_get_arena(game), game_get_strings(game));
+        if (links[i] == NULL)
+        {
+            status = ERROR;
+            break;
+        }
+        link_set_id(links[i], r->id);
+        link_set_first_space(links[i], r->first);
+        link_set_second_space(links[i], r->second);
+        link_set_opened(links[i], r->opened ? TRUE : FALSE);
+        if (intern_length(IMAGE_TEXT(r->name)) > 0)
+            link_set_name(links[i], IMAGE_TEXT(r->name));
+        status = game_add_link(game, links[i]);
+    }
+
+    for (uint32_t i = 0; i < h->n_spaces && status == OK; i++)
+    {
+        const ImageSpace *r = &space_records[i];
+        Space *s = space_create(game_get_arena(game), game_get_strings(game), r->id);
+        if (s == NULL)
+        {
+            status = ERROR;
+            break;
+        }
+        space_set_name(s, IMAGE_TEXT(r->name));
+        space_set_description(s, IMAGE_TEXT(r->description));
+        space_set_detailed_description(s, IMAGE_TEXT(r->detailed_description));
+        space_set_illumination(s, r->illuminated ? TRUE : FALSE);
+        for (int j = 0; j < 3; j++)
+            space_set_gdesc(s, j, IMAGE_TEXT(r->gdesc[j]));
+        for (int d = 0; d < N_DIRECTIONS; d++)
+        {
+            if (r->exits[d] >= 0 && (uint32_t)r->exits[d] < h->n_links)
+                space_set_exit(s, d, links[r->exits[d]]);
+        }
+        status = game_add_space(game, s);
+    }
+
+    for (uint32_t i = 0; i < h->n_links && status == OK; i++)
+    {
+        if (intern_length(link_get_name(links[i])) > 0)
+            game_index_link(game, links[i]);
+    }
+
+    for (uint32_t i = 0; i < h->n_objects && status == OK; i++)
+    {
+        const ImageObject *r = &object_records[i];
+        Object *o = object_create(game_get_arena(game), game_get_strings(game), r->id);
+        if (o == NULL)
+        {
+            status = ERROR;
+            break;
+        }
+        object_set_name(o, IMAGE_TEXT(r->name));
+        object_set_description(o, IMAGE_TEXT(r->description));
+        object_set_location(o, r->location);
+        object_set_movable(o, r->movable ? TRUE : FALSE);
+        object_set_dependency(o, r->dependency);
+        object_set_openLink(o, r->open_link);
+        object_set_illuminate(o, r->illuminate ? TRUE : FALSE);
+        object_set_turnedOn(o, r->turned_on ? TRUE : FALSE);
+        status = game_add_object(game, o);
+    }
+
+    if (status == OK && (h->flags & IMAGE_PLAYER))
+    {
+        Player *p = player_create(game_get_arena(game), h->player.id, h->player.capacity);
+        player_set_name(p, IMAGE_TEXT(h->player.name));
+        player_set_location(p, h->player.location);
+        status = game_set_player(game, p);
+        for (uint32_t i = 0; i < h->n_inventory && status == OK; i++)
+            player_add_object(p, game_get_object(game, carried[i]));
+    }
+    if (status == OK && (h->flags & IMAGE_DICE))
+    {
+        Dice *dice = dice_create(game_get_arena(game), h->dice.minimum, h->dice.maximum, game_get_rng(game));
+        dice_set_last_roll(dice, h->dice.last_roll);
+        if (dice != NULL)
+            game_set_dice(game, dice);
+    }
+    if (status == OK)
+        status = image_rules_load(data, game);
+    if (status == OK)
+        status = image_events_load(data, game);
+    if (status == OK)
+        status = image_synonyms_load(data, game);
+#undef IMAGE_TEXT
+
+    free(handles);
+    free(links);
+    return status;
+}
+
+STATUS world_image_set_region_spaces(int n)
+{
+    if (n <= 0)
+        return ERROR;
+
+    region_spaces = (uint32_t)n;
+    return OK;
+}
+
+static const char *stream_image_text(WorldStream *ws, uint32_t index)
+{
+    const ImageString *e = &ws->table[index];
+
+    if (index >= ws->header->n_strings || (uint64_t)e->offset + e->length >= ws->header->text_size || ws->text[e->offset + e->length] != '\0')
+        return "";
+    return ws->text + e->offset;
+}
+
+static char *stream_text(WorldStream *ws, uint32_t index)
+{
+    return (char *)intern_string(ws->strings, stream_image_text(ws, index));
+}
+
+static int stream_space_region(WorldStream *ws, Id id)
+{
+    int position = image_key_find(ws->space_keys, ws->header->n_spaces, id);
+
+    if (position < 0 || (uint32_t)position >= ws->header->n_spaces)
+        return -1;
+    return (int)((uint32_t)position / ws->header->region_spaces);
+}
+
+static void stream_touch(WorldStream *ws, Game *game)
+{
+    int region = stream_space_region(ws, player_get_location(game_get_player(game)));
+
+    if (region >= 0 && ws->used[region] != 0)
+        ws->used[region] = ++ws->tick;
+}
+
+static Link *stream_link(WorldStream *ws, Game *game, int position)
+{
+    if (ws->links[position] != NULL)
+        return ws->links[position];
+
+    const ImageLink *r = &ws->link_records[position];
+    char *name = stream_text(ws, r->name);
+    Link *l = link_create(NULL, ws->strings);
+    if (l == NULL)
+        return NULL;
+    link_set_id(l, r->id);
+    link_set_first_space(l, r->first);
+    link_set_second_space(l, r->second);
+    link_set_opened(l, r->opened ? TRUE : FALSE);
+    link_set_dirty(l, FALSE);
+    if (intern_length(name) > 0)
+        link_set_name(l, name);
+    if (game_add_link(game, l) == ERROR)
+    {
+        link_destroy(&l);
+        return NULL;
+    }
+    if (intern_length(name) > 0)
+        game_index_link(game, l);
+
+    ws->links[position] = l;
+    return l;
+}
+
+static STATUS stream_region_load(WorldStream *ws, Game *game, int region)
+{
+    const ImageHeader *h = ws->header;
+    const ImageRegion *objects = &ws->regions[region];
+    uint32_t first = (uint32_t)region * h->region_spaces;
+    uint32_t last = (first + h->region_spaces < h->n_spaces) ? first + h->region_spaces : h->n_spaces;
+    STATUS status = OK;
+
+    if ((uint64_t)objects->first + objects->n > h->n_objects)
+        return ERROR;
+
+    // In memory from now on, what is asked for while it is built is not built twice
+    ws->used[region] = ++ws->tick;
+    if ((uint32_t)region != h->n_regions - 1)
+        ws->n_resident++;
+
+    // Not taken from the arena of the game, so an evicted region gives its
+    // memory back
+    for (uint32_t i = first; i < last && status == OK; i++)
+    {
+        const ImageSpace *r = &ws->space_records[i];
+        Space *s = space_create(NULL, ws->strings, r->id);
+        if (s == NULL)
+        {
+            status = ERROR;
+            break;
+        }
+        // Not clean until the region is built, so the objects put in it
+        // do not push it on the dirty list of the game
+        space_set_dirty(s, TRUE);
+        space_set_name(s, stream_text(ws, r->name));
+        space_set_description(s, stream_text(ws, r->description));
+        space_set_detailed_description(s, stream_text(ws, r->detailed_description));
+        space_set_illumination(s, r->illuminated ? TRUE : FALSE);
+        for (int j = 0; j < 3; j++)
+            space_set_gdesc(s, j, stream_text(ws, r->gdesc[j]));
+        for (int d = 0; d < N_DIRECTIONS && status == OK; d++)
+        {
+            if (r->exits[d] < 0 || (uint32_t)r->exits[d] >= h->n_links)
+                continue;
+            Link *l = stream_link(ws, game, r->exits[d]);
+            if (l == NULL)
+                status = ERROR;
+            else
+                space_set_exit(s, d, l);
+        }
+        if (status == OK)
+            status = game_add_space(game, s);
+        if (status == OK)
+            ws->spaces[i] = s;
+        else
+            space_destroy(&s);
+    }
+
+    for (uint32_t k = 0; k < objects->n && status == OK; k++)
+    {
+        uint32_t i = ws->region_objects[objects->first + k];
+        if (i >= h->n_objects)
+            continue;
+        const ImageObject *r = &ws->object_records[i];
+        Object *o = object_create(NULL, ws->strings, r->id);
+        if (o == NULL)
+        {
+            status = ERROR;
+            break;
+        }
+        object_set_name(o, stream_text(ws, r->name));
+        object_set_description(o, stream_text(ws, r->description));
+        object_set_location(o, r->location);
+        object_set_movable(o, r->movable ? TRUE : FALSE);
+        object_set_dependency(o, r->dependency);
+        object_set_openLink(o, r->open_link);
+        object_set_illuminate(o, r->illuminate ? TRUE : FALSE);
+        object_set_turnedOn(o, r->turned_on ? TRUE : FALSE);
+        status = game_add_object(game, o);
+        if (status == OK)
+            ws->objects[i] = o;
+        else
+            object_destroy(&o);
+    }
+
+    if (status == OK)
+    {
+        // Built as in the image, nothing there changed yet
+        for (uint32_t i = first; i < last; i++)
+            space_set_dirty(ws->spaces[i], FALSE);
+        for (uint32_t k = 0; k < objects->n; k++)
+        {
+            uint32_t i = ws->region_objects[objects->first + k];
+            if (i < h->n_objects)
+                object_set_dirty(ws->objects[i], FALSE);
+        }
+        stream_evict(ws, game, region);
+    }
+    return status;
+}
+
+static BOOL stream_region_clean(WorldStream *ws, Game *game, int region)
+{
+    const ImageHeader *h = ws->header;
+    const ImageRegion *objects = &ws->regions[region];
+    Player *player = game_get_player(game);
+    uint32_t first = (uint32_t)region * h->region_spaces;
+    uint32_t last = (first + h->region_spaces < h->n_spaces) ? first + h->region_spaces : h->n_spaces;
+    uint32_t n = 0;
+
+    if (stream_space_region(ws, player_get_location(player)) == region)
+        return FALSE;
+
+    for (uint32_t i = first; i < last; i++)
+    {
+        const ImageSpace *r = &ws->space_records[i];
+        Space *s = ws->spaces[i];
+        if (s == NULL || space_get_illumination(s) != (r->illuminated ? TRUE : FALSE))
+            return FALSE;
+        n += (uint32_t)space_objects_count(s);
+        for (int d = 0; d < N_DIRECTIONS; d++)
+        {
+            if (r->exits[d] < 0 || (uint32_t)r->exits[d] >= h->n_links)
+                continue;
+            Link *l = ws->links[r->exits[d]];
+            if (l != NULL && link_get_opened(l) != (ws->link_records[r->exits[d]].opened ? TRUE : FALSE))
+                return FALSE;
+        }
+    }
+    // Nothing was taken from or dropped in its spaces
+    if (n != objects->n)
+        return FALSE;
+
+    for (uint32_t k = 0; k < objects->n; k++)
+    {
+        uint32_t i = ws->region_objects[objects->first + k];
+        if (i >= h->n_objects)
+            continue;
+        const ImageObject *r = &ws->object_records[i];
+        Object *o = ws->objects[i];
+        if (o == NULL || object_get_location(o) != r->location || object_get_turnedOn(o) != (r->turned_on ? TRUE : FALSE) ||
+            player_has_object(player, r->id) == TRUE)
+            return FALSE;
+        int position = image_key_find(ws->space_keys, h->n_spaces, r->location);
+        if (position < 0 || (uint32_t)position >= h->n_spaces || ws->spaces[position] == NULL ||
+            space_hasObject(ws->spaces[position], r->id) == FALSE)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static void stream_region_evict(WorldStream *ws, Game *game, int region)
+{
+    const ImageHeader *h = ws->header;
+    const ImageRegion *objects = &ws->regions[region];
+    uint32_t first = (uint32_t)region * h->region_spaces;
+    uint32_t last = (first + h->region_spaces < h->n_spaces) ? first + h->region_spaces : h->n_spaces;
+
+    ws->used[region] = 0;
+    ws->n_resident--;
+
+    for (uint32_t k = 0; k < objects->n; k++)
+    {
+        uint32_t i = ws->region_objects[objects->first + k];
+        if (i >= h->n_objects || ws->objects[i] == NULL)
+            continue;
+        game_remove_object(game, ws->objects[i]);
+        object_destroy(&ws->objects[i]);
+    }
+
+    for (uint32_t i = first; i < last; i++)
+    {
+        const ImageSpace *r = &ws->space_records[i];
+        if (ws->spaces[i] == NULL)
+            continue;
+        for (int d = 0; d < N_DIRECTIONS; d++)
+        {
+            if (r->exits[d] < 0 || (uint32_t)r->exits[d] >= h->n_links || ws->links[r->exits[d]] == NULL)
+                continue;
+            // The space at the other end still uses it
+            int other = stream_space_region(ws, link_get_destination(ws->links[r->exits[d]], r->id));
+            if (other >= 0 && ws->used[other] != 0)
+                continue;
+            game_remove_link(game, ws->links[r->exits[d]]);
+            link_destroy(&ws->links[r->exits[d]]);
+        }
+        game_remove_space(game, ws->spaces[i]);
+        space_destroy(&ws->spaces[i]);
+    }
+}
+
+static void stream_evict(WorldStream *ws, Game *game, int keep)
+{
+    uint32_t loose = ws->header->n_regions - 1;
+
+    while (ws->max_regions > 0 && ws->n_resident > ws->max_regions)
+    {
+        int oldest = -1;
+        for (uint32_t r = 0; r < loose; r++)
+        {
+            if (ws->used[r] == 0 || (int)r == keep || (oldest >= 0 && ws->used[r] >= ws->used[oldest]))
+                continue;
+            if (stream_region_clean(ws, game, (int)r) == TRUE)
+                oldest = (int)r;
+        }
+        // Every other region was changed, they stay over the limit
+        if (oldest < 0)
+            return;
+        stream_region_evict(ws, game, oldest);
+    }
+}
+
+STATUS world_stream_open(const char *data, size_t size, Game *game, int max_regions, void (*release)(const char *data, size_t size))
+{
+    const ImageHeader *h = (const ImageHeader *)data;
+    STATUS status = OK;
+
+    if (game == NULL || game_get_stream(game) != NULL || world_image_check(data, size) == FALSE || image_valid(data, size) == FALSE)
+        return ERROR;
+
+    WorldStream *ws = calloc(1, sizeof(WorldStream));
+    if (ws == NULL)
+        return ERROR;
+    ws->data = data;
+    ws->size = size;
+    ws->strings = game_get_strings(game);
+    ws->header = h;
+    ws->table = (const ImageString *)(data + h->strings);
+    ws->text = data + h->text;
+    ws->link_records = (const ImageLink *)(data + h->links);
+    ws->space_records = (const ImageSpace *)(data + h->spaces);
+    ws->object_records = (const ImageObject *)(data + h->objects);
+    ws->space_keys = (const ImageKey *)(data + h->space_keys);
+    ws->object_keys = (const ImageKey *)(data + h->object_keys);
+    ws->regions = (const ImageRegion *)(data + h->regions);
+    ws->region_objects = (const uint32_t *)(data + h->region_objects);
+    ws->max_regions = (max_regions > 0) ? max_regions : 0;
+    ws->spaces = calloc(h->n_spaces + 1, sizeof(Space *));
+    ws->links = calloc(h->n_links + 1, sizeof(Link *));
+    ws->objects = calloc(h->n_objects + 1, sizeof(Object *));
+    ws->used = calloc(h->n_regions, sizeof(uint32_t));
+    if (ws->spaces == NULL || ws->links == NULL || ws->objects == NULL || ws->used == NULL || game_set_stream(game, ws) == ERROR)
+    {
+        world_stream_close(&ws);
+        return ERROR;
+    }
+
+    // Only the player, the dice, the objects that are in no space and the
+    // region of the player are built now
+    status = stream_region_load(ws, game, (int)h->n_regions - 1);
+    if (status == OK && (h->flags & IMAGE_PLAYER))
+    {
+        Player *p = player_create(NULL, h->player.id, h->player.capacity);
+        player_set_name(p, stream_text(ws, h->player.name));
+        player_set_location(p, h->player.location);
+        status = game_set_player(game, p);
+    }
+    if (status == OK && (h->flags & IMAGE_DICE))
+    {
+        Dice *dice = dice_create(NULL, h->dice.minimum, h->dice.maximum, game_get_rng(game));
+        dice_set_last_roll(dice, h->dice.last_roll);
+        if (dice != NULL)
+            game_set_dice(game, dice);
+    }
+    if (status == OK)
+        status = image_rules_load(data, game);
+    if (status == OK)
+        status = image_events_load(data, game);
+    if (status == OK)
+        status = image_synonyms_load(data, game);
+
+    if (status == OK && (h->flags & IMAGE_PLAYER))
+    {
+        const int64_t *carried = (const int64_t *)(data + h->inventory);
+        game_get_space(game, h->player.location);
+        for (uint32_t i = 0; i < h->n_inventory; i++)
+            player_add_object(game_get_player(game), game_get_object(game, carried[i]));
+    }
+
+    if (status == ERROR)
+    {
+        // The caller still owns the image
+        game_set_stream(game, NULL);
+        ws->release = NULL;
+        world_stream_close(&ws);
+        return ERROR;
+    }
+    ws->release = release;
+    return OK;
+}
+
+STATUS world_stream_close(WorldStream **ws)
+{
+    if (ws == NULL || *ws == NULL)
+        return ERROR;
+
+    if ((*ws)->release != NULL)
+        (*ws)->release((*ws)->data, (*ws)->size);
+    free((*ws)->spaces);
+    free((*ws)->links);
+    free((*ws)->objects);
+    free((*ws)->used);
+    free(*ws);
+    *ws = NULL;
+    return OK;
+}
+
+Space *world_stream_get_space(WorldStream *ws, Game *game, Id id)
+{
+    if (ws == NULL || game == NULL)
+        return NULL;
+
+    int position = image_key_find(ws->space_keys, ws->header->n_spaces, id);
+    if (position < 0 || (uint32_t)position >= ws->header->n_spaces)
+        return NULL;
+
+    int region = (int)((uint32_t)position / ws->header->region_spaces);
+    if (ws->used[region] == 0)
+    {
+        // The region the player is in is the last one used
+        stream_touch(ws, game);
+        if (stream_region_load(ws, game, region) == ERROR)
+            return NULL;
+    }
+    return ws->spaces[position];
+}
+
+Object *world_stream_get_object(WorldStream *ws, Game *game, Id id)
+{
+    if (ws == NULL || game == NULL)
+        return NULL;
+
+    int position = image_key_find(ws->object_keys, ws->header->n_objects, id);
+    if (position < 0 || (uint32_t)position >= ws->header->n_objects)
+        return NULL;
+
+    int region = stream_space_region(ws, ws->object_records[position].location);
+    if (region < 0)
+        region = (int)ws->header->n_regions - 1;
+    if (ws->used[region] == 0)
+    {
+        stream_touch(ws, game);
+        if (stream_region_load(ws, game, region) == ERROR)
+            return NULL;
+    }
+    return ws->objects[position];
+}
+
+STATUS world_stream_load_all(WorldStream *ws, Game *game)
+{
+    if (ws == NULL || game == NULL)
+        return ERROR;
+
+    // Nothing is evicted any more
+    ws->max_regions = 0;
+    for (uint32_t r = 0; r < ws->header->n_regions; r++)
+    {
+        if (ws->used[r] == 0 && stream_region_load(ws, game, (int)r) == ERROR)
+            return ERROR;
+    }
+    return OK;
+}
+
+STATUS world_stream_get_size(WorldStream *ws, int *n_spaces, int *n_links, int *n_objects)
+{
+    if (ws == NULL || n_spaces == NULL || n_links == NULL || n_objects == NULL)
+        return ERROR;
+
+    *n_spaces = (int)ws->header->n_spaces;
+    *n_links = (int)ws->header->n_links;
+    *n_objects = (int)ws->header->n_objects;
+    return OK;
+}
+
+STATUS world_stream_get_space_record(WorldStream *ws, int position, StreamRecord *r)
+{
+    if (ws == NULL || r == NULL || position < 0 || (uint32_t)position >= ws->header->n_spaces)
+        return ERROR;
+
+    const ImageSpace *s = &ws->space_records[position];
+    memset(r, 0, sizeof(StreamRecord));
+    r->id = s->id;
+    r->first = r->second = NO_ID;
+    r->on = s->illuminated ? TRUE : FALSE;
+    r->name = stream_image_text(ws, s->name);
+    // Where each exit leads, as link_get_destination tells it
+    for (int d = 0; d < N_DIRECTIONS; d++)
+    {
+        const ImageLink *l = NULL;
+        r->exits[d] = NO_ID;
+        if (s->exits[d] < 0 || (uint32_t)s->exits[d] >= ws->header->n_links)
+            continue;
+        l = &ws->link_records[s->exits[d]];
+        if (l->first == s->id)
+            r->exits[d] = l->second;
+        else if (l->second == s->id)
+            r->exits[d] = l->first;
+    }
+    return OK;
+}
+
+STATUS world_stream_get_link_record(WorldStream *ws, int position, StreamRecord *r)
+{
+    if (ws == NULL || r == NULL || position < 0 || (uint32_t)position >= ws->header->n_links)
+        return ERROR;
+
+    const ImageLink *l = &ws->link_records[position];
+    memset(r, 0, sizeof(StreamRecord));
+    r->id = l->id;
+    r->first = l->first;
+    r->second = l->second;
+    r->on = l->opened ? TRUE : FALSE;
+    r->name = stream_image_text(ws, l->name);
+    for (int d = 0; d < N_DIRECTIONS; d++)
+        r->exits[d] = NO_ID;
+    return OK;
+}
+
+STATUS world_stream_get_object_record(WorldStream *ws, int position, StreamRecord *r)
+{
+    if (ws == NULL || r == NULL || position < 0 || (uint32_t)position >= ws->header->n_objects)
+        return ERROR;
+
+    const ImageObject *o = &ws->object_records[position];
+    memset(r, 0, sizeof(StreamRecord));
+    r->id = o->id;
+    r->first = o->location;
+    r->second = NO_ID;
+    r->on = o->turned_on ? TRUE : FALSE;
+    r->name = stream_image_text(ws, o->name);
+    for (int d = 0; d < N_DIRECTIONS; d++)
+        r->exits[d] = NO_ID;
+    return OK;
+}
+
+Space *world_stream_get_space_at(WorldStream *ws, int position)
+{
+    if (ws == NULL || position < 0 || (uint32_t)position >= ws->header->n_spaces)
+        return NULL;
+    return ws->spaces[position];
+}
+
+Link *world_stream_get_link_at(WorldStream *ws, int position)
+{
+    if (ws == NULL || position < 0 || (uint32_t)position >= ws->header->n_links)
+        return NULL;
+    return ws->links[position];
+}
+
+Object *world_stream_get_object_at(WorldStream *ws, int position)
+{
+    if (ws == NULL || position < 0 || (uint32_t)position >= ws->header->n_objects)
+        return NULL;
+    return ws->objects[position];
+}
+
+int world_stream_get_resident(WorldStream *ws)
+{
+    return ws != NULL ? ws->n_resident : -1;
+}
@@ -0,0 +1,482 @@
+/**
+ * @brief It tests the world image module
+ *
+ * The tests compile the world of datanew.dat and read it back, so they are
+ * run from the root of the project. The streamed worlds are compiled with
+ * regions of two spaces, so they have several
+ *
+ * @file world_image_test.c
+ * @author Jiri Zak
+ * @version 2.0
+ * @date 26-05-2021
+ * @copyright GNU Public License
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/world_image.h"
+#include "../include/game.h"
+#include "../include/space.h"
+#include "../include/link.h"
+#include "../include/object.h"
+#include "../include/die.h"
+#include "../include/test.h"
+#include "../include/types.h"
+
+#define TEST_WORLD "datanew.dat"
+#define TEST_IMAGE "/tmp/world_image_test.gwc"
+#define TEST_REGION_SPACES 2
+
+/**
+ * @brief reads a whole file into memory
+ *
+ * @param filename name of the file
+ * @param size set to the size of the file
+ * @return the contents, NULL if error
+ */
+static char* read_file(const char* filename, size_t* size) {
+    FILE* f = fopen(filename, "rb");
+    char* data = NULL;
+    long n = 0;
+
+    if (f == NULL)
+        return NULL;
+    if (fseek(f, 0, SEEK_END) == 0 && (n = ftell(f)) > 0 && fseek(f, 0, SEEK_SET) == 0) {
+        data = malloc((size_t)n);
+        if (data != NULL && fread(data, 1, (size_t)n, f) != (size_t)n) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(f);
+    *size = (size_t)n;
+    return data;
+}
+
+/**
+ * @brief game with the world of the test data file
+ *
+ * @return the game, NULL if error
+ */
+static Game* load_world() {
+    Game* game = game_init();
+    if (game != NULL && game_create_from_file(game, TEST_WORLD) == ERROR) {
+        game_destroy(game);
+        return NULL;
+    }
+    return game;
+}
+
+/**
+ * @brief game with the world of the test data file, saved as an image and
+ * read back
+ *
+ * @param original set to the game the image was made from
+ * @return the game read from the image, NULL if error
+ */
+static Game* load_image(Game** original) {
+    size_t size = 0;
+    char* data = NULL;
+    Game* game = NULL;
+
+    *original = load_world();
+    if (*original == NULL || world_image_save(TEST_IMAGE, *original) == ERROR)
+        return NULL;
+    data = read_file(TEST_IMAGE, &size);
+    if (data == NULL)
+        return NULL;
+
+    game = game_init();
+    if (game == NULL || game_create(game) == ERROR || world_image_load(data, size, game) == ERROR) {
+        free(data);
+        return NULL;
+    }
+    free(data);
+    return game;
+}
+
+/**
+ * @brief frees the image of a stream, like munmap does with a mapped one
+ *
+ * @param data image read by read_file
+ * @param size size of the image
+ */
+static void release_file(const char* data, size_t size) {
+    (void)size;
+    free((void*)data);
+}
+
+/**
+ * @brief game with the world of the test data file streamed from an image
+ *
+ * @param original set to the game the image was made from
+ * @param max_regions regions kept in memory, 0 for no limit
+ * @return the streamed game, NULL if error
+ */
+static Game* stream_image(Game** original, int max_regions) {
+    size_t size = 0;
+    char* data = NULL;
+    Game* game = NULL;
+
+    *original = load_world();
+    world_image_set_region_spaces(TEST_REGION_SPACES);
+    if (*original == NULL || world_image_save(TEST_IMAGE, *original) == ERROR)
+        return NULL;
+    data = read_file(TEST_IMAGE, &size);
+    if (data == NULL)
+        return NULL;
+
+    game = game_init();
+    if (game == NULL || game_create(game) == ERROR || world_stream_open(data, size, game, max_regions, release_file) == ERROR) {
+        free(data);
+        return NULL;
+    }
+    return game;
+}
+
+/**
+ * @brief first exit of a space
+ *
+ * @param space pointer to space, can be NULL
+ * @return the link or NULL if the space has no exits
+ */
+static Link* first_exit(Space* space) {
+    Link* link = NULL;
+    for (int d = 0; space != NULL && link == NULL && d < N_DIRECTIONS; d++)
+        link = space_get_exit(space, (T_Direction)d);
+    return link;
+}
+
+/**
+ * @brief destroys the games of a streaming test
+ *
+ * @param game streamed game, can be NULL
+ * @param original game the image was made from, can be NULL
+ */
+static void destroy_games(Game* game, Game* original) {
+    if (game != NULL)
+        game_destroy(game);
+    if (original != NULL)
+        game_destroy(original);
+}
+
+void test_world_image_save() {
+    Game* game = load_world();
+    PRINT_TEST_RESULT(game != NULL && world_image_save(TEST_IMAGE, game) == OK);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_world_image_save_null() {
+    PRINT_TEST_RESULT(world_image_save(TEST_IMAGE, NULL) == ERROR);
+}
+
+void test_world_image_check() {
+    size_t size = 0;
+    Game* game = load_world();
+    world_image_save(TEST_IMAGE, game);
+    char* data = read_file(TEST_IMAGE, &size);
+    PRINT_TEST_RESULT(data != NULL && world_image_check(data, size) == TRUE);
+    free(data);
+    if (game != NULL)
+        game_destroy(game);
+}
+
+void test_world_image_check_text() {
+    size_t size = 0;
+    char* data = read_file(TEST_WORLD, &size);
+    PRINT_TEST_RESULT(data != NULL && world_image_check(data, size) == FALSE);
+    free(data);
+}
+
+void test_world_image_load_truncated() {
+    size_t size = 0;
+    Game* original = load_world();
+    world_image_save(TEST_IMAGE, original);
+    char* data = read_file(TEST_IMAGE, &size);
+    Game* game = game_init();
+    game_create(game);
+    PRINT_TEST_RESULT(data != NULL && world_image_load(data, size / 2, game) == ERROR);
+    free(data);
+    game_destroy(game);
+    if (original != NULL)
+        game_destroy(original);
+}
+
+void test_world_image_load_counts() {
+    Game* original = NULL;
+    Game* game = load_image(&original);
+    PRINT_TEST_RESULT(game != NULL &&
+                      game_get_number_space(game) == game_get_number_space(original) &&
+                      game_get_number_link(game) == game_get_number_link(original) &&
+                      game_get_number_object(game) == game_get_number_object(original));
+    if (game != NULL)
+        game_destroy(game);
+    if (original != NULL)
+        game_destroy(original);
+}
+
+void test_world_image_load_spaces() {
+    Game* original = NULL;
+    Game* game = load_image(&original);
+    BOOL same = (game != NULL) ? TRUE : FALSE;
+
+    for (int i = 0; same == TRUE && i < game_get_number_space(original); i++) {
+        Space* a = game_get_space_at_position(original, i);
+        Space* b = game_get_space(game, space_get_id(a));
+        Link* la = space_get_north(a);
+        Link* lb = (b != NULL) ? space_get_north(b) : NULL;
+        if (b == NULL || strcmp(space_get_name(a), space_get_name(b)) != 0 ||
+            (la == NULL) != (lb == NULL) ||
+            (la != NULL && link_get_destination(la, space_get_id(a)) != link_get_destination(lb, space_get_id(b))))
+            same = FALSE;
+    }
+    PRINT_TEST_RESULT(same == TRUE);
+    if (game != NULL)
+        game_destroy(game);
+    if (original != NULL)
+        game_destroy(original);
+}
+
+void test_world_image_load_objects() {
+    Game* original = NULL;
+    Game* game = load_image(&original);
+    BOOL same = (game != NULL) ? TRUE : FALSE;
+
+    for (int i = 0; same == TRUE && i < game_get_number_object(original); i++) {
+        Object* a = game_get_object_at_position(original, i);
+        Object* b = game_get_object(game, object_get_id(a));
+        if (b == NULL || strcmp(object_get_name(a), object_get_name(b)) != 0 || object_get_location(a) != object_get_location(b))
+            same = FALSE;
+    }
+    PRINT_TEST_RESULT(same == TRUE);
+    if (game != NULL)
+        game_destroy(game);
+    if (original != NULL)
+        game_destroy(original);
+}
+
+void test_world_image_load_player_dice() {
+    Game* original = NULL;
+    Game* game = load_image(&original);
+    PRINT_TEST_RESULT(game != NULL &&
+                      game_get_player_location(game) == game_get_player_location(original) &&
+                      dice_get_maximum(game_get_dice(game)) == dice_get_maximum(game_get_dice(original)));
+    if (game != NULL)
+        game_destroy(game);
+    if (original != NULL)
+        game_destroy(original);
+}
+
+void test_world_stream_open() {
+    Game* original = NULL;
+    Game* game = stream_image(&original, 0);
+    // The region of the player and the one of the objects in no space
+    PRINT_TEST_RESULT(game != NULL && world_stream_get_resident(game_get_stream(game)) <= 2 &&
+                      game_get_number_space(game) < game_get_number_space(original) &&
+                      game_get_space(game, game_get_player_location(game)) != NULL);
+    destroy_games(game, original);
+}
+
+void test_world_stream_open_truncated() {
+    size_t size = 0;
+    Game* original = load_world();
+    world_image_save(TEST_IMAGE, original);
+    char* data = read_file(TEST_IMAGE, &size);
+    Game* game = game_init();
+    game_create(game);
+    PRINT_TEST_RESULT(data != NULL && world_stream_open(data, size / 2, game, 0, release_file) == ERROR &&
+                      game_get_stream(game) == NULL);
+    free(data);
+    destroy_games(game, original);
+}
+
+void test_world_stream_get_space() {
+    Game* original = NULL;
+    Game* game = stream_image(&original, 0);
+    Space* far = game_get_space_at_position(original, game_get_number_space(original) - 1);
+    Space* space = (game != NULL) ? game_get_space(game, space_get_id(far)) : NULL;
+    PRINT_TEST_RESULT(space != NULL && strcmp(space_get_name(space), space_get_name(far)) == 0 &&
+                      game_get_space(game, NO_ID) == NULL);
+    destroy_games(game, original);
+}
+
+void test_world_stream_get_object() {
+    Game* original = NULL;
+    Game* game = stream_image(&original, 0);
+    BOOL same = (game != NULL) ? TRUE : FALSE;
+
+    for (int i = 0; same == TRUE && i < game_get_number_object(original); i++) {
+        Object* a = game_get_object_at_position(original, i);
+        Object* b = game_get_object(game, object_get_id(a));
+        if (b == NULL || strcmp(object_get_name(a), object_get_name(b)) != 0 || object_get_location(a) != object_get_location(b))
+            same = FALSE;
+    }
+    PRINT_TEST_RESULT(same == TRUE);
+    destroy_games(game, original);
+}
+
+void test_world_stream_budget() {
+    Game* original = NULL;
+    Game* game = stream_image(&original, 1);
+    BOOL kept = (game != NULL) ? TRUE : FALSE;
+
+    // The region of the player is never evicted, the last one built neither
+    for (int i = 0; kept == TRUE && i < game_get_number_space(original); i++) {
+        if (game_get_space(game, space_get_id(game_get_space_at_position(original, i))) == NULL ||
+            world_stream_get_resident(game_get_stream(game)) > 3)
+            kept = FALSE;
+    }
+    // The entities left where the evicted ones were are still found by their id
+    for (int i = 0; kept == TRUE && i < game_get_number_space(game); i++) {
+        Space* space = game_get_space_at_position(game, i);
+        if (game_get_space(game, space_get_id(space)) != space)
+            kept = FALSE;
+    }
+    for (int i = 0; kept == TRUE && i < game_get_number_object(game); i++) {
+        Object* obj = game_get_object_at_position(game, i);
+        if (game_get_object(game, object_get_id(obj)) != obj)
+            kept = FALSE;
+    }
+    PRINT_TEST_RESULT(kept == TRUE);
+    destroy_games(game, original);
+}
+
+void test_world_stream_dirty() {
+    Game* original = NULL;
+    Game* game = stream_image(&original, 1);
+    Id far = NO_ID;
+    Link* link = NULL;
+    BOOL opened = FALSE;
+
+    // The last space with some exit, far from the player
+    for (int i = game_get_number_space(original) - 1; far == NO_ID && i >= 0; i--) {
+        if (first_exit(game_get_space_at_position(original, i)) != NULL)
+            far = space_get_id(game_get_space_at_position(original, i));
+    }
+    if (game != NULL)
+        link = first_exit(game_get_space(game, far));
+    if (link != NULL) {
+        opened = (link_get_opened(link) == TRUE) ? FALSE : TRUE;
+        link_set_opened(link, opened);
+    }
+    for (int i = 0; game != NULL && i < game_get_number_space(original); i++)
+        game_get_space(game, space_get_id(game_get_space_at_position(original, i)));
+
+    link = (game != NULL) ? first_exit(game_get_space(game, far)) : NULL;
+    PRINT_TEST_RESULT(link != NULL && link_get_opened(link) == opened);
+    destroy_games(game, original);
+}
+
+void test_world_stream_load_all() {
+    Game* original = NULL;
+    Game* game = stream_image(&original, 1);
+    PRINT_TEST_RESULT(game != NULL && world_stream_load_all(game_get_stream(game), game) == OK &&
+                      game_get_number_space(game) == game_get_number_space(original) &&
+                      game_get_number_link(game) == game_get_number_link(original) &&
+                      game_get_number_object(game) == game_get_number_object(original));
+    destroy_games(game, original);
+}
+
+void test_world_image_set_region_spaces() {
+    PRINT_TEST_RESULT(world_image_set_region_spaces(0) == ERROR && world_image_set_region_spaces(64) == OK);
+}
+
+void test_all() {
+    test_world_image_save();
+    test_world_image_save_null();
+    test_world_image_check();
+    test_world_image_check_text();
+    test_world_image_load_truncated();
+    test_world_image_load_counts();
+    test_world_image_load_spaces();
+    test_world_image_load_objects();
+    test_world_image_load_player_dice();
+    test_world_stream_open();
+    test_world_stream_open_truncated();
+    test_world_stream_get_space();
+    test_world_stream_get_object();
+    test_world_stream_budget();
+    test_world_stream_dirty();
+    test_world_stream_load_all();
+    test_world_image_set_region_spaces();
+
+    PRINT_PASSED_PERCENTAGE;
+}
+
+/**
+ * @brief Main function for WORLD IMAGE unit tests.
+ *
+ * You may execute ALL or a SINGLE test
+ *   1.- No parameter -> ALL test are executed
+ *   2.- A number means a particular test (the one identified by that number)
+ *       is executed
+ *
+ */
+int main(int argc, char **argv) {
+    printf("World image test\n");
+    printf("=========================\n");
+
+    if (argc == 2) {
+        switch (atoi(argv[1])) {
+            case 1:
+                test_world_image_save();
+                break;
+            case 2:
+                test_world_image_save_null();
+                break;
+            case 3:
+                test_world_image_check();
+                break;
+            case 4:
+                test_world_image_check_text();
+                break;
+            case 5:
+                test_world_image_load_truncated();
+                break;
+            case 6:
+                test_world_image_load_counts();
+                break;
+            case 7:
+                test_world_image_load_spaces();
+                break;
+            case 8:
+                test_world_image_load_objects();
+                break;
+            case 9:
+                test_world_image_load_player_dice();
+                break;
+            case 10:
+                test_world_stream_open();
+                break;
+            case 11:
+                test_world_stream_open_truncated();
+                break;
+            case 12:
+                test_world_stream_get_space();
+                break;
+            case 13:
+                test_world_stream_get_object();
+                break;
+            case 14:
+                test_world_stream_budget();
+                break;
+            case 15:
+                test_world_stream_dirty();
+                break;
+            case 16:
+                test_world_stream_load_all();
+                break;
+            case 17:
+                test_world_image_set_region_spaces();
+                break;
+            default:
+                break;
+        }
+    } else
+        test_all();
+
+    return 0;
+}